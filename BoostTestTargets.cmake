@@ -211,7 +211,7 @@ function(add_boost_test _name)
 		set(${_name}_TARGET_NAME "${_target_name}" PARENT_SCOPE)
 
 		# Build the test.
-		add_executable(${_target_name} $<TARGET_OBJECTS:Compiler> ${SOURCES})
+		add_executable(${_target_name} $<TARGET_OBJECTS:Compiler> $<TARGET_OBJECTS:PeepholeRules> ${SOURCES})
 
 		list(APPEND LIBRARIES ${_boosttesttargets_libs})
 
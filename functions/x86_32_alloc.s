@@ -8,70 +8,145 @@ push edx
 push edi
 push esi
 
-;Add the size of the header
-add ecx, 8
+;ecx = size of the block, header included, rounded to 8 bytes
+add ecx, 15
+and ecx, -8
 
-;ebx = start, edx = last
-mov eax, [V_mem_start]
-mov edx, [V_mem_last]
+;The big blocks are managed in a first-fit list
+cmp ecx, 256
+ja .large
 
-.start:
+;esi = address of the free list of the size class
+mov esi, ecx
+shr esi, 1
+add esi, V_mem_bins + 4
 
-;Check if we are at the end
-cmp eax, edx
-je .alloc
+;edx = first free block of the size class
+mov edx, [esi]
+test edx, edx
+jz .bump
 
-;edi = availability of the block
-;esi = size of the block
-mov edi, [eax]
-mov esi, [eax + 4]
-cmp edi, 1
-jne .move
+;Remove the block from the free list
+mov ebx, [edx + 4]
+mov [esi], ebx
 
-cmp esi, ecx
-jl .move
+jmp .clear
 
-;The block is available and of the good size
-;The block is of the good size
+.large:
 
-;make it unavailable
-mov dword [eax], 0
+;edx = current free large block
+mov edx, [V_mem_large]
 
-;The pointer is past the header
-add eax, 8
+.large_next:
 
-pop esi
-pop edi
-pop edx
-pop ecx
-pop ebx
+test edx, edx
+jz .bump
 
-leave
-ret
+;ebx = size of the block (without the free flag)
+mov ebx, [edx]
+and ebx, -8
+
+cmp ebx, ecx
+jae .large_found
+
+mov edx, [edx + 4]
+jmp .large_next
+
+.large_found:
+
+;Unlink the block, edi = next, esi = previous
+mov edi, [edx + 4]
+mov esi, [edx + 8]
+
+test esi, esi
+jz .large_head
+
+mov [esi + 4], edi
+jmp .large_unlink_next
+
+.large_head:
+
+mov [V_mem_large], edi
+
+.large_unlink_next:
 
-.move:
+test edi, edi
+jz .large_unlinked
 
-;switch to the next block
-add eax, esi
+mov [edi + 8], esi
 
-jmp .start
+.large_unlinked:
 
-.alloc:
+;esi = size of the remainder
+mov esi, ebx
+sub esi, ecx
 
-mov edi, eax
+;Split the block only if the remainder is still a large block
+cmp esi, 256
+jbe .large_whole
 
-;alloc new block of the good size
-lea ebx, [eax + ecx]
+;edi = remainder, inserted at the head of the free list
+lea edi, [edx + ecx]
+lea eax, [esi + 1]
+mov [edi], eax
+mov eax, [V_mem_large]
+mov [edi + 4], eax
+mov dword [edi + 8], 0
+
+test eax, eax
+jz .large_split_head
+
+mov [eax + 8], edi
+
+.large_split_head:
+
+mov [V_mem_large], edi
+mov [edx], ecx
+
+jmp .clear
+
+.large_whole:
+
+;Take the whole block (clear the free flag)
+mov [edx], ebx
+mov ecx, ebx
+
+.clear:
+
+;A reused block contains old values, clear it
+lea edi, [edx + 4]
+sub ecx, 4
+shr ecx, 2
+xor eax, eax
+rep stosd
+
+jmp .done
+
+.bump:
+
+;Take the block at the end of the heap, this memory is still clear
+mov edx, [V_mem_bump]
+lea esi, [edx + ecx]
+
+cmp esi, [V_mem_last]
+jbe .bumped
+
+;Grow the heap by chunks of 64 KiB
+lea ebx, [esi + 65536]
 mov eax, 45
 int 80h
 
-mov [V_mem_last], ebx
+mov [V_mem_last], eax
+
+.bumped:
 
-mov dword [edi], 0
-mov dword [edi + 4], ecx
+mov [V_mem_bump], esi
+mov [edx], ecx
 
-;the pointer is past the header
-lea eax, [edi + 8]
+.done:
+
+;The pointer is past the header
+lea eax, [edx + 8]
 
 pop esi
 pop edi
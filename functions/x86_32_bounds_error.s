@@ -0,0 +1,21 @@
+_bounds_error:
+push ebp
+mov ebp, esp
+
+;The output of the program must be visible before the error
+call _F5flush
+
+;Print the error on the standard error
+mov eax, 4
+mov ebx, 2
+mov ecx, .message
+mov edx, 26
+int 80h
+
+;Exit with an error code
+mov eax, 1
+mov ebx, 1
+int 80h
+
+.message:
+db `Array index out of bounds\n`
@@ -16,10 +16,10 @@ mov edi, eax
 
 mov ecx, [ebp + 16]
 mov esi, [ebp + 20]
-rep movsb
+call _memcopy
 mov ecx, [ebp + 8]
 mov esi, [ebp + 12]
-rep movsb
+call _memcopy
 
 pop edi
 pop esi
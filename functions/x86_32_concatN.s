@@ -0,0 +1,47 @@
+_concatN:
+push ebp
+mov ebp, esp
+
+push ecx
+push edx
+push esi
+push edi
+
+;Each string is 8 bytes on the stack, the last one is at the top
+lea edx, [ebp + ecx * 8 + 8]
+
+;Compute the total number of bytes
+xor ebx, ebx
+lea esi, [ebp + 8]
+
+.length:
+add ebx, [esi]
+add esi, 8
+cmp esi, edx
+jne .length
+
+;alloc the total number of bytes
+mov ecx, ebx
+call _F5allocI
+;destination address for the copy
+mov edi, eax
+
+;Copy the strings from the first one to the last one
+.copy:
+sub edx, 8
+;number of bytes of the source
+mov ecx, [edx]
+;source address
+mov esi, [edx + 4]
+call _memcopy
+lea ecx, [ebp + 8]
+cmp edx, ecx
+jne .copy
+
+pop edi
+pop esi
+pop edx
+pop ecx
+
+leave
+ret
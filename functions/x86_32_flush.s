@@ -0,0 +1,44 @@
+_F5flush:
+push ebp
+mov ebp, esp
+
+push eax
+push ebx
+push ecx
+push edx
+
+;Nothing to do if the output buffer is empty
+mov edx, [V_out_length]
+or edx, edx
+jz .exit
+
+mov ecx, V_out_buffer
+
+;write can write less bytes than asked, write until the whole buffer is out
+.write:
+mov eax, 4
+mov ebx, 1
+int 80h
+
+;Retry when interrupted by a signal (EINTR), give up on the other errors
+cmp eax, -4
+je .write
+cmp eax, 0
+jle .done
+
+add ecx, eax
+sub edx, eax
+jnz .write
+
+.done:
+mov dword [V_out_length], 0
+
+.exit:
+
+pop edx
+pop ecx
+pop ebx
+pop eax
+
+leave
+ret
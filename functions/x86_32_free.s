@@ -2,8 +2,93 @@ _F4freePI:
 push ebp
 mov ebp, esp
 
-;block->available = 1
-mov dword [ecx - 8], 1
+push eax
+push ebx
+push ecx
+push edx
+push esi
+
+;edx = header of the block, ecx = size of the block
+lea edx, [ecx - 8]
+mov ecx, [edx]
+
+cmp ecx, 256
+ja .merge
+
+;A small block is pushed on the free list of its size class
+mov esi, ecx
+shr esi, 1
+add esi, V_mem_bins + 4
+
+mov ebx, [esi]
+mov [edx + 4], ebx
+mov [esi], edx
+
+jmp .done
+
+.merge:
+
+;esi = next block in memory
+lea esi, [edx + ecx]
+cmp esi, [V_mem_bump]
+jae .insert
+
+;Only the free large blocks have the free flag
+mov ebx, [esi]
+test ebx, 1
+jz .insert
+
+;Merge the next block into this one
+and ebx, -8
+add ecx, ebx
+
+;Unlink the next block, eax = next, ebx = previous
+mov eax, [esi + 4]
+mov ebx, [esi + 8]
+
+test ebx, ebx
+jz .merge_head
+
+mov [ebx + 4], eax
+jmp .merge_next
+
+.merge_head:
+
+mov [V_mem_large], eax
+
+.merge_next:
+
+test eax, eax
+jz .merge
+
+mov [eax + 8], ebx
+jmp .merge
+
+.insert:
+
+;Mark the block as free and insert it at the head of the free list
+lea ebx, [ecx + 1]
+mov [edx], ebx
+mov ebx, [V_mem_large]
+mov [edx + 4], ebx
+mov dword [edx + 8], 0
+
+test ebx, ebx
+jz .insert_head
+
+mov [ebx + 8], edx
+
+.insert_head:
+
+mov [V_mem_large], edx
+
+.done:
+
+pop esi
+pop edx
+pop ecx
+pop ebx
+pop eax
 
 leave
 ret
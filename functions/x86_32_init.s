@@ -7,8 +7,13 @@ xor ebx, ebx
 mov eax, 45
 int 80h
 
+;The blocks are aligned on 8 bytes
+add eax, 7
+and eax, -8
+
 mov [V_mem_start], eax
 mov [V_mem_last], eax
+mov [V_mem_bump], eax
 
 leave
 ret
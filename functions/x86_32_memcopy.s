@@ -0,0 +1,23 @@
+_memcopy:
+sub esp, 16
+movdqu [esp], xmm0
+
+;Copy 16 bytes at a time
+.vectors:
+cmp ecx, 16
+jb .bytes
+movdqu xmm0, [esi]
+movdqu [edi], xmm0
+add esi, 16
+add edi, 16
+sub ecx, 16
+jmp .vectors
+
+;Copy the remaining bytes
+.bytes:
+rep movsb
+
+movdqu xmm0, [esp]
+add esp, 16
+
+ret
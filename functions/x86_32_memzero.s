@@ -0,0 +1,42 @@
+_memzero:
+push eax
+push ecx
+push edi
+sub esp, 16
+movdqu [esp], xmm0
+
+pxor xmm0, xmm0
+
+;Clear 64 bytes at a time
+.blocks:
+cmp ecx, 64
+jb .vectors
+movdqu [edi], xmm0
+movdqu [edi + 16], xmm0
+movdqu [edi + 32], xmm0
+movdqu [edi + 48], xmm0
+add edi, 64
+sub ecx, 64
+jmp .blocks
+
+;Clear 16 bytes at a time
+.vectors:
+cmp ecx, 16
+jb .bytes
+movdqu [edi], xmm0
+add edi, 16
+sub ecx, 16
+jmp .vectors
+
+;Clear the remaining bytes
+.bytes:
+xor eax, eax
+rep stosb
+
+movdqu xmm0, [esp]
+add esp, 16
+pop edi
+pop ecx
+pop eax
+
+ret
@@ -4,24 +4,16 @@ mov ebp, esp
 sub esp, 4
 
 push eax
-push ebx
-push ecx
-push edx
-push esi
 
 mov [ebp - 4], ecx
 
-mov esi, 0
-mov eax, 4
-mov ebx, 1
-lea ecx, [ebp - 4]
-mov edx, 1
-int 80h
+;The char is printed as a string of length 1
+lea eax, [ebp - 4]
+push 1
+push eax
+call _F5printS
+add esp, 8
 
-pop esi
-pop edx
-pop ecx
-pop ebx
 pop eax
 
 add esp, 4
@@ -1,48 +1,50 @@
 _F5printI:
 push ebp
 mov ebp, esp
+sub esp, 12
 push eax
 push ebx
 push ecx
 push edx
-push esi
+push edi
+;The parameter is in ecx
 mov eax, ecx
-xor esi, esi
+;The chars are written backward from the top of the local buffer
+mov edi, ebp
+;ecx = 1 if the number is negative
+xor ecx, ecx
 cmp eax, 0
 jge .loop
 neg eax
-push eax
-push 1
-push S2
-call _F5printS
-add esp, 8
-pop eax
+mov ecx, 1
+;Divide eax until there is nothing to divide
 .loop:
 mov edx, 0
 mov ebx, 10
 div ebx
 add edx, 48
-push edx
-inc esi
+dec edi
+mov [edi], dl
 cmp eax, 0
-jz .next
-jmp .loop
-.next:
-cmp esi, 0
-jz .exit
-dec esi
-mov eax, 4
-mov ecx, esp
-mov ebx, 1
-mov edx, 1
-int 80h
-add esp, 4
-jmp .next
-.exit:
-pop esi
+jnz .loop
+;If the number is negative, we add the -
+cmp ecx, 0
+jz .print
+dec edi
+mov byte [edi], 45
+;Print all the chars at once
+.print:
+mov ebx, ebp
+sub ebx, edi
+push ebx
+push edi
+call _F5printS
+add esp, 8
+pop edi
 pop edx
 pop ecx
 pop ebx
 pop eax
+add esp, 12
 leave
 ret
@@ -7,14 +7,54 @@ push ebx
 push ecx
 push edx
 push esi
+push edi
 
-mov esi, 0
+mov esi, [ebp + 8]
+mov ecx, [ebp + 12]
+
+;Flush the output buffer if the string does not fit in it
+mov eax, [V_out_length]
+add eax, ecx
+cmp eax, 65536
+jbe .append
+
+call _F5flush
+
+;A string bigger than the buffer is written directly
+cmp ecx, 65536
+jbe .append
+
+mov edx, ecx
+mov ecx, esi
+
+;write can write less bytes than asked, write until the whole string is out
+.write:
 mov eax, 4
 mov ebx, 1
-mov ecx, [ebp + 8]
-mov edx, [ebp + 12]
 int 80h
 
+;Retry when interrupted by a signal (EINTR), give up on the other errors
+cmp eax, -4
+je .write
+cmp eax, 0
+jle .exit
+
+add ecx, eax
+sub edx, eax
+jnz .write
+
+jmp .exit
+
+;Copy the string at the end of the output buffer
+.append:
+mov edi, V_out_buffer
+add edi, [V_out_length]
+add [V_out_length], ecx
+rep movsb
+
+.exit:
+
+pop edi
 pop esi
 pop edx
 pop ecx
@@ -1,22 +1,10 @@
 _F7printlnS:
 push ebp
 mov ebp, esp
-push eax
-push ebx
-push ecx
-push edx
-push esi
-mov esi, 0
-mov eax, 4
-mov ebx, 1
-mov ecx, [ebp + 8]
-mov edx, [ebp + 12]
-int 80h
+push dword [ebp + 12]
+push dword [ebp + 8]
+call _F5printS
+add esp, 8
 call _F7println
-pop esi
-pop edx
-pop ecx
-pop ebx
-pop eax
 leave
 ret
@@ -10,6 +10,9 @@ push esi
 
 mov dword [ebp - 4], 0
 
+;The pending output must be visible before waiting for input
+call _F5flush
+
 mov eax, 3
 mov ebx, 0
 lea ecx, [ebp - 4]
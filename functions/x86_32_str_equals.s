@@ -0,0 +1,58 @@
+_F10str_equalsSS:
+push ebp
+mov ebp, esp
+
+push ecx
+push esi
+push edi
+sub esp, 32
+movdqu [esp], xmm0
+movdqu [esp + 16], xmm1
+
+;Strings of different lengths are never equal
+mov ecx, [ebp + 12]
+cmp ecx, [ebp + 20]
+jne .different
+
+mov esi, [ebp + 8]
+mov edi, [ebp + 16]
+
+;Compare 16 bytes at a time
+.vectors:
+cmp ecx, 16
+jb .bytes
+movdqu xmm0, [esi]
+movdqu xmm1, [edi]
+pcmpeqb xmm0, xmm1
+pmovmskb eax, xmm0
+cmp eax, 0xFFFF
+jne .different
+add esi, 16
+add edi, 16
+sub ecx, 16
+jmp .vectors
+
+;Compare the remaining bytes
+.bytes:
+test ecx, ecx
+jz .equal
+repe cmpsb
+jne .different
+
+.equal:
+mov eax, 1
+jmp .exit
+
+.different:
+xor eax, eax
+
+.exit:
+movdqu xmm1, [esp + 16]
+movdqu xmm0, [esp]
+add esp, 32
+pop edi
+pop esi
+pop ecx
+
+leave
+ret
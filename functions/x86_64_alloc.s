@@ -2,6 +2,8 @@ _F5allocI:
 push rbp
 mov rbp, rsp
 
+push rcx
+push rdx
 push rdi
 push r10
 push r11
@@ -9,68 +11,145 @@ push r12
 push r13
 push r14
 
-;Add the size of the header
-add r14, 16
+;r14 = size of the block, header included, rounded to 16 bytes
+add r14, 31
+and r14, -16
 
-;r12 = start, r13 = last
-mov r12, [V_mem_start]
-mov r13, [V_mem_last]
+;The big blocks are managed in a first-fit list
+cmp r14, 512
+ja .large
 
-.start:
+;r13 = address of the free list of the size class
+mov r13, r14
+shr r13, 1
+add r13, V_mem_bins + 8
 
-;Check if we are at the end
-cmp r12, r13
-je .alloc
+;r12 = first free block of the size class
+mov r12, [r13]
+test r12, r12
+jz .bump
 
-;r10 = availability of the block
-;r11 = size of the block
+;Remove the block from the free list
+mov r10, [r12 + 8]
+mov [r13], r10
+
+jmp .clear
+
+.large:
+
+;r12 = current free large block
+mov r12, [V_mem_large]
+
+.large_next:
+
+test r12, r12
+jz .bump
+
+;r10 = size of the block (without the free flag)
 mov r10, [r12]
+and r10, -16
+
+cmp r10, r14
+jae .large_found
+
+mov r12, [r12 + 8]
+jmp .large_next
+
+.large_found:
+
+;Unlink the block, r11 = next, r13 = previous
 mov r11, [r12 + 8]
-cmp r10, 1
-jne .move
+mov r13, [r12 + 16]
 
-cmp r11, r14
-jl .move
+test r13, r13
+jz .large_head
 
-;The block is available and of the good size
-;The block is of the good size
+mov [r13 + 8], r11
+jmp .large_unlink_next
 
-;make it unavailable
-mov qword [r12], 0
+.large_head:
 
-;The pointer is past the header
-lea rax, [r12 + 16]
+mov [V_mem_large], r11
 
-pop r14
-pop r13
-pop r12
-pop r11
-pop r10
-pop rdi
+.large_unlink_next:
 
-leave
-ret
+test r11, r11
+jz .large_unlinked
+
+mov [r11 + 16], r13
+
+.large_unlinked:
+
+;r13 = size of the remainder
+mov r13, r10
+sub r13, r14
+
+;Split the block only if the remainder is still a large block
+cmp r13, 512
+jbe .large_whole
+
+;r11 = remainder, inserted at the head of the free list
+lea r11, [r12 + r14]
+lea rdx, [r13 + 1]
+mov [r11], rdx
+mov rdx, [V_mem_large]
+mov [r11 + 8], rdx
+mov qword [r11 + 16], 0
+
+test rdx, rdx
+jz .large_split_head
+
+mov [rdx + 16], r11
+
+.large_split_head:
 
-.move:
+mov [V_mem_large], r11
+mov [r12], r14
 
-;switch to the next block
-add r12, r11
+jmp .clear
 
-jmp .start
+.large_whole:
 
-.alloc:
+;Take the whole block (clear the free flag)
+mov [r12], r10
+mov r14, r10
 
-;alloc new block of the good size
-lea rdi, [r12 + r14]
+.clear:
+
+;A reused block contains old values, clear it
+lea rdi, [r12 + 8]
+mov rcx, r14
+sub rcx, 8
+shr rcx, 3
+xor rax, rax
+rep stosq
+
+jmp .done
+
+.bump:
+
+;Take the block at the end of the heap, this memory is still clear
+mov r12, [V_mem_bump]
+lea r13, [r12 + r14]
+
+cmp r13, [V_mem_last]
+jbe .bumped
+
+;Grow the heap by chunks of 64 KiB
+lea rdi, [r13 + 65536]
 mov rax, 12
 syscall
 
-mov [V_mem_last], rdi
+mov [V_mem_last], rax
+
+.bumped:
 
-mov qword [r12], 0
-mov qword [r12 + 8], r14
+mov [V_mem_bump], r13
+mov [r12], r14
 
-;the pointer is past the header
+.done:
+
+;The pointer is past the header
 lea rax, [r12 + 16]
 
 pop r14
@@ -79,6 +158,8 @@ pop r12
 pop r11
 pop r10
 pop rdi
+pop rdx
+pop rcx
 
 leave
 ret
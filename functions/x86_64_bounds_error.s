@@ -0,0 +1,21 @@
+_bounds_error:
+push rbp
+mov rbp, rsp
+
+;The output of the program must be visible before the error
+call _F5flush
+
+;Print the error on the standard error
+mov rax, 1
+mov rdi, 2
+mov rsi, .message
+mov rdx, 26
+syscall
+
+;Exit with an error code
+mov rax, 60
+mov rdi, 1
+syscall
+
+.message:
+db `Array index out of bounds\n`
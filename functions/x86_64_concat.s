@@ -2,26 +2,36 @@ _F6concatSS:
 push rbp
 mov rbp, rsp
 
+push rcx
+push rsi
+push rdi
+push r14
+
 mov rbx, [rbp + 32]
 mov rcx, [rbp + 16]
 add rbx, rcx
 ;alloc the total number of bytes
 mov r14, rbx
 call _F5allocI
-;destination address for the movsb
+;destination address for the copy
 mov rdi, rax
 ;number of bytes of the source
 mov rcx, [rbp + 32]
 ;source address
 mov rsi, [rbp + 40]
 ;copy the first part of the string into the destination
-rep movsb
+call _memcopy
 ;number of bytes of the source
 mov rcx, [rbp + 16]
 ;source address
 mov rsi, [rbp + 24]
 ;copy the second part of the string into the destination
-rep movsb
+call _memcopy
+
+pop r14
+pop rdi
+pop rsi
+pop rcx
 
 leave
 ret
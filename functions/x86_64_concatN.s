@@ -0,0 +1,49 @@
+_concatN:
+push rbp
+mov rbp, rsp
+
+push rcx
+push rdx
+push rsi
+push rdi
+
+;Each string is 16 bytes on the stack, the last one is at the top
+mov rdx, r14
+shl rdx, 4
+lea rdx, [rbp + rdx + 16]
+
+;Compute the total number of bytes
+xor rbx, rbx
+lea rsi, [rbp + 16]
+
+.length:
+add rbx, [rsi]
+add rsi, 16
+cmp rsi, rdx
+jne .length
+
+;alloc the total number of bytes
+mov r14, rbx
+call _F5allocI
+;destination address for the copy
+mov rdi, rax
+
+;Copy the strings from the first one to the last one
+.copy:
+sub rdx, 16
+;number of bytes of the source
+mov rcx, [rdx]
+;source address
+mov rsi, [rdx + 8]
+call _memcopy
+lea rcx, [rbp + 16]
+cmp rdx, rcx
+jne .copy
+
+pop rdi
+pop rsi
+pop rdx
+pop rcx
+
+leave
+ret
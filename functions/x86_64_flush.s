@@ -0,0 +1,48 @@
+_F5flush:
+push rbp
+mov rbp, rsp
+
+push rax
+push rcx
+push rdi
+push rsi
+push rdx
+push r11
+
+;Nothing to do if the output buffer is empty
+mov rdx, [V_out_length]
+or rdx, rdx
+jz .exit
+
+mov rsi, V_out_buffer
+
+;write can write less bytes than asked, write until the whole buffer is out
+.write:
+mov rax, 1
+mov rdi, 1
+syscall
+
+;Retry when interrupted by a signal (EINTR), give up on the other errors
+cmp rax, -4
+je .write
+cmp rax, 0
+jle .done
+
+add rsi, rax
+sub rdx, rax
+jnz .write
+
+.done:
+mov qword [V_out_length], 0
+
+.exit:
+
+pop r11
+pop rdx
+pop rsi
+pop rdi
+pop rcx
+pop rax
+
+leave
+ret
@@ -2,8 +2,93 @@ _F4freePI:
 push rbp
 mov rbp, rsp
 
-;block->available = 1
-mov qword [r14 - 16], 1
+push r10
+push r11
+push r12
+push r13
+push r14
+
+;r12 = header of the block, r10 = size of the block
+lea r12, [r14 - 16]
+mov r10, [r12]
+
+cmp r10, 512
+ja .merge
+
+;A small block is pushed on the free list of its size class
+mov r13, r10
+shr r13, 1
+add r13, V_mem_bins + 8
+
+mov r11, [r13]
+mov [r12 + 8], r11
+mov [r13], r12
+
+jmp .done
+
+.merge:
+
+;r13 = next block in memory
+lea r13, [r12 + r10]
+cmp r13, [V_mem_bump]
+jae .insert
+
+;Only the free large blocks have the free flag
+mov r11, [r13]
+test r11, 1
+jz .insert
+
+;Merge the next block into this one
+and r11, -16
+add r10, r11
+
+;Unlink the next block, r14 = next, r11 = previous
+mov r14, [r13 + 8]
+mov r11, [r13 + 16]
+
+test r11, r11
+jz .merge_head
+
+mov [r11 + 8], r14
+jmp .merge_next
+
+.merge_head:
+
+mov [V_mem_large], r14
+
+.merge_next:
+
+test r14, r14
+jz .merge
+
+mov [r14 + 16], r11
+jmp .merge
+
+.insert:
+
+;Mark the block as free and insert it at the head of the free list
+lea r11, [r10 + 1]
+mov [r12], r11
+mov r11, [V_mem_large]
+mov [r12 + 8], r11
+mov qword [r12 + 16], 0
+
+test r11, r11
+jz .insert_head
+
+mov [r11 + 16], r12
+
+.insert_head:
+
+mov [V_mem_large], r12
+
+.done:
+
+pop r14
+pop r13
+pop r12
+pop r11
+pop r10
 
 leave
 ret
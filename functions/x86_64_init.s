@@ -7,8 +7,13 @@ mov rax, 12
 xor rdi, rdi
 syscall
 
+;The blocks are aligned on 16 bytes
+add rax, 15
+and rax, -16
+
 mov [V_mem_start], rax
 mov [V_mem_last], rax
+mov [V_mem_bump], rax
 
 leave
 ret
@@ -0,0 +1,23 @@
+_memcopy:
+sub rsp, 16
+movdqu [rsp], xmm0
+
+;Copy 16 bytes at a time
+.vectors:
+cmp rcx, 16
+jb .bytes
+movdqu xmm0, [rsi]
+movdqu [rdi], xmm0
+add rsi, 16
+add rdi, 16
+sub rcx, 16
+jmp .vectors
+
+;Copy the remaining bytes
+.bytes:
+rep movsb
+
+movdqu xmm0, [rsp]
+add rsp, 16
+
+ret
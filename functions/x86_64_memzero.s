@@ -0,0 +1,42 @@
+_memzero:
+push rax
+push rcx
+push rdi
+sub rsp, 16
+movdqu [rsp], xmm0
+
+pxor xmm0, xmm0
+
+;Clear 64 bytes at a time
+.blocks:
+cmp rcx, 64
+jb .vectors
+movdqu [rdi], xmm0
+movdqu [rdi + 16], xmm0
+movdqu [rdi + 32], xmm0
+movdqu [rdi + 48], xmm0
+add rdi, 64
+sub rcx, 64
+jmp .blocks
+
+;Clear 16 bytes at a time
+.vectors:
+cmp rcx, 16
+jb .bytes
+movdqu [rdi], xmm0
+add rdi, 16
+sub rcx, 16
+jmp .vectors
+
+;Clear the remaining bytes
+.bytes:
+xor rax, rax
+rep stosb
+
+movdqu xmm0, [rsp]
+add rsp, 16
+pop rdi
+pop rcx
+pop rax
+
+ret
@@ -4,25 +4,16 @@ mov rbp, rsp
 sub rsp, 8
 
 push rax
-push rcx
-push rdi
-push rsi
-push rdx
-push r11
 
 mov [rbp - 8], r14
 
-mov rax, 1
-mov rdi, 1
-lea rsi, [rbp - 8]
-mov rdx, 1
-syscall
+;The char is printed as a string of length 1
+lea rax, [rbp - 8]
+push 1
+push rax
+call _F5printS
+add rsp, 16
 
-pop r11
-pop rdx
-pop rsi
-pop rdi
-pop rcx
 pop rax
 
 add rsp, 8
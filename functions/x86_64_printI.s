@@ -1,59 +1,54 @@
 _F5printI:
 push rbp
 mov rbp, rsp
+sub rsp, 24
 
 push rax
 push rbx
 push rcx
 push rdx
-push rsi
 push rdi
-push r11
 
 ;The parameter is in r14
 mov rax, r14
-xor r14, r14
-;If the number is negative, we print the - and then the number
+;The chars are written backward from the top of the local buffer
+mov rdi, rbp
+;rcx = 1 if the number is negative
+xor rcx, rcx
 or rax, rax
 jge .loop
 neg rax
-;Print "-" 
-push 1
-push S2
-call _F5printS
-add rsp, 16
+mov rcx, 1
 ;Divide rax until there is nothing to divide
 .loop:
 xor rdx, rdx
 mov rbx, 10
 div rbx
 add rdx, 48
-push rdx
-inc r14
+dec rdi
+mov [rdi], dl
 or rax, rax
-jz .next
-jmp .loop
-;Print each of the char, one by one
-.next:
-or r14, r14
-jz .exit
-dec r14
-mov rax, 1
-mov rdi, 1
-mov rsi, rsp
-mov rdx, 1
-syscall
-add rsp, 8
-jmp .next
-.exit:
+jnz .loop
+;If the number is negative, we add the -
+or rcx, rcx
+jz .print
+dec rdi
+mov byte [rdi], 45
+;Print all the chars at once
+.print:
+mov rbx, rbp
+sub rbx, rdi
+push rbx
+push rdi
+call _F5printS
+add rsp, 16
 
-pop r11
 pop rdi
-pop rsi
 pop rdx
 pop rcx
 pop rbx
 pop rax
 
+add rsp, 24
 leave
 ret
@@ -9,12 +9,50 @@ push rsi
 push rdx
 push r11
 
+mov rsi, [rbp + 16]
+mov rcx, [rbp + 24]
+
+;Flush the output buffer if the string does not fit in it
+mov rax, [V_out_length]
+add rax, rcx
+cmp rax, 65536
+jbe .append
+
+call _F5flush
+
+;A string bigger than the buffer is written directly
+cmp rcx, 65536
+jbe .append
+
+mov rdx, rcx
+
+;write can write less bytes than asked, write until the whole string is out
+.write:
 mov rax, 1
 mov rdi, 1
-mov rsi, [rbp + 16]
-mov rdx, [rbp + 24]
 syscall
 
+;Retry when interrupted by a signal (EINTR), give up on the other errors
+cmp rax, -4
+je .write
+cmp rax, 0
+jle .exit
+
+add rsi, rax
+sub rdx, rax
+jnz .write
+
+jmp .exit
+
+;Copy the string at the end of the output buffer
+.append:
+mov rdi, V_out_buffer
+add rdi, [V_out_length]
+add [V_out_length], rcx
+rep movsb
+
+.exit:
+
 pop r11
 pop rdx
 pop rsi
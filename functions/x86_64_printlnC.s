@@ -2,27 +2,9 @@ _F7printlnC:
 push rbp
 mov rbp, rsp
 
-push rax
-push rcx
-push rdi
-push rsi
-push rdx
-
-mov [rbp - 8], r14
-
-mov rax, 1
-mov rdi, 1
-lea rsi, [rbp - 8]
-mov rdx, 1
-syscall
-
+;The parameter is still in r14
+call _F5printC
 call _F7println
 
-pop rdx
-pop rsi
-pop rdi
-pop rcx
-pop rax
-
 leave
 ret
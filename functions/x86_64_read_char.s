@@ -11,6 +11,9 @@ push r11
 
 mov qword [rbp - 8], 0
 
+;The pending output must be visible before waiting for input
+call _F5flush
+
 mov rax, 0
 mov rdi, 0
 lea rsi, [rbp - 8]
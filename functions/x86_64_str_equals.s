@@ -0,0 +1,58 @@
+_F10str_equalsSS:
+push rbp
+mov rbp, rsp
+
+push rcx
+push rsi
+push rdi
+sub rsp, 32
+movdqu [rsp], xmm0
+movdqu [rsp + 16], xmm1
+
+;Strings of different lengths are never equal
+mov rcx, [rbp + 24]
+cmp rcx, [rbp + 40]
+jne .different
+
+mov rsi, [rbp + 16]
+mov rdi, [rbp + 32]
+
+;Compare 16 bytes at a time
+.vectors:
+cmp rcx, 16
+jb .bytes
+movdqu xmm0, [rsi]
+movdqu xmm1, [rdi]
+pcmpeqb xmm0, xmm1
+pmovmskb eax, xmm0
+cmp eax, 0xFFFF
+jne .different
+add rsi, 16
+add rdi, 16
+sub rcx, 16
+jmp .vectors
+
+;Compare the remaining bytes
+.bytes:
+test rcx, rcx
+jz .equal
+repe cmpsb
+jne .different
+
+.equal:
+mov rax, 1
+jmp .exit
+
+.different:
+xor rax, rax
+
+.exit:
+movdqu xmm1, [rsp + 16]
+movdqu xmm0, [rsp]
+add rsp, 32
+pop rdi
+pop rsi
+pop rcx
+
+leave
+ret
@@ -14,6 +14,18 @@
 
 namespace eddic {
 
+/*!
+ * \brief Encode the assembly directly into the output executable, without starting nasm and ld.
+ * This is only supported on x86_64 without debugging symbols.
+ * \param platform The target platform.
+ * \param source The assembly code.
+ * \param output The output file path.
+ * \param debug The debug mode flag.
+ * \param verbose The verbose mode flag.
+ * \return true if the executable has been written, false if it must be assembled and linked by the tools.
+ */
+bool encode(Platform platform, const std::string& source, const std::string& output, bool debug, bool verbose);
+
 /*!
  * \brief Assemble and link the output.asm file and procude the output executable. 
  * \param platform The target platform. 
@@ -8,7 +8,8 @@
 #ifndef ASSEMBLY_FILE_WRITER_H
 #define ASSEMBLY_FILE_WRITER_H
 
-#include <fstream>
+#include <sstream>
+#include <string>
 
 namespace eddic {
 
@@ -20,26 +21,27 @@ namespace eddic {
  */
 class AssemblyFileWriter {
     private:
-        std::ofstream m_stream;
-	
+        std::stringstream m_stream;
+
     public:
-    	/*!
-    	 * Construct an AssemblyFileWriter that will output on the given path. 
-    	 * \param path The path to the file. 
-    	 */
-        AssemblyFileWriter(const std::string& path);
-        
-        /*!
-         * Close the file stream. 
-         */
-        ~AssemblyFileWriter();
-        
         /*!
          * \brief Return the enclosing stream. 
          * This method should be used to output assembly instruction to the file. 
          * \return A reference to the enclosing stream. 
          */
         std::ostream& stream();
+
+        /*!
+         * Return the assembly code written so far.
+         * \return The content of the buffer.
+         */
+        std::string content() const;
+
+        /*!
+         * Write the content of the buffer to a file.
+         * \param path The path to the file.
+         */
+        void write(const std::string& path) const;
 };
 
 } //end of eddic
@@ -10,6 +10,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <mutex>
 
 namespace eddic {
 
@@ -17,12 +18,15 @@ namespace eddic {
  * \class FloatPool
  * \brief The float pool of the program. 
  * All the floats are stored and referred only by an index.  
+ * The pool can be safely accessed by several threads. 
  */
 class FloatPool {
     private:
         std::unordered_map<double, std::string> pool;
         unsigned int currentString;
 
+        mutable std::mutex mutex;
+
     public:
         FloatPool();
 
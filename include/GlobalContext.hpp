@@ -9,6 +9,7 @@
 #define GLOBAL_CONTEXT_H
 
 #include <map>
+#include <mutex>
 
 #include "Context.hpp"
 #include "Function.hpp"
@@ -23,6 +24,7 @@ namespace eddic {
  *
  * There is always only one instance of this class in the application. This symbol table is responsible
  * of storing all the global variables. It is also responsible for storing the global functions and structures. 
+ * The reference counters can be safely updated by several threads. 
  */
 struct GlobalContext final : public Context {
     public: 
@@ -108,6 +110,14 @@ struct GlobalContext final : public Context {
          */
         int referenceCount(const std::string& function);
 
+        /*!
+         * Returns the definition of a call to the N-ary concatenation of strings (_concatN) with the given number of strings. 
+         * All the definitions share the references of the _concatN function. 
+         * \param strings The number of concatenated strings. 
+         * \return A pointer to the definition of the concatenation of the given number of strings. 
+         */
+        std::shared_ptr<Function> concat_function(unsigned int strings);
+
         void add_reference(std::shared_ptr<Variable> variable) override;
         unsigned int reference_count(std::shared_ptr<Variable> variable) override;
 
@@ -116,10 +126,14 @@ struct GlobalContext final : public Context {
     private:
         FunctionMap m_functions;
         StructMap m_structs;
+        std::unordered_map<unsigned int, std::shared_ptr<Function>> concat_functions;
         Platform platform;
 
         std::shared_ptr<std::map<std::shared_ptr<Variable>, unsigned int>> references;
 
+        std::mutex references_mutex;
+        std::mutex concat_mutex;
+
         void addPrintFunction(const std::string& function, std::shared_ptr<const Type> parameterType);
         void defineStandardFunctions();
         
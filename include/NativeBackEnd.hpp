@@ -12,8 +12,14 @@
 
 namespace eddic {
 
+class FloatPool;
+
 struct NativeBackEnd : public BackEnd {
     void generate(mtac::program_p mtacProgram, Platform platform) override;
+
+    private:
+        void generate_serial(mtac::program_p mtacProgram, Platform platform, std::shared_ptr<FloatPool> float_pool);
+        void generate_parallel(mtac::program_p mtacProgram, Platform platform, std::shared_ptr<FloatPool> float_pool);
 };
 
 }
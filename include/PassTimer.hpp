@@ -0,0 +1,85 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#ifndef PASS_TIMER_H
+#define PASS_TIMER_H
+
+#include <string>
+#include <iostream>
+
+#include "StopWatch.hpp"
+
+namespace eddic {
+
+/*!
+ * Enable the collection of the time spent in each pass of the compiler (--time-passes).
+ */
+void enable_time_passes();
+
+/*!
+ * Indicates if the time spent in the passes is collected.
+ * \return true if the passes are timed, false otherwise.
+ */
+bool time_passes_enabled();
+
+/*!
+ * Print the time spent in each pass, sorted by decreasing time, and reset the collected times.
+ * The passes running on several threads at once are accounted the sum of the times of the threads.
+ * \param out The stream to print to.
+ * \param json Indicates if the report is printed as JSON instead of a table.
+ */
+void print_time_passes(std::ostream& out, bool json);
+
+/*!
+ * \class PassTimer
+ * \brief Measure one run of a pass of the compiler.
+ *
+ * The run is added to the report of --time-passes when the timer is destroyed. Nothing is
+ * recorded if the passes are not timed.
+ */
+class PassTimer {
+    public:
+        PassTimer(const std::string& category, const std::string& name);
+
+        /*!
+         * Start timing a pass running on the given number of statements.
+         * \param category The category of the pass (front end, ast, mtac, ltac, ...)
+         * \param name The name of the pass.
+         * \param statements The number of statements before the pass.
+         */
+        PassTimer(const std::string& category, const std::string& name, std::size_t statements);
+
+        ~PassTimer();
+
+        /*!
+         * Set the result of the pass.
+         * \param changed true if the pass changed the code, false otherwise.
+         */
+        void changed(bool changed);
+
+        /*!
+         * Set the number of statements after the pass.
+         * \param statements The number of statements.
+         */
+        void statements(std::size_t statements);
+
+    private:
+        StopWatch timer;
+        std::string category;
+        std::string name;
+
+        bool report_changed = false;
+        bool has_changed = false;
+
+        bool report_statements = false;
+        std::size_t before = 0;
+        std::size_t after = 0;
+};
+
+} //end of eddic
+
+#endif
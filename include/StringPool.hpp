@@ -10,6 +10,8 @@
 
 #include <string>
 #include <unordered_map>
+#include <map>
+#include <vector>
 #include <mutex>
 
 namespace eddic {
@@ -18,13 +20,18 @@ namespace eddic {
  * \struct StringPool
  * \brief The string pool of the program. 
  * All the strings are stored and referred only by an index.  
+ * The pool can be safely accessed by several threads. 
  */
 struct StringPool {
     private:
         std::unordered_map<std::string, std::string> pool;
         unsigned int currentString;
 
-//        mutable std::mutex mutex;
+        //The labels created in a scope are numbered independently of the other scopes
+        std::map<std::pair<std::string, std::string>, std::string> scoped_pool;
+        std::unordered_map<std::string, unsigned int> scoped_strings;
+
+        mutable std::mutex mutex;
 
     public:
         StringPool();
@@ -41,6 +48,18 @@ struct StringPool {
          */
         std::string label(const std::string& value);
         
+        /*!
+         * \brief Return the label for the given value in the given scope. 
+         * If the given value is not in the pool, it will be inserted with a new label numbered 
+         * in the scope. The label does not depend on the values inserted concurrently in 
+         * the other scopes. 
+         * \n\n \b Complexity : O(log n)
+         * \param value The string we want to search in the pool. 
+         * \param scope The name of the scope, used as the prefix of the label.
+         * \return The label associated with the given value. 
+         */
+        std::string label(const std::string& value, const std::string& scope);
+        
         /*!
          * \brief Return the value for the given label. 
          * This function should only be used for existing labels.
@@ -50,7 +69,12 @@ struct StringPool {
          */
         std::string value(const std::string& label) const ;
 
-        std::unordered_map<std::string, std::string> getPool() const;
+        /*!
+         * \brief Return all the (value, label) pairs of the pool. 
+         * A value can be present several times with labels of different scopes.
+         * \return The content of the pool. 
+         */
+        std::vector<std::pair<std::string, std::string>> getPool() const;
 };
 
 } //end of eddic
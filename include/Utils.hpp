@@ -98,6 +98,15 @@ bool file_exists(const std::string& file);
 
 std::string execCommand(const std::string& command);
 
+/*!
+ * \brief Execute the given program and return its standard output. 
+ * Unlike the other version, the program is directly started without going through a shell. 
+ * \param arguments The name of the program followed by its arguments. 
+ * \param status Filled with the exit code of the program, -1 if it could not be started or did not exit normally. 
+ * \return The standard output of the program. 
+ */
+std::string execCommand(const std::vector<std::string>& arguments, int& status);
+
 bool isPowerOfTwo (int x);
 
 int powerOfTwo(int x);
@@ -0,0 +1,139 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace eddic {
+
+/*!
+ * \brief Allocate a chunk of memory for the arenas. The chunks are never given back.
+ * \param size The size of the chunk in bytes.
+ * \return A pointer to the chunk, aligned for any type.
+ */
+void* allocate_chunk(std::size_t size);
+
+/*!
+ * \class slot_pool
+ * \brief Slots of a fixed size carved out of large chunks.
+ *
+ * The pool is shared by all the threads and protected by a mutex. A released slot goes back to 
+ * the shared free list, so the slots of a worker thread are reused after the thread exited.
+ */
+template<std::size_t Size, std::size_t Align>
+struct slot_pool {
+    static const std::size_t align = Align < alignof(void*) ? alignof(void*) : Align;
+    static const std::size_t slot_size = (Size + align - 1) / align * align;
+    static const std::size_t chunk_slots = slot_size > 1024 ? 16 : 16 * 1024 / slot_size;
+
+    static std::mutex mutex;
+    static void* free_list;
+    static char* next;
+    static char* last;
+
+    static void* allocate(){
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if(free_list){
+            auto slot = free_list;
+            free_list = *static_cast<void**>(slot);
+            return slot;
+        }
+
+        if(next == last){
+            next = static_cast<char*>(allocate_chunk(chunk_slots * slot_size));
+            last = next + chunk_slots * slot_size;
+        }
+
+        auto slot = next;
+        next += slot_size;
+        return slot;
+    }
+
+    static void release(void* slot){
+        std::lock_guard<std::mutex> lock(mutex);
+
+        *static_cast<void**>(slot) = free_list;
+        free_list = slot;
+    }
+};
+
+template<std::size_t Size, std::size_t Align>
+std::mutex slot_pool<Size, Align>::mutex;
+
+template<std::size_t Size, std::size_t Align>
+void* slot_pool<Size, Align>::free_list = nullptr;
+
+template<std::size_t Size, std::size_t Align>
+char* slot_pool<Size, Align>::next = nullptr;
+
+template<std::size_t Size, std::size_t Align>
+char* slot_pool<Size, Align>::last = nullptr;
+
+/*!
+ * \class arena_allocator
+ * \brief A standard allocator taking the single objects from the slot pool of their size.
+ */
+template<typename T>
+struct arena_allocator {
+    typedef T value_type;
+
+    static_assert(alignof(T) <= alignof(std::max_align_t), "The chunks are not aligned enough for this type");
+
+    arena_allocator(){}
+
+    template<typename U>
+    arena_allocator(const arena_allocator<U>&){}
+
+    T* allocate(std::size_t n){
+        if(n == 1){
+            return static_cast<T*>(slot_pool<sizeof(T), alignof(T)>::allocate());
+        }
+
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* pointer, std::size_t n){
+        if(n == 1){
+            slot_pool<sizeof(T), alignof(T)>::release(pointer);
+        } else {
+            ::operator delete(pointer);
+        }
+    }
+};
+
+template<typename T, typename U>
+inline bool operator==(const arena_allocator<T>&, const arena_allocator<U>&){
+    return true;
+}
+
+template<typename T, typename U>
+inline bool operator!=(const arena_allocator<T>&, const arena_allocator<U>&){
+    return false;
+}
+
+/*!
+ * \brief Create a node of the intermediate representations (MTAC or LTAC statement) in the arena.
+ *
+ * The node and its reference counts are stored in a single slot, next to the other nodes of the
+ * same size, instead of a separate allocation of the general purpose heap.
+ * \param args The arguments of the constructor of the node.
+ * \return A shared pointer to the new node.
+ */
+template<typename T, typename... Args>
+inline std::shared_ptr<T> make_node(Args&&... args){
+    return std::allocate_shared<T>(arena_allocator<T>(), std::forward<Args>(args)...);
+}
+
+} //end of eddic
+
+#endif
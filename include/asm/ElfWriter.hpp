@@ -0,0 +1,62 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#ifndef ELF_WRITER_H
+#define ELF_WRITER_H
+
+#include <cstdint>
+#include <string>
+
+namespace eddic {
+
+namespace as {
+
+/*!
+ * \class ElfWriter
+ * \brief Write a static ELF64 executable for x86_64.
+ * The executable has no section headers, the text is loaded in a read-only segment and the data and the bss
+ * in a writable segment. The layout is fixed by the sizes of the sections, so that the addresses of the
+ * symbols can be computed before the executable is written.
+ */
+class ElfWriter {
+    public:
+        /*!
+         * Compute the layout of an executable with sections of the given sizes.
+         * \param text_size The size of the code.
+         * \param data_size The size of the initialized data.
+         * \param bss_size The size of the uninitialized data.
+         */
+        ElfWriter(std::size_t text_size, std::size_t data_size, std::size_t bss_size);
+
+        uint64_t text_address() const;
+        uint64_t data_address() const;
+        uint64_t bss_address() const;
+
+        /*!
+         * Write the executable.
+         * \param path The path to the executable.
+         * \param entry The address of the entry point.
+         * \param text The code, of the size given to the constructor.
+         * \param data The initialized data, of the size given to the constructor.
+         */
+        void write(const std::string& path, uint64_t entry, const std::string& text, const std::string& data) const;
+
+    private:
+        std::size_t text_size;
+        std::size_t data_size;
+        std::size_t bss_size;
+
+        std::size_t segments;
+        std::size_t text_offset;
+        std::size_t data_offset;
+};
+
+} //end of as
+
+} //end of eddic
+
+#endif
@@ -11,6 +11,8 @@
 #include <vector>
 #include <string>
 
+#include "ltac/Address.hpp"
+
 namespace eddic {
 
 class AssemblyFileWriter;
@@ -32,6 +34,15 @@ void save(AssemblyFileWriter& writer, const std::vector<std::string>& registers)
  */
 void restore(AssemblyFileWriter& writer, const std::vector<std::string>& registers);
 
+/*!
+ * Returns the given address once some bytes have been pushed on the stack. Only the addresses relative to 
+ * the stack pointer are changed. 
+ * \param address The address before the push. 
+ * \param pushed The number of bytes pushed on the stack. 
+ * \return The same address relative to the new stack pointer. 
+ */
+ltac::Address after_push(ltac::Address address, int pushed);
+
 } //end of as
 
 } //end of eddic
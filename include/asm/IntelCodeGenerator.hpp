@@ -41,9 +41,10 @@ class IntelCodeGenerator : public CodeGenerator {
         
         virtual void writeRuntimeSupport() = 0;
         virtual void addStandardFunctions() = 0;
-        virtual void compile(mtac::function_p function) = 0;
+        virtual void compile(mtac::function_p function, std::ostream& out) = 0;
 
         virtual void defineDataSection() = 0;
+        virtual void defineBssSection() = 0;
 
         virtual void declareIntArray(const std::string& name, unsigned int size) = 0;
         virtual void declareStringArray(const std::string& name, unsigned int size) = 0;
@@ -53,11 +54,15 @@ class IntelCodeGenerator : public CodeGenerator {
         virtual void declareStringVariable(const std::string& name, const std::string& label, int size) = 0;
         virtual void declareString(const std::string& label, const std::string& value) = 0;
         virtual void declareFloat(const std::string& label, double value) = 0;
+        virtual void declareBuffer(const std::string& name, unsigned int size) = 0;
 
         void output_function(const std::string& function);
 
         bool is_enabled_printI();
         bool is_enabled_println();
+        bool is_enabled_printC();
+        bool is_enabled_printS();
+        bool is_enabled_flush();
 };
 
 } //end of as
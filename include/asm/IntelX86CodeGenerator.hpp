@@ -25,10 +25,11 @@ class IntelX86CodeGenerator : public IntelCodeGenerator {
     protected:        
         void writeRuntimeSupport();
         void addStandardFunctions();
-        void compile(mtac::function_p function);
+        void compile(mtac::function_p function, std::ostream& out);
 
         /* Functions for global variables */
         void defineDataSection();
+        void defineBssSection();
         void declareStringArray(const std::string& name, unsigned int size);
         void declareIntArray(const std::string& name, unsigned int size);
         void declareFloatArray(const std::string& name, unsigned int size);
@@ -37,6 +38,7 @@ class IntelX86CodeGenerator : public IntelCodeGenerator {
         void declareStringVariable(const std::string& name, const std::string& label, int size);
         void declareString(const std::string& label, const std::string& value);
         void declareFloat(const std::string& label, double value);
+        void declareBuffer(const std::string& name, unsigned int size);
 };
 
 } //end of as
@@ -0,0 +1,42 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#ifndef INTEL_X86_64_ENCODER_H
+#define INTEL_X86_64_ENCODER_H
+
+#include <string>
+
+#include "SemanticalException.hpp"
+
+namespace eddic {
+
+namespace as {
+
+/*!
+ * \class UnsupportedAssembly
+ * \brief Thrown when the assembly uses a construct that the encoder does not support.
+ */
+class UnsupportedAssembly : public SemanticalException {
+    public:
+        UnsupportedAssembly(const std::string& message);
+};
+
+/*!
+ * \brief Encode x86_64 assembly into a static ELF64 executable.
+ * Only the part of the NASM syntax that is output by the x86_64 code generator and used by the
+ * runtime functions is supported.
+ * \param source The assembly source.
+ * \param output The path to the executable.
+ * \throw UnsupportedAssembly If the source cannot be encoded, in that case nothing is written.
+ */
+void encode_x86_64(const std::string& source, const std::string& output);
+
+} //end of as
+
+} //end of eddic
+
+#endif
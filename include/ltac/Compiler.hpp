@@ -36,11 +36,17 @@ class Compiler {
          * \param float_pool The float pool to use. 
          */
         void compile(mtac::program_p source, std::shared_ptr<FloatPool> float_pool);
+        
+        /*!
+         * Compile one MTAC function into LTAC. 
+         * This function can be called concurrently on different functions of the same program. 
+         * \param source The source MTAC Program. 
+         * \param src_function The function to compile. 
+         * \param float_pool The float pool to use. 
+         */
+        void compile(mtac::program_p source, mtac::function_p src_function, std::shared_ptr<FloatPool> float_pool);
     
     private:
-        void compile(mtac::program_p source, mtac::function_p src_function, std::shared_ptr<FloatPool> float_pool);
-
-        std::unordered_set<mtac::basic_block_p> block_usage;
         Platform platform;
         std::shared_ptr<Configuration> configuration;
 };
@@ -8,15 +8,11 @@
 #ifndef MTAC_LIVE_REGISTERS_PROBLEM_H
 #define MTAC_LIVE_REGISTERS_PROBLEM_H
 
-#include <memory>
-#include <iostream>
-#include <unordered_set>
+#include <vector>
 
-#include "assert.hpp"
+#include "mtac/BitDataFlow.hpp"
 
-#include "mtac/DataFlowProblem.hpp"
-
-//Necessary for hash
+#include "ltac/forward.hpp"
 #include "ltac/Register.hpp"
 #include "ltac/FloatRegister.hpp"
 #include "ltac/PseudoRegister.hpp"
@@ -26,92 +22,23 @@ namespace eddic {
 
 namespace ltac {
 
-template<typename Reg, typename FloatReg>
-struct LiveRegisterValues {
-    std::unordered_set<Reg> registers;
-    std::unordered_set<FloatReg> float_registers;
-
-    void insert(const Reg& reg){
-        registers.insert(reg);
-    }
-
-    void insert(const FloatReg& reg){
-        float_registers.insert(reg);
-    }
-
-    auto find(const Reg& reg) -> decltype(registers.find(reg)) {
-        return registers.find(reg);
-    }
-    
-    auto find(const FloatReg& reg) -> decltype(float_registers.find(reg)) {
-        return float_registers.find(reg);
-    }
-    
-    auto end() -> decltype(registers.end()) {
-        return registers.end();
-    }
-    
-    auto fend() -> decltype(float_registers.end()) {
-        return float_registers.end();
-    }
-    
-    void erase(const Reg& reg){
-        registers.erase(reg);
-    }
-
-    void erase(const FloatReg& reg){
-        float_registers.erase(reg);
-    }
-
-    std::size_t size(){
-        return (static_cast<std::size_t>(std::numeric_limits<unsigned short>::max()) + 1) * registers.size() + float_registers.size();
-    }
-};
+/*!
+ * \struct LiveRegistersProblem
+ * \brief Liveness analysis of one kind of registers on the LTAC statements. 
+ *
+ * The analysis is solved with mtac::backward_bit_data_flow, the bit of a register is its number. 
+ * Reg is one of ltac::Register, ltac::FloatRegister, ltac::PseudoRegister or ltac::PseudoFloatRegister.
+ */
+template<typename Reg>
+struct LiveRegistersProblem {
+    std::size_t init(mtac::function_p function);
 
-//Liveness analysis on Hard Registers
+    std::vector<ltac::Statement>& statements(mtac::basic_block_p block);
 
-struct LiveRegistersProblem : public mtac::DataFlowProblem<mtac::DataFlowType::Low_Backward, LiveRegisterValues<ltac::Register, ltac::FloatRegister>> {
-    ProblemDomain Boundary(mtac::function_p function) override;
-    ProblemDomain Init(mtac::function_p function) override;
-   
-    ProblemDomain meet(ProblemDomain& in, ProblemDomain& out) override;
-    ProblemDomain transfer(mtac::basic_block_p basic_block, ltac::Statement& statement, ProblemDomain& in) override;
-    ProblemDomain transfer(mtac::basic_block_p, mtac::Statement&, ProblemDomain&) override { eddic_unreachable("Not MTAC"); };
-    
-    bool optimize(ltac::Statement& statement, std::shared_ptr<mtac::DataFlowResults<ProblemDomain>> results) override;
-    bool optimize(mtac::Statement&, std::shared_ptr<mtac::DataFlowResults<ProblemDomain>> ) override { eddic_unreachable("Not MTAC"); };
+    void transfer(ltac::Statement& statement, mtac::BitSet& values);
 };
 
-//Liveness analysis on Pseudo Registers
-
-struct LivePseudoRegistersProblem : public mtac::DataFlowProblem<mtac::DataFlowType::Low_Backward, LiveRegisterValues<ltac::PseudoRegister, ltac::PseudoFloatRegister>> {
-    ProblemDomain Boundary(mtac::function_p function) override;
-    ProblemDomain Init(mtac::function_p function) override;
-   
-    ProblemDomain meet(ProblemDomain& in, ProblemDomain& out) override;
-    ProblemDomain transfer(mtac::basic_block_p basic_block, ltac::Statement& statement, ProblemDomain& in) override;
-    ProblemDomain transfer(mtac::basic_block_p, mtac::Statement&, ProblemDomain&) override { eddic_unreachable("Not MTAC"); };
-    
-    bool optimize(ltac::Statement& statement, std::shared_ptr<mtac::DataFlowResults<ProblemDomain>> results) override;
-    bool optimize(mtac::Statement&, std::shared_ptr<mtac::DataFlowResults<ProblemDomain>> ) override { eddic_unreachable("Not MTAC"); };
-};
-
-template<typename Reg, typename FloatReg>
-std::ostream& operator<<(std::ostream& stream, const LiveRegisterValues<Reg, FloatReg>& value){
-    stream << "set{";
-
-    for(auto& v : value.registers){
-        stream << v << ", ";
-    }
-    
-    for(auto& v : value.float_registers){
-        stream << v << ", ";
-    }
-
-    return stream << "}";
-}
-
-} //end of mtac
+} //end of ltac
 
 } //end of eddic
 
@@ -17,7 +17,7 @@ enum class Operator : unsigned int {
     FMOV,
     MUL3,
 
-    //Set the memory to 0
+    //Set the memory to 0, the size is in bytes
     MEMSET,
 
     //Enter stack frame
@@ -34,6 +34,9 @@ enum class Operator : unsigned int {
     CMP_INT,
     CMP_FLOAT,
 
+    //Logical comparison
+    TEST,
+
     //Logical operations
     OR,
     XOR,
@@ -70,6 +73,16 @@ enum class Operator : unsigned int {
     I2F,
     F2I,
 
+    //Packed operations on the vectors of ints or floats of a SSE register
+    PMOV,
+    PADD,
+    PSUB,
+    PFADD,
+    PFSUB,
+    PFMUL,
+    PSPLAT,         //Copy the first element into all the elements
+    PSHR,           //Shift the whole register right, the count is in bytes
+
     CMOVE,
     CMOVNE,
     CMOVA,
@@ -19,6 +19,12 @@ namespace eddic {
 namespace ltac {
 
 void optimize(mtac::program_p program, Platform platform);
+void optimize(mtac::function_p function, Platform platform);
+
+/*!
+ * Print the number of times each rule of the peephole optimizer has been applied. 
+ */
+void print_peephole_statistics();
 
 } //end of ltac
 
@@ -130,6 +130,11 @@ class StatementCompiler : public boost::static_visitor<> {
         void compile_DOT_ASSIGN(std::shared_ptr<mtac::Quadruple> quadruple);
         void compile_DOT_FASSIGN(std::shared_ptr<mtac::Quadruple> quadruple);
         void compile_DOT_PASSIGN(std::shared_ptr<mtac::Quadruple> quadruple);
+        void compile_VDOT(std::shared_ptr<mtac::Quadruple> quadruple);
+        void compile_DOT_VASSIGN(std::shared_ptr<mtac::Quadruple> quadruple);
+        void compile_VSPLAT(std::shared_ptr<mtac::Quadruple> quadruple);
+        void compile_VSUM(std::shared_ptr<mtac::Quadruple> quadruple);
+        void compile_packed(std::shared_ptr<mtac::Quadruple> quadruple, ltac::Operator op);
         void compile_RETURN(std::shared_ptr<mtac::Quadruple> quadruple);
         void compile_NOT(std::shared_ptr<mtac::Quadruple> quadruple);
         void compile_AND(std::shared_ptr<mtac::Quadruple> quadruple);
@@ -31,11 +31,11 @@ class interference_graph {
         void gather(const Pseudo& reg);
 
         void add_edge(reg i, reg j);
-        void remove_node(reg i);
+        void connect(reg i, reg j);
         bool connected(reg i, reg j);
 
-        std::size_t degree(reg i);
-        std::size_t& spill_cost(reg i);
+        std::size_t& degree(reg i);
+        double& spill_cost(reg i);
         std::vector<reg>& neighbors(reg i);
 
         void build_graph();
@@ -52,7 +52,7 @@ class interference_graph {
         //For each pseudo reg
         std::vector<std::vector<reg>> adjacency_vectors;
         std::vector<std::size_t> degrees;
-        std::vector<std::size_t> spill_costs;
+        std::vector<double> spill_costs;
         std::vector<Pseudo> index_to_pseudo; //Maps indices to pseudo regs
 
         std::unordered_map<Pseudo, std::size_t> pseudo_to_index; //Maps pseudo regs to indices
@@ -108,27 +108,30 @@ bool ltac::interference_graph<Pseudo>::connected(reg i, reg j){
     return matrix->is_set(i, j);
 }
 
+/*!
+ * Add an edge once the adjacency vectors have been built. The adjacency vectors and 
+ * the degrees of both nodes are updated. 
+ */
 template<typename Pseudo>
-void ltac::interference_graph<Pseudo>::remove_node(std::size_t i){
-    auto& matrix = *this->matrix;
+void ltac::interference_graph<Pseudo>::connect(std::size_t i, std::size_t j){
+    if(i != j && !connected(i, j)){
+        add_edge(i, j);
 
-    for(auto j : adjacency_vectors[i]){
-        matrix.clear(i, j);
-        matrix.clear(j, i);
+        adjacency_vectors[i].push_back(j);
+        adjacency_vectors[j].push_back(i);
 
-        --degrees[j];
+        ++degrees[i];
+        ++degrees[j];
     }
-
-    degrees[i] = 0;
 }
 
 template<typename Pseudo>
-std::size_t ltac::interference_graph<Pseudo>::degree(std::size_t i){
+std::size_t& ltac::interference_graph<Pseudo>::degree(std::size_t i){
     return degrees[i];
 }
 
 template<typename Pseudo>
-std::size_t& ltac::interference_graph<Pseudo>::spill_cost(reg i){
+double& ltac::interference_graph<Pseudo>::spill_cost(reg i){
     return spill_costs[i];
 }
 
@@ -0,0 +1,48 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#ifndef LTAC_PEEPHOLE_RULES_H
+#define LTAC_PEEPHOLE_RULES_H
+
+#include <iostream>
+
+#include "Platform.hpp"
+
+#include "mtac/basic_block.hpp"
+
+namespace eddic {
+
+namespace ltac {
+
+/*!
+ * Apply the first peephole rule whose window of instructions starts at the given position of the block.
+ * The rules are looked up in a decision tree indexed by the operators of the instructions, generated at build time.
+ * \param block The basic block to optimize.
+ * \param position The position of the first statement of the window.
+ * \param platform The target platform.
+ * \return true if a rule has been applied, false otherwise.
+ */
+bool apply_peephole_rules(mtac::basic_block_p block, std::size_t position, Platform platform);
+
+/*!
+ * Print the number of times each peephole rule has been applied.
+ * \param out The stream to print to.
+ */
+void print_peephole_rules_statistics(std::ostream& out);
+
+/*!
+ * Print the decision tree of the peephole rules as the C++ arrays of peephole_tree.inc. 
+ * This is used by peephole_tree_generator during the build.
+ * \param out The stream to print to.
+ */
+void generate_peephole_tree(std::ostream& out);
+
+} //end of ltac
+
+} //end of eddic
+
+#endif
@@ -17,6 +17,7 @@ namespace eddic {
 namespace ltac {
 
 void pre_alloc_cleanup(mtac::program_p program);
+void pre_alloc_cleanup(mtac::function_p function);
 
 } //end of ltac
 
@@ -11,6 +11,7 @@
 #include <memory>
 
 #include "Options.hpp"
+#include "Platform.hpp"
 
 #include "mtac/Program.hpp"
 
@@ -19,6 +20,7 @@ namespace eddic {
 namespace ltac {
 
 void generate_prologue_epilogue(mtac::program_p mtac_program, std::shared_ptr<Configuration> configuration);
+void generate_prologue_epilogue(mtac::function_p function, Platform platform, std::shared_ptr<Configuration> configuration);
 
 } //end of ltac
 
@@ -10,6 +10,7 @@
 
 #include <memory>
 
+#include "Options.hpp"
 #include "Platform.hpp"
 
 #include "mtac/Program.hpp"
@@ -18,7 +19,8 @@ namespace eddic {
 
 namespace ltac {
 
-void register_allocation(mtac::program_p program, Platform platform);
+void register_allocation(mtac::program_p program, Platform platform, std::shared_ptr<Configuration> configuration);
+void register_allocation(mtac::function_p function, Platform platform, std::shared_ptr<Configuration> configuration);
 
 } //end of mtac
 
@@ -19,6 +19,7 @@ namespace eddic {
 namespace ltac {
 
 void fix_stack_offsets(mtac::program_p mtac_program, Platform platform);
+void fix_stack_offsets(mtac::function_p function, Platform platform);
 
 } //end of ltac
 
@@ -27,6 +27,7 @@ struct pass_traits<merge_basic_blocks> {
     STATIC_STRING(name, "merge_bb");
     STATIC_CONSTANT(unsigned int, property_flags, 0);
     STATIC_CONSTANT(unsigned int, todo_after_flags, TODO_REMOVE_NOP);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_NONE);
 };
 
 struct remove_dead_basic_blocks {
@@ -39,6 +40,7 @@ struct pass_traits<remove_dead_basic_blocks> {
     STATIC_STRING(name, "remove_dead_bb");
     STATIC_CONSTANT(unsigned int, property_flags, 0);
     STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_NONE);
 };
 
 } //end of mtac
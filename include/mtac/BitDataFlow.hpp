@@ -0,0 +1,161 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#ifndef MTAC_BIT_DATA_FLOW_H
+#define MTAC_BIT_DATA_FLOW_H
+
+#include <memory>
+#include <vector>
+#include <unordered_map>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "mtac/Program.hpp"
+#include "mtac/block_order.hpp"
+#include "mtac/WorkList.hpp"
+
+namespace eddic {
+
+namespace mtac {
+
+typedef boost::dynamic_bitset<> BitSet;
+
+/*!
+ * \struct BitDataFlowResults
+ * \brief The results of a bit-vector data-flow problem.
+ *
+ * Only the IN and OUT sets of the basic blocks are stored, the values of the statements
+ * are computed on demand from the values of their basic block.
+ */
+template<typename Problem>
+struct BitDataFlowResults {
+    Problem& problem;
+
+    std::unordered_map<mtac::basic_block_p, std::size_t> numbers;   /*!< The dense number of each basic block */
+
+    std::vector<BitSet> IN;
+    std::vector<BitSet> OUT;
+
+    BitDataFlowResults(Problem& problem) : problem(problem) {}
+
+    BitSet& in(const mtac::basic_block_p& block){
+        return IN[numbers[block]];
+    }
+
+    BitSet& out(const mtac::basic_block_p& block){
+        return OUT[numbers[block]];
+    }
+
+    /*!
+     * Call the functor with each statement of the basic block, from the last to the first,
+     * and with the values at the exit of the statement. The statements must not be modified
+     * before the end of the walk.
+     * \param block The basic block to walk.
+     * \param functor The functor to call with the statement and its OUT values.
+     */
+    template<typename Functor>
+    void backward_statements(const mtac::basic_block_p& block, Functor functor){
+        auto values = out(block);
+        auto& statements = problem.statements(block);
+
+        for(std::size_t i = statements.size(); i > 0; --i){
+            auto& statement = statements[i - 1];
+
+            functor(statement, values);
+
+            problem.transfer(statement, values);
+        }
+    }
+};
+
+/*!
+ * Solve a backward data-flow problem whose meet is the union and whose transfer functions are
+ * of the gen/kill form.
+ *
+ * The problem must provide:
+ *  - std::size_t init(mtac::function_p function) that numbers the values of the function and returns their number
+ *  - statements(mtac::basic_block_p block) that returns the statements of the basic block
+ *  - void transfer(Statement& statement, BitSet& values) that computes the IN values of the statement from its OUT values
+ *
+ * \param function The function to analyze.
+ * \param problem The problem to solve.
+ * \return The IN and OUT values of each basic block.
+ */
+template<typename Problem>
+std::shared_ptr<BitDataFlowResults<Problem>> backward_bit_data_flow(mtac::function_p function, Problem& problem){
+    auto results = std::make_shared<BitDataFlowResults<Problem>>(problem);
+
+    auto size = problem.init(function);
+
+    //The blocks are numbered in post-order, the order of the sweeps
+    auto blocks = mtac::post_order(function);
+
+    for(std::size_t i = 0; i < blocks.size(); ++i){
+        results->numbers[blocks[i]] = i;
+    }
+
+    //The transfer function of a block is summarized as IN = GEN | (OUT & PRESERVED)
+    std::vector<BitSet> gen(blocks.size(), BitSet(size));
+    std::vector<BitSet> preserved(blocks.size(), BitSet(size));
+
+    for(std::size_t i = 0; i < blocks.size(); ++i){
+        auto& statements = problem.statements(blocks[i]);
+
+        preserved[i].set();
+
+        for(std::size_t j = statements.size(); j > 0; --j){
+            problem.transfer(statements[j - 1], gen[i]);
+            problem.transfer(statements[j - 1], preserved[i]);
+        }
+    }
+
+    results->IN.assign(blocks.size(), BitSet(size));
+    results->OUT.assign(blocks.size(), BitSet(size));
+
+    BitSet in(size);
+
+    //A block is only visited again when the IN values of one of its successors changed
+    WorkList work_list(blocks);
+
+    while(work_list.next_sweep()){
+        for(std::size_t i = 0; i < blocks.size(); ++i){
+            if(!work_list.take(i)){
+                continue;
+            }
+
+            work_list.visit();
+
+            auto& out = results->OUT[i];
+
+            for(auto& successor : blocks[i]->successors){
+                out |= results->IN[results->numbers[successor]];
+            }
+
+            in = out;
+            in &= preserved[i];
+            in |= gen[i];
+
+            if(in != results->IN[i]){
+                results->IN[i].swap(in);
+
+                for(auto& predecessor : blocks[i]->predecessors){
+                    work_list.add(predecessor);
+                }
+            }
+        }
+    }
+
+    work_list.report(function, "Bit backward");
+
+    return results;
+}
+
+} //end of mtac
+
+} //end of eddic
+
+#endif
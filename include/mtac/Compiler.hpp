@@ -15,11 +15,12 @@
 namespace eddic {
 
 struct StringPool;
+struct Configuration;
 
 namespace mtac {
 
 struct Compiler {
-    void compile(ast::SourceFile& program, std::shared_ptr<StringPool> pool, mtac::program_p mtacProgram) const ;
+    void compile(ast::SourceFile& program, std::shared_ptr<StringPool> pool, mtac::program_p mtacProgram, std::shared_ptr<Configuration> configuration) const ;
 };
 
 } //end of mtac
@@ -33,6 +33,7 @@ struct pass_traits<optimize_concat> {
     STATIC_STRING(name, "optimize_concat");
     STATIC_CONSTANT(unsigned int, property_flags, PROPERTY_POOL);
     STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_CONTROL_FLOW);
 };
 
 } //end of mtac
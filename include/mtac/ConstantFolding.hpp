@@ -34,6 +34,7 @@ struct pass_traits<ConstantFolding> {
     STATIC_STRING(name, "constant_folding");
     STATIC_CONSTANT(unsigned int, property_flags, 0);
     STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_CONTROL_FLOW);
 };
 
 } //end of mtac
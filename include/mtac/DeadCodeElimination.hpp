@@ -27,6 +27,7 @@ struct pass_traits<dead_code_elimination> {
     STATIC_STRING(name, "dead_code_elimination");
     STATIC_CONSTANT(unsigned int, property_flags, 0);
     STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_CONTROL_FLOW);
 };
 
 } //end of mtac
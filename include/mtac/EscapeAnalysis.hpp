@@ -21,6 +21,12 @@ namespace mtac {
 
 typedef std::shared_ptr<std::unordered_set<std::shared_ptr<Variable>>> EscapedVariables;
 
+/*!
+ * Compute the variables whose address is taken in the function. The result is cached in the 
+ * analyses of the function. 
+ * \param function The function to analyze. 
+ * \return The escaped variables of the function. 
+ */
 EscapedVariables escape_analysis(mtac::function_p function);
 
 } //end of eddic
@@ -18,6 +18,7 @@
 #include "mtac/forward.hpp"
 #include "mtac/basic_block.hpp"
 #include "mtac/basic_block_iterator.hpp"
+#include "mtac/analysis_manager.hpp"
 
 #include "ltac/Register.hpp"
 #include "ltac/FloatRegister.hpp"
@@ -67,6 +68,29 @@ class Function : public std::enable_shared_from_this<Function> {
 
         std::vector<std::shared_ptr<Loop>>& loops();
 
+        /*!
+         * Must be called each time the control flow graph changes. The numbering and the orders of the 
+         * blocks, the dominators and the loops are then computed again the next time they are needed. 
+         */
+        void cfg_changed();
+
+        /*!
+         * Invalidate the analyses of the function that are not preserved by a change of the function. 
+         * \param preserved The preserved analyses, a combination of mtac::ANALYSIS flags. 
+         */
+        void invalidate_analyses(unsigned int preserved);
+
+        /*!
+         * Return the basic blocks in the order of the function, the index of each block is its id. 
+         * The blocks are only numbered again after a change of the CFG. 
+         * \return The basic blocks indexed by their id. 
+         */
+        const std::vector<basic_block_p>& numbered_blocks();
+
+        mtac::analysis_manager analyses;    /*!< The cached analyses of the function */
+
+        bool bounds_check = false;          /*!< Indicates if the indexes of the array accesses are checked at runtime (-fbounds-check) */
+
         std::size_t bb_count();
         std::size_t size();
         
@@ -111,6 +135,8 @@ class Function : public std::enable_shared_from_this<Function> {
 
         std::vector<std::shared_ptr<mtac::Loop>> m_loops;
 
+        std::vector<basic_block_p> numbering;
+
         std::string name;
 };
 
@@ -25,6 +25,7 @@ struct pass_traits<remove_unused_functions> {
     STATIC_STRING(name, "remove_unused_functions");
     STATIC_CONSTANT(unsigned int, property_flags, 0);
     STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_ALL);
 };
 
 struct remove_empty_functions {
@@ -37,6 +38,7 @@ struct pass_traits<remove_empty_functions> {
     STATIC_STRING(name, "remove_empty_functions");
     STATIC_CONSTANT(unsigned int, property_flags, 0);
     STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_NONE);
 };
 
 } //end of mtac
@@ -17,6 +17,8 @@
 
 #include "mtac/Program.hpp"
 #include "mtac/DataFlowProblem.hpp"
+#include "mtac/block_order.hpp"
+#include "mtac/WorkList.hpp"
 
 namespace eddic {
 
@@ -98,30 +100,52 @@ std::shared_ptr<DataFlowResults<mtac::Domain<DomainValues>>> forward_data_flow(m
         }
     }
 
-    bool changes = true;
-    while(changes){
-        changes = false;
+    //The blocks are visited in reverse post-order and only when the values of a predecessor changed
+    auto order = mtac::reverse_post_order(function);
+    WorkList work_list(order);
 
-        for(auto& B : function){
-            //Do not consider ENTRY
-            if(B->index == -1){
+    while(work_list.next_sweep()){
+        for(std::size_t i = 0; i < order.size(); ++i){
+            if(!work_list.take(i)){
                 continue;
             }
 
+            auto& B = order[i];
+
+            //Do not consider ENTRY nor the blocks that cannot be reached
+            if(B->index == -1 || B->predecessors.empty()){
+                continue;
+            }
+
+            work_list.visit();
+
+            Domain in;
+
             for(auto& P : B->predecessors){
                 log::emit<Dev>("Data-Flow") << "Meet B = " << *B << " with P = " << *P << log::endl;
-                log::emit<Dev>("Data-Flow") << "IN[B] before " << IN[B] << log::endl;
+                log::emit<Dev>("Data-Flow") << "IN[B] before " << in << log::endl;
                 log::emit<Dev>("Data-Flow") << "OUT[P] before " << OUT[P] << log::endl;
 
-                IN[B] = problem.meet(IN[B], OUT[P]);
+                in = problem.meet(in, OUT[P]);
                 
-                log::emit<Dev>("Data-Flow") << "IN[B] after " << IN[B] << log::endl;
+                log::emit<Dev>("Data-Flow") << "IN[B] after " << in << log::endl;
+            }
+
+            IN[B] = in;
+
+            bool changes = false;
+            forward_statements<Low>(problem, results, B, changes);
 
-                forward_statements<Low>(problem, results, B, changes);
+            if(changes){
+                for(auto& S : B->successors){
+                    work_list.add(S);
+                }
             }
         }
     }
 
+    work_list.report(function, "Forward");
+
     return results;
 }
 
@@ -197,32 +221,54 @@ std::shared_ptr<DataFlowResults<mtac::Domain<DomainValues>>> backward_data_flow(
         }
     }
 
-    bool changes = true;
-    while(changes){
-        changes = false;
+    //The blocks are visited in post-order and only when the values of a successor changed
+    auto order = mtac::post_order(function);
+    WorkList work_list(order);
 
-        for(auto& B : function){
-            //Do not consider EXIT
-            if(B->index == -2){
+    while(work_list.next_sweep()){
+        for(std::size_t i = 0; i < order.size(); ++i){
+            if(!work_list.take(i)){
                 continue;
             }
 
+            auto& B = order[i];
+
+            //Do not consider EXIT nor the blocks without successors
+            if(B->index == -2 || B->successors.empty()){
+                continue;
+            }
+
+            work_list.visit();
+
+            Domain out;
+
             for(auto& S : B->successors){
                 log::emit<Dev>("Data-Flow") << "Meet B = " << *B << " with S = " << *S << log::endl;
-                log::emit<Dev>("Data-Flow") << "OUT[B] before " << OUT[B] << log::endl;
+                log::emit<Dev>("Data-Flow") << "OUT[B] before " << out << log::endl;
                 log::emit<Dev>("Data-Flow") << "IN[S]  before " << IN[S] << log::endl;
 
-                OUT[B] = problem.meet(OUT[B], IN[S]);
+                out = problem.meet(out, IN[S]);
                 
-                log::emit<Dev>("Data-Flow") << "OUT[B]  after " << OUT[B] << log::endl;
+                log::emit<Dev>("Data-Flow") << "OUT[B]  after " << out << log::endl;
+            }
 
-                backward_statements<Low>(problem, results, B, changes);
-                
-                log::emit<Dev>("Data-Flow") << "IN[B]   after " << IN[B] << log::endl;
+            OUT[B] = out;
+
+            bool changes = false;
+            backward_statements<Low>(problem, results, B, changes);
+            
+            log::emit<Dev>("Data-Flow") << "IN[B]   after " << IN[B] << log::endl;
+
+            if(changes){
+                for(auto& P : B->predecessors){
+                    work_list.add(P);
+                }
             }
         }
     }
 
+    work_list.report(function, "Backward");
+
     return results;
 }
 
@@ -8,12 +8,11 @@
 #ifndef MTAC_LIVE_VARIABLE_ANALYSIS_PROBLEM_H
 #define MTAC_LIVE_VARIABLE_ANALYSIS_PROBLEM_H
 
-#include <unordered_set>
+#include <vector>
 #include <memory>
+#include <unordered_map>
 
-#include "assert.hpp"
-
-#include "mtac/DataFlowProblem.hpp"
+#include "mtac/BitDataFlow.hpp"
 #include "mtac/EscapeAnalysis.hpp"
 
 namespace eddic {
@@ -21,53 +20,42 @@ namespace eddic {
 class Variable;
 
 namespace mtac {
-    
-typedef std::unordered_set<std::shared_ptr<Variable>> Values;
-
-struct LiveVariableValues {
-    Values values;
 
-    void insert(std::shared_ptr<Variable> var){
-        values.insert(var);
-    }
-    
-    void erase(std::shared_ptr<Variable> var){
-        values.erase(var);
-    }
-
-    Values::iterator find(std::shared_ptr<Variable> var){
-        return values.find(var);
-    }
+/*!
+ * \struct LiveVariableAnalysisProblem
+ * \brief Liveness analysis of the variables on the MTAC statements. 
+ *
+ * The analysis is solved with mtac::backward_bit_data_flow. The variables are numbered 
+ * by init(), the bit of a variable is given by index(). 
+ */
+struct LiveVariableAnalysisProblem {
+    mtac::EscapedVariables pointer_escaped;
     
-    Values::iterator begin(){
-        return values.begin();
-    }
+    std::unordered_map<std::shared_ptr<Variable>, std::size_t> indices;
     
-    Values::iterator end(){
-        return values.end();
-    }
+    std::size_t init(mtac::function_p function);
 
-    std::size_t size(){
-        return values.size();
-    }
-};
+    std::vector<mtac::Statement>& statements(mtac::basic_block_p block);
 
-std::ostream& operator<<(std::ostream& stream, LiveVariableValues& expression);
+    void transfer(mtac::Statement& statement, BitSet& values);
 
-struct LiveVariableAnalysisProblem : public DataFlowProblem<DataFlowType::Backward, LiveVariableValues> {
-    mtac::EscapedVariables pointer_escaped;
-    
-    ProblemDomain Boundary(mtac::function_p function) override;
-    ProblemDomain Init(mtac::function_p function) override;
-   
-    ProblemDomain meet(ProblemDomain& in, ProblemDomain& out) override;
-    ProblemDomain transfer(mtac::basic_block_p basic_block, mtac::Statement& statement, ProblemDomain& in) override;
-    ProblemDomain transfer(mtac::basic_block_p, ltac::Statement&, ProblemDomain&) override { eddic_unreachable("Not LTAC"); };
-    
-    bool optimize(mtac::Statement& statement, std::shared_ptr<DataFlowResults<ProblemDomain>> results) override;
-    bool optimize(ltac::Statement&, std::shared_ptr<DataFlowResults<ProblemDomain>>) override { eddic_unreachable("Not LTAC"); };
+    /*!
+     * Return the bit of the given variable. 
+     * \param variable The variable, it must be used in the analyzed function. 
+     * \return The index of the variable in the bit sets. 
+     */
+    std::size_t index(const std::shared_ptr<Variable>& variable);
 };
 
+typedef std::shared_ptr<mtac::BitDataFlowResults<mtac::LiveVariableAnalysisProblem>> LiveVariables;
+
+/*!
+ * Compute the live variables of the function. The result is cached in the analyses of the function. 
+ * \param function The function to analyze. 
+ * \return The live variables at the boundaries of each basic block. 
+ */
+LiveVariables live_variable_analysis(mtac::function_p function);
+
 } //end of mtac
 
 } //end of eddic
@@ -15,9 +15,12 @@
 
 #include "mtac/pass_traits.hpp"
 #include "mtac/Pass.hpp"
+#include "mtac/forward.hpp"
 #include "mtac/Quadruple.hpp"
 #include "mtac/IfFalse.hpp"
 #include "mtac/If.hpp"
+#include "mtac/Param.hpp"
+#include "mtac/Call.hpp"
 
 namespace eddic {
 
@@ -28,11 +31,13 @@ class MathPropagation : public boost::static_visitor<void> {
         bool optimized = false;
         Pass pass;
         
-        void clear();
+        bool operator()(mtac::function_p function);
 
         void operator()(std::shared_ptr<mtac::Quadruple> quadruple);
         void operator()(std::shared_ptr<mtac::IfFalse> ifFalse);
         void operator()(std::shared_ptr<mtac::If> if_);
+        void operator()(std::shared_ptr<mtac::Param> param);
+        void operator()(std::shared_ptr<mtac::Call> call);
 
         template<typename T>
         void operator()(T&) const { 
@@ -43,16 +48,19 @@ class MathPropagation : public boost::static_visitor<void> {
         void collect(boost::optional<mtac::Argument>& arg);
 
     private:
+        void invalidate(std::shared_ptr<Variable> variable);
+
         std::unordered_map<std::shared_ptr<Variable>, std::shared_ptr<mtac::Quadruple>> assigns;
         std::unordered_map<std::shared_ptr<Variable>, int> usage;
 };
 
 template<>
 struct pass_traits<MathPropagation> {
-    STATIC_CONSTANT(pass_type, type, pass_type::BB_TWO_PASS);
+    STATIC_CONSTANT(pass_type, type, pass_type::CUSTOM);
     STATIC_STRING(name, "math_propagation");
     STATIC_CONSTANT(unsigned int, property_flags, 0);
     STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_CONTROL_FLOW);
 };
 
 } //end of mtac
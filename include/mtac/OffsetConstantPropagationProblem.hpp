@@ -58,6 +58,7 @@ struct pass_traits<OffsetConstantPropagationProblem> {
     STATIC_STRING(name, "offset_constant_propagation");
     STATIC_CONSTANT(unsigned int, property_flags, PROPERTY_POOL | PROPERTY_PLATFORM);
     STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_CONTROL_FLOW);
 };
 
 } //end of mtac
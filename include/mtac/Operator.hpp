@@ -66,6 +66,18 @@ enum class Operator : unsigned int {
     DOT_ASSIGN,     //result+arg1=arg2
     DOT_FASSIGN,    //result+arg1=arg2
     DOT_PASSIGN,    //result+arg1=arg2
+
+    /* vector operators, only created by the loop vectorizer */
+    VDOT,           //result = vector at (arg1)+arg2
+    DOT_VASSIGN,    //vector at result+arg1 = arg2
+    VSPLAT,         //result = arg1 in each element of the vector
+    VADD,           //result = arg1 + arg2 on each int element
+    VSUB,           //result = arg1 - arg2 on each int element
+    VFADD,          //result = arg1 + arg2 on each float element
+    VFSUB,          //result = arg1 - arg2 on each float element
+    VFMUL,          //result = arg1 * arg2 on each float element
+    VSUM,           //result = sum of the int elements of arg1
+    VFSUM,          //result = sum of the float elements of arg1
     
     RETURN,         //return from a function
 
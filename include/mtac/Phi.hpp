@@ -0,0 +1,42 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#ifndef MTAC_PHI_H
+#define MTAC_PHI_H
+
+#include <memory>
+#include <vector>
+
+#include "mtac/Argument.hpp"
+
+namespace eddic {
+
+class Variable;
+
+namespace mtac {
+
+/*!
+ * \struct Phi
+ * \brief A phi function at the entry of a basic block in SSA form. 
+ * There is one argument for each predecessor of the basic block, in the order of the predecessors. 
+ */
+struct Phi {
+    std::shared_ptr<Variable> variable;     /*!< The variable before renaming */
+    std::shared_ptr<Variable> result;       /*!< The version defined by the phi function */
+    std::vector<mtac::Argument> args;       /*!< The incoming value from each predecessor */
+
+    Phi(const Phi& rhs) = delete;
+    Phi& operator=(const Phi& rhs) = delete;
+
+    Phi(std::shared_ptr<Variable> variable, std::size_t predecessors);
+};
+
+} //end of mtac
+
+} //end of eddic
+
+#endif
@@ -46,6 +46,7 @@ struct pass_traits<PointerPropagation> {
     STATIC_STRING(name, "pointer_propagation");
     STATIC_CONSTANT(unsigned int, property_flags, 0);
     STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_CONTROL_FLOW);
 };
 
 } //end of mtac
@@ -36,6 +36,7 @@ struct pass_traits<ReduceInStrength> {
     STATIC_STRING(name, "strength_reduction");
     STATIC_CONSTANT(unsigned int, property_flags, 0);
     STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_CONTROL_FLOW);
 };
 
 } //end of mtac
@@ -27,6 +27,7 @@ struct pass_traits<remove_aliases> {
     STATIC_STRING(name, "remove_aliases");
     STATIC_CONSTANT(unsigned int, property_flags, 0);
     STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_CONTROL_FLOW);
 };
 
 struct clean_variables {
@@ -39,6 +40,7 @@ struct pass_traits<clean_variables> {
     STATIC_STRING(name, "clean_variables");
     STATIC_CONSTANT(unsigned int, property_flags, 0);
     STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_ALL);
 };
 
 } //end of mtac
@@ -0,0 +1,85 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#ifndef MTAC_WORK_LIST_H
+#define MTAC_WORK_LIST_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "StopWatch.hpp"
+
+#include "mtac/forward.hpp"
+#include "mtac/basic_block.hpp"
+
+namespace eddic {
+
+namespace mtac {
+
+/*!
+ * \class WorkList
+ * \brief The basic blocks that must be visited by an iterative data-flow solver. 
+ *
+ * The blocks are visited by sweeps in a fixed order (reverse post-order or post-order). During a sweep, 
+ * only the blocks whose input values may have changed since their last visit are visited. 
+ */
+class WorkList {
+    public:
+        /*!
+         * Create a work list containing all the blocks of the order. 
+         * \param order The order of the blocks in a sweep. 
+         */
+        WorkList(const std::vector<mtac::basic_block_p>& order);
+
+        /*!
+         * Start a new sweep. 
+         * \return true if there are still blocks to visit, false if the data-flow has converged. 
+         */
+        bool next_sweep();
+
+        /*!
+         * Remove the block at the given position in the order from the work list.
+         * \param position The position of the block in the order.
+         * \return true if the block was in the work list. 
+         */
+        bool take(std::size_t position);
+
+        /*!
+         * Add a block to the work list. 
+         * \param block The block to add. 
+         */
+        void add(const mtac::basic_block_p& block);
+
+        /*!
+         * Count a visit of a block for the statistics. 
+         */
+        void visit();
+
+        /*!
+         * Log the statistics of the convergence of the data-flow. 
+         * \param function The analyzed function.
+         * \param direction The direction of the data-flow problem. 
+         */
+        void report(std::shared_ptr<Function> function, const std::string& direction);
+
+    private:
+        std::unordered_map<mtac::basic_block_p, std::size_t> positions;
+        std::vector<bool> pending;
+        std::size_t pending_blocks;
+
+        std::size_t sweeps = 0;
+        std::size_t visits = 0;
+        StopWatch timer;
+};
+
+} //end of mtac
+
+} //end of eddic
+
+#endif
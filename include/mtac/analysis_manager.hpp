@@ -0,0 +1,61 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#ifndef MTAC_ANALYSIS_MANAGER_H
+#define MTAC_ANALYSIS_MANAGER_H
+
+#include <memory>
+#include <vector>
+
+#include "mtac/forward.hpp"
+#include "mtac/pass_traits.hpp"
+#include "mtac/EscapeAnalysis.hpp"
+
+namespace eddic {
+
+namespace mtac {
+
+struct LiveVariableAnalysisProblem;
+
+template<typename Problem>
+struct BitDataFlowResults;
+
+/*!
+ * \class analysis_manager
+ * \brief The results of the analyses of a function, kept until a change of the function invalidates them.
+ *
+ * The CFG analyses are invalidated by the changes of the CFG themselves (see mtac::Function::cfg_changed).
+ * The other analyses are invalidated by the pass runner after each pass that changed the function,
+ * depending on the analyses preserved by the pass (see mtac::pass_traits).
+ */
+struct analysis_manager {
+    std::vector<basic_block_p> post_order;      /*!< The blocks in post-order, empty if not computed, see mtac::post_order */
+    bool dominators_valid = false;              /*!< Indicates if the dominators of the blocks are up to date, see mtac::compute_dominators */
+    bool loops_valid = false;                   /*!< Indicates if the loops are up to date, see mtac::loop_analysis */
+
+    mtac::EscapedVariables escaped;             /*!< The escaped variables, null if not computed, see mtac::escape_analysis */
+
+    std::shared_ptr<mtac::LiveVariableAnalysisProblem> live_problem;
+    std::shared_ptr<mtac::BitDataFlowResults<mtac::LiveVariableAnalysisProblem>> live_variables; /*!< The liveness, null if not computed, see mtac::live_variable_analysis */
+
+    /*!
+     * Invalidate the analyses depending on the CFG: the orders of the blocks, the dominators, the loops and the liveness.
+     */
+    void cfg_changed();
+
+    /*!
+     * Invalidate the analyses that are not preserved.
+     * \param preserved The preserved analyses, a combination of mtac::ANALYSIS flags.
+     */
+    void invalidate(unsigned int preserved);
+};
+
+} //end of mtac
+
+} //end of eddic
+
+#endif
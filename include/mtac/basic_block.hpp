@@ -57,14 +57,20 @@ class basic_block {
         void add(mtac::Statement statement);
 
         const int index;    /*!< The index of the block */
+        std::size_t id = 0; /*!< The dense id of the block in its function, see mtac::Function::numbered_blocks */
         unsigned int depth = 0;
+        double frequency = 1.0;    /*!< The execution frequency of the block relative to the entry of the function, computed by mtac::compute_frequencies */
+        bool vectorized = false;    /*!< Indicates that the block is the vector loop or the remainder loop of a loop vectorized by mtac::loop_vectorization */
         std::string label;  /*!< The label of the block */
         std::shared_ptr<FunctionContext> context = nullptr;     /*!< The context of the enclosing function. */
+        mtac::Function* function = nullptr;                     /*!< The enclosing function, its cached CFG analyses are invalidated when an edge changes. */
 
         std::vector<mtac::Statement> statements;    /*!< The MTAC statements inside the basic block. */
         
         std::vector<ltac::Statement> l_statements;  /*!< The LTAC statements inside the basic block. */
 
+        std::vector<std::shared_ptr<mtac::Phi>> phis;   /*!< The phi functions at the entry of the basic block, only when the function is in SSA form. */
+
         /* Doubly-linked list  */
 
         std::shared_ptr<basic_block> next = nullptr;     /*!< The next basic block in the doubly-linked list. */
@@ -0,0 +1,41 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#ifndef MTAC_BLOCK_ORDER_H
+#define MTAC_BLOCK_ORDER_H
+
+#include <memory>
+#include <vector>
+
+#include "mtac/forward.hpp"
+#include "mtac/basic_block.hpp"
+
+namespace eddic {
+
+namespace mtac {
+
+/*!
+ * Return the basic blocks of the function in reverse post-order of the CFG starting from ENTRY. 
+ * The blocks that are not reachable from ENTRY are put at the end, in the order of the function. 
+ * \param function The function.
+ * \return The basic blocks in reverse post-order. 
+ */
+std::vector<mtac::basic_block_p> reverse_post_order(std::shared_ptr<Function> function);
+
+/*!
+ * Return the basic blocks of the function in post-order of the CFG starting from ENTRY. 
+ * The blocks that are not reachable from ENTRY are put at the beginning. 
+ * \param function The function.
+ * \return The basic blocks in post-order. 
+ */
+std::vector<mtac::basic_block_p> post_order(std::shared_ptr<Function> function);
+
+} //end of mtac
+
+} //end of eddic
+
+#endif
@@ -33,6 +33,7 @@ struct Quadruple;
 struct Goto;
 struct Call;
 struct NoOp;
+struct Phi;
 
 typedef boost::variant<
         std::shared_ptr<mtac::Quadruple>,        //Basic quadruples
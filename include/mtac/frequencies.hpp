@@ -0,0 +1,42 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#ifndef MTAC_FREQUENCIES_H
+#define MTAC_FREQUENCIES_H
+
+#include <memory>
+
+#include "Options.hpp"
+
+#include "mtac/forward.hpp"
+
+namespace eddic {
+
+namespace mtac {
+
+/*!
+ * Compute the execution frequency of each basic block of the function, relative to one execution 
+ * of the function and store it in the frequency field of the basic block. 
+ *
+ * When the fprofile-use option gives a profile file containing the function, the frequencies are 
+ * the execution counts of the profile divided by the count of the ENTRY block. Each line of the file 
+ * contains the mangled name of a function, the index of a basic block (-1 for ENTRY, as printed by 
+ * the MTAC printer) and its execution count. 
+ *
+ * Otherwise, the frequencies are estimated from static branch probabilities: the back edges are 
+ * taken and the loops left with a probability of 0.88 and 0.12, the other branches are equiprobable. 
+ *
+ * \param function The function to compute the frequencies for. 
+ * \param configuration The configuration of the compilation. 
+ */
+void compute_frequencies(mtac::function_p function, std::shared_ptr<Configuration> configuration);
+
+} //end of mtac
+
+} //end of eddic
+
+#endif
@@ -5,10 +5,8 @@
 //  http://www.boost.org/LICENSE_1_0.txt)
 //=======================================================================
 
-#ifndef MTAC_BRANCH_OPTIMIZATIONS_H
-#define MTAC_BRANCH_OPTIMIZATIONS_H
-
-#include <memory>
+#ifndef MTAC_GVN_H
+#define MTAC_GVN_H
 
 #include "mtac/pass_traits.hpp"
 #include "mtac/forward.hpp"
@@ -17,16 +15,23 @@ namespace eddic {
 
 namespace mtac {
 
-struct optimize_branches {
+/*!
+ * \struct global_value_numbering
+ * \brief Dominator-based value numbering on the SSA form of the function. 
+ * The expressions are numbered in a hash table scoped on the dominator tree, a redundant expression
+ * is replaced by a copy of the value computed by the dominating expression. 
+ */
+struct global_value_numbering {
     bool operator()(mtac::function_p function);
 };
 
 template<>
-struct pass_traits<optimize_branches> {
+struct pass_traits<global_value_numbering> {
     STATIC_CONSTANT(pass_type, type, pass_type::CUSTOM);
-    STATIC_STRING(name, "optimize_branches");
+    STATIC_STRING(name, "global_value_numbering");
     STATIC_CONSTANT(unsigned int, property_flags, 0);
     STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_CONTROL_FLOW);
 };
 
 } //end of mtac
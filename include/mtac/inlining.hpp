@@ -31,6 +31,7 @@ struct pass_traits<inline_functions> {
     STATIC_STRING(name, "inline_functions");
     STATIC_CONSTANT(unsigned int, property_flags, PROPERTY_CONFIGURATION);
     STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_NONE);
 };
 
 } //end of mtac
@@ -28,6 +28,7 @@ struct pass_traits<loop_analysis> {
     STATIC_CONSTANT(pass_type, type, pass_type::CUSTOM);
     STATIC_CONSTANT(unsigned int, property_flags, 0);
     STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_ALL);
 };
 
 } //end of mtac
@@ -10,6 +10,9 @@
 
 #include <memory>
 
+#include "Platform.hpp"
+#include "Options.hpp"
+
 #include "mtac/pass_traits.hpp"
 #include "mtac/forward.hpp"
 
@@ -27,6 +30,7 @@ struct pass_traits<loop_invariant_code_motion> {
     STATIC_CONSTANT(pass_type, type, pass_type::CUSTOM);
     STATIC_CONSTANT(unsigned int, property_flags, 0);
     STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_NONE);
 };
 
 struct loop_induction_variables_optimization {
@@ -39,6 +43,7 @@ struct pass_traits<loop_induction_variables_optimization> {
     STATIC_STRING(name, "loop_iv_optimization");
     STATIC_CONSTANT(unsigned int, property_flags, 0);
     STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_NONE);
 };
 
 struct remove_empty_loops {
@@ -51,6 +56,7 @@ struct pass_traits<remove_empty_loops> {
     STATIC_STRING(name, "remove_empty_loops");
     STATIC_CONSTANT(unsigned int, property_flags, 0);
     STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_NONE);
 };
 
 struct complete_loop_peeling {
@@ -63,6 +69,52 @@ struct pass_traits<complete_loop_peeling> {
     STATIC_STRING(name, "complete_loop_peeling");
     STATIC_CONSTANT(unsigned int, property_flags, 0);
     STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_NONE);
+};
+
+struct loop_vectorization {
+    Platform platform;
+    std::shared_ptr<Configuration> configuration;
+
+    void set_platform(Platform platform);
+    void set_configuration(std::shared_ptr<Configuration> configuration);
+
+    bool operator()(mtac::function_p function);
+};
+
+template<>
+struct pass_traits<loop_vectorization> {
+    STATIC_CONSTANT(pass_type, type, pass_type::CUSTOM);
+    STATIC_STRING(name, "loop_vectorization");
+    STATIC_CONSTANT(unsigned int, property_flags, PROPERTY_PLATFORM | PROPERTY_CONFIGURATION);
+    STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_NONE);
+};
+
+struct loop_unrolling {
+    bool operator()(mtac::function_p function);
+};
+
+template<>
+struct pass_traits<loop_unrolling> {
+    STATIC_CONSTANT(pass_type, type, pass_type::CUSTOM);
+    STATIC_STRING(name, "loop_unrolling");
+    STATIC_CONSTANT(unsigned int, property_flags, 0);
+    STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_NONE);
+};
+
+struct bounds_check_elimination {
+    bool operator()(mtac::function_p function);
+};
+
+template<>
+struct pass_traits<bounds_check_elimination> {
+    STATIC_CONSTANT(pass_type, type, pass_type::CUSTOM);
+    STATIC_STRING(name, "bounds_check_elimination");
+    STATIC_CONSTANT(unsigned int, property_flags, 0);
+    STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_NONE);
 };
 
 } //end of mtac
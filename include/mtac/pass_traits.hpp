@@ -37,6 +37,18 @@ enum PROPERTY {
     PROPERTY_CONFIGURATION = 4
 };
 
+enum ANALYSIS {
+    ANALYSIS_CFG = 1,
+    ANALYSIS_DOMINATORS = 2,
+    ANALYSIS_LOOPS = 4,
+    ANALYSIS_ESCAPED_VARIABLES = 8,
+    ANALYSIS_LIVE_VARIABLES = 16,
+
+    ANALYSIS_NONE = 0,
+    ANALYSIS_CONTROL_FLOW = ANALYSIS_CFG | ANALYSIS_DOMINATORS | ANALYSIS_LOOPS,
+    ANALYSIS_ALL = ANALYSIS_CONTROL_FLOW | ANALYSIS_ESCAPED_VARIABLES | ANALYSIS_LIVE_VARIABLES
+};
+
 template<typename T>
 struct pass_traits {
 
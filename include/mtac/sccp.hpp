@@ -0,0 +1,41 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#ifndef MTAC_SCCP_H
+#define MTAC_SCCP_H
+
+#include "mtac/pass_traits.hpp"
+#include "mtac/forward.hpp"
+
+namespace eddic {
+
+namespace mtac {
+
+/*!
+ * \struct sparse_conditional_constant_propagation
+ * \brief Wegman-Zadeck constant propagation on the SSA form of the function. 
+ * The constant values and the executable edges of the CFG are computed together, the branches 
+ * whose condition is known are folded in the same pass. 
+ */
+struct sparse_conditional_constant_propagation {
+    bool operator()(mtac::function_p function);
+};
+
+template<>
+struct pass_traits<sparse_conditional_constant_propagation> {
+    STATIC_CONSTANT(pass_type, type, pass_type::CUSTOM);
+    STATIC_STRING(name, "sccp");
+    STATIC_CONSTANT(unsigned int, property_flags, 0);
+    STATIC_CONSTANT(unsigned int, todo_after_flags, TODO_REMOVE_NOP);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_NONE);
+};
+
+} //end of mtac
+
+} //end of eddic
+
+#endif
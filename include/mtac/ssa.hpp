@@ -0,0 +1,64 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#ifndef MTAC_SSA_H
+#define MTAC_SSA_H
+
+#include <memory>
+#include <vector>
+#include <unordered_map>
+
+#include "mtac/forward.hpp"
+
+namespace eddic {
+
+class Variable;
+
+namespace mtac {
+
+typedef std::unordered_map<mtac::basic_block_p, std::vector<mtac::basic_block_p>> DominanceFrontiers;
+typedef std::unordered_map<std::shared_ptr<Variable>, std::shared_ptr<Variable>> SSAVersions;
+
+/*!
+ * Compute the dominance frontier of each reachable basic block of the function. 
+ * The dominators of the function must have been computed before. 
+ * \param function The function. 
+ * \return The dominance frontier of each basic block.
+ */
+DominanceFrontiers dominance_frontiers(mtac::function_p function);
+
+/*!
+ * Put the function in SSA form. 
+ *
+ * Only the local scalar variables whose address is never taken are renamed, the other variables 
+ * are left untouched. The phi functions are placed in the phis of the basic blocks. 
+ * \param function The function to transform. 
+ * \return The original variable of each version created by the renaming. 
+ */
+SSAVersions build_ssa(mtac::function_p function);
+
+/*!
+ * Translate the function out of SSA form. Each phi function is replaced by copies in the
+ * predecessors of its basic block. 
+ * \param function The function to transform. 
+ */
+void destroy_ssa(mtac::function_p function);
+
+/*!
+ * Translate the function out of SSA form by renaming each version back to its original variable and 
+ * by dropping the phi functions. This is only valid if the versions of a variable do not interfere, 
+ * which holds as long as the transformations only replaced uses by constants or folded statements in place.
+ * \param function The function to transform. 
+ * \param versions The versions returned by build_ssa. 
+ */
+void revert_ssa(mtac::function_p function, const SSAVersions& versions);
+
+} //end of mtac
+
+} //end of eddic
+
+#endif
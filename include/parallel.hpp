@@ -0,0 +1,93 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <exception>
+
+namespace eddic {
+
+/*!
+ * \brief Return the number of worker threads to use for parallel tasks.
+ * \return The number of hardware threads, at least one.
+ */
+inline unsigned int worker_threads(){
+    auto threads = std::thread::hardware_concurrency();
+
+    return threads == 0 ? 1 : threads;
+}
+
+/*!
+ * \brief Apply the functor to each element of the container using several threads.
+ *
+ * The elements are not statically partitioned between the threads. Each worker takes the next
+ * unprocessed element as soon as it is idle, so that a few expensive elements do not leave the
+ * other workers waiting. The elements should be sorted from the most to the least expensive to
+ * get the best balance. The function returns only when all the elements have been processed.
+ * If a functor throws, the first exception is rethrown in the calling thread.
+ * \param container The elements to process.
+ * \param threads The maximum number of threads to use.
+ * \param functor The functor to apply to each element.
+ */
+template<typename Container, typename Functor>
+void parallel_for_each(Container& container, unsigned int threads, Functor functor){
+    if(threads > container.size()){
+        threads = container.size();
+    }
+
+    if(threads <= 1){
+        for(auto& element : container){
+            functor(element);
+        }
+
+        return;
+    }
+
+    std::atomic<std::size_t> next(0);
+    std::atomic<bool> failed(false);
+    std::exception_ptr exception;
+
+    auto worker = [&](){
+        std::size_t i;
+        while(!failed.load() && (i = next++) < container.size()){
+            try {
+                functor(container[i]);
+            } catch (...) {
+                bool expected = false;
+                if(failed.compare_exchange_strong(expected, true)){
+                    exception = std::current_exception();
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+
+    for(unsigned int t = 1; t < threads; ++t){
+        pool.emplace_back(worker);
+    }
+
+    //The calling thread works too
+    worker();
+
+    for(auto& thread : pool){
+        thread.join();
+    }
+
+    if(exception){
+        std::rethrow_exception(exception);
+    }
+}
+
+} //end of eddic
+
+#endif
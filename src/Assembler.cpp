@@ -6,39 +6,64 @@
 //=======================================================================
 
 #include <iostream>
+#include <vector>
 
 #include "Assembler.hpp"
 #include "PerfsTimer.hpp"
+#include "PassTimer.hpp"
+#include "SemanticalException.hpp"
 #include "Utils.hpp"
 
+#include "asm/IntelX86_64Encoder.hpp"
+
 using namespace eddic;
 
 namespace {
 
-void exec(const std::string& command, bool verbose) {
+void exec(const std::vector<std::string>& arguments, bool verbose) {
+    std::string command;
+    for(auto& argument : arguments){
+        if(!command.empty()){
+            command += " ";
+        }
+
+        command += argument;
+    }
+
     PerfsTimer timer("Exec " + command);
+    PassTimer pass_timer("assembler", arguments.front());
     
     if(verbose){
         std::cout << "eddic : exec command : " << command << std::endl;
     }
 
-    std::string result = execCommand(command);
+    int status;
+    std::string result = execCommand(arguments, status);
 
     if(result.size() > 0){
         std::cout << result << std::endl;
     }
+
+    //The executable is not valid if one of the tools failed
+    if(status != 0){
+        if(status > 0){
+            throw SemanticalException("eddic : " + command + " failed with exit code " + toString(status));
+        } else {
+            throw SemanticalException("eddic : " + command + " did not complete");
+        }
+    }
 }
 
 void assembleWithoutDebug(Platform platform, const std::string& s, const std::string& o, const std::string& output, bool verbose){
     switch(platform){
         case Platform::INTEL_X86:
-            exec("nasm -f elf32 -o " + o + " " + s, verbose);
-            exec("ld -S -m elf_i386 " + o  + " -o " + output, verbose);
+            exec({"nasm", "-f", "elf32", "-o", o, s}, verbose);
+            exec({"ld", "-S", "-m", "elf_i386", o, "-o", output}, verbose);
 
             break;
         case Platform::INTEL_X86_64:
-            exec("nasm -f elf64 -o " + o + " " + s, verbose);
-            exec("ld -S -m elf_x86_64 " + o  + " -o " + output, verbose);
+            exec({"nasm", "-f", "elf64", "-o", o, s}, verbose);
+            exec({"ld", "-S", "-m", "elf_x86_64", o, "-o", output}, verbose);
 
             break;
     }
@@ -47,13 +72,13 @@ void assembleWithoutDebug(Platform platform, const std::string& s, const std::st
 void assembleWithDebug(Platform platform, const std::string& s, const std::string& o, const std::string& output, bool verbose){
     switch(platform){
         case Platform::INTEL_X86:
-            exec("nasm -g -f elf32 -o " + o + " " + s, verbose);
-            exec("ld -m elf_i386 " + o  + " -o " + output, verbose);
+            exec({"nasm", "-g", "-f", "elf32", "-o", o, s}, verbose);
+            exec({"ld", "-m", "elf_i386", o, "-o", output}, verbose);
 
             break;
         case Platform::INTEL_X86_64:
-            exec("nasm -g -f elf64 -o " + o + " " + s, verbose);
-            exec("ld -m elf_x86_64 " + o  + " -o " + output, verbose);
+            exec({"nasm", "-g", "-f", "elf64", "-o", o, s}, verbose);
+            exec({"ld", "-m", "elf_x86_64", o, "-o", output}, verbose);
 
         break;
    }
@@ -61,6 +86,32 @@ void assembleWithDebug(Platform platform, const std::string& s, const std::strin
 
 } //end of anonymous namespace
 
+bool eddic::encode(Platform platform, const std::string& source, const std::string& output, bool debug, bool verbose){
+    //The debugging symbols are only generated by nasm and ld
+    if(platform != Platform::INTEL_X86_64 || debug){
+        return false;
+    }
+
+    PerfsTimer timer("Encode " + output);
+    PassTimer pass_timer("assembler", "encoder");
+
+    try {
+        as::encode_x86_64(source, output);
+    } catch (const as::UnsupportedAssembly& e){
+        if(verbose){
+            std::cout << "eddic : the assembly cannot be encoded (" << e.message() << "), falling back to nasm and ld" << std::endl;
+        }
+
+        return false;
+    }
+
+    if(verbose){
+        std::cout << "eddic : encoded " << output << std::endl;
+    }
+
+    return true;
+}
+
 void eddic::assemble(Platform platform, const std::string& s, const std::string& o, const std::string& output, bool debug, bool verbose){
    if(debug){
        assembleWithDebug(platform, s, o, output, verbose);
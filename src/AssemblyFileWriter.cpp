@@ -5,24 +5,28 @@
 //  http://www.boost.org/LICENSE_1_0.txt)
 //=======================================================================
 
+#include <fstream>
+
 #include "AssemblyFileWriter.hpp"
 
 #include "SemanticalException.hpp"
 
 using namespace eddic;
 
-AssemblyFileWriter::AssemblyFileWriter(const std::string& path) {
-    m_stream.open(path.c_str());
-
-    if (!m_stream) {
-        throw SemanticalException("Unable to open the output file");
-    }
+std::ostream& AssemblyFileWriter::stream() {
+    return m_stream;
 }
 
-AssemblyFileWriter::~AssemblyFileWriter() {
+std::string AssemblyFileWriter::content() const {
+    return m_stream.str();
 }
 
-std::ostream& AssemblyFileWriter::stream() {
-    return m_stream;
-}
+void AssemblyFileWriter::write(const std::string& path) const {
+    std::ofstream stream(path.c_str());
+
+    if (!stream) {
+        throw SemanticalException("Unable to open the output file");
+    }
 
+    stream << m_stream.str();
+}
@@ -9,6 +9,7 @@
 #include <cstdio>
 
 #include "StopWatch.hpp"
+#include "PassTimer.hpp"
 #include "Compiler.hpp"
 #include "Target.hpp"
 #include "Utils.hpp"
@@ -50,6 +51,10 @@ int Compiler::compile(const std::string& file, std::shared_ptr<Configuration> co
         platform = Platform::INTEL_X86_64;
     }
 
+    if(configuration->option_defined("time-passes")){
+        enable_time_passes();
+    }
+
     StopWatch timer;
     
     int code = compile_only(file, platform, configuration);
@@ -58,6 +63,10 @@ int Compiler::compile(const std::string& file, std::shared_ptr<Configuration> co
         std::cout << "Compilation took " << timer.elapsed() << "ms" << std::endl;
     }
 
+    if(configuration->option_defined("time-passes")){
+        print_time_passes(std::cout, configuration->option_value("time-passes") == "json");
+    }
+
     return code;
 }
 
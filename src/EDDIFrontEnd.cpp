@@ -60,7 +60,7 @@ mtac::program_p EDDIFrontEnd::compile(const std::string& file, Platform platform
 
         //Generate Three-Address-Code language
         mtac::Compiler compiler;
-        compiler.compile(program, pool, mtacProgram);
+        compiler.compile(program, pool, mtacProgram, configuration);
 
         return mtacProgram;
     }
@@ -17,6 +17,8 @@ FloatPool::FloatPool() : currentString(0) {
 }
 
 std::string FloatPool::label(double value) {
+    std::lock_guard<std::mutex> lock(mutex);
+
     if (pool.find(value) == pool.end()) {
         std::stringstream ss;
         ss << "F";
@@ -28,6 +30,8 @@ std::string FloatPool::label(double value) {
 }
 
 double FloatPool::value(const std::string& label) const {
+    std::lock_guard<std::mutex> lock(mutex);
+
     for (auto it : pool){
         if(it.second == label){
             return it.first;
@@ -39,5 +43,7 @@ double FloatPool::value(const std::string& label) const {
 }
 
 std::unordered_map<double, std::string> FloatPool::get_pool() const {
+    std::lock_guard<std::mutex> lock(mutex);
+
     return pool;
 }
@@ -134,6 +134,12 @@ void FunctionContext::removeVariable(std::shared_ptr<Variable> variable){
     auto var = *iter_var;
     
     storage.erase(iter_var);
+
+    //The versions and temporaries created by the optimizations are only known by their name in this context
+    auto iter = variables.find(variable->name());
+    if(iter != variables.end() && iter->second == variable){
+        variables.erase(iter);
+    }
     
     log::emit<Info>("Variables") << "Remove " << variable->name() << log::endl;
 }
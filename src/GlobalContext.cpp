@@ -23,9 +23,22 @@ GlobalContext::GlobalContext(Platform platform) : Context(NULL), platform(platfo
     
     variables["_mem_start"] = std::make_shared<Variable>("_mem_start", INT, Position(PositionType::GLOBAL, "_mem_start"), zero);
     variables["_mem_last"] = std::make_shared<Variable>("_mem_last", INT, Position(PositionType::GLOBAL, "_mem_last"), zero);
+    variables["_mem_bump"] = std::make_shared<Variable>("_mem_bump", INT, Position(PositionType::GLOBAL, "_mem_bump"), zero);
+    variables["_mem_large"] = std::make_shared<Variable>("_mem_large", INT, Position(PositionType::GLOBAL, "_mem_large"), zero);
+    
+    //The heads of the free lists of the small size classes of the allocator
+    variables["_mem_bins"] = std::make_shared<Variable>("_mem_bins", new_array_type(INT, 33), Position(PositionType::GLOBAL, "_mem_bins"));
 
     add_reference(variables["_mem_start"]); //In order to not display a warning
     add_reference(variables["_mem_last"]);  //In order to not display a warning
+    add_reference(variables["_mem_bump"]);  //In order to not display a warning
+    add_reference(variables["_mem_large"]); //In order to not display a warning
+    add_reference(variables["_mem_bins"]);  //In order to not display a warning
+
+    //The number of bytes waiting in the output buffer of the print functions
+    variables["_out_length"] = std::make_shared<Variable>("_out_length", INT, Position(PositionType::GLOBAL, "_out_length"), zero);
+    
+    add_reference(variables["_out_length"]); //In order to not display a warning
     
     defineStandardFunctions();
 }
@@ -157,23 +170,50 @@ bool GlobalContext::struct_exists(const std::string& struct_){
 }
 
 void GlobalContext::addReference(const std::string& function){
+    std::lock_guard<std::mutex> lock(references_mutex);
+
     eddic_assert(exists(function), "The function must exists");
     
     ++(m_functions[function]->references);
 }
 
 void GlobalContext::removeReference(const std::string& function){
+    std::lock_guard<std::mutex> lock(references_mutex);
+
     eddic_assert(exists(function), "The function must exists");
     
     --(m_functions[function]->references);
 }
 
 int GlobalContext::referenceCount(const std::string& function){
+    std::lock_guard<std::mutex> lock(references_mutex);
+
     eddic_assert(exists(function), "The function must exists");
     
     return m_functions[function]->references;
 }
 
+std::shared_ptr<Function> GlobalContext::concat_function(unsigned int strings){
+    std::lock_guard<std::mutex> lock(concat_mutex);
+
+    auto& function = concat_functions[strings];
+
+    if(!function){
+        function = std::make_shared<Function>(STRING, "concat");
+        function->standard = true;
+        function->mangledName = "_concatN";
+
+        for(unsigned int i = 0; i < strings; ++i){
+            function->parameters.push_back({"a" + std::to_string(i), STRING});
+        }
+
+        //The number of strings is passed in the first int register
+        function->parameters.push_back({"count", INT});
+    }
+
+    return function;
+}
+
 void GlobalContext::addPrintFunction(const std::string& function, std::shared_ptr<const Type> parameterType){
     auto printFunction = std::make_shared<Function>(VOID, "print");
     printFunction->standard = true;
@@ -221,6 +261,32 @@ void GlobalContext::defineStandardFunctions(){
     concatFunction->parameters.push_back({"b", STRING});
     addFunction(concatFunction);
     
+    //N-ary concat function, the parameters depend on the call, see concat_function
+    auto concatNFunction = std::make_shared<Function>(STRING, "concat");
+    concatNFunction->standard = true;
+    concatNFunction->mangledName = "_concatN";
+    addFunction(concatNFunction);
+    
+    //str_equals function
+    auto strEqualsFunction = std::make_shared<Function>(BOOL, "str_equals");
+    strEqualsFunction->standard = true;
+    strEqualsFunction->mangledName = "_F10str_equalsSS";
+    strEqualsFunction->parameters.push_back({"a", STRING});
+    strEqualsFunction->parameters.push_back({"b", STRING});
+    addFunction(strEqualsFunction);
+    
+    //memzero function, only used to clear the big blocks of the stack
+    auto memzeroFunction = std::make_shared<Function>(VOID, "memzero");
+    memzeroFunction->standard = true;
+    memzeroFunction->mangledName = "_memzero";
+    addFunction(memzeroFunction);
+    
+    //bounds_error function, called when an array is accessed out of its bounds (-fbounds-check)
+    auto boundsErrorFunction = std::make_shared<Function>(VOID, "bounds_error");
+    boundsErrorFunction->standard = true;
+    boundsErrorFunction->mangledName = "_bounds_error";
+    addFunction(boundsErrorFunction);
+    
     //alloc function
     auto allocFunction = std::make_shared<Function>(new_pointer_type(INT), "alloc");
     allocFunction->standard = true;
@@ -260,9 +326,13 @@ Platform GlobalContext::target_platform(){
 }
         
 void GlobalContext::add_reference(std::shared_ptr<Variable> variable){
+    std::lock_guard<std::mutex> lock(references_mutex);
+
     ++((*references)[variable]);
 }
 
 unsigned int GlobalContext::reference_count(std::shared_ptr<Variable> variable){
+    std::lock_guard<std::mutex> lock(references_mutex);
+
     return (*references)[variable];
 }
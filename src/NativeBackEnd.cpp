@@ -5,12 +5,20 @@
 //  http://www.boost.org/LICENSE_1_0.txt)
 //=======================================================================
 
+#include <algorithm>
+#include <vector>
+
 #include "NativeBackEnd.hpp"
 #include "Utils.hpp"
 #include "Options.hpp"
 #include "AssemblyFileWriter.hpp"
 #include "Assembler.hpp"
 #include "FloatPool.hpp"
+#include "PerfsTimer.hpp"
+#include "PassTimer.hpp"
+#include "parallel.hpp"
+
+#include "mtac/Program.hpp"
 
 //Low-level Three Address Code
 #include "ltac/Compiler.hpp"
@@ -27,6 +35,43 @@
 
 using namespace eddic;
 
+namespace {
+
+//The statements are only counted for the report of --time-passes
+
+std::size_t ltac_statements(mtac::function_p function){
+    std::size_t statements = 0;
+
+    if(time_passes_enabled()){
+        for(auto& block : function){
+            statements += block->l_statements.size();
+        }
+    }
+
+    return statements;
+}
+
+std::size_t ltac_statements(mtac::program_p program){
+    std::size_t statements = 0;
+
+    for(auto& function : program->functions){
+        statements += ltac_statements(function);
+    }
+
+    return statements;
+}
+
+template<typename Code, typename Stage>
+void run_stage(const std::string& name, Code code, Stage stage){
+    PassTimer timer("ltac", name, ltac_statements(code));
+
+    stage();
+
+    timer.statements(ltac_statements(code));
+}
+
+} //end of anonymous namespace
+
 void NativeBackEnd::generate(mtac::program_p mtac_program, Platform platform){
     std::string output = configuration->option_value("output");
 
@@ -34,17 +79,81 @@ void NativeBackEnd::generate(mtac::program_p mtac_program, Platform platform){
     auto float_pool = std::make_shared<FloatPool>();
 
     //Allocate stack positions for aggregates that have not been allocated
-    ltac::allocate_aggregates(mtac_program);
+    run_stage("aggregates allocation", mtac_program, [&](){ ltac::allocate_aggregates(mtac_program); });
+
+    //The intermediate representations can only be printed if each stage is run on the whole program
+    if(configuration->option_defined("single-threaded") || configuration->option_defined("ltac-pre") || configuration->option_defined("ltac-alloc")){
+        generate_serial(mtac_program, platform, float_pool);
+    } else {
+        generate_parallel(mtac_program, platform, float_pool);
+    }
+
+    if(configuration->option_defined("peephole-stats")){
+        ltac::print_peephole_statistics();
+    }
+
+    if(configuration->option_defined("ltac") || configuration->option_defined("ltac-only")){
+        ltac::Printer printer;
+        printer.print(mtac_program);
+    }
+
+    if(!configuration->option_defined("ltac-only")){
+        auto input_file_name = configuration->option_value("input");
+        auto asm_file_name = input_file_name + ".s";
+        auto object_file_name = input_file_name + ".o";
+
+        AssemblyFileWriter writer;
+
+        {
+            PassTimer timer("asm", "code generation");
+
+            as::CodeGeneratorFactory factory;
+            auto generator = factory.get(platform, writer, mtac_program->context);
+
+            //Generate the code from the LTAC Program
+            generator->generate(mtac_program, get_string_pool(), float_pool);
+        }
+
+        if(configuration->option_defined("assembly")){
+            writer.write(asm_file_name);
+        } else {
+            bool keep = configuration->option_defined("keep");
+            bool debug = configuration->option_defined("debug");
+            bool verbose = configuration->option_defined("verbose");
+
+            //The assembly file is only written if the user wants it or if the tools need it
+            if(keep){
+                writer.write(asm_file_name);
+            }
+
+            if(!encode(platform, writer.content(), output, debug, verbose)){
+                if(!keep){
+                    writer.write(asm_file_name);
+                }
 
+                assemble(platform, asm_file_name, object_file_name, output, debug, verbose);
+
+                //Remove temporary files
+                if(!keep){
+                    remove(asm_file_name.c_str());
+                }
+
+                remove(object_file_name.c_str());
+            }
+        }
+    }
+}
+
+void NativeBackEnd::generate_serial(mtac::program_p mtac_program, Platform platform, std::shared_ptr<FloatPool> float_pool){
     //Generate LTAC Code
     ltac::Compiler ltacCompiler(platform, configuration);
-    ltacCompiler.compile(mtac_program, float_pool);
+    run_stage("compilation", mtac_program, [&](){ ltacCompiler.compile(mtac_program, float_pool); });
 
     //Switch to LTAC Mode
     mtac_program->mode = mtac::Mode::LTAC;
 
     //Clean the code generated by the LTAC Compiler to ease the register allocation
-    ltac::pre_alloc_cleanup(mtac_program);
+    run_stage("pre allocation cleanup", mtac_program, [&](){ ltac::pre_alloc_cleanup(mtac_program); });
     
     if(configuration->option_defined("ltac-pre")){
         ltac::Printer printer;
@@ -52,14 +161,14 @@ void NativeBackEnd::generate(mtac::program_p mtac_program, Platform platform){
     }
 
     //Allocate pseudo registers into hard registers
-    ltac::register_allocation(mtac_program, platform);
+    run_stage("register allocation", mtac_program, [&](){ ltac::register_allocation(mtac_program, platform, configuration); });
     
     //Generate the prologue and epilogue of each functions
-    ltac::generate_prologue_epilogue(mtac_program, configuration);
+    run_stage("prologue and epilogue", mtac_program, [&](){ ltac::generate_prologue_epilogue(mtac_program, configuration); });
 
     //If specified by the configuration, replace all stack offsets using SP 
     if(configuration->option_defined("fomit-frame-pointer")){
-        ltac::fix_stack_offsets(mtac_program, platform);
+        run_stage("stack offsets", mtac_program, [&](){ ltac::fix_stack_offsets(mtac_program, platform); });
     }
     
     if(configuration->option_defined("ltac-alloc")){
@@ -68,42 +177,40 @@ void NativeBackEnd::generate(mtac::program_p mtac_program, Platform platform){
     }
 
     if(configuration->option_defined("fpeephole-optimization")){
-        ltac::optimize(mtac_program, platform);
+        run_stage("peephole optimization", mtac_program, [&](){ ltac::optimize(mtac_program, platform); });
     }
+}
 
-    if(configuration->option_defined("ltac") || configuration->option_defined("ltac-only")){
-        ltac::Printer printer;
-        printer.print(mtac_program);
-    }
+void NativeBackEnd::generate_parallel(mtac::program_p mtac_program, Platform platform, std::shared_ptr<FloatPool> float_pool){
+    PerfsTimer timer("LTAC back end");
 
-    if(!configuration->option_defined("ltac-only")){
-        auto input_file_name = configuration->option_value("input");
-        auto asm_file_name = input_file_name + ".s";
-        auto object_file_name = input_file_name + ".o";
+    bool omit_frame_pointer = configuration->option_defined("fomit-frame-pointer");
+    bool peephole = configuration->option_defined("fpeephole-optimization");
 
-        {
-            //Generate assembly from TAC
-            AssemblyFileWriter writer(asm_file_name);
+    //Switch to LTAC Mode
+    mtac_program->mode = mtac::Mode::LTAC;
 
-            as::CodeGeneratorFactory factory;
-            auto generator = factory.get(platform, writer, mtac_program->context);
+    //Start with the biggest functions to balance the work between the threads
+    std::vector<mtac::function_p> functions(mtac_program->functions);
+    std::stable_sort(functions.begin(), functions.end(), 
+            [](const mtac::function_p& lhs, const mtac::function_p& rhs){ return lhs->size() > rhs->size(); });
 
-            //Generate the code from the LTAC Program
-            generator->generate(mtac_program, get_string_pool(), float_pool);
+    ltac::Compiler ltacCompiler(platform, configuration);
 
-            //writer's destructor flushes the file
-        }
+    //Each function goes through the whole LTAC chain independently of the others
+    parallel_for_each(functions, worker_threads(), [&](mtac::function_p& function){
+        run_stage("compilation", function, [&](){ ltacCompiler.compile(mtac_program, function, float_pool); });
 
-        //If it's necessary, assemble and link the assembly
-        if(!configuration->option_defined("assembly")){
-            assemble(platform, asm_file_name, object_file_name, output, configuration->option_defined("debug"), configuration->option_defined("verbose"));
+        run_stage("pre allocation cleanup", function, [&](){ ltac::pre_alloc_cleanup(function); });
+        run_stage("register allocation", function, [&](){ ltac::register_allocation(function, platform, configuration); });
+        run_stage("prologue and epilogue", function, [&](){ ltac::generate_prologue_epilogue(function, platform, configuration); });
 
-            //Remove temporary files
-            if(!configuration->option_defined("keep")){
-                remove(asm_file_name.c_str());
-            }
+        if(omit_frame_pointer){
+            run_stage("stack offsets", function, [&](){ ltac::fix_stack_offsets(function, platform); });
+        }
 
-            remove(object_file_name.c_str());
+        if(peephole){
+            run_stage("peephole optimization", function, [&](){ ltac::optimize(function, platform); });
         }
-    }
+    });
 }
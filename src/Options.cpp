@@ -57,6 +57,8 @@ void init_descriptions(){
         
         ("template-depth", po::value<int>()->default_value(100), "Define the maximum template depth")
         
+        ("fbounds-check", "Check the indexes of the array accesses at runtime")
+        
         ("32", "Force the compilation for 32 bits platform")
         ("64", "Force the compilation for 64 bits platform")
 
@@ -76,7 +78,10 @@ void init_descriptions(){
         ("ltac-pre", "Print the low-level Three Address Code representation of the source before allocation of registers")
         ("ltac-alloc", "Print the low-level Three Address Code representation of the source before optimization")
         ("ltac", "Print the final low-level Three Address Code representation of the source")
-        ("ltac-only", "Only print the low-level Three Address Code representation of the source (do not continue compilation after printing)");
+        ("ltac-only", "Only print the low-level Three Address Code representation of the source (do not continue compilation after printing)")
+        
+        ("peephole-stats", "Print the number of times each rule of the peephole optimizer has been applied")
+        ("time-passes", po::value<std::string>()->implicit_value("table"), "Print the time spent in each pass of the compiler, as a table or as JSON (--time-passes=json)");
 
     po::options_description optimization("Optimization options");
     optimization.add_options()
@@ -90,6 +95,12 @@ void init_descriptions(){
         ("fpeephole-optimization", "Enable peephole optimizer")
         ("fomit-frame-pointer", "Omit frame pointer from functions")
         ("finline-functions", "Enable inlining")
+        ("fvectorize-loops", "Vectorize the simple counted loops over int and float arrays")
+        ("ffast-math", "Allow the optimizations changing the rounding of the float computations (vectorization of the float sums)")
+        ("funroll-loops", "Unroll the counted loops by a factor of 2, 4 or 8")
+        ("fgraph-coloring-allocation", "Allocate the registers by graph coloring instead of linear scan")
+        ("fno-graph-coloring-allocation", "Allocate the registers by linear scan")
+        ("fprofile-use", po::value<std::string>(), "Use the basic block execution counts of the given profile to drive the register allocation and the inlining")
         ("fno-inline-functions", "Disable inlining");
     
     po::options_description backend("Backend options");
@@ -107,7 +118,7 @@ void init_descriptions(){
     
     //Special triggers for optimization levels
     add_trigger("__1", {"fpeephole-optimization"});
-    add_trigger("__2", {"fglobal-optimization", "fomit-frame-pointer", "fparameter-allocation", "finline-functions"});
+    add_trigger("__2", {"fglobal-optimization", "fomit-frame-pointer", "fparameter-allocation", "finline-functions", "fgraph-coloring-allocation", "fvectorize-loops", "funroll-loops"});
 }
 
 inline void trigger_childs(std::shared_ptr<Configuration> configuration, const std::vector<std::string>& childs){
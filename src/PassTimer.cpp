@@ -0,0 +1,179 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#include <atomic>
+#include <mutex>
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <iomanip>
+
+#include "PassTimer.hpp"
+
+using namespace eddic;
+
+namespace {
+
+struct pass_times {
+    std::string category;
+    std::string name;
+
+    double time = 0.0;          //In microseconds
+    std::size_t runs = 0;
+
+    bool report_changed = false;
+    std::size_t changed = 0;
+
+    bool report_statements = false;
+    std::size_t before = 0;
+    std::size_t after = 0;
+};
+
+std::atomic<bool> enabled(false);
+
+std::mutex times_mutex;
+std::map<std::pair<std::string, std::string>, pass_times> times;
+
+std::string escape(const std::string& value){
+    std::string escaped;
+
+    for(auto c : value){
+        if(c == '"' || c == '\\'){
+            escaped += '\\';
+        }
+
+        escaped += c;
+    }
+
+    return escaped;
+}
+
+void print_json(std::ostream& out, const std::vector<pass_times>& passes){
+    out << "{" << std::endl;
+    out << "  \"passes\": [" << std::endl;
+
+    for(std::size_t i = 0; i < passes.size(); ++i){
+        auto& pass = passes[i];
+
+        out << "    {\"category\": \"" << escape(pass.category) << "\", \"name\": \"" << escape(pass.name) << "\"";
+        out << ", \"time_ms\": " << std::fixed << std::setprecision(3) << pass.time / 1000.0;
+        out << ", \"runs\": " << pass.runs;
+
+        if(pass.report_changed){
+            out << ", \"changed\": " << pass.changed;
+        }
+
+        if(pass.report_statements){
+            out << ", \"statements_before\": " << pass.before << ", \"statements_after\": " << pass.after;
+        }
+
+        out << "}" << (i + 1 < passes.size() ? "," : "") << std::endl;
+    }
+
+    out << "  ]" << std::endl;
+    out << "}" << std::endl;
+}
+
+void print_table(std::ostream& out, const std::vector<pass_times>& passes){
+    out << std::left << std::setw(12) << "Category" << std::setw(36) << "Pass" << std::right
+        << std::setw(12) << "Time (ms)" << std::setw(8) << "Runs" << std::setw(9) << "Changed"
+        << std::setw(12) << "Before" << std::setw(12) << "After" << std::endl;
+
+    for(auto& pass : passes){
+        out << std::left << std::setw(12) << pass.category << std::setw(36) << pass.name << std::right
+            << std::setw(12) << std::fixed << std::setprecision(3) << pass.time / 1000.0 << std::setw(8) << pass.runs;
+
+        if(pass.report_changed){
+            out << std::setw(9) << pass.changed;
+        } else {
+            out << std::setw(9) << "-";
+        }
+
+        if(pass.report_statements){
+            out << std::setw(12) << pass.before << std::setw(12) << pass.after;
+        } else {
+            out << std::setw(12) << "-" << std::setw(12) << "-";
+        }
+
+        out << std::endl;
+    }
+}
+
+} //end of anonymous namespace
+
+void eddic::enable_time_passes(){
+    enabled = true;
+}
+
+bool eddic::time_passes_enabled(){
+    return enabled;
+}
+
+void eddic::print_time_passes(std::ostream& out, bool json){
+    std::vector<pass_times> passes;
+
+    {
+        std::lock_guard<std::mutex> lock(times_mutex);
+
+        for(auto& pair : times){
+            passes.push_back(pair.second);
+        }
+
+        times.clear();
+    }
+
+    std::stable_sort(passes.begin(), passes.end(), [](const pass_times& lhs, const pass_times& rhs){ return lhs.time > rhs.time; });
+
+    if(json){
+        print_json(out, passes);
+    } else {
+        print_table(out, passes);
+    }
+}
+
+PassTimer::PassTimer(const std::string& category, const std::string& name) : category(category), name(name) {}
+
+PassTimer::PassTimer(const std::string& category, const std::string& name, std::size_t statements) :
+        category(category), name(name), report_statements(true), before(statements), after(statements) {}
+
+void PassTimer::changed(bool changed){
+    report_changed = true;
+    has_changed = changed;
+}
+
+void PassTimer::statements(std::size_t statements){
+    report_statements = true;
+    after = statements;
+}
+
+PassTimer::~PassTimer(){
+    if(!enabled){
+        return;
+    }
+
+    auto elapsed = timer.micro_elapsed();
+
+    std::lock_guard<std::mutex> lock(times_mutex);
+
+    auto& pass = times[std::make_pair(category, name)];
+    pass.category = category;
+    pass.name = name;
+
+    pass.time += elapsed;
+    ++pass.runs;
+
+    if(report_changed){
+        pass.report_changed = true;
+        pass.changed += has_changed;
+    }
+
+    if(report_statements){
+        pass.report_statements = true;
+        pass.before += before;
+        pass.after += after;
+    }
+}
@@ -20,7 +20,7 @@ StringPool::StringPool() : currentString(0) {
 }
 
 std::string StringPool::label(const std::string& value) {
-//    std::lock_guard<std::mutex> lock(mutex);
+    std::lock_guard<std::mutex> lock(mutex);
 
     if (pool.find(value) == pool.end()) {
         std::stringstream ss;
@@ -32,8 +32,29 @@ std::string StringPool::label(const std::string& value) {
     return pool[value];
 }
 
+std::string StringPool::label(const std::string& value, const std::string& scope) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    //The values of the global pool are not modified during the optimization
+    if (pool.find(value) != pool.end()) {
+        return pool[value];
+    }
+
+    auto key = std::make_pair(scope, value);
+
+    if (scoped_pool.find(key) == scoped_pool.end()) {
+        std::stringstream ss;
+        ss << scope;
+        ss << "_S";
+        ss << ++scoped_strings[scope];
+        scoped_pool[key] = ss.str();
+    }
+
+    return scoped_pool[key];
+}
+
 std::string StringPool::value(const std::string& label) const {
-//    std::lock_guard<std::mutex> lock(mutex);
+    std::lock_guard<std::mutex> lock(mutex);
 
     for (auto it : pool){
         if(it.second == label){
@@ -41,10 +62,24 @@ std::string StringPool::value(const std::string& label) const {
         }
     }
 
+    for (auto it : scoped_pool){
+        if(it.second == label){
+            return it.first.second;
+        }
+    }
+
     //This method should not be called on not-existing label
     eddic_unreachable("The label does not exists");
 }
 
-std::unordered_map<std::string, std::string> StringPool::getPool() const {
-    return pool;
+std::vector<std::pair<std::string, std::string>> StringPool::getPool() const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::vector<std::pair<std::string, std::string>> values(pool.begin(), pool.end());
+
+    for (auto it : scoped_pool){
+        values.push_back(std::make_pair(it.first.second, it.second));
+    }
+
+    return values;
 }
@@ -8,8 +8,14 @@
 #include <iostream>
 #include <fstream>
 
+#include <spawn.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
 #include "Utils.hpp"
 
+extern char** environ;
+
 bool eddic::has_extension(const std::string& file, const std::string& extension){
     return file.rfind("." + extension) != std::string::npos;
 }
@@ -35,6 +41,57 @@ std::string eddic::execCommand(const std::string& command) {
     return output.str();
 }
 
+std::string eddic::execCommand(const std::vector<std::string>& arguments, int& status) {
+    std::stringstream output;
+
+    status = -1;
+
+    int pipe_fds[2];
+    if(pipe(pipe_fds) != 0){
+        return "eddic : unable to create a pipe for " + arguments[0];
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addclose(&actions, pipe_fds[0]);
+    posix_spawn_file_actions_adddup2(&actions, pipe_fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addclose(&actions, pipe_fds[1]);
+
+    std::vector<char*> argv;
+    for(auto& argument : arguments){
+        argv.push_back(const_cast<char*>(argument.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    //The program is started directly, without an intermediate shell
+    pid_t pid;
+    int error = posix_spawnp(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+
+    posix_spawn_file_actions_destroy(&actions);
+    close(pipe_fds[1]);
+
+    if(error != 0){
+        close(pipe_fds[0]);
+        return "eddic : unable to execute " + arguments[0];
+    }
+
+    char buffer[1024];
+    ssize_t read_bytes;
+
+    while((read_bytes = read(pipe_fds[0], buffer, sizeof(buffer))) > 0){
+        output.write(buffer, read_bytes);
+    }
+
+    close(pipe_fds[0]);
+
+    int wait_status;
+    if(waitpid(pid, &wait_status, 0) == pid && WIFEXITED(wait_status)){
+        status = WEXITSTATUS(wait_status);
+    }
+
+    return output.str();
+}
+
 bool eddic::isPowerOfTwo (int x){
     return ((x > 0) && !(x & (x - 1)));
 }
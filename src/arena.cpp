@@ -0,0 +1,15 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#include "arena.hpp"
+
+using namespace eddic;
+
+void* eddic::allocate_chunk(std::size_t size){
+    //The nodes can outlive the function that allocated them, the chunks are only released with the process
+    return ::operator new(size);
+}
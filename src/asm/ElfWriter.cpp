@@ -0,0 +1,136 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#include <cstdio>
+#include <fstream>
+
+#include <sys/stat.h>
+
+#include "SemanticalException.hpp"
+
+#include "asm/ElfWriter.hpp"
+
+using namespace eddic;
+
+namespace {
+
+//Same base address and page size than ld for x86_64
+const uint64_t base_address = 0x400000;
+const uint64_t page_size = 0x1000;
+
+const std::size_t elf_header_size = 64;
+const std::size_t program_header_size = 56;
+
+const uint32_t PT_LOAD = 1;
+const uint32_t PT_GNU_STACK = 0x6474e551;
+
+const uint32_t PF_X = 1;
+const uint32_t PF_W = 2;
+const uint32_t PF_R = 4;
+
+std::size_t align(std::size_t value, std::size_t alignment){
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+void put(std::string& out, uint64_t value, int size){
+    for(int i = 0; i < size; ++i){
+        out.push_back(static_cast<char>(value >> (8 * i)));
+    }
+}
+
+void program_header(std::string& out, uint32_t type, uint32_t flags, uint64_t offset, uint64_t address, uint64_t file_size, uint64_t memory_size){
+    put(out, type, 4);
+    put(out, flags, 4);
+    put(out, offset, 8);
+    put(out, address, 8);       //virtual address
+    put(out, address, 8);       //physical address
+    put(out, file_size, 8);
+    put(out, memory_size, 8);
+    put(out, page_size, 8);
+}
+
+} //end of anonymous namespace
+
+as::ElfWriter::ElfWriter(std::size_t text_size, std::size_t data_size, std::size_t bss_size) : text_size(text_size), data_size(data_size), bss_size(bss_size) {
+    //The text segment, the data segment if there are data and the stack segment
+    segments = data_size + bss_size > 0 ? 3 : 2;
+
+    //The text segment also maps the headers so that the file offsets are the same than the addresses
+    text_offset = align(elf_header_size + segments * program_header_size, 16);
+    data_offset = align(text_offset + text_size, 16);
+}
+
+uint64_t as::ElfWriter::text_address() const {
+    return base_address + text_offset;
+}
+
+uint64_t as::ElfWriter::data_address() const {
+    //The data are mapped one page after the text so that their last pages are never shared
+    return base_address + page_size + data_offset;
+}
+
+uint64_t as::ElfWriter::bss_address() const {
+    return data_address() + align(data_size, 16);
+}
+
+void as::ElfWriter::write(const std::string& path, uint64_t entry, const std::string& text, const std::string& data) const {
+    std::string out;
+    out.reserve(data_offset + data_size);
+
+    //ELF identification: 64 bits, little endian, current version, System V ABI
+    out += "\x7f" "ELF";
+    put(out, 2, 1);
+    put(out, 1, 1);
+    put(out, 1, 1);
+    put(out, 0, 9);
+
+    put(out, 2, 2);                             //executable file
+    put(out, 62, 2);                            //x86_64
+    put(out, 1, 4);                             //current version
+    put(out, entry, 8);
+    put(out, elf_header_size, 8);               //program headers offset
+    put(out, 0, 8);                             //no section headers
+    put(out, 0, 4);                             //flags
+    put(out, elf_header_size, 2);
+    put(out, program_header_size, 2);
+    put(out, segments, 2);
+    put(out, 64, 2);                            //section header size
+    put(out, 0, 2);
+    put(out, 0, 2);
+
+    program_header(out, PT_LOAD, PF_R | PF_X, 0, base_address, text_offset + text_size, text_offset + text_size);
+
+    if(segments == 3){
+        program_header(out, PT_LOAD, PF_R | PF_W, data_offset, data_address(), data_size, align(data_size, 16) + bss_size);
+    }
+
+    //The stack does not need to be executable
+    program_header(out, PT_GNU_STACK, PF_R | PF_W, 0, 0, 0, 0);
+
+    out.resize(text_offset, '\0');
+    out += text;
+    out.resize(data_offset, '\0');
+    out += data;
+
+    //Replace the file rather than rewriting it, like ld, in case the executable is still running
+    std::remove(path.c_str());
+
+    std::ofstream stream(path.c_str(), std::ios::binary);
+
+    if(!stream){
+        throw SemanticalException("Unable to open the output file");
+    }
+
+    stream.write(out.data(), out.size());
+    stream.close();
+
+    if(!stream){
+        throw SemanticalException("Unable to write the output file");
+    }
+
+    chmod(path.c_str(), 0755);
+}
@@ -26,3 +26,15 @@ void eddic::as::restore(AssemblyFileWriter& writer, const std::vector<std::strin
         ++it;
     }
 }
+
+ltac::Address eddic::as::after_push(ltac::Address address, int pushed){
+    if(address.base_register){
+        if(auto* ptr = boost::get<ltac::Register>(&*address.base_register)){
+            if(*ptr == ltac::SP){
+                address.displacement = (address.displacement ? *address.displacement : 0) + pushed;
+            }
+        }
+    }
+
+    return address;
+}
@@ -5,6 +5,11 @@
 //  http://www.boost.org/LICENSE_1_0.txt)
 //=======================================================================
 
+#include <fstream>
+#include <vector>
+#include <numeric>
+#include <sstream>
+
 #include "asm/IntelCodeGenerator.hpp"
 
 #include "mtac/Program.hpp"
@@ -17,6 +22,7 @@
 #include "Type.hpp"
 #include "Variable.hpp"
 #include "FloatPool.hpp"
+#include "parallel.hpp"
 
 using namespace eddic;
 
@@ -27,13 +33,34 @@ void as::IntelCodeGenerator::generate(mtac::program_p program, std::shared_ptr<S
 
     writeRuntimeSupport(); 
 
-    for(auto& function : program->functions){
-        compile(function);
+    auto& functions = program->functions;
+
+    //Each function is rendered in its own buffer
+    std::vector<std::size_t> indices(functions.size());
+    std::iota(indices.begin(), indices.end(), 0);
+
+    std::vector<std::string> buffers(functions.size());
+
+    parallel_for_each(indices, worker_threads(), [&](std::size_t i){
+        std::stringstream stream;
+        compile(functions[i], stream);
+        buffers[i] = stream.str();
+    });
+
+    //The buffers are output in the order of the functions in the program
+    for(auto& buffer : buffers){
+        writer.stream() << buffer;
     }
 
     addStandardFunctions();
 
     addGlobalVariables(pool, float_pool);
+
+    //The output buffer of the print functions does not need to be stored in the executable
+    if(is_enabled_flush()){
+        defineBssSection();
+        declareBuffer("_out_buffer", 65536);
+    }
 }
 
 void as::IntelCodeGenerator::addGlobalVariables(std::shared_ptr<StringPool> pool, std::shared_ptr<FloatPool> float_pool){
@@ -100,6 +127,7 @@ void as::IntelCodeGenerator::output_function(const std::string& function){
 
 bool as::IntelCodeGenerator::is_enabled_printI(){
     return context->referenceCount("_F5printI") || 
+            context->referenceCount("_F7printlnI") || 
             context->referenceCount("_F5printB") || 
             context->referenceCount("_F7printlnB") || 
             context->referenceCount("_F5printF") || 
@@ -116,3 +144,20 @@ bool as::IntelCodeGenerator::is_enabled_println(){
             context->referenceCount("_F7printlnF");
 }
 
+bool as::IntelCodeGenerator::is_enabled_printC(){
+    return context->referenceCount("_F5printC") || 
+            context->referenceCount("_F7printlnC");
+}
+
+bool as::IntelCodeGenerator::is_enabled_printS(){
+    return context->referenceCount("_F5printS") || 
+            is_enabled_printI() || 
+            is_enabled_printC() || 
+            is_enabled_println();
+}
+
+bool as::IntelCodeGenerator::is_enabled_flush(){
+    return is_enabled_printS() || 
+            context->referenceCount("_F9read_char") || 
+            context->referenceCount("_bounds_error");
+}
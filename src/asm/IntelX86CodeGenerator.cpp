@@ -89,9 +89,9 @@ using namespace x86;
 namespace {
 
 struct X86StatementCompiler : public boost::static_visitor<> {
-    AssemblyFileWriter& writer;
+    std::ostream& out;
 
-    X86StatementCompiler(AssemblyFileWriter& writer) : writer(writer) {
+    X86StatementCompiler(std::ostream& out) : out(out) {
         //Nothing else to init
     }
 
@@ -101,13 +101,13 @@ struct X86StatementCompiler : public boost::static_visitor<> {
                 if(instruction->size != ltac::Size::DEFAULT){
                     switch(instruction->size){
                         case ltac::Size::BYTE:
-                            writer.stream() << "movzx " << *instruction->arg1 << ", byte " << *instruction->arg2 << '\n';
+                            out << "movzx " << *instruction->arg1 << ", byte " << *instruction->arg2 << '\n';
                             break;
                         case ltac::Size::WORD:
-                            writer.stream() << "movzx " << *instruction->arg1 << ", word " << *instruction->arg2 << '\n';
+                            out << "movzx " << *instruction->arg1 << ", word " << *instruction->arg2 << '\n';
                             break;
                         default:
-                            writer.stream() << "mov " << *instruction->arg1 << ", dword " << *instruction->arg2 << '\n';
+                            out << "mov " << *instruction->arg1 << ", dword " << *instruction->arg2 << '\n';
                             break;
                     }
 
@@ -115,154 +115,189 @@ struct X86StatementCompiler : public boost::static_visitor<> {
                 }
 
                 if(boost::get<ltac::FloatRegister>(&*instruction->arg1) && boost::get<ltac::Register>(&*instruction->arg2)){
-                    writer.stream() << "movd " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                    out << "movd " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 } else if(boost::get<ltac::Register>(&*instruction->arg1) && boost::get<ltac::FloatRegister>(&*instruction->arg2)){
-                    writer.stream() << "movd " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                    out << "movd " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 } else if(boost::get<ltac::Address>(&*instruction->arg1)){
-                    writer.stream() << "mov dword " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                    out << "mov dword " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 } else {
-                    writer.stream() << "mov " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                    out << "mov " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 }
 
                 break;
             case ltac::Operator::FMOV:
                 if(boost::get<ltac::FloatRegister>(&*instruction->arg1) && boost::get<ltac::Register>(&*instruction->arg2)){
-                    writer.stream() << "movd " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                    out << "movd " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 } else {
-                    writer.stream() << "movss " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                    out << "movss " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 }
 
                 break;
             case ltac::Operator::MEMSET:
-                writer.stream() << "mov ecx, " << *instruction->arg2 << '\n';
-                writer.stream() << "xor eax, eax" << '\n';
-                writer.stream() << "lea edi, " << *instruction->arg1 << '\n';
-                writer.stream() << "rep stosw" << '\n';
+                {
+                    //The address can be relative to the stack pointer
+                    ltac::Argument address = as::after_push(boost::get<ltac::Address>(*instruction->arg1), 8);
+
+                    out << "push edi" << '\n';
+                    out << "push ecx" << '\n';
+                    out << "lea edi, " << address << '\n';
+                    out << "mov ecx, " << *instruction->arg2 << '\n';
+                    out << "call _memzero" << '\n';
+                    out << "pop ecx" << '\n';
+                    out << "pop edi" << '\n';
+                }
 
                 break;
             case ltac::Operator::ENTER:
-                writer.stream() << "push ebp" << '\n';
-                writer.stream() << "mov ebp, esp" << '\n';
+                out << "push ebp" << '\n';
+                out << "mov ebp, esp" << '\n';
                 break;
             case ltac::Operator::LEAVE:
-                writer.stream() << "mov esp, ebp" << '\n';
-                writer.stream() << "pop ebp" << '\n';
+                out << "mov esp, ebp" << '\n';
+                out << "pop ebp" << '\n';
                 break;
             case ltac::Operator::RET:
-                writer.stream() << "ret" << '\n';
+                out << "ret" << '\n';
                 break;
             case ltac::Operator::CMP_INT:
-                writer.stream() << "cmp " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "cmp " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::CMP_FLOAT:
-                writer.stream() << "ucomiss " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "ucomiss " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                break;
+            case ltac::Operator::TEST:
+                out << "test " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::OR:
-                writer.stream() << "or " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "or " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::XOR:
-                writer.stream() << "xor " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "xor " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::PUSH:
                 if(boost::get<ltac::Address>(&*instruction->arg1)){
-                    writer.stream() << "push dword " << *instruction->arg1 << '\n';
+                    out << "push dword " << *instruction->arg1 << '\n';
                 } else {
-                    writer.stream() << "push " << *instruction->arg1 << '\n';
+                    out << "push " << *instruction->arg1 << '\n';
                 }
 
                 break;
             case ltac::Operator::POP:
-                writer.stream() << "pop " << *instruction->arg1 << '\n';
+                out << "pop " << *instruction->arg1 << '\n';
                 break;
             case ltac::Operator::LEA:
-                writer.stream() << "lea " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "lea " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::SHIFT_LEFT:
-                writer.stream() << "sal " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "sal " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::SHIFT_RIGHT:
-                writer.stream() << "sar " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "sar " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::ADD:
-                writer.stream() << "add " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "add " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::SUB:
-                writer.stream() << "sub " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "sub " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::MUL2:
             case ltac::Operator::MUL3:
                 if(instruction->arg3){
-                    writer.stream() << "imul " << *instruction->arg1 << ", " << *instruction->arg2 << ", " << *instruction->arg3 << '\n';
+                    out << "imul " << *instruction->arg1 << ", " << *instruction->arg2 << ", " << *instruction->arg3 << '\n';
                 } else {
-                    writer.stream() << "imul " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                    out << "imul " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 }
 
                 break;
             case ltac::Operator::DIV:
-                writer.stream() << "idiv " << *instruction->arg1 << '\n';
+                out << "idiv " << *instruction->arg1 << '\n';
                 break;
             case ltac::Operator::FADD:
-                writer.stream() << "addss " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "addss " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::FSUB:
-                writer.stream() << "subss " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "subss " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::FMUL:
-                writer.stream() << "mulss " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "mulss " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::FDIV:
-                writer.stream() << "divss " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "divss " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::INC:
-                writer.stream() << "inc " << *instruction->arg1 << '\n';
+                out << "inc " << *instruction->arg1 << '\n';
                 break;
             case ltac::Operator::DEC:
-                writer.stream() << "dec " << *instruction->arg1 << '\n';
+                out << "dec " << *instruction->arg1 << '\n';
                 break;
             case ltac::Operator::NEG:
-                writer.stream() << "neg " << *instruction->arg1 << '\n';
+                out << "neg " << *instruction->arg1 << '\n';
                 break;
             case ltac::Operator::NOT:
-                writer.stream() << "not " << *instruction->arg1 << '\n';
+                out << "not " << *instruction->arg1 << '\n';
                 break;
             case ltac::Operator::AND:
-                writer.stream() << "and " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "and " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::I2F:
-                writer.stream() << "cvtsi2ss " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "cvtsi2ss " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::F2I:
-                writer.stream() << "cvttss2si " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "cvttss2si " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                break;
+            case ltac::Operator::PMOV:
+                out << "movdqu " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                break;
+            case ltac::Operator::PADD:
+                out << "paddd " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                break;
+            case ltac::Operator::PSUB:
+                out << "psubd " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                break;
+            case ltac::Operator::PFADD:
+                out << "addps " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                break;
+            case ltac::Operator::PFSUB:
+                out << "subps " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                break;
+            case ltac::Operator::PFMUL:
+                out << "mulps " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                break;
+            case ltac::Operator::PSPLAT:
+                out << "pshufd " << *instruction->arg1 << ", " << *instruction->arg1 << ", 0" << '\n';
+                break;
+            case ltac::Operator::PSHR:
+                out << "psrldq " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::CMOVE:
-                writer.stream() << "cmove " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "cmove " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::CMOVNE:
-                writer.stream() << "cmovne " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "cmovne " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::CMOVA:
-                writer.stream() << "cmova " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "cmova " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::CMOVAE:
-                writer.stream() << "cmovae " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "cmovae " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::CMOVB:
-                writer.stream() << "cmovb " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "cmovb " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::CMOVBE:
-                writer.stream() << "cmovbe " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "cmovbe " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::CMOVG:
-                writer.stream() << "cmovg " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "cmovg " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::CMOVGE:
-                writer.stream() << "cmovge " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "cmovge " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::CMOVL:
-                writer.stream() << "cmovl " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "cmovl " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::CMOVLE:
-                writer.stream() << "cmovle " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "cmovle " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::NOP:
                 //Nothing to output for a nop
@@ -275,49 +310,49 @@ struct X86StatementCompiler : public boost::static_visitor<> {
     void operator()(std::shared_ptr<ltac::Jump> jump){
         switch(jump->type){
             case ltac::JumpType::CALL:
-                writer.stream() << "call " << jump->label << '\n';
+                out << "call " << jump->label << '\n';
                 break;
             case ltac::JumpType::ALWAYS:
-                writer.stream() << "jmp " << "." << jump->label << '\n';
+                out << "jmp " << "." << jump->label << '\n';
                 break;
             case ltac::JumpType::NE:
-                writer.stream() << "jne " << "." << jump->label << '\n';
+                out << "jne " << "." << jump->label << '\n';
                 break;
             case ltac::JumpType::E:
-                writer.stream() << "je " << "." << jump->label << '\n';
+                out << "je " << "." << jump->label << '\n';
                 break;
             case ltac::JumpType::GE:
-                writer.stream() << "jge " << "." << jump->label << '\n';
+                out << "jge " << "." << jump->label << '\n';
                 break;
             case ltac::JumpType::G:
-                writer.stream() << "jg " << "." << jump->label << '\n';
+                out << "jg " << "." << jump->label << '\n';
                 break;
             case ltac::JumpType::LE:
-                writer.stream() << "jle " << "." << jump->label << '\n';
+                out << "jle " << "." << jump->label << '\n';
                 break;
             case ltac::JumpType::L:
-                writer.stream() << "jl " << "." << jump->label << '\n';
+                out << "jl " << "." << jump->label << '\n';
                 break;
             case ltac::JumpType::AE:
-                writer.stream() << "jae " << "." << jump->label << '\n';
+                out << "jae " << "." << jump->label << '\n';
                 break;
             case ltac::JumpType::A:
-                writer.stream() << "ja" << "." << jump->label << '\n';
+                out << "ja " << "." << jump->label << '\n';
                 break;
             case ltac::JumpType::BE:
-                writer.stream() << "jbe " << "." << jump->label << '\n';
+                out << "jbe " << "." << jump->label << '\n';
                 break;
             case ltac::JumpType::B:
-                writer.stream() << "jb " << "." << jump->label << '\n';
+                out << "jb " << "." << jump->label << '\n';
                 break;
             case ltac::JumpType::P:
-                writer.stream() << "jp " << "." << jump->label << '\n';
+                out << "jp " << "." << jump->label << '\n';
                 break;
             case ltac::JumpType::Z:
-                writer.stream() << "jz " << "." << jump->label << '\n';
+                out << "jz " << "." << jump->label << '\n';
                 break;
             case ltac::JumpType::NZ:
-                writer.stream() << "jnz " << "." << jump->label << '\n';
+                out << "jnz " << "." << jump->label << '\n';
                 break;
             default:
                 eddic_unreachable("The jump type is not supported");
@@ -325,16 +360,16 @@ struct X86StatementCompiler : public boost::static_visitor<> {
     }
 
     void operator()(std::string& label){
-        writer.stream() << "." << label << ":" << '\n';
+        out << "." << label << ":" << '\n';
     }
 };
 
 } //end of anonymous namespace
 
-void as::IntelX86CodeGenerator::compile(mtac::function_p function){
-    writer.stream() << '\n' << function->getName() << ":" << '\n';
+void as::IntelX86CodeGenerator::compile(mtac::function_p function, std::ostream& out){
+    out << '\n' << function->getName() << ":" << '\n';
 
-    X86StatementCompiler compiler(writer);
+    X86StatementCompiler compiler(out);
 
     for(auto& bb : function){
         visit_each(compiler, bb->l_statements);
@@ -349,7 +384,7 @@ void as::IntelX86CodeGenerator::writeRuntimeSupport(){
     writer.stream() << "_start:" << '\n';
     
     //If necessary init memory manager 
-    if(context->exists("_F4mainAS") || context->referenceCount("_F4freePI") || context->referenceCount("_F5allocI") || context->referenceCount("_F6concatSS")){
+    if(context->exists("_F4mainAS") || context->referenceCount("_F4freePI") || context->referenceCount("_F5allocI") || context->referenceCount("_F6concatSS") || context->referenceCount("_concatN")){
         writer.stream() << "call _F4init" << '\n'; 
     }
 
@@ -393,7 +428,12 @@ void as::IntelX86CodeGenerator::writeRuntimeSupport(){
     } else {
         writer.stream() << "call _F4main" << '\n';
     }
-    
+
+    /* Write the output that is still in the buffer */
+    if(is_enabled_flush()){
+        writer.stream() << "call _F5flush" << '\n';
+    }
+
     /* Exit the program */
     writer.stream() << "mov eax, 1" << '\n';
     writer.stream() << "xor ebx, ebx" << '\n';
@@ -404,6 +444,10 @@ void as::IntelX86CodeGenerator::defineDataSection(){
     writer.stream() << '\n' << "section .data" << '\n';
 }
 
+void as::IntelX86CodeGenerator::defineBssSection(){
+    writer.stream() << '\n' << "section .bss" << '\n';
+}
+
 void as::IntelX86CodeGenerator::declareIntArray(const std::string& name, unsigned int size){
     writer.stream() << "V" << name << ":" <<'\n';
     writer.stream() << "dd " << size << '\n';
@@ -441,6 +485,10 @@ void as::IntelX86CodeGenerator::declareFloat(const std::string& label, double va
     writer.stream() << std::fixed << label << " dd __float32__(" << value << ")" << '\n';
 }
 
+void as::IntelX86CodeGenerator::declareBuffer(const std::string& name, unsigned int size){
+    writer.stream() << "V" << name << " resb " << size << '\n';
+}
+
 void as::IntelX86CodeGenerator::addStandardFunctions(){
     if(is_enabled_printI()){
         output_function("x86_32_printI");
@@ -450,7 +498,7 @@ void as::IntelX86CodeGenerator::addStandardFunctions(){
         output_function("x86_32_printlnI");
     }
     
-    if(context->referenceCount("_F5printC")){
+    if(is_enabled_printC()){
         output_function("x86_32_printC");
     }
     
@@ -478,7 +526,7 @@ void as::IntelX86CodeGenerator::addStandardFunctions(){
         output_function("x86_32_println");
     }
     
-    if(context->referenceCount("_F5printS") || is_enabled_printI() || is_enabled_println()){ 
+    if(is_enabled_printS()){
         output_function("x86_32_printS");
     }
     
@@ -490,8 +538,28 @@ void as::IntelX86CodeGenerator::addStandardFunctions(){
         output_function("x86_32_concat");
     }
     
+    if(context->referenceCount("_concatN")){
+        output_function("x86_32_concatN");
+    }
+    
+    if(context->referenceCount("_F6concatSS") || context->referenceCount("_concatN")){
+        output_function("x86_32_memcopy");
+    }
+    
+    if(context->referenceCount("_memzero")){
+        output_function("x86_32_memzero");
+    }
+    
+    if(context->referenceCount("_F10str_equalsSS")){
+        output_function("x86_32_str_equals");
+    }
+    
+    if(context->referenceCount("_bounds_error")){
+        output_function("x86_32_bounds_error");
+    }
+    
     //Memory management functions are included the three together
-    if(context->exists("_F4mainAS") || context->referenceCount("_F4freePI") || context->referenceCount("_F5allocI") || context->referenceCount("_F6concatSS")){
+    if(context->exists("_F4mainAS") || context->referenceCount("_F4freePI") || context->referenceCount("_F5allocI") || context->referenceCount("_F6concatSS") || context->referenceCount("_concatN")){
         output_function("x86_32_alloc");
         output_function("x86_32_init");
         output_function("x86_32_free");
@@ -505,6 +573,10 @@ void as::IntelX86CodeGenerator::addStandardFunctions(){
         output_function("x86_32_duration");
     }
     
+    if(is_enabled_flush()){
+        output_function("x86_32_flush");
+    }
+    
     if(context->referenceCount("_F9read_char")){
         output_function("x86_32_read_char");
     }
@@ -92,9 +92,9 @@ using namespace x86_64;
 namespace {
 
 struct X86_64StatementCompiler : public boost::static_visitor<> {
-    AssemblyFileWriter& writer;
+    std::ostream& out;
 
-    X86_64StatementCompiler(AssemblyFileWriter& writer) : writer(writer) {
+    X86_64StatementCompiler(std::ostream& out) : out(out) {
         //Nothing else to init
     }
 
@@ -104,16 +104,16 @@ struct X86_64StatementCompiler : public boost::static_visitor<> {
                 if(instruction->size != ltac::Size::DEFAULT){
                     switch(instruction->size){
                         case ltac::Size::BYTE:
-                            writer.stream() << "movzx " << *instruction->arg1 << ", byte " << *instruction->arg2 << '\n';
+                            out << "movzx " << *instruction->arg1 << ", byte " << *instruction->arg2 << '\n';
                             break;
                         case ltac::Size::WORD:
-                            writer.stream() << "movzx " << *instruction->arg1 << ", word " << *instruction->arg2 << '\n';
+                            out << "movzx " << *instruction->arg1 << ", word " << *instruction->arg2 << '\n';
                             break;
                         case ltac::Size::DOUBLE_WORD:
-                            writer.stream() << "movzx " << *instruction->arg1 << ", dword " << *instruction->arg2 << '\n';
+                            out << "movzx " << *instruction->arg1 << ", dword " << *instruction->arg2 << '\n';
                             break;
                         default:
-                            writer.stream() << "mov " << *instruction->arg1 << ", qword " << *instruction->arg2 << '\n';
+                            out << "mov " << *instruction->arg1 << ", qword " << *instruction->arg2 << '\n';
                             break;
                     }
 
@@ -121,154 +121,189 @@ struct X86_64StatementCompiler : public boost::static_visitor<> {
                 }
 
                 if(boost::get<ltac::FloatRegister>(&*instruction->arg1) && boost::get<ltac::Register>(&*instruction->arg2)){
-                    writer.stream() << "movq " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                    out << "movq " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 } else if(boost::get<ltac::Register>(&*instruction->arg1) && boost::get<ltac::FloatRegister>(&*instruction->arg2)){
-                    writer.stream() << "movq " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                    out << "movq " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 } else if(boost::get<ltac::Address>(&*instruction->arg1)){
-                    writer.stream() << "mov qword " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                    out << "mov qword " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 } else {
-                    writer.stream() << "mov " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                    out << "mov " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 }
 
                 break;
             case ltac::Operator::FMOV:
                 if(boost::get<ltac::FloatRegister>(&*instruction->arg1) && boost::get<ltac::Register>(&*instruction->arg2)){
-                    writer.stream() << "movq " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                    out << "movq " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 } else {
-                    writer.stream() << "movsd " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                    out << "movsd " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 }
 
                 break;
             case ltac::Operator::MEMSET:
-                writer.stream() << "mov rcx, " << *instruction->arg2 << '\n';
-                writer.stream() << "xor rax, rax" << '\n';
-                writer.stream() << "lea rdi, " << *instruction->arg1 << '\n';
-                writer.stream() << "rep stosq" << '\n';
+                {
+                    //The address can be relative to the stack pointer
+                    ltac::Argument address = as::after_push(boost::get<ltac::Address>(*instruction->arg1), 16);
+
+                    out << "push rdi" << '\n';
+                    out << "push rcx" << '\n';
+                    out << "lea rdi, " << address << '\n';
+                    out << "mov rcx, " << *instruction->arg2 << '\n';
+                    out << "call _memzero" << '\n';
+                    out << "pop rcx" << '\n';
+                    out << "pop rdi" << '\n';
+                }
 
                 break;
             case ltac::Operator::ENTER:
-                writer.stream() << "push rbp" << '\n';
-                writer.stream() << "mov rbp, rsp" << '\n';
+                out << "push rbp" << '\n';
+                out << "mov rbp, rsp" << '\n';
                 break;
             case ltac::Operator::LEAVE:
-                writer.stream() << "mov rsp, rbp" << '\n';
-                writer.stream() << "pop rbp" << '\n';
+                out << "mov rsp, rbp" << '\n';
+                out << "pop rbp" << '\n';
                 break;
             case ltac::Operator::RET:
-                writer.stream() << "ret" << '\n';
+                out << "ret" << '\n';
                 break;
             case ltac::Operator::CMP_INT:
-                writer.stream() << "cmp " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "cmp " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::CMP_FLOAT:
-                writer.stream() << "ucomisd " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "ucomisd " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                break;
+            case ltac::Operator::TEST:
+                out << "test " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::OR:
-                writer.stream() << "or " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "or " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::XOR:
-                writer.stream() << "xor " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "xor " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::PUSH:
                 if(boost::get<ltac::Address>(&*instruction->arg1)){
-                    writer.stream() << "push qword " << *instruction->arg1 << '\n';
+                    out << "push qword " << *instruction->arg1 << '\n';
                 } else {
-                    writer.stream() << "push " << *instruction->arg1 << '\n';
+                    out << "push " << *instruction->arg1 << '\n';
                 }
 
                 break;
             case ltac::Operator::POP:
-                writer.stream() << "pop " << *instruction->arg1 << '\n';
+                out << "pop " << *instruction->arg1 << '\n';
                 break;
             case ltac::Operator::LEA:
-                writer.stream() << "lea " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "lea " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::SHIFT_LEFT:
-                writer.stream() << "sal " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "sal " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::SHIFT_RIGHT:
-                writer.stream() << "sar " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "sar " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::ADD:
-                writer.stream() << "add " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "add " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::SUB:
-                writer.stream() << "sub " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "sub " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::MUL2:
             case ltac::Operator::MUL3:
                 if(instruction->arg3){
-                    writer.stream() << "imul " << *instruction->arg1 << ", " << *instruction->arg2 << ", " << *instruction->arg3 << '\n';
+                    out << "imul " << *instruction->arg1 << ", " << *instruction->arg2 << ", " << *instruction->arg3 << '\n';
                 } else {
-                    writer.stream() << "imul " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                    out << "imul " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 }
 
                 break;
             case ltac::Operator::DIV:
-                writer.stream() << "idiv " << *instruction->arg1 << '\n';
+                out << "idiv " << *instruction->arg1 << '\n';
                 break;
             case ltac::Operator::FADD:
-                writer.stream() << "addsd " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "addsd " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::FSUB:
-                writer.stream() << "subsd " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "subsd " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::FMUL:
-                writer.stream() << "mulsd " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "mulsd " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::FDIV:
-                writer.stream() << "divsd " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "divsd " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::INC:
-                writer.stream() << "inc " << *instruction->arg1 << '\n';
+                out << "inc " << *instruction->arg1 << '\n';
                 break;
             case ltac::Operator::DEC:
-                writer.stream() << "dec " << *instruction->arg1 << '\n';
+                out << "dec " << *instruction->arg1 << '\n';
                 break;
             case ltac::Operator::NEG:
-                writer.stream() << "neg " << *instruction->arg1 << '\n';
+                out << "neg " << *instruction->arg1 << '\n';
                 break;
             case ltac::Operator::NOT:
-                writer.stream() << "not " << *instruction->arg1 << '\n';
+                out << "not " << *instruction->arg1 << '\n';
                 break;
             case ltac::Operator::AND:
-                writer.stream() << "and " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "and " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::I2F:
-                writer.stream() << "cvtsi2sd " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "cvtsi2sd " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::F2I:
-                writer.stream() << "cvttsd2si " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "cvttsd2si " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                break;
+            case ltac::Operator::PMOV:
+                out << "movdqu " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                break;
+            case ltac::Operator::PADD:
+                out << "paddq " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                break;
+            case ltac::Operator::PSUB:
+                out << "psubq " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                break;
+            case ltac::Operator::PFADD:
+                out << "addpd " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                break;
+            case ltac::Operator::PFSUB:
+                out << "subpd " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                break;
+            case ltac::Operator::PFMUL:
+                out << "mulpd " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                break;
+            case ltac::Operator::PSPLAT:
+                out << "punpcklqdq " << *instruction->arg1 << ", " << *instruction->arg1 << '\n';
+                break;
+            case ltac::Operator::PSHR:
+                out << "psrldq " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::CMOVE:
-                writer.stream() << "cmove " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "cmove " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::CMOVNE:
-                writer.stream() << "cmovne " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "cmovne " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::CMOVA:
-                writer.stream() << "cmova " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "cmova " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::CMOVAE:
-                writer.stream() << "cmovae " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "cmovae " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::CMOVB:
-                writer.stream() << "cmovb " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "cmovb " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::CMOVBE:
-                writer.stream() << "cmovbe " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "cmovbe " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::CMOVG:
-                writer.stream() << "cmovg " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "cmovg " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::CMOVGE:
-                writer.stream() << "cmovge " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "cmovge " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::CMOVL:
-                writer.stream() << "cmovl " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "cmovl " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::CMOVLE:
-                writer.stream() << "cmovle " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
+                out << "cmovle " << *instruction->arg1 << ", " << *instruction->arg2 << '\n';
                 break;
             case ltac::Operator::NOP:
                 //Nothing to output for a nop
@@ -281,49 +316,49 @@ struct X86_64StatementCompiler : public boost::static_visitor<> {
     void operator()(std::shared_ptr<ltac::Jump> jump){
         switch(jump->type){
             case ltac::JumpType::CALL:
-                writer.stream() << "call " << jump->label << '\n';
+                out << "call " << jump->label << '\n';
                 break;
             case ltac::JumpType::ALWAYS:
-                writer.stream() << "jmp " << "." << jump->label << '\n';
+                out << "jmp " << "." << jump->label << '\n';
                 break;
             case ltac::JumpType::NE:
-                writer.stream() << "jne " << "." << jump->label << '\n';
+                out << "jne " << "." << jump->label << '\n';
                 break;
             case ltac::JumpType::E:
-                writer.stream() << "je " << "." << jump->label << '\n';
+                out << "je " << "." << jump->label << '\n';
                 break;
             case ltac::JumpType::GE:
-                writer.stream() << "jge " << "." << jump->label << '\n';
+                out << "jge " << "." << jump->label << '\n';
                 break;
             case ltac::JumpType::G:
-                writer.stream() << "jg " << "." << jump->label << '\n';
+                out << "jg " << "." << jump->label << '\n';
                 break;
             case ltac::JumpType::LE:
-                writer.stream() << "jle " << "." << jump->label << '\n';
+                out << "jle " << "." << jump->label << '\n';
                 break;
             case ltac::JumpType::L:
-                writer.stream() << "jl " << "." << jump->label << '\n';
+                out << "jl " << "." << jump->label << '\n';
                 break;
             case ltac::JumpType::AE:
-                writer.stream() << "jae " << "." << jump->label << '\n';
+                out << "jae " << "." << jump->label << '\n';
                 break;
             case ltac::JumpType::A:
-                writer.stream() << "ja" << "." << jump->label << '\n';
+                out << "ja " << "." << jump->label << '\n';
                 break;
             case ltac::JumpType::BE:
-                writer.stream() << "jbe " << "." << jump->label << '\n';
+                out << "jbe " << "." << jump->label << '\n';
                 break;
             case ltac::JumpType::B:
-                writer.stream() << "jb " << "." << jump->label << '\n';
+                out << "jb " << "." << jump->label << '\n';
                 break;
             case ltac::JumpType::P:
-                writer.stream() << "jp " << "." << jump->label << '\n';
+                out << "jp " << "." << jump->label << '\n';
                 break;
             case ltac::JumpType::Z:
-                writer.stream() << "jz " << "." << jump->label << '\n';
+                out << "jz " << "." << jump->label << '\n';
                 break;
             case ltac::JumpType::NZ:
-                writer.stream() << "jnz " << "." << jump->label << '\n';
+                out << "jnz " << "." << jump->label << '\n';
                 break;
             default:
                 eddic_unreachable("The jump type is not supported");
@@ -331,16 +366,16 @@ struct X86_64StatementCompiler : public boost::static_visitor<> {
     }
 
     void operator()(std::string& label){
-        writer.stream() << "." << label << ":" << '\n';
+        out << "." << label << ":" << '\n';
     }
 };
 
 } //end of anonymous namespace
 
-void as::IntelX86_64CodeGenerator::compile(mtac::function_p function){
-    writer.stream() << '\n' << function->getName() << ":" << '\n';
+void as::IntelX86_64CodeGenerator::compile(mtac::function_p function, std::ostream& out){
+    out << '\n' << function->getName() << ":" << '\n';
 
-    X86_64StatementCompiler compiler(writer);
+    X86_64StatementCompiler compiler(out);
     
     for(auto& bb : function){
         visit_each(compiler, bb->l_statements);
@@ -355,7 +390,7 @@ void as::IntelX86_64CodeGenerator::writeRuntimeSupport(){
     writer.stream() << "_start:" << '\n';
     
     //If necessary init memory manager 
-    if(context->exists("_F4mainAS") || context->referenceCount("_F4freePI") || context->referenceCount("_F5allocI") || context->referenceCount("_F6concatSS")){
+    if(context->exists("_F4mainAS") || context->referenceCount("_F4freePI") || context->referenceCount("_F5allocI") || context->referenceCount("_F6concatSS") || context->referenceCount("_concatN")){
         writer.stream() << "call _F4init" << '\n'; 
     }
 
@@ -405,6 +440,11 @@ void as::IntelX86_64CodeGenerator::writeRuntimeSupport(){
         writer.stream() << "call _F4main" << '\n';
     }
 
+    //Write the output that is still in the buffer
+    if(is_enabled_flush()){
+        writer.stream() << "call _F5flush" << '\n';
+    }
+
     //Exit from the program
     writer.stream() << "mov rax, 60" << '\n';  //syscall 60 is exit
     writer.stream() << "xor rdi, rdi" << '\n'; //exit code (0 = success)
@@ -415,6 +455,10 @@ void as::IntelX86_64CodeGenerator::defineDataSection(){
     writer.stream() << '\n' << "section .data" << '\n';
 }
 
+void as::IntelX86_64CodeGenerator::defineBssSection(){
+    writer.stream() << '\n' << "section .bss" << '\n';
+}
+
 void as::IntelX86_64CodeGenerator::declareIntArray(const std::string& name, unsigned int size){
     writer.stream() << "V" << name << ":" <<'\n';
     writer.stream() << "dq " << size << '\n';
@@ -452,6 +496,10 @@ void as::IntelX86_64CodeGenerator::declareFloat(const std::string& label, double
     writer.stream() << label << std::fixed << " dq __float64__(" << value << ")" << '\n';
 }
 
+void as::IntelX86_64CodeGenerator::declareBuffer(const std::string& name, unsigned int size){
+    writer.stream() << "V" << name << " resb " << size << '\n';
+}
+
 void as::IntelX86_64CodeGenerator::addStandardFunctions(){
     if(is_enabled_printI()){
         output_function("x86_64_printI");
@@ -461,7 +509,7 @@ void as::IntelX86_64CodeGenerator::addStandardFunctions(){
         output_function("x86_64_printlnI");
     }
     
-    if(context->referenceCount("_F5printC")){
+    if(is_enabled_printC()){
         output_function("x86_64_printC");
     }
     
@@ -489,7 +537,7 @@ void as::IntelX86_64CodeGenerator::addStandardFunctions(){
         output_function("x86_64_println");
     }
     
-    if(context->referenceCount("_F5printS") || is_enabled_printI() || is_enabled_println()){ 
+    if(is_enabled_printS()){
         output_function("x86_64_printS");
     }
    
@@ -501,8 +549,28 @@ void as::IntelX86_64CodeGenerator::addStandardFunctions(){
         output_function("x86_64_concat");
     }
     
+    if(context->referenceCount("_concatN")){
+        output_function("x86_64_concatN");
+    }
+    
+    if(context->referenceCount("_F6concatSS") || context->referenceCount("_concatN")){
+        output_function("x86_64_memcopy");
+    }
+    
+    if(context->referenceCount("_memzero")){
+        output_function("x86_64_memzero");
+    }
+    
+    if(context->referenceCount("_F10str_equalsSS")){
+        output_function("x86_64_str_equals");
+    }
+    
+    if(context->referenceCount("_bounds_error")){
+        output_function("x86_64_bounds_error");
+    }
+    
     //Memory management functions are included the three together
-    if(context->exists("_F4mainAS") || context->referenceCount("_F4freePI") || context->referenceCount("_F5allocI") || context->referenceCount("_F6concatSS")){
+    if(context->exists("_F4mainAS") || context->referenceCount("_F4freePI") || context->referenceCount("_F5allocI") || context->referenceCount("_F6concatSS") || context->referenceCount("_concatN")){
         output_function("x86_64_alloc");
         output_function("x86_64_init");
         output_function("x86_64_free");
@@ -516,6 +584,10 @@ void as::IntelX86_64CodeGenerator::addStandardFunctions(){
         output_function("x86_64_duration");
     }
     
+    if(is_enabled_flush()){
+        output_function("x86_64_flush");
+    }
+    
     if(context->referenceCount("_F9read_char")){
         output_function("x86_64_read_char");
     }
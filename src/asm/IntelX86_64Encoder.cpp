@@ -0,0 +1,1540 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "asm/IntelX86_64Encoder.hpp"
+#include "asm/ElfWriter.hpp"
+
+using namespace eddic;
+
+as::UnsupportedAssembly::UnsupportedAssembly(const std::string& message) : SemanticalException(message) {}
+
+namespace {
+
+/* Lexical analysis of a line */
+
+enum class TokenType : char {
+    IDENTIFIER,
+    NUMBER,
+    STRING,
+    PUNCTUATION
+};
+
+struct Token {
+    TokenType type;
+    std::string value;      //The characters of a string are unescaped
+};
+
+typedef std::vector<Token> Tokens;
+
+bool is_identifier_start(char c){
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == '.' || c == '%' || c == '$' || c == '?' || c == '@';
+}
+
+bool is_identifier_part(char c){
+    return is_identifier_start(c) || (c >= '0' && c <= '9') || c == '#' || c == '~';
+}
+
+char unescape(const char*& it, const char* end){
+    if(it == end){
+        throw as::UnsupportedAssembly("Unterminated string");
+    }
+
+    switch(*it++){
+        case 'n': return '\n';
+        case 't': return '\t';
+        case 'r': return '\r';
+        case '0': return '\0';
+        case 'a': return '\a';
+        case 'b': return '\b';
+        case 'f': return '\f';
+        case 'v': return '\v';
+        case 'e': return 27;
+        case '\\': return '\\';
+        case '`': return '`';
+        case '\'': return '\'';
+        case '"': return '"';
+        case 'x':
+            {
+                int value = 0;
+                for(int i = 0; i < 2 && it != end && isxdigit(*it); ++i){
+                    value = value * 16 + (isdigit(*it) ? *it - '0' : (tolower(*it) - 'a' + 10));
+                    ++it;
+                }
+
+                return static_cast<char>(value);
+            }
+        default:
+            throw as::UnsupportedAssembly("Unsupported escape sequence");
+    }
+}
+
+void tokenize(const char* it, const char* end, Tokens& tokens){
+    tokens.clear();
+
+    while(it != end){
+        char c = *it;
+
+        if(c == ' ' || c == '\t' || c == '\r'){
+            ++it;
+        } else if(c == ';'){
+            return;
+        } else if(c == '"' || c == '\'' || c == '`'){
+            Token token{TokenType::STRING, ""};
+            ++it;
+
+            while(true){
+                if(it == end){
+                    throw as::UnsupportedAssembly("Unterminated string");
+                }
+
+                char current = *it++;
+
+                if(current == c){
+                    break;
+                } else if(current == '\\' && c == '`'){
+                    token.value += unescape(it, end);
+                } else {
+                    token.value += current;
+                }
+            }
+
+            tokens.push_back(std::move(token));
+        } else if(is_identifier_start(c) || (c >= '0' && c <= '9')){
+            auto begin = it;
+
+            while(it != end && is_identifier_part(*it)){
+                ++it;
+            }
+
+            tokens.push_back({is_identifier_start(c) ? TokenType::IDENTIFIER : TokenType::NUMBER, std::string(begin, it)});
+        } else if(c == ',' || c == '[' || c == ']' || c == '+' || c == '-' || c == '*' || c == '(' || c == ')' || c == ':'){
+            tokens.push_back({TokenType::PUNCTUATION, std::string(1, c)});
+            ++it;
+        } else {
+            throw as::UnsupportedAssembly("Unsupported character in assembly");
+        }
+    }
+}
+
+bool is(const Token& token, char punctuation){
+    return token.type == TokenType::PUNCTUATION && token.value[0] == punctuation;
+}
+
+/* Operands */
+
+struct RegisterInfo {
+    int number;
+    int size;           //In bytes, 16 for the SSE registers
+    bool rex;           //The low bytes of rsp, rbp, rsi and rdi can only be accessed with a REX prefix
+};
+
+const RegisterInfo* find_register(const std::string& name){
+    static const std::unordered_map<std::string, RegisterInfo> registers = []{
+        std::unordered_map<std::string, RegisterInfo> registers;
+
+        const char* r64[8] = {"rax", "rcx", "rdx", "rbx", "rsp", "rbp", "rsi", "rdi"};
+        const char* r32[8] = {"eax", "ecx", "edx", "ebx", "esp", "ebp", "esi", "edi"};
+        const char* r16[8] = {"ax", "cx", "dx", "bx", "sp", "bp", "si", "di"};
+        const char* r8[8] = {"al", "cl", "dl", "bl", "spl", "bpl", "sil", "dil"};
+
+        for(int i = 0; i < 8; ++i){
+            registers[r64[i]] = {i, 8, false};
+            registers[r32[i]] = {i, 4, false};
+            registers[r16[i]] = {i, 2, false};
+            registers[r8[i]] = {i, 1, i >= 4};
+        }
+
+        for(int i = 8; i < 16; ++i){
+            auto name = "r" + std::to_string(i);
+
+            registers[name] = {i, 8, false};
+            registers[name + "d"] = {i, 4, false};
+            registers[name + "w"] = {i, 2, false};
+            registers[name + "b"] = {i, 1, false};
+        }
+
+        for(int i = 0; i < 16; ++i){
+            registers["xmm" + std::to_string(i)] = {i, 16, false};
+        }
+
+        return registers;
+    }();
+
+    auto it = registers.find(name);
+    return it == registers.end() ? nullptr : &it->second;
+}
+
+//A memory address or an immediate value: symbol + value + base + index * scale
+struct Expression {
+    int64_t value = 0;
+    std::string symbol;
+    int base = -1;
+    int index = -1;
+    int scale = 1;
+};
+
+enum class OperandType : char {
+    REGISTER,
+    MEMORY,
+    IMMEDIATE
+};
+
+struct Operand {
+    OperandType type;
+    int size = 0;           //In bytes, 0 if not specified
+    int reg = -1;
+    bool rex = false;
+    Expression expression;
+
+    bool gpr() const {
+        return type == OperandType::REGISTER && size != 16;
+    }
+
+    bool xmm() const {
+        return type == OperandType::REGISTER && size == 16;
+    }
+};
+
+bool fits8(int64_t value){
+    return value >= -128 && value <= 127;
+}
+
+bool fits32(int64_t value){
+    return value >= INT32_MIN && value <= INT32_MAX;
+}
+
+int64_t parse_number(const std::string& value){
+    const char* begin = value.c_str();
+    char* end;
+    uint64_t result;
+
+    if(value.size() > 2 && value[0] == '0' && (value[1] == 'x' || value[1] == 'X')){
+        result = strtoull(begin + 2, &end, 16);
+    } else {
+        result = strtoull(begin, &end, 10);
+    }
+
+    if(*end){
+        throw as::UnsupportedAssembly("Unsupported number " + value);
+    }
+
+    return static_cast<int64_t>(result);
+}
+
+//A string used as a number is stored in little endian order
+int64_t character_constant(const std::string& value){
+    if(value.size() > 8){
+        throw as::UnsupportedAssembly("Character constant too long");
+    }
+
+    uint64_t result = 0;
+    for(std::size_t i = 0; i < value.size(); ++i){
+        result |= static_cast<uint64_t>(static_cast<unsigned char>(value[i])) << (8 * i);
+    }
+
+    return static_cast<int64_t>(result);
+}
+
+/* Instructions and directives */
+
+enum class Kind : char {
+    ALU, TEST, MOV, MOVZX, LEA, PUSH, POP, UNARY, IMUL, SHIFT, CMOV, JCC, JMP, CALL, FIXED, REP,
+    SSE, SSE_MOVE, MOVQ, CVTSI2SD, CVTTSD2SI, PMOVMSKB, PSRLDQ,
+    SECTION, GLOBAL, DATA, RESERVE, TIMES
+};
+
+struct Mnemonic {
+    Kind kind;
+    int code;           //Opcode, opcode extension, condition code or size
+    int prefix;         //Mandatory prefix of the SSE instructions, store opcode of the moves
+};
+
+const Mnemonic* find_mnemonic(const std::string& name){
+    static const std::unordered_map<std::string, Mnemonic> mnemonics = []{
+        std::unordered_map<std::string, Mnemonic> mnemonics = {
+            {"add", {Kind::ALU, 0, 0}}, {"or", {Kind::ALU, 1, 0}}, {"and", {Kind::ALU, 4, 0}},
+            {"sub", {Kind::ALU, 5, 0}}, {"xor", {Kind::ALU, 6, 0}}, {"cmp", {Kind::ALU, 7, 0}},
+            {"test", {Kind::TEST, 0, 0}}, {"mov", {Kind::MOV, 0, 0}}, {"movzx", {Kind::MOVZX, 0, 0}}, {"lea", {Kind::LEA, 0, 0}},
+            {"push", {Kind::PUSH, 0, 0}}, {"pop", {Kind::POP, 0, 0}},
+            {"inc", {Kind::UNARY, 0, 0}}, {"dec", {Kind::UNARY, 1, 0}}, {"not", {Kind::UNARY, 2, 0}}, {"neg", {Kind::UNARY, 3, 0}},
+            {"div", {Kind::UNARY, 6, 0}}, {"idiv", {Kind::UNARY, 7, 0}}, {"imul", {Kind::IMUL, 0, 0}},
+            {"sal", {Kind::SHIFT, 4, 0}}, {"shl", {Kind::SHIFT, 4, 0}}, {"shr", {Kind::SHIFT, 5, 0}}, {"sar", {Kind::SHIFT, 7, 0}},
+            {"jmp", {Kind::JMP, 0, 0}}, {"call", {Kind::CALL, 0, 0}},
+            {"ret", {Kind::FIXED, 0xC3, 0}}, {"leave", {Kind::FIXED, 0xC9, 0}}, {"syscall", {Kind::FIXED, 0x0F05, 0}},
+            {"cpuid", {Kind::FIXED, 0x0FA2, 0}}, {"rdtsc", {Kind::FIXED, 0x0F31, 0}},
+            {"movsb", {Kind::FIXED, 0xA4, 0}}, {"stosb", {Kind::FIXED, 0xAA, 0}}, {"stosq", {Kind::FIXED, 0x48AB, 0}},
+            {"cmpsb", {Kind::FIXED, 0xA6, 0}}, {"scasb", {Kind::FIXED, 0xAE, 0}},
+            {"rep", {Kind::REP, 0xF3, 0}}, {"repe", {Kind::REP, 0xF3, 0}}, {"repz", {Kind::REP, 0xF3, 0}},
+            {"repne", {Kind::REP, 0xF2, 0}}, {"repnz", {Kind::REP, 0xF2, 0}},
+            {"addsd", {Kind::SSE, 0x58, 0xF2}}, {"subsd", {Kind::SSE, 0x5C, 0xF2}}, {"mulsd", {Kind::SSE, 0x59, 0xF2}}, {"divsd", {Kind::SSE, 0x5E, 0xF2}},
+            {"ucomisd", {Kind::SSE, 0x2E, 0x66}}, {"addpd", {Kind::SSE, 0x58, 0x66}}, {"subpd", {Kind::SSE, 0x5C, 0x66}}, {"mulpd", {Kind::SSE, 0x59, 0x66}},
+            {"paddq", {Kind::SSE, 0xD4, 0x66}}, {"psubq", {Kind::SSE, 0xFB, 0x66}}, {"punpcklqdq", {Kind::SSE, 0x6C, 0x66}},
+            {"pxor", {Kind::SSE, 0xEF, 0x66}}, {"pcmpeqb", {Kind::SSE, 0x74, 0x66}},
+            {"movsd", {Kind::SSE_MOVE, 0xF210, 0xF211}}, {"movdqu", {Kind::SSE_MOVE, 0xF36F, 0xF37F}}, {"movq", {Kind::MOVQ, 0, 0}},
+            {"cvtsi2sd", {Kind::CVTSI2SD, 0, 0}}, {"cvttsd2si", {Kind::CVTTSD2SI, 0, 0}},
+            {"pmovmskb", {Kind::PMOVMSKB, 0, 0}}, {"psrldq", {Kind::PSRLDQ, 0, 0}},
+            {"section", {Kind::SECTION, 0, 0}}, {"segment", {Kind::SECTION, 0, 0}}, {"global", {Kind::GLOBAL, 0, 0}},
+            {"db", {Kind::DATA, 1, 0}}, {"dw", {Kind::DATA, 2, 0}}, {"dd", {Kind::DATA, 4, 0}}, {"dq", {Kind::DATA, 8, 0}},
+            {"resb", {Kind::RESERVE, 1, 0}}, {"resw", {Kind::RESERVE, 2, 0}}, {"resd", {Kind::RESERVE, 4, 0}}, {"resq", {Kind::RESERVE, 8, 0}},
+            {"times", {Kind::TIMES, 0, 0}}
+        };
+
+        const char* conditions[16][3] = {
+            {"o", 0, 0}, {"no", 0, 0}, {"b", "c", "nae"}, {"ae", "nb", "nc"}, {"e", "z", 0}, {"ne", "nz", 0}, {"be", "na", 0}, {"a", "nbe", 0},
+            {"s", 0, 0}, {"ns", 0, 0}, {"p", "pe", 0}, {"np", "po", 0}, {"l", "nge", 0}, {"ge", "nl", 0}, {"le", "ng", 0}, {"g", "nle", 0}};
+
+        for(int i = 0; i < 16; ++i){
+            for(auto condition : conditions[i]){
+                if(condition){
+                    mnemonics[std::string("j") + condition] = {Kind::JCC, i, 0};
+                    mnemonics[std::string("cmov") + condition] = {Kind::CMOV, i, 0};
+                }
+            }
+        }
+
+        return mnemonics;
+    }();
+
+    auto it = mnemonics.find(name);
+    return it == mnemonics.end() ? nullptr : &it->second;
+}
+
+enum class Section : char {
+    TEXT,
+    DATA,
+    BSS
+};
+
+enum class RelocationType : char {
+    ABSOLUTE_32,        //Absolute address stored on 32 bits
+    ABSOLUTE_64,        //Absolute address stored on 64 bits
+    RELATIVE_32         //Address relative to the end of the field, stored on 32 bits
+};
+
+struct Relocation {
+    std::size_t offset;
+    RelocationType type;
+    std::string symbol;
+    int64_t addend;
+};
+
+const int NO_JUMP = -1;
+const int ALWAYS = 16;
+
+/*!
+ * A sequence of bytes, ended by a jump whose size depends on the distance to its target.
+ */
+struct Fragment {
+    std::string bytes;
+    std::vector<Relocation> relocations;
+
+    int jump = NO_JUMP;         //Condition code of the jump or ALWAYS
+    std::string target;
+    bool near = false;
+
+    std::size_t address = 0;    //Offset in the section
+
+    std::size_t jump_size() const {
+        if(jump == NO_JUMP){
+            return 0;
+        }
+
+        return near ? (jump == ALWAYS ? 5 : 6) : 2;
+    }
+
+    std::size_t size() const {
+        return bytes.size() + jump_size();
+    }
+};
+
+struct Symbol {
+    Section section;
+    std::size_t fragment;
+    std::size_t offset;
+};
+
+struct Line {
+    const char* begin;
+    const char* end;
+};
+
+class Encoder {
+    public:
+        Encoder(){
+            text.emplace_back();
+            data.emplace_back();
+        }
+
+        void assemble(const std::vector<Line>& lines, std::size_t begin, std::size_t end);
+        void link(const std::string& output);
+
+    private:
+        std::vector<Fragment> text;
+        std::vector<Fragment> data;
+        std::size_t bss = 0;
+
+        Section section = Section::TEXT;
+
+        std::unordered_map<std::string, Symbol> symbols;
+        std::string scope;          //The last non-local label
+
+        Tokens tokens;
+
+        Fragment& out(){
+            if(section == Section::BSS){
+                throw as::UnsupportedAssembly("Only space can be reserved in the bss section");
+            }
+
+            return section == Section::TEXT ? text.back() : data.back();
+        }
+
+        void byte(int value){
+            out().bytes.push_back(static_cast<char>(value));
+        }
+
+        void bytes(uint64_t value, int size){
+            auto& bytes = out().bytes;
+
+            for(int i = 0; i < size; ++i){
+                bytes.push_back(static_cast<char>(value >> (8 * i)));
+            }
+        }
+
+        void relocation(RelocationType type, const std::string& symbol, int64_t addend, int size){
+            auto& fragment = out();
+            fragment.relocations.push_back({fragment.bytes.size(), type, symbol, addend});
+            bytes(0, size);
+        }
+
+        std::string symbol_name(const std::string& name) const {
+            return name[0] == '.' ? scope + name : name;
+        }
+
+        void define(const std::string& label);
+
+        void statement(std::size_t i);
+        void instruction(const Mnemonic& mnemonic, std::size_t i);
+        void directive(const Mnemonic& mnemonic, std::size_t i);
+
+        std::vector<Operand> operands(std::size_t i);
+        Operand operand(std::size_t i, std::size_t end);
+        Expression expression(std::size_t i, std::size_t end, bool memory);
+        int64_t constant(std::size_t i, std::size_t end);
+
+        void encode(int prefix, bool w, std::initializer_list<int> opcode, int reg, const Operand& rm, int trailing = 0, bool rex = false);
+        void displacement(const Expression& address);
+        void immediate(const Expression& expression, int size);
+        void with_register(bool w, int opcode, const Operand& reg);
+
+        void alu(const Mnemonic& mnemonic, const Operand& dst, const Operand& src);
+        void test(const Operand& dst, const Operand& src);
+        void mov(const Operand& dst, const Operand& src);
+        void jump(int condition, const Operand& target);
+
+        std::size_t address(const std::string& name, uint64_t text_address, uint64_t data_address, uint64_t bss_address) const;
+        void resolve(Fragment& fragment, uint64_t address, uint64_t text_address, uint64_t data_address, uint64_t bss_address) const;
+};
+
+int operand_size(const Operand& operand){
+    if(!operand.size){
+        throw as::UnsupportedAssembly("Operation size not specified");
+    }
+
+    return operand.size;
+}
+
+int size_prefix(int size){
+    return size == 2 ? 0x66 : 0;
+}
+
+void check_size(const Operand& operand, int size){
+    if(operand.size && operand.size != size){
+        throw as::UnsupportedAssembly("Mismatch in operand sizes");
+    }
+}
+
+//Encode an instruction with a ModR/M byte: [prefix] [REX] opcode ModR/M [SIB] [displacement]
+//The immediate is output by the caller, its size is necessary for the addresses relative to rip
+void Encoder::encode(int prefix, bool w, std::initializer_list<int> opcode, int reg, const Operand& rm, int trailing, bool rex){
+    if(prefix){
+        byte(prefix);
+    }
+
+    auto& address = rm.expression;
+
+    int r = reg >= 8;
+    int x = rm.type == OperandType::MEMORY && address.index >= 8;
+    int b = rm.type == OperandType::REGISTER ? rm.reg >= 8 : address.base >= 8;
+
+    if(w || r || x || b || rex || rm.rex){
+        byte(0x40 | (w << 3) | (r << 2) | (x << 1) | b);
+    }
+
+    for(auto code : opcode){
+        byte(code);
+    }
+
+    reg &= 7;
+
+    if(rm.type == OperandType::REGISTER){
+        byte(0xC0 | (reg << 3) | (rm.reg & 7));
+        return;
+    }
+
+    if(rm.type != OperandType::MEMORY){
+        throw as::UnsupportedAssembly("Invalid operand");
+    }
+
+    //Absolute address, the symbols are addressed relatively to rip
+    if(address.base < 0 && address.index < 0){
+        if(address.symbol.empty()){
+            byte((reg << 3) | 4);
+            byte(0x25);
+            displacement(address);
+        } else {
+            byte((reg << 3) | 5);
+            relocation(RelocationType::RELATIVE_32, address.symbol, address.value - trailing, 4);
+        }
+
+        return;
+    }
+
+    int base = address.base;
+    int index = address.index;
+    int scale = address.scale;
+
+    if(index == 4){
+        if(scale != 1 || base == 4){
+            throw as::UnsupportedAssembly("rsp cannot be used as index");
+        }
+
+        std::swap(base, index);
+    }
+
+    int mode;
+    if(base < 0 || !address.symbol.empty() || !fits8(address.value)){
+        mode = 2;
+    } else if(address.value || (base & 7) == 5){
+        mode = 1;
+    } else {
+        mode = 0;
+    }
+
+    if(index < 0 && (base & 7) != 4){
+        byte((mode << 6) | (reg << 3) | (base & 7));
+    } else {
+        int scale_bits = scale == 1 ? 0 : scale == 2 ? 1 : scale == 4 ? 2 : 3;
+
+        if(base < 0){
+            //No base register, only a 32 bits displacement
+            mode = 0;
+            base = 5;
+        }
+
+        byte((mode << 6) | (reg << 3) | 4);
+        byte((scale_bits << 6) | ((index < 0 ? 4 : index) & 7) << 3 | (base & 7));
+
+        if(address.base < 0){
+            displacement(address);
+            return;
+        }
+    }
+
+    if(mode == 1){
+        bytes(address.value, 1);
+    } else if(mode == 2){
+        displacement(address);
+    }
+}
+
+void Encoder::displacement(const Expression& address){
+    if(!address.symbol.empty()){
+        relocation(RelocationType::ABSOLUTE_32, address.symbol, address.value, 4);
+    } else if(fits32(address.value)){
+        bytes(address.value, 4);
+    } else {
+        throw as::UnsupportedAssembly("Displacement does not fit in 32 bits");
+    }
+}
+
+void Encoder::immediate(const Expression& expression, int size){
+    if(expression.base >= 0 || expression.index >= 0){
+        throw as::UnsupportedAssembly("Registers cannot be used in an immediate value");
+    }
+
+    if(expression.symbol.empty()){
+        bytes(expression.value, size);
+    } else if(size == 4){
+        relocation(RelocationType::ABSOLUTE_32, expression.symbol, expression.value, 4);
+    } else if(size == 8){
+        relocation(RelocationType::ABSOLUTE_64, expression.symbol, expression.value, 8);
+    } else {
+        throw as::UnsupportedAssembly("Address does not fit in the immediate value");
+    }
+}
+
+//Encode an instruction whose register is encoded in the opcode
+void Encoder::with_register(bool w, int opcode, const Operand& reg){
+    if(w || reg.reg >= 8 || reg.rex){
+        byte(0x40 | (w << 3) | (reg.reg >= 8));
+    }
+
+    byte(opcode + (reg.reg & 7));
+}
+
+void Encoder::alu(const Mnemonic& mnemonic, const Operand& dst, const Operand& src){
+    int extension = mnemonic.code;
+
+    if(src.type == OperandType::IMMEDIATE && dst.type != OperandType::IMMEDIATE){
+        int size = operand_size(dst);
+        auto& value = src.expression;
+
+        if(size == 1){
+            encode(0, false, {0x80}, extension, dst, 1);
+            immediate(value, 1);
+        } else if(value.symbol.empty() && fits8(value.value)){
+            encode(size_prefix(size), size == 8, {0x83}, extension, dst, 1);
+            immediate(value, 1);
+        } else {
+            if(size == 8 && value.symbol.empty() && !fits32(value.value)){
+                throw as::UnsupportedAssembly("Immediate value does not fit in 32 bits");
+            }
+
+            int immediate_size = size == 2 ? 2 : 4;
+            encode(size_prefix(size), size == 8, {0x81}, extension, dst, immediate_size);
+            immediate(value, immediate_size);
+        }
+    } else if(src.gpr() && dst.type != OperandType::IMMEDIATE && !dst.xmm()){
+        check_size(dst, src.size);
+        encode(size_prefix(src.size), src.size == 8, {extension * 8 + (src.size == 1 ? 0 : 1)}, src.reg, dst, 0, src.rex);
+    } else if(dst.gpr() && src.type == OperandType::MEMORY){
+        check_size(src, dst.size);
+        encode(size_prefix(dst.size), dst.size == 8, {extension * 8 + (dst.size == 1 ? 2 : 3)}, dst.reg, src, 0, dst.rex);
+    } else {
+        throw as::UnsupportedAssembly("Invalid combination of operands");
+    }
+}
+
+void Encoder::test(const Operand& dst, const Operand& src){
+    if(src.type == OperandType::IMMEDIATE && dst.type != OperandType::IMMEDIATE){
+        int size = operand_size(dst);
+        int immediate_size = size == 8 ? 4 : size;
+
+        if(size == 8 && src.expression.symbol.empty() && !fits32(src.expression.value)){
+            throw as::UnsupportedAssembly("Immediate value does not fit in 32 bits");
+        }
+
+        encode(size_prefix(size), size == 8, {size == 1 ? 0xF6 : 0xF7}, 0, dst, immediate_size);
+        immediate(src.expression, immediate_size);
+    } else if(src.gpr() && dst.type != OperandType::IMMEDIATE && !dst.xmm()){
+        check_size(dst, src.size);
+        encode(size_prefix(src.size), src.size == 8, {src.size == 1 ? 0x84 : 0x85}, src.reg, dst, 0, src.rex);
+    } else if(dst.gpr() && src.type == OperandType::MEMORY){
+        test(src, dst);
+    } else {
+        throw as::UnsupportedAssembly("Invalid combination of operands");
+    }
+}
+
+void Encoder::mov(const Operand& dst, const Operand& src){
+    if(dst.gpr() && src.type == OperandType::IMMEDIATE){
+        auto& value = src.expression;
+
+        switch(dst.size){
+            case 1:
+                with_register(false, 0xB0, dst);
+                immediate(value, 1);
+                break;
+            case 2:
+                byte(0x66);
+                with_register(false, 0xB8, dst);
+                immediate(value, 2);
+                break;
+            case 4:
+                with_register(false, 0xB8, dst);
+                immediate(value, 4);
+                break;
+            default:
+                //The 32 bits moves are zero extended, the addresses of the static executable always fit
+                if(!value.symbol.empty() || (value.value >= 0 && value.value <= UINT32_MAX)){
+                    with_register(false, 0xB8, dst);
+                    immediate(value, 4);
+                } else if(fits32(value.value)){
+                    encode(0, true, {0xC7}, 0, dst, 4);
+                    immediate(value, 4);
+                } else {
+                    with_register(true, 0xB8, dst);
+                    immediate(value, 8);
+                }
+        }
+    } else if(dst.type == OperandType::MEMORY && src.type == OperandType::IMMEDIATE){
+        int size = operand_size(dst);
+        int immediate_size = size == 8 ? 4 : size;
+
+        if(size == 8 && src.expression.symbol.empty() && !fits32(src.expression.value)){
+            throw as::UnsupportedAssembly("Immediate value does not fit in 32 bits");
+        }
+
+        encode(size_prefix(size), size == 8, {size == 1 ? 0xC6 : 0xC7}, 0, dst, immediate_size);
+        immediate(src.expression, immediate_size);
+    } else if(src.gpr() && (dst.gpr() || dst.type == OperandType::MEMORY)){
+        check_size(dst, src.size);
+        encode(size_prefix(src.size), src.size == 8, {src.size == 1 ? 0x88 : 0x89}, src.reg, dst, 0, src.rex);
+    } else if(dst.gpr() && src.type == OperandType::MEMORY){
+        check_size(src, dst.size);
+        encode(size_prefix(dst.size), dst.size == 8, {dst.size == 1 ? 0x8A : 0x8B}, dst.reg, src, 0, dst.rex);
+    } else {
+        throw as::UnsupportedAssembly("Invalid combination of operands");
+    }
+}
+
+void Encoder::jump(int condition, const Operand& target){
+    if(target.type != OperandType::IMMEDIATE || target.expression.symbol.empty() || target.expression.value){
+        throw as::UnsupportedAssembly("Only jumps to labels are supported");
+    }
+
+    if(section != Section::TEXT){
+        throw as::UnsupportedAssembly("Jumps are only supported in the text section");
+    }
+
+    //The size of the jump is only known once all the code is known
+    text.back().jump = condition;
+    text.back().target = target.expression.symbol;
+
+    text.emplace_back();
+}
+
+void Encoder::define(const std::string& label){
+    std::string name;
+    if(label[0] == '.'){
+        name = scope + label;
+    } else {
+        name = scope = label;
+    }
+
+    Symbol symbol{section, 0, bss};
+    if(section != Section::BSS){
+        auto& fragments = section == Section::TEXT ? text : data;
+        symbol = {section, fragments.size() - 1, fragments.back().bytes.size()};
+    }
+
+    if(!symbols.insert({name, symbol}).second){
+        throw as::UnsupportedAssembly("Symbol " + name + " redefined");
+    }
+}
+
+Expression Encoder::expression(std::size_t i, std::size_t end, bool memory){
+    Expression result;
+
+    while(i < end){
+        int sign = 1;
+        while(i < end && (is(tokens[i], '+') || is(tokens[i], '-'))){
+            if(is(tokens[i], '-')){
+                sign = -sign;
+            }
+
+            ++i;
+        }
+
+        //A term is a product of factors
+        int64_t coefficient = sign;
+        int reg = -1;
+        std::string symbol;
+
+        while(true){
+            if(i >= end){
+                throw as::UnsupportedAssembly("Invalid expression");
+            }
+
+            auto& token = tokens[i++];
+
+            if(is(token, '-')){
+                coefficient = -coefficient;
+                continue;
+            } else if(token.type == TokenType::NUMBER){
+                coefficient *= parse_number(token.value);
+            } else if(token.type == TokenType::STRING){
+                coefficient *= character_constant(token.value);
+            } else if(token.type == TokenType::IDENTIFIER && token.value == "__float64__"){
+                if(i + 1 >= end || !is(tokens[i], '(')){
+                    throw as::UnsupportedAssembly("Invalid float constant");
+                }
+
+                std::string text;
+                for(++i; i < end && !is(tokens[i], ')'); ++i){
+                    text += tokens[i].value;
+                }
+
+                if(i++ >= end){
+                    throw as::UnsupportedAssembly("Invalid float constant");
+                }
+
+                char* last;
+                double value = strtod(text.c_str(), &last);
+
+                if(*last){
+                    throw as::UnsupportedAssembly("Invalid float constant " + text);
+                }
+
+                int64_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                coefficient *= bits;
+            } else if(token.type == TokenType::IDENTIFIER){
+                if(auto* info = find_register(token.value)){
+                    if(!memory || info->size != 8 || reg >= 0 || !symbol.empty()){
+                        throw as::UnsupportedAssembly("Invalid use of register " + token.value);
+                    }
+
+                    reg = info->number;
+                } else {
+                    if(reg >= 0 || !symbol.empty()){
+                        throw as::UnsupportedAssembly("Invalid expression");
+                    }
+
+                    symbol = symbol_name(token.value);
+                }
+            } else {
+                throw as::UnsupportedAssembly("Invalid expression");
+            }
+
+            if(i < end && is(tokens[i], '*')){
+                ++i;
+            } else {
+                break;
+            }
+        }
+
+        if(reg >= 0){
+            if(coefficient == 1 && result.base < 0){
+                result.base = reg;
+            } else if(result.index < 0 && (coefficient == 1 || coefficient == 2 || coefficient == 4 || coefficient == 8)){
+                result.index = reg;
+                result.scale = coefficient;
+            } else {
+                throw as::UnsupportedAssembly("Invalid address");
+            }
+        } else if(!symbol.empty()){
+            if(coefficient != 1 || !result.symbol.empty()){
+                throw as::UnsupportedAssembly("Invalid use of symbol " + symbol);
+            }
+
+            result.symbol = symbol;
+        } else {
+            result.value += coefficient;
+        }
+
+        if(i < end && !is(tokens[i], '+') && !is(tokens[i], '-')){
+            throw as::UnsupportedAssembly("Invalid expression");
+        }
+    }
+
+    return result;
+}
+
+int64_t Encoder::constant(std::size_t i, std::size_t end){
+    auto value = expression(i, end, false);
+
+    if(!value.symbol.empty()){
+        throw as::UnsupportedAssembly("A constant is necessary");
+    }
+
+    return value.value;
+}
+
+Operand Encoder::operand(std::size_t i, std::size_t end){
+    Operand result;
+    result.type = OperandType::IMMEDIATE;
+
+    if(i < end && tokens[i].type == TokenType::IDENTIFIER){
+        auto& value = tokens[i].value;
+
+        if(value == "byte"){
+            result.size = 1;
+        } else if(value == "word"){
+            result.size = 2;
+        } else if(value == "dword"){
+            result.size = 4;
+        } else if(value == "qword"){
+            result.size = 8;
+        } else if(value == "oword"){
+            result.size = 16;
+        }
+
+        if(result.size){
+            ++i;
+        }
+    }
+
+    if(i >= end){
+        throw as::UnsupportedAssembly("Missing operand");
+    }
+
+    if(is(tokens[i], '[')){
+        if(!is(tokens[end - 1], ']')){
+            throw as::UnsupportedAssembly("Invalid memory operand");
+        }
+
+        result.type = OperandType::MEMORY;
+        result.expression = expression(i + 1, end - 1, true);
+    } else if(i + 1 == end && tokens[i].type == TokenType::IDENTIFIER && find_register(tokens[i].value)){
+        auto* info = find_register(tokens[i].value);
+
+        if(result.size && result.size != info->size){
+            throw as::UnsupportedAssembly("Mismatch in operand sizes");
+        }
+
+        result.type = OperandType::REGISTER;
+        result.size = info->size;
+        result.reg = info->number;
+        result.rex = info->rex;
+    } else {
+        result.expression = expression(i, end, false);
+    }
+
+    return result;
+}
+
+std::vector<Operand> Encoder::operands(std::size_t i){
+    std::vector<Operand> operands;
+
+    if(i == tokens.size()){
+        return operands;
+    }
+
+    std::size_t begin = i;
+    int depth = 0;
+
+    for(; i < tokens.size(); ++i){
+        if(is(tokens[i], '[')){
+            ++depth;
+        } else if(is(tokens[i], ']')){
+            --depth;
+        } else if(is(tokens[i], ',') && depth == 0){
+            operands.push_back(operand(begin, i));
+            begin = i + 1;
+        }
+    }
+
+    operands.push_back(operand(begin, i));
+
+    return operands;
+}
+
+void Encoder::statement(std::size_t i){
+    if(i == tokens.size()){
+        return;
+    }
+
+    auto& first = tokens[i];
+
+    if(first.type != TokenType::IDENTIFIER){
+        throw as::UnsupportedAssembly("Invalid statement");
+    }
+
+    //Label with a colon
+    if(i + 1 < tokens.size() && is(tokens[i + 1], ':')){
+        define(first.value);
+        statement(i + 2);
+        return;
+    }
+
+    auto* mnemonic = find_mnemonic(first.value);
+
+    if(!mnemonic){
+        //Label without a colon, it must be followed by something on the same line
+        if(i + 1 == tokens.size()){
+            throw as::UnsupportedAssembly("Unknown instruction " + first.value);
+        }
+
+        define(first.value);
+        statement(i + 1);
+        return;
+    }
+
+    switch(mnemonic->kind){
+        case Kind::SECTION:
+        case Kind::GLOBAL:
+        case Kind::DATA:
+        case Kind::RESERVE:
+        case Kind::TIMES:
+            directive(*mnemonic, i + 1);
+            break;
+        default:
+            if(section != Section::TEXT){
+                throw as::UnsupportedAssembly("Instructions are only supported in the text section");
+            }
+
+            instruction(*mnemonic, i + 1);
+    }
+}
+
+void Encoder::directive(const Mnemonic& mnemonic, std::size_t i){
+    switch(mnemonic.kind){
+        case Kind::SECTION:
+            if(i + 1 != tokens.size()){
+                throw as::UnsupportedAssembly("Invalid section directive");
+            } else if(tokens[i].value == ".text"){
+                section = Section::TEXT;
+            } else if(tokens[i].value == ".data"){
+                section = Section::DATA;
+            } else if(tokens[i].value == ".bss"){
+                section = Section::BSS;
+            } else {
+                throw as::UnsupportedAssembly("Unsupported section " + tokens[i].value);
+            }
+
+            break;
+        case Kind::GLOBAL:
+            //There is no symbol table in the executable
+            break;
+        case Kind::DATA:
+            {
+                int size = mnemonic.code;
+
+                std::size_t begin = i;
+                for(; i <= tokens.size(); ++i){
+                    if(i < tokens.size() && !is(tokens[i], ',')){
+                        continue;
+                    }
+
+                    if(begin == i){
+                        throw as::UnsupportedAssembly("Missing data");
+                    }
+
+                    //The strings are padded to a multiple of the size
+                    if(i == begin + 1 && tokens[begin].type == TokenType::STRING){
+                        auto& value = tokens[begin].value;
+                        out().bytes += value;
+                        bytes(0, (size - value.size() % size) % size);
+                    } else {
+                        immediate(expression(begin, i, false), size);
+                    }
+
+                    begin = i + 1;
+                }
+            }
+
+            break;
+        case Kind::RESERVE:
+            {
+                int64_t count = constant(i, tokens.size());
+
+                if(count < 0){
+                    throw as::UnsupportedAssembly("Invalid size");
+                }
+
+                if(section == Section::BSS){
+                    bss += count * mnemonic.code;
+                } else {
+                    out().bytes.append(count * mnemonic.code, '\0');
+                }
+            }
+
+            break;
+        case Kind::TIMES:
+            {
+                if(i + 1 >= tokens.size()){
+                    throw as::UnsupportedAssembly("Invalid times directive");
+                }
+
+                int64_t count = constant(i, i + 1);
+
+                for(int64_t j = 0; j < count; ++j){
+                    statement(i + 1);
+                }
+            }
+
+            break;
+        default:
+            throw as::UnsupportedAssembly("Invalid directive");
+    }
+}
+
+void Encoder::instruction(const Mnemonic& mnemonic, std::size_t i){
+    if(mnemonic.kind == Kind::REP){
+        auto* next = i < tokens.size() ? find_mnemonic(tokens[i].value) : nullptr;
+
+        if(!next || next->kind != Kind::FIXED || i + 1 != tokens.size()){
+            throw as::UnsupportedAssembly("Invalid use of a repeat prefix");
+        }
+
+        byte(mnemonic.code);
+        instruction(*next, i + 1);
+        return;
+    }
+
+    auto args = operands(i);
+
+    auto arity = [&args](std::size_t count){
+        if(args.size() != count){
+            throw as::UnsupportedAssembly("Invalid number of operands");
+        }
+    };
+
+    switch(mnemonic.kind){
+        case Kind::ALU:
+            arity(2);
+            alu(mnemonic, args[0], args[1]);
+            break;
+        case Kind::TEST:
+            arity(2);
+            test(args[0], args[1]);
+            break;
+        case Kind::MOV:
+            arity(2);
+            mov(args[0], args[1]);
+            break;
+        case Kind::MOVZX:
+            {
+                arity(2);
+                auto& dst = args[0];
+                auto& src = args[1];
+                int size = operand_size(src);
+
+                if(!dst.gpr() || dst.size == 1 || (size != 1 && size != 2) || src.xmm() || src.type == OperandType::IMMEDIATE){
+                    throw as::UnsupportedAssembly("Invalid combination of operands");
+                }
+
+                encode(size_prefix(dst.size), dst.size == 8, {0x0F, size == 1 ? 0xB6 : 0xB7}, dst.reg, src, 0, src.rex);
+            }
+
+            break;
+        case Kind::LEA:
+            arity(2);
+
+            if(!args[0].gpr() || args[0].size == 1 || args[1].type != OperandType::MEMORY){
+                throw as::UnsupportedAssembly("Invalid combination of operands");
+            }
+
+            encode(size_prefix(args[0].size), args[0].size == 8, {0x8D}, args[0].reg, args[1]);
+            break;
+        case Kind::PUSH:
+            arity(1);
+
+            if(args[0].gpr() && args[0].size == 8){
+                with_register(false, 0x50, args[0]);
+            } else if(args[0].type == OperandType::MEMORY){
+                check_size(args[0], 8);
+                encode(0, false, {0xFF}, 6, args[0]);
+            } else if(args[0].type == OperandType::IMMEDIATE){
+                auto& value = args[0].expression;
+
+                if(value.symbol.empty() && fits8(value.value)){
+                    byte(0x6A);
+                    immediate(value, 1);
+                } else if(value.symbol.empty() && !fits32(value.value)){
+                    throw as::UnsupportedAssembly("Immediate value does not fit in 32 bits");
+                } else {
+                    byte(0x68);
+                    immediate(value, 4);
+                }
+            } else {
+                throw as::UnsupportedAssembly("Invalid operand");
+            }
+
+            break;
+        case Kind::POP:
+            arity(1);
+
+            if(args[0].gpr() && args[0].size == 8){
+                with_register(false, 0x58, args[0]);
+            } else if(args[0].type == OperandType::MEMORY){
+                check_size(args[0], 8);
+                encode(0, false, {0x8F}, 0, args[0]);
+            } else {
+                throw as::UnsupportedAssembly("Invalid operand");
+            }
+
+            break;
+        case Kind::UNARY:
+            {
+                arity(1);
+
+                if(args[0].type == OperandType::IMMEDIATE || args[0].xmm()){
+                    throw as::UnsupportedAssembly("Invalid operand");
+                }
+
+                int size = operand_size(args[0]);
+                int opcode = mnemonic.code < 2 ? 0xFE : 0xF6;
+
+                encode(size_prefix(size), size == 8, {size == 1 ? opcode : opcode + 1}, mnemonic.code, args[0], 0, args[0].rex);
+            }
+
+            break;
+        case Kind::IMUL:
+            {
+                //The two operands form with an immediate is a short form of the three operands form
+                if(args.size() == 2 && args[1].type == OperandType::IMMEDIATE){
+                    auto dst = args[0];
+                    args.insert(args.begin() + 1, dst);
+                }
+
+                if(args.size() < 2 || args.size() > 3 || !args[0].gpr() || args[0].size == 1 || args[1].type == OperandType::IMMEDIATE || args[1].xmm()){
+                    throw as::UnsupportedAssembly("Invalid combination of operands");
+                }
+
+                auto& dst = args[0];
+                check_size(args[1], dst.size);
+
+                if(args.size() == 2){
+                    encode(size_prefix(dst.size), dst.size == 8, {0x0F, 0xAF}, dst.reg, args[1]);
+                } else {
+                    auto& value = args[2].expression;
+
+                    if(args[2].type != OperandType::IMMEDIATE || !value.symbol.empty() || !fits32(value.value)){
+                        throw as::UnsupportedAssembly("Invalid combination of operands");
+                    }
+
+                    int immediate_size = fits8(value.value) ? 1 : (dst.size == 2 ? 2 : 4);
+                    encode(size_prefix(dst.size), dst.size == 8, {immediate_size == 1 ? 0x6B : 0x69}, dst.reg, args[1], immediate_size);
+                    immediate(value, immediate_size);
+                }
+            }
+
+            break;
+        case Kind::SHIFT:
+            {
+                arity(2);
+
+                if(args[0].type == OperandType::IMMEDIATE || args[0].xmm()){
+                    throw as::UnsupportedAssembly("Invalid operand");
+                }
+
+                int size = operand_size(args[0]);
+                int opcode = size == 1 ? 0 : 1;
+
+                if(args[1].type == OperandType::IMMEDIATE && args[1].expression.symbol.empty()){
+                    if(args[1].expression.value == 1){
+                        encode(size_prefix(size), size == 8, {0xD0 + opcode}, mnemonic.code, args[0], 0);
+                    } else {
+                        encode(size_prefix(size), size == 8, {0xC0 + opcode}, mnemonic.code, args[0], 1);
+                        immediate(args[1].expression, 1);
+                    }
+                } else if(args[1].gpr() && args[1].size == 1 && args[1].reg == 1){
+                    encode(size_prefix(size), size == 8, {0xD2 + opcode}, mnemonic.code, args[0]);
+                } else {
+                    throw as::UnsupportedAssembly("Invalid shift count");
+                }
+            }
+
+            break;
+        case Kind::CMOV:
+            arity(2);
+
+            if(!args[0].gpr() || args[0].size == 1 || args[1].type == OperandType::IMMEDIATE || args[1].xmm()){
+                throw as::UnsupportedAssembly("Invalid combination of operands");
+            }
+
+            check_size(args[1], args[0].size);
+            encode(size_prefix(args[0].size), args[0].size == 8, {0x0F, 0x40 + mnemonic.code}, args[0].reg, args[1]);
+            break;
+        case Kind::JCC:
+            arity(1);
+            jump(mnemonic.code, args[0]);
+            break;
+        case Kind::JMP:
+            arity(1);
+            jump(ALWAYS, args[0]);
+            break;
+        case Kind::CALL:
+            arity(1);
+
+            if(args[0].type != OperandType::IMMEDIATE || args[0].expression.symbol.empty()){
+                throw as::UnsupportedAssembly("Only calls to labels are supported");
+            }
+
+            byte(0xE8);
+            relocation(RelocationType::RELATIVE_32, args[0].expression.symbol, args[0].expression.value, 4);
+            break;
+        case Kind::FIXED:
+            arity(0);
+
+            if(mnemonic.code > 0xFF){
+                byte(mnemonic.code >> 8);
+            }
+
+            byte(mnemonic.code & 0xFF);
+            break;
+        case Kind::SSE:
+            arity(2);
+
+            if(!args[0].xmm() || !(args[1].xmm() || args[1].type == OperandType::MEMORY)){
+                throw as::UnsupportedAssembly("Invalid combination of operands");
+            }
+
+            encode(mnemonic.prefix, false, {0x0F, mnemonic.code}, args[0].reg, args[1]);
+            break;
+        case Kind::SSE_MOVE:
+            arity(2);
+
+            if(args[0].xmm() && (args[1].xmm() || args[1].type == OperandType::MEMORY)){
+                encode(mnemonic.code >> 8, false, {0x0F, mnemonic.code & 0xFF}, args[0].reg, args[1]);
+            } else if(args[0].type == OperandType::MEMORY && args[1].xmm()){
+                encode(mnemonic.prefix >> 8, false, {0x0F, mnemonic.prefix & 0xFF}, args[1].reg, args[0]);
+            } else {
+                throw as::UnsupportedAssembly("Invalid combination of operands");
+            }
+
+            break;
+        case Kind::MOVQ:
+            arity(2);
+
+            if(args[0].xmm() && args[1].xmm()){
+                encode(0xF3, false, {0x0F, 0x7E}, args[0].reg, args[1]);
+            } else if(args[0].xmm() && ((args[1].gpr() && args[1].size == 8) || args[1].type == OperandType::MEMORY)){
+                encode(0x66, true, {0x0F, 0x6E}, args[0].reg, args[1]);
+            } else if(args[1].xmm() && ((args[0].gpr() && args[0].size == 8) || args[0].type == OperandType::MEMORY)){
+                encode(0x66, true, {0x0F, 0x7E}, args[1].reg, args[0]);
+            } else {
+                throw as::UnsupportedAssembly("Invalid combination of operands");
+            }
+
+            break;
+        case Kind::CVTSI2SD:
+            {
+                arity(2);
+
+                int size = args[1].type == OperandType::MEMORY ? operand_size(args[1]) : args[1].size;
+
+                if(!args[0].xmm() || !(args[1].gpr() || args[1].type == OperandType::MEMORY) || (size != 4 && size != 8)){
+                    throw as::UnsupportedAssembly("Invalid combination of operands");
+                }
+
+                encode(0xF2, size == 8, {0x0F, 0x2A}, args[0].reg, args[1]);
+            }
+
+            break;
+        case Kind::CVTTSD2SI:
+            arity(2);
+
+            if(!args[0].gpr() || (args[0].size != 4 && args[0].size != 8) || !(args[1].xmm() || args[1].type == OperandType::MEMORY)){
+                throw as::UnsupportedAssembly("Invalid combination of operands");
+            }
+
+            encode(0xF2, args[0].size == 8, {0x0F, 0x2C}, args[0].reg, args[1]);
+            break;
+        case Kind::PMOVMSKB:
+            arity(2);
+
+            if(!args[0].gpr() || (args[0].size != 4 && args[0].size != 8) || !args[1].xmm()){
+                throw as::UnsupportedAssembly("Invalid combination of operands");
+            }
+
+            encode(0x66, false, {0x0F, 0xD7}, args[0].reg, args[1]);
+            break;
+        case Kind::PSRLDQ:
+            arity(2);
+
+            if(!args[0].xmm() || args[1].type != OperandType::IMMEDIATE){
+                throw as::UnsupportedAssembly("Invalid combination of operands");
+            }
+
+            encode(0x66, false, {0x0F, 0x73}, 3, args[0], 1);
+            immediate(args[1].expression, 1);
+            break;
+        default:
+            throw as::UnsupportedAssembly("Invalid instruction");
+    }
+}
+
+void Encoder::assemble(const std::vector<Line>& lines, std::size_t begin, std::size_t end){
+    for(std::size_t i = begin; i < end; ++i){
+        tokenize(lines[i].begin, lines[i].end, tokens);
+
+        if(tokens.empty()){
+            continue;
+        }
+
+        if(tokens[0].value == "%rep"){
+            int64_t count = constant(1, tokens.size());
+
+            //Find the matching end of the block
+            std::size_t last = i + 1;
+            for(int depth = 1; ; ++last){
+                if(last >= end){
+                    throw as::UnsupportedAssembly("Missing %endrep");
+                }
+
+                tokenize(lines[last].begin, lines[last].end, tokens);
+
+                if(!tokens.empty() && tokens[0].value == "%rep"){
+                    ++depth;
+                } else if(!tokens.empty() && tokens[0].value == "%endrep" && --depth == 0){
+                    break;
+                }
+            }
+
+            for(int64_t j = 0; j < count; ++j){
+                assemble(lines, i + 1, last);
+            }
+
+            i = last;
+        } else {
+            statement(0);
+        }
+    }
+}
+
+std::size_t Encoder::address(const std::string& name, uint64_t text_address, uint64_t data_address, uint64_t bss_address) const {
+    auto it = symbols.find(name);
+
+    if(it == symbols.end()){
+        throw as::UnsupportedAssembly("Undefined symbol " + name);
+    }
+
+    auto& symbol = it->second;
+
+    switch(symbol.section){
+        case Section::TEXT:
+            return text_address + text[symbol.fragment].address + symbol.offset;
+        case Section::DATA:
+            return data_address + symbol.offset;
+        default:
+            return bss_address + symbol.offset;
+    }
+}
+
+void Encoder::resolve(Fragment& fragment, uint64_t fragment_address, uint64_t text_address, uint64_t data_address, uint64_t bss_address) const {
+    for(auto& relocation : fragment.relocations){
+        int64_t value = address(relocation.symbol, text_address, data_address, bss_address) + relocation.addend;
+        int size = 4;
+
+        switch(relocation.type){
+            case RelocationType::ABSOLUTE_32:
+                break;
+            case RelocationType::ABSOLUTE_64:
+                size = 8;
+                break;
+            case RelocationType::RELATIVE_32:
+                value -= fragment_address + relocation.offset + 4;
+                break;
+        }
+
+        if(size == 4 && !fits32(value)){
+            throw as::UnsupportedAssembly("Relocation out of range");
+        }
+
+        for(int i = 0; i < size; ++i){
+            fragment.bytes[relocation.offset + i] = static_cast<char>(value >> (8 * i));
+        }
+    }
+}
+
+void Encoder::link(const std::string& output){
+    //Start with short jumps and make them near until all the targets are in range
+    bool changed = true;
+    while(changed){
+        changed = false;
+
+        std::size_t current = 0;
+        for(auto& fragment : text){
+            fragment.address = current;
+            current += fragment.size();
+        }
+
+        for(auto& fragment : text){
+            if(fragment.jump != NO_JUMP && !fragment.near){
+                auto it = symbols.find(fragment.target);
+
+                if(it == symbols.end() || it->second.section != Section::TEXT){
+                    throw as::UnsupportedAssembly("Invalid jump target " + fragment.target);
+                }
+
+                int64_t target = text[it->second.fragment].address + it->second.offset;
+                int64_t next = fragment.address + fragment.size();
+
+                if(!fits8(target - next)){
+                    fragment.near = true;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    std::size_t text_size = text.back().address + text.back().size();
+    std::size_t data_size = data.back().bytes.size();
+
+    as::ElfWriter writer(text_size, data_size, bss);
+
+    auto text_address = writer.text_address();
+    auto data_address = writer.data_address();
+    auto bss_address = writer.bss_address();
+
+    std::string text_bytes;
+    text_bytes.reserve(text_size);
+
+    for(auto& fragment : text){
+        resolve(fragment, text_address + fragment.address, text_address, data_address, bss_address);
+
+        text_bytes += fragment.bytes;
+
+        if(fragment.jump != NO_JUMP){
+            int64_t target = address(fragment.target, text_address, data_address, bss_address);
+            int64_t displacement = target - static_cast<int64_t>(text_address + fragment.address + fragment.size());
+
+            if(!fragment.near){
+                text_bytes.push_back(static_cast<char>(fragment.jump == ALWAYS ? 0xEB : 0x70 + fragment.jump));
+                text_bytes.push_back(static_cast<char>(displacement));
+            } else {
+                if(fragment.jump == ALWAYS){
+                    text_bytes.push_back(static_cast<char>(0xE9));
+                } else {
+                    text_bytes.push_back(static_cast<char>(0x0F));
+                    text_bytes.push_back(static_cast<char>(0x80 + fragment.jump));
+                }
+
+                for(int i = 0; i < 4; ++i){
+                    text_bytes.push_back(static_cast<char>(displacement >> (8 * i)));
+                }
+            }
+        }
+    }
+
+    auto& data_fragment = data.back();
+    resolve(data_fragment, data_address, text_address, data_address, bss_address);
+
+    auto entry = symbols.find("_start");
+    if(entry == symbols.end() || entry->second.section != Section::TEXT){
+        throw as::UnsupportedAssembly("No entry point");
+    }
+
+    writer.write(output, address("_start", text_address, data_address, bss_address), text_bytes, data_fragment.bytes);
+}
+
+} //end of anonymous namespace
+
+void as::encode_x86_64(const std::string& source, const std::string& output){
+    std::vector<Line> lines;
+
+    const char* it = source.data();
+    const char* end = it + source.size();
+
+    while(it != end){
+        auto next = static_cast<const char*>(std::memchr(it, '\n', end - it));
+
+        if(!next){
+            next = end;
+        }
+
+        lines.push_back({it, next});
+
+        it = next == end ? end : next + 1;
+    }
+
+    Encoder encoder;
+    encoder.assemble(lines, 0, lines.size());
+    encoder.link(output);
+}
@@ -7,6 +7,7 @@
 
 #include "logging.hpp"
 #include "Options.hpp"
+#include "PassTimer.hpp"
 #include "SemanticalException.hpp"
 
 #include "ast/PassManager.hpp"
@@ -204,6 +205,9 @@ void ast::PassManager::dec_depth(){
 
 void ast::PassManager::run_passes(){
     for(auto& pass : passes){
+        //The passes applied to the instantiated templates are accounted to the pass that instantiated them
+        PassTimer timer("ast", pass->name());
+
         //A simple pass is only applied once to the whole program
         //They won't be applied on later instantiated function templates and class templates
         if(pass->is_simple()){
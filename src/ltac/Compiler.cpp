@@ -36,6 +36,7 @@ void ltac::Compiler::compile(mtac::program_p source, mtac::function_p function,
     PerfsTimer timer("LTAC Compilation");
     
     //Compute the block usage (in order to know if we have to output the label)
+    std::unordered_set<mtac::basic_block_p> block_usage;
     mtac::computeBlockUsage(function, block_usage);
 
     resetNumbering();
@@ -5,6 +5,8 @@
 //  http://www.boost.org/LICENSE_1_0.txt)
 //=======================================================================
 
+#include <algorithm>
+
 #include "VisitorUtils.hpp"
 
 #include "ltac/Statement.hpp"
@@ -12,96 +14,98 @@
 
 using namespace eddic;
 
-typedef ltac::LiveRegistersProblem::ProblemDomain ProblemDomain;
-typedef ltac::LivePseudoRegistersProblem::ProblemDomain PseudoProblemDomain;
-
 namespace {
 
-template<typename Reg, typename FloatReg, typename ProblemDomain>
-typename std::enable_if<std::is_same<Reg, ltac::PseudoRegister>::value, void>::type collect_jump(std::shared_ptr<ltac::Jump> instruction, ProblemDomain& in){
-    for(auto& reg : instruction->uses){
-        in.values().insert(reg);
-    }
+//The registers of each kind that are implicitly used and killed by the statements
 
-    for(auto& reg : instruction->float_uses){
-        in.values().insert(reg);
-    }
+template<typename Reg>
+struct implicit_registers;
 
-    for(auto& reg : instruction->kills){
-        in.values().erase(reg);
-    }
+template<>
+struct implicit_registers<ltac::PseudoRegister> {
+    static std::vector<ltac::PseudoRegister>& uses(ltac::Instruction& instruction){ return instruction.uses; }
+    static std::vector<ltac::PseudoRegister>& uses(ltac::Jump& jump){ return jump.uses; }
+    static std::vector<ltac::PseudoRegister>& kills(ltac::Jump& jump){ return jump.kills; }
+};
 
-    for(auto& reg : instruction->float_kills){
-        in.values().erase(reg);
-    }
-}
+template<>
+struct implicit_registers<ltac::PseudoFloatRegister> {
+    static std::vector<ltac::PseudoFloatRegister>& uses(ltac::Instruction& instruction){ return instruction.float_uses; }
+    static std::vector<ltac::PseudoFloatRegister>& uses(ltac::Jump& jump){ return jump.float_uses; }
+    static std::vector<ltac::PseudoFloatRegister>& kills(ltac::Jump& jump){ return jump.float_kills; }
+};
 
-template<typename Reg, typename FloatReg, typename ProblemDomain>
-typename std::enable_if<std::is_same<Reg, ltac::Register>::value, void>::type collect_jump(std::shared_ptr<ltac::Jump> instruction, ProblemDomain& in){
-    for(auto& reg : instruction->hard_uses){
-        in.values().insert(reg);
-    }
+template<>
+struct implicit_registers<ltac::Register> {
+    static std::vector<ltac::Register>& uses(ltac::Instruction& instruction){ return instruction.hard_uses; }
+    static std::vector<ltac::Register>& uses(ltac::Jump& jump){ return jump.hard_uses; }
+    static std::vector<ltac::Register>& kills(ltac::Jump& jump){ return jump.hard_kills; }
+};
 
-    for(auto& reg : instruction->hard_float_uses){
-        in.values().insert(reg);
-    }
+template<>
+struct implicit_registers<ltac::FloatRegister> {
+    static std::vector<ltac::FloatRegister>& uses(ltac::Instruction& instruction){ return instruction.hard_float_uses; }
+    static std::vector<ltac::FloatRegister>& uses(ltac::Jump& jump){ return jump.hard_float_uses; }
+    static std::vector<ltac::FloatRegister>& kills(ltac::Jump& jump){ return jump.hard_float_kills; }
+};
 
-    for(auto& reg : instruction->hard_kills){
-        in.values().erase(reg);
-    }
+//Update the live registers from the exit to the entry of a statement
 
-    for(auto& reg : instruction->hard_float_kills){
-        in.values().erase(reg);
-    }
-}
+struct BitValues {
+    mtac::BitSet& values;
 
-template<typename Reg, typename FloatReg, typename ProblemDomain>
-typename std::enable_if<std::is_same<Reg, ltac::PseudoRegister>::value, void>::type collect_instruction(std::shared_ptr<ltac::Instruction> instruction, ProblemDomain& in){
-    for(auto& reg : instruction->uses){
-        in.values().insert(reg);
+    BitValues(mtac::BitSet& values) : values(values) {}
+
+    void live(std::size_t reg){
+        values.set(reg);
     }
 
-    for(auto& reg : instruction->float_uses){
-        in.values().insert(reg);
+    void dead(std::size_t reg){
+        values.reset(reg);
     }
-}
+};
+
+//Compute the number of bits necessary to hold the registers
 
-template<typename Reg, typename FloatReg, typename ProblemDomain>
-typename std::enable_if<std::is_same<Reg, ltac::Register>::value, void>::type collect_instruction(std::shared_ptr<ltac::Instruction> instruction, ProblemDomain& in){
-    for(auto& reg : instruction->hard_uses){
-        in.values().insert(reg);
+struct LastRegister {
+    std::size_t& last;
+
+    LastRegister(std::size_t& last) : last(last) {}
+
+    void live(std::size_t reg){
+        last = std::max(last, reg + 1);
     }
 
-    for(auto& reg : instruction->hard_float_uses){
-        in.values().insert(reg);
+    void dead(std::size_t reg){
+        last = std::max(last, reg + 1);
     }
-}
+};
 
-template<typename Reg, typename FloatReg, typename ProblemDomain>
+template<typename Reg, typename Values>
 struct LivenessCollector : public boost::static_visitor<> {
-    ProblemDomain& in;
+    Values values;
 
-    LivenessCollector(ProblemDomain& in) : in(in) {}
+    LivenessCollector(Values values) : values(values) {}
 
-    template<typename Arg>
-    inline void set_live(Arg& arg){
+    void set_live(ltac::AddressRegister& arg){
+        if(auto* ptr = boost::get<Reg>(&arg)){
+            values.live(ptr->reg);
+        }
+    }
+
+    void set_live(ltac::Argument& arg){
         if(auto* ptr = boost::get<Reg>(&arg)){
-            in.values().insert(*ptr);
-        } else if(auto* ptr = boost::get<FloatReg>(&arg)){
-            in.values().insert(*ptr);
+            values.live(ptr->reg);
         } else if(auto* ptr = boost::get<ltac::Address>(&arg)){
             set_live_opt(ptr->base_register);
             set_live_opt(ptr->scaled_register);
         }
     }
     
-    template<typename Arg>
-    inline void set_dead(Arg& arg){
+    void set_dead(ltac::Argument& arg){
         if(auto* ptr = boost::get<Reg>(&arg)){
-            in.values().erase(*ptr);
-        } else if(auto* ptr = boost::get<FloatReg>(&arg)){
-            in.values().erase(*ptr);
-        }     
+            values.dead(ptr->reg);
+        }
     }
 
     template<typename Arg>
@@ -128,11 +132,19 @@ struct LivenessCollector : public boost::static_visitor<> {
             set_live_opt(instruction->arg3);
         }
 
-        collect_instruction<Reg, FloatReg, ProblemDomain>(instruction, in);
+        for(auto& reg : implicit_registers<Reg>::uses(*instruction)){
+            values.live(reg.reg);
+        }
     }
     
-    void operator()(std::shared_ptr<ltac::Jump> instruction){
-        collect_jump<Reg, FloatReg, ProblemDomain>(instruction, in);
+    void operator()(std::shared_ptr<ltac::Jump> jump){
+        for(auto& reg : implicit_registers<Reg>::uses(*jump)){
+            values.live(reg.reg);
+        }
+
+        for(auto& reg : implicit_registers<Reg>::kills(*jump)){
+            values.dead(reg.reg);
+        }
     }
 
     template<typename T>
@@ -141,90 +153,33 @@ struct LivenessCollector : public boost::static_visitor<> {
     }
 };
 
-template<typename Domain>
-Domain meet(Domain& in, Domain& out){
-    if(out.top()){
-        return in;
-    } else if(in.top()){
-        return out;
-    }
-
-    typename Domain::Values values;
-    Domain result(values);
-
-    for(auto& value : in.values().registers){
-        result.values().insert(value);
-    }
-    
-    for(auto& value : in.values().float_registers){
-        result.values().insert(value);
-    }
-    
-    for(auto& value : out.values().registers){
-        result.values().insert(value);
-    }
-    
-    for(auto& value : out.values().float_registers){
-        result.values().insert(value);
-    }
-
-    return result;
-}
-
 } //End of anonymous namespace
 
-ProblemDomain ltac::LiveRegistersProblem::Boundary(mtac::function_p /*function*/){
-    auto value = default_element();
-    return value;
-}
-
-ProblemDomain ltac::LiveRegistersProblem::Init(mtac::function_p /*function*/){
-    auto value = default_element();
-    return value;
-}
-    
-PseudoProblemDomain ltac::LivePseudoRegistersProblem::Boundary(mtac::function_p /*function*/){
-    auto value = default_element();
-    return value;
-}
+template<typename Reg>
+std::size_t ltac::LiveRegistersProblem<Reg>::init(mtac::function_p function){
+    std::size_t last = 0;
 
-PseudoProblemDomain ltac::LivePseudoRegistersProblem::Init(mtac::function_p /*function*/){
-    auto value = default_element();
-    return value;
-}
+    LivenessCollector<Reg, LastRegister> collector(last);
 
-ProblemDomain ltac::LiveRegistersProblem::meet(ProblemDomain& in, ProblemDomain& out){
-    return ::meet(in, out);
-}
+    for(auto& block : function){
+        visit_each(collector, block->l_statements);
+    }
 
-PseudoProblemDomain ltac::LivePseudoRegistersProblem::meet(PseudoProblemDomain& in, PseudoProblemDomain& out){
-    return ::meet(in, out);
+    return last;
 }
 
-ProblemDomain ltac::LiveRegistersProblem::transfer(mtac::basic_block_p /*basic_block*/, ltac::Statement& statement, ProblemDomain& in){
-    auto out = in;
-    
-    LivenessCollector<ltac::Register, ltac::FloatRegister, ProblemDomain> collector(out);
-    visit(collector, statement);
-
-    return out;
+template<typename Reg>
+std::vector<ltac::Statement>& ltac::LiveRegistersProblem<Reg>::statements(mtac::basic_block_p block){
+    return block->l_statements;
 }
 
-PseudoProblemDomain ltac::LivePseudoRegistersProblem::transfer(mtac::basic_block_p /*basic_block*/, ltac::Statement& statement, PseudoProblemDomain& in){
-    auto out = in;
-    
-    LivenessCollector<ltac::PseudoRegister, ltac::PseudoFloatRegister, PseudoProblemDomain> collector(out);
+template<typename Reg>
+void ltac::LiveRegistersProblem<Reg>::transfer(ltac::Statement& statement, mtac::BitSet& values){
+    LivenessCollector<Reg, BitValues> collector(values);
     visit(collector, statement);
-
-    return out;
-}
-
-bool ltac::LiveRegistersProblem::optimize(ltac::Statement& /*statement*/, std::shared_ptr<mtac::DataFlowResults<ProblemDomain>> /*results*/){
-    //This analysis is only made to gather information, not to optimize anything
-    throw "Unimplemented";
 }
 
-bool ltac::LivePseudoRegistersProblem::optimize(ltac::Statement& /*statement*/, std::shared_ptr<mtac::DataFlowResults<PseudoProblemDomain>> /*results*/){
-    //This analysis is only made to gather information, not to optimize anything
-    throw "Unimplemented";
-}
+template struct ltac::LiveRegistersProblem<ltac::Register>;
+template struct ltac::LiveRegistersProblem<ltac::FloatRegister>;
+template struct ltac::LiveRegistersProblem<ltac::PseudoRegister>;
+template struct ltac::LiveRegistersProblem<ltac::PseudoFloatRegister>;
@@ -25,6 +25,7 @@ bool ltac::erase_result(ltac::Operator op){
 bool ltac::erase_result_complete(ltac::Operator op){
     return op == Operator::MOV 
         || op == Operator::FMOV 
+        || op == Operator::PMOV 
         || op == Operator::LEA 
         || op == Operator::MUL3;
 }
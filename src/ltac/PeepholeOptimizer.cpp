@@ -5,11 +5,15 @@
 //  http://www.boost.org/LICENSE_1_0.txt)
 //=======================================================================
 
+#include <atomic>
+#include <deque>
 #include <iostream>
+#include <iomanip>
 #include <boost/optional.hpp>
 #include <boost/range/adaptors.hpp>
 
 #include "assert.hpp"
+#include "arena.hpp"
 #include "logging.hpp"
 #include "Utils.hpp"
 #include "PerfsTimer.hpp"
@@ -20,10 +24,10 @@
 #include "FunctionContext.hpp"
 #include "Variable.hpp"
 
-#include "mtac/GlobalOptimizations.hpp"
 #include "mtac/Statement.hpp"
 
 #include "ltac/PeepholeOptimizer.hpp"
+#include "ltac/peephole_rules.hpp"
 #include "ltac/Printer.hpp"
 #include "ltac/Utils.hpp"
 #include "ltac/LiveRegistersProblem.hpp"
@@ -32,348 +36,33 @@ using namespace eddic;
 
 namespace {
 
-inline bool optimize_statement(ltac::Statement& statement){
-    if(boost::get<std::shared_ptr<ltac::Instruction>>(&statement)){
-        auto instruction = boost::get<std::shared_ptr<ltac::Instruction>>(statement);
-        
-        //SUB or ADD 0 has no effect
-        if(instruction->op == ltac::Operator::ADD || instruction->op == ltac::Operator::SUB){
-            if(ltac::is_reg(*instruction->arg1) && boost::get<int>(&*instruction->arg2)){
-                auto value = boost::get<int>(*instruction->arg2);
-                
-                if(value == 0){
-                    return ltac::transform_to_nop(instruction);
-                }
-            }
-        }
-
-        if(instruction->op == ltac::Operator::MOV){
-            //MOV reg, 0 can be transformed into XOR reg, reg
-            if(ltac::is_reg(*instruction->arg1) && mtac::equals<int>(*instruction->arg2, 0)){
-                instruction->op = ltac::Operator::XOR;
-                instruction->arg2 = instruction->arg1;
-
-                return true;
-            }
-
-            if(ltac::is_reg(*instruction->arg1) && ltac::is_reg(*instruction->arg2)){
-                auto& reg1 = boost::get<ltac::Register>(*instruction->arg1); 
-                auto& reg2 = boost::get<ltac::Register>(*instruction->arg2); 
-            
-                //MOV reg, reg is useless
-                if(reg1 == reg2){
-                    return ltac::transform_to_nop(instruction);
-                }
-            }
-        }
-
-        if(instruction->op == ltac::Operator::ADD){
-            //ADD reg, 1 can be transformed into INC reg
-            if(ltac::is_reg(*instruction->arg1) && mtac::equals<int>(*instruction->arg2, 1)){
-                instruction->op = ltac::Operator::INC;
-                instruction->arg2.reset();
-
-                return true;
-            }
-            
-            //ADD reg, -1 can be transformed into DEC reg
-            if(ltac::is_reg(*instruction->arg1) && mtac::equals<int>(*instruction->arg2, -1)){
-                instruction->op = ltac::Operator::DEC;
-                instruction->arg2.reset();
-
-                    return true;
-            }
-        }
-        
-        if(instruction->op == ltac::Operator::SUB){
-            //SUB reg, 1 can be transformed into DEC reg
-            if(ltac::is_reg(*instruction->arg1) && mtac::equals<int>(*instruction->arg2, 1)){
-                instruction->op = ltac::Operator::DEC;
-                instruction->arg2.reset();
-
-                    return true;
-            }
-            
-            //SUB reg, -1 can be transformed into INC reg
-            if(ltac::is_reg(*instruction->arg1) && mtac::equals<int>(*instruction->arg2, -1)){
-                instruction->op = ltac::Operator::INC;
-                instruction->arg2.reset();
-
-                    return true;
-            }
-        }
-
-        if(instruction->op == ltac::Operator::MUL2 || instruction->op == ltac::Operator::MUL3){
-            //Optimize multiplications with SHIFTs or LEAs
-            if(ltac::is_reg(*instruction->arg1) && mtac::is<int>(*instruction->arg2)){
-                int constant = boost::get<int>(*instruction->arg2);
-
-                auto reg = boost::get<ltac::Register>(*instruction->arg1);
-        
-                if(isPowerOfTwo(constant)){
-                    instruction->op = ltac::Operator::SHIFT_LEFT;
-                    instruction->arg2 = powerOfTwo(constant);
-
-                    return true;
-                } 
-                
-                if(constant == 3){
-                    instruction->op = ltac::Operator::LEA;
-                    instruction->arg2 = ltac::Address(reg, reg, 2, 0);
-
-                    return true;
-                } 
-                
-                if(constant == 5){
-                    instruction->op = ltac::Operator::LEA;
-                    instruction->arg2 = ltac::Address(reg, reg, 4, 0);
-
-                    return true;
-                } 
-                
-                if(constant == 9){
-                    instruction->op = ltac::Operator::LEA;
-                    instruction->arg2 = ltac::Address(reg, reg, 8, 0);
-
-                    return true;
-                }
-            }
-        }
-
-        if(instruction->op == ltac::Operator::CMP_INT){
-            //Optimize comparisons with 0 with or reg, reg
-            if(ltac::is_reg(*instruction->arg1) && mtac::equals<int>(*instruction->arg2, 0)){
-                instruction->op = ltac::Operator::OR;
-                instruction->arg2 = instruction->arg1;
-
-                return true;
-            }
-        }
-
-        if(instruction->op == ltac::Operator::LEA){
-            auto address = boost::get<ltac::Address>(*instruction->arg2);
-
-            if(address.base_register && !address.scaled_register){
-                if(!address.displacement){
-                    instruction->op = ltac::Operator::MOV;
-                    instruction->arg2 = address.base_register;
-
-                    return true;
-                } else if(*address.displacement == 0){
-                    instruction->op = ltac::Operator::MOV;
-                    instruction->arg2 = address.base_register;
-
-                    return true;
-                }
-            }
-        }
-    }
-
-    return false;
-}
-
-inline bool multiple_statement_optimizations(ltac::Statement& s1, ltac::Statement& s2){
-    if(mtac::is<std::shared_ptr<ltac::Instruction>>(s1) && mtac::is<std::shared_ptr<ltac::Instruction>>(s2)){
-        auto& i1 = boost::get<std::shared_ptr<ltac::Instruction>>(s1);
-        auto& i2 = boost::get<std::shared_ptr<ltac::Instruction>>(s2);
-
-        //Statements after RET are dead
-        if(i1->op == ltac::Operator::RET){
-            return ltac::transform_to_nop(i2);
-        }
-        
-        //Two following LEAVE are not useful
-        if(i1->op == ltac::Operator::LEAVE && i2->op == ltac::Operator::LEAVE){
-            return ltac::transform_to_nop(i2);
-        }
-
-        //Combine two ADD into one
-        if(i1->op == ltac::Operator::ADD && i2->op == ltac::Operator::ADD){
-            if(ltac::is_reg(*i1->arg1) && ltac::is_reg(*i2->arg1) && boost::get<int>(&*i1->arg2) && boost::get<int>(&*i2->arg2)){
-                auto reg1 = boost::get<ltac::Register>(*i1->arg1);
-                auto reg2 = boost::get<ltac::Register>(*i2->arg1);
-
-                if(reg1 == reg2){
-                    i1->arg2 = boost::get<int>(*i1->arg2) + boost::get<int>(*i2->arg2);
-
-                    return ltac::transform_to_nop(i2);
-                }
-            }
-        }
-        
-        //Combine two SUB into one
-        if(i1->op == ltac::Operator::SUB && i2->op == ltac::Operator::SUB){
-            if(ltac::is_reg(*i1->arg1) && ltac::is_reg(*i2->arg1) && boost::get<int>(&*i1->arg2) && boost::get<int>(&*i2->arg2)){
-                auto reg1 = boost::get<ltac::Register>(*i1->arg1);
-                auto reg2 = boost::get<ltac::Register>(*i2->arg1);
-
-                if(reg1 == reg2){
-                    i1->arg2 = boost::get<int>(*i1->arg2) + boost::get<int>(*i2->arg2);
-
-                    return ltac::transform_to_nop(i2);
-                }
-            }
-        }
-
-        if(i1->op == ltac::Operator::MOV && i2->op == ltac::Operator::MOV){
-            if(ltac::is_reg(*i1->arg1) && ltac::is_reg(*i1->arg2) && ltac::is_reg(*i2->arg1) && ltac::is_reg(*i2->arg2)){
-                auto reg11 = boost::get<ltac::Register>(*i1->arg1);
-                auto reg12 = boost::get<ltac::Register>(*i1->arg2);
-                auto reg21 = boost::get<ltac::Register>(*i2->arg1);
-                auto reg22 = boost::get<ltac::Register>(*i2->arg2);
-
-                //cross MOV (ir4 = ir5, ir5 = ir4), keep only the first
-                if (reg11 == reg22 && reg12 == reg21){
-                    return ltac::transform_to_nop(i2);
-                }
-            } else if(ltac::is_reg(*i1->arg1) && ltac::is_reg(*i2->arg2)){
-                auto reg11 = boost::get<ltac::Register>(*i1->arg1);
-                auto reg22 = boost::get<ltac::Register>(*i2->arg2);
-                
-                if(reg11 == reg22 && boost::get<ltac::Address>(&*i1->arg2) && boost::get<ltac::Address>(&*i2->arg1)){
-                    if(boost::get<ltac::Address>(*i1->arg2) == boost::get<ltac::Address>(*i2->arg1)){
-                        return ltac::transform_to_nop(i2);
-                    }
-                }
-            } else if(ltac::is_reg(*i1->arg2) && ltac::is_reg(*i2->arg1)){
-                auto reg12 = boost::get<ltac::Register>(*i1->arg2);
-                auto reg21 = boost::get<ltac::Register>(*i2->arg1);
-
-                if(reg12 == reg21 && boost::get<ltac::Address>(&*i1->arg1) && boost::get<ltac::Address>(&*i2->arg2)){
-                    if(boost::get<ltac::Address>(*i1->arg1) == boost::get<ltac::Address>(*i2->arg2)){
-                        return ltac::transform_to_nop(i2);
-                    }
-                }
-            }
-        }
-        
-        if(i1->op == ltac::Operator::MOV && i2->op == ltac::Operator::ADD){
-            if(ltac::is_reg(*i1->arg1) && ltac::is_reg(*i2->arg1)){
-                if(boost::get<ltac::Register>(*i1->arg1) == boost::get<ltac::Register>(*i2->arg1)){
-                    if(boost::get<ltac::Register>(&*i1->arg2) && boost::get<int>(&*i2->arg2)){
-                        i2->op = ltac::Operator::LEA;
-                        i2->arg2 = ltac::Address(boost::get<ltac::Register>(*i1->arg2), boost::get<int>(*i2->arg2));
-
-                        return ltac::transform_to_nop(i1);
-                    } else if(boost::get<std::string>(&*i1->arg2) && boost::get<int>(&*i2->arg2)){
-                        i2->op = ltac::Operator::LEA;
-                        i2->arg2 = ltac::Address(boost::get<std::string>(*i1->arg2), boost::get<int>(*i2->arg2));
-
-                        return ltac::transform_to_nop(i1);
-                    }
-                }
-            }
-        }
-
-        if(i1->op == ltac::Operator::POP && i2->op == ltac::Operator::PUSH){
-            if(ltac::is_reg(*i1->arg1) && ltac::is_reg(*i2->arg1)){
-                auto reg1 = boost::get<ltac::Register>(*i1->arg1);
-                auto reg2 = boost::get<ltac::Register>(*i2->arg1);
-
-                if(reg1 == reg2){
-                    i1->op = ltac::Operator::MOV;
-                    i1->arg2 = ltac::Address(ltac::SP, 0);
-
-                    return ltac::transform_to_nop(i2);
-                }
-            }
-        }
-        
-        if(i1->op == ltac::Operator::PUSH && i2->op == ltac::Operator::POP){
-            if(ltac::is_reg(*i1->arg1) && ltac::is_reg(*i2->arg1)){
-                auto reg1 = boost::get<ltac::Register>(*i1->arg1);
-                auto reg2 = boost::get<ltac::Register>(*i2->arg1);
-
-                if(reg1 == reg2){
-                    ltac::transform_to_nop(i1);
-
-                    return ltac::transform_to_nop(i2);
-                }
-            }
-        }
+//The passes of the peephole optimizer working on more than a window of instructions, 
+//the number of times each of them is applied is counted
+
+enum class Rule : unsigned int {
+    CONSTANT_PROPAGATION,
+    COPY_PROPAGATION,
+    DEAD_CODE_ELIMINATION,
+    CONDITIONAL_MOVE,
+    COUNT
+};
+
+const char* rule_names[] = {
+    "constant propagation",
+    "copy propagation",
+    "dead code elimination",
+    "conditional move"
+};
+
+//The functions are optimized in parallel
+std::atomic<std::size_t> hits[static_cast<unsigned int>(Rule::COUNT)];
+
+inline bool hit(Rule rule, bool applied = true){
+    if(applied){
+        hits[static_cast<unsigned int>(rule)].fetch_add(1, std::memory_order_relaxed);
     }
 
-    return false;
-}
-
-inline bool multiple_statement_optimizations_second(ltac::Statement& s1, ltac::Statement& s2, Platform platform){
-    if(mtac::is<std::shared_ptr<ltac::Instruction>>(s1) && mtac::is<std::shared_ptr<ltac::Instruction>>(s2)){
-        auto& i1 = boost::get<std::shared_ptr<ltac::Instruction>>(s1);
-        auto& i2 = boost::get<std::shared_ptr<ltac::Instruction>>(s2);
-
-        if(i1->op == ltac::Operator::MOV && i2->op == ltac::Operator::MOV){
-            if(ltac::is_reg(*i1->arg1) && ltac::is_reg(*i2->arg1) && ltac::is_reg(*i2->arg2)){
-                auto reg11 = boost::get<ltac::Register>(*i1->arg1);
-                auto reg21 = boost::get<ltac::Register>(*i2->arg1);
-                auto reg22 = boost::get<ltac::Register>(*i2->arg2);
-
-                bool possible = true;
-
-                if(auto* ptr = boost::get<ltac::Address>(&*i1->arg2)){
-                    if(ptr->base_register && boost::get<ltac::Register>(*ptr->base_register) == reg11){
-                        possible = false;
-                    }
-                    
-                    if(ptr->scaled_register && boost::get<ltac::Register>(*ptr->scaled_register) == reg11){
-                        possible = false;
-                    }
-                }
-
-                if(reg22 == reg11 && possible){
-                    auto descriptor = getPlatformDescriptor(platform);
-
-                    for(unsigned int i = 0; i < descriptor->numberOfIntParamRegisters(); ++i){
-                        auto reg = ltac::Register(descriptor->int_param_register(i + 1));
-
-                        if(reg21 == reg){
-                            i2->arg2 = i1->arg2;
-
-                            return true;
-                        }
-                    }
-    
-                    if(reg21 == ltac::Register(descriptor->int_return_register1())){
-                        i2->arg2 = i1->arg2;
-
-                        return true;
-                    }
-    
-                    if(reg21 == ltac::Register(descriptor->int_return_register2())){
-                        i2->arg2 = i1->arg2;
-
-                        return true;
-                    }
-                }
-            }
-        }
-        
-        if(i1->op == ltac::Operator::MOV && i2->op == ltac::Operator::PUSH){
-            if(ltac::is_reg(*i1->arg1) && ltac::is_reg(*i2->arg1) && !ltac::is_float_reg(*i1->arg2)){
-                auto reg11 = boost::get<ltac::Register>(*i1->arg1);
-                auto reg21 = boost::get<ltac::Register>(*i2->arg1);
-                
-                if(reg11 == reg21){
-                    bool valid = true;
-                    
-                    if(auto* ptr = boost::get<ltac::Address>(&*i1->arg2)){
-                        if(ptr->base_register && boost::get<ltac::Register>(*ptr->base_register) == reg11){
-                            valid = false;
-                        } else if(ptr->scaled_register && boost::get<ltac::Register>(*ptr->scaled_register) == reg11){
-                            valid = false;
-                        }
-                    }
-
-                    if(valid){
-                        i2->arg1 = i1->arg2;
-
-                        return true;
-                    }
-                }
-            }
-        }
-    }
-    
-    return false;
+    return applied;
 }
 
 inline bool is_nop(ltac::Statement& statement){
@@ -388,119 +77,92 @@ inline bool is_nop(ltac::Statement& statement){
     return false;
 }
 
-bool basic_optimizations(mtac::function_p function, Platform platform){
+/*!
+ * Apply the peephole rules to the basic block. After a change, the window backs up by one 
+ * statement so that only the statements around the changes are visited again. 
+ */
+bool basic_optimizations(mtac::basic_block_p bb, Platform platform){
     bool optimized = false;
-    
-    for(auto& bb : function){
-        auto& statements = bb->l_statements;
-
-        if(statements.empty()){
-            continue;
-        }
-
-        if(statements.size() == 1){
-            optimized |= optimize_statement(statements.front());
-
-            continue;
-        }
-
-        auto it = statements.begin();
-        auto end = statements.end() - 1;
-
-        while(it != end){
-            auto& s1 = *it;
-            auto& s2 = *(it + 1);
 
-            //Optimizations that looks at only one statement
-            optimized |= optimize_statement(s1);
-            optimized |= optimize_statement(s2);
+    auto& statements = bb->l_statements;
 
-            //Optimizations that looks at several statements at once
-            optimized |= multiple_statement_optimizations(s1, s2);
+    std::size_t i = 0;
 
-            if(unlikely(is_nop(s1))){
-                it = statements.erase(it);
-                end = statements.end() - 1;
+    while(i < statements.size()){
+        bool changed = ltac::apply_peephole_rules(bb, i, platform);
 
-                optimized = true;
-
-                continue;
-            }
-
-            ++it;
+        //A block is never left empty
+        if(unlikely(statements.size() > 1 && is_nop(statements[i]))){
+            statements.erase(statements.begin() + i);
+            changed = true;
         }
 
-        it = statements.begin();
-        end = statements.end() - 1;
-
-        while(it != end){
-            auto& s1 = *it;
-            auto& s2 = *(it + 1);
+        if(changed){
+            optimized = true;
 
-            optimized |= multiple_statement_optimizations_second(s1, s2, platform);
-
-            ++it;
+            if(i > 0){
+                --i;
+            }
+        } else {
+            ++i;
         }
     }
 
     return optimized;
 }
 
-bool constant_propagation(mtac::function_p function){
+bool constant_propagation(mtac::basic_block_p bb){
     bool optimized = false;
 
-    for(auto& bb : function){
-        auto& statements = bb->l_statements;
+    auto& statements = bb->l_statements;
 
-        std::unordered_map<ltac::Register, int> constants; 
+    std::unordered_map<ltac::Register, int> constants; 
 
-        for(std::size_t i = 0; i < statements.size(); ++i){
-            auto statement = statements[i];
+    for(std::size_t i = 0; i < statements.size(); ++i){
+        auto statement = statements[i];
 
-            if(auto* ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&statement)){
-                auto instruction = *ptr;
+        if(auto* ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&statement)){
+            auto instruction = *ptr;
 
-                //Erase constant
-                if(instruction->arg1 && ltac::is_reg(*instruction->arg1)){
-                    auto reg1 = boost::get<ltac::Register>(*instruction->arg1);
+            //Erase constant
+            if(instruction->arg1 && ltac::is_reg(*instruction->arg1)){
+                auto reg1 = boost::get<ltac::Register>(*instruction->arg1);
 
-                    constants.erase(reg1);
-                }
+                constants.erase(reg1);
+            }
 
-                //Collect constants
-                if(instruction->op == ltac::Operator::XOR){
-                    if(ltac::is_reg(*instruction->arg1) && ltac::is_reg(*instruction->arg2)){
-                        auto reg1 = boost::get<ltac::Register>(*instruction->arg1);
-                        auto reg2 = boost::get<ltac::Register>(*instruction->arg2);
+            //Collect constants
+            if(instruction->op == ltac::Operator::XOR){
+                if(ltac::is_reg(*instruction->arg1) && ltac::is_reg(*instruction->arg2)){
+                    auto reg1 = boost::get<ltac::Register>(*instruction->arg1);
+                    auto reg2 = boost::get<ltac::Register>(*instruction->arg2);
 
-                        if(reg1 == reg2){
-                            constants[reg1] = 0;
-                        }
+                    if(reg1 == reg2){
+                        constants[reg1] = 0;
                     }
-                } else if(instruction->op == ltac::Operator::MOV){
-                    if(ltac::is_reg(*instruction->arg1)){
-                        if (auto* valuePtr = boost::get<int>(&*instruction->arg2)){
-                            auto reg1 = boost::get<ltac::Register>(*instruction->arg1);
-                            constants[reg1] = *valuePtr;
-                        }
+                }
+            } else if(instruction->op == ltac::Operator::MOV){
+                if(ltac::is_reg(*instruction->arg1)){
+                    if (auto* valuePtr = boost::get<int>(&*instruction->arg2)){
+                        auto reg1 = boost::get<ltac::Register>(*instruction->arg1);
+                        constants[reg1] = *valuePtr;
                     }
                 }
+            }
 
-                //Optimize MOV
-                if(instruction->op == ltac::Operator::MOV){
-                    if(ltac::is_reg(*instruction->arg2)){
-                        auto reg2 = boost::get<ltac::Register>(*instruction->arg2);
+            //Optimize MOV
+            if(instruction->op == ltac::Operator::MOV){
+                if(ltac::is_reg(*instruction->arg2)){
+                    auto reg2 = boost::get<ltac::Register>(*instruction->arg2);
 
-                        if(constants.find(reg2) != constants.end()){
-                            instruction->arg2 = constants[reg2];
-                            optimized = true;
-                        }
+                    if(constants.find(reg2) != constants.end()){
+                        instruction->arg2 = constants[reg2];
+                        optimized = hit(Rule::CONSTANT_PROPAGATION);
                     }
                 }
-            } 
-        }
+            }
+        } 
     }
-    
 
     return optimized;
 }
@@ -520,57 +182,55 @@ void remove_reg(std::unordered_map<ltac::Register, ltac::Register>& copies, ltac
     }
 }
 
-bool copy_propagation(mtac::function_p function, Platform platform){
+bool copy_propagation(mtac::basic_block_p bb, Platform platform){
     auto descriptor = getPlatformDescriptor(platform);
 
     bool optimized = false;
 
-    for(auto& bb : function){
-        auto& statements = bb->l_statements;
+    auto& statements = bb->l_statements;
 
-        std::unordered_map<ltac::Register, ltac::Register> copies;
+    std::unordered_map<ltac::Register, ltac::Register> copies;
 
-        for(std::size_t i = 0; i < statements.size(); ++i){
-            auto statement = statements[i];
+    for(std::size_t i = 0; i < statements.size(); ++i){
+        auto statement = statements[i];
 
-            if(auto* ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&statement)){
-                auto instruction = *ptr;
+        if(auto* ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&statement)){
+            auto instruction = *ptr;
 
-                //Erase constant
-                if(instruction->arg1 && ltac::is_reg(*instruction->arg1)){
-                    auto reg = boost::get<ltac::Register>(*instruction->arg1);
+            //Erase constant
+            if(instruction->arg1 && ltac::is_reg(*instruction->arg1)){
+                auto reg = boost::get<ltac::Register>(*instruction->arg1);
 
-                    remove_reg(copies, reg);
-                }
+                remove_reg(copies, reg);
+            }
 
-                if(instruction->op == ltac::Operator::DIV){
-                    remove_reg(copies, ltac::Register(descriptor->a_register()));
-                    remove_reg(copies, ltac::Register(descriptor->d_register()));
-                }
+            if(instruction->op == ltac::Operator::DIV){
+                remove_reg(copies, ltac::Register(descriptor->a_register()));
+                remove_reg(copies, ltac::Register(descriptor->d_register()));
+            }
 
-                //Collect copies
-                if(instruction->op == ltac::Operator::MOV){
-                    if(ltac::is_reg(*instruction->arg1)){
-                        if (auto* reg_ptr = boost::get<ltac::Register>(&*instruction->arg2)){
-                            auto reg1 = boost::get<ltac::Register>(*instruction->arg1);
-                            copies[reg1] = *reg_ptr;
-                        }
+            //Collect copies
+            if(instruction->op == ltac::Operator::MOV){
+                if(ltac::is_reg(*instruction->arg1)){
+                    if (auto* reg_ptr = boost::get<ltac::Register>(&*instruction->arg2)){
+                        auto reg1 = boost::get<ltac::Register>(*instruction->arg1);
+                        copies[reg1] = *reg_ptr;
                     }
                 }
+            }
 
-                //Optimize MOV
-                if(instruction->op == ltac::Operator::MOV){
-                    if(ltac::is_reg(*instruction->arg2)){
-                        auto reg2 = boost::get<ltac::Register>(*instruction->arg2);
+            //Optimize MOV
+            if(instruction->op == ltac::Operator::MOV){
+                if(ltac::is_reg(*instruction->arg2)){
+                    auto reg2 = boost::get<ltac::Register>(*instruction->arg2);
 
-                        if(copies.find(reg2) != copies.end()){
-                            instruction->arg2 = copies[reg2];
-                            optimized = true;
-                        }
+                    if(copies.find(reg2) != copies.end()){
+                        instruction->arg2 = copies[reg2];
+                        optimized = hit(Rule::COPY_PROPAGATION);
                     }
                 }
-            } 
-        }
+            }
+        } 
     }
 
     return optimized;
@@ -669,47 +329,51 @@ inline bool one_of(const T& value, const std::vector<T>& container){
     return std::find(container.begin(), container.end(), value) != container.end();
 }
 
-bool dead_code_elimination(mtac::function_p function){
-    bool optimized = false;
+typedef ltac::LiveRegistersProblem<ltac::Register> LivenessProblem;
+typedef mtac::BitDataFlowResults<LivenessProblem> Liveness;
 
-    ltac::LiveRegistersProblem problem;
-    auto results = mtac::data_flow(function, problem);
-    
-    for(auto& block : function){
-        auto it = iterate(block->l_statements);
+bool dead_code_elimination(mtac::basic_block_p block, Liveness& liveness){
+    //The statements of EXIT are not considered
+    if(block->index == -2 || !liveness.numbers.count(block)){
+        return false;
+    }
 
-        while(it.has_next()){
-            auto& statement = *it;
+    bool optimized = false;
 
-            if(auto* ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&statement)){
-                if(ltac::erase_result((*ptr)->op)){
-                    //OR is used for comparisons
-                    if((*ptr)->op == ltac::Operator::OR){
-                        ++it;
-                        continue;
-                    }
+    std::vector<bool> dead(block->l_statements.size(), false);
+    std::size_t i = block->l_statements.size();
 
-                    if(auto* reg_ptr = boost::get<ltac::Register>(&*(*ptr)->arg1)){
-                        //SP is always live
-                        if(*reg_ptr == ltac::SP){
-                            ++it;
-                            continue;
-                        }
+    liveness.backward_statements(block, [&dead, &i](ltac::Statement& statement, mtac::BitSet& live){
+        --i;
 
-                        //Some statements (in ENTRY and EXIT) are not annotated, it is enough to ignore them
-                        if(results->OUT_LS.count(statement)){
-                            auto& liveness = results->OUT_LS[statement].values();
+        if(auto* ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&statement)){
+            if(ltac::erase_result((*ptr)->op)){
+                //OR is used for comparisons
+                if((*ptr)->op == ltac::Operator::OR){
+                    return;
+                }
 
-                            if(liveness.find(*reg_ptr) == liveness.end()){
-                                it.erase();
-                                optimized=true;
-                                continue;
-                            }
-                        }
+                if(auto* reg_ptr = boost::get<ltac::Register>(&*(*ptr)->arg1)){
+                    //SP is always live
+                    if(*reg_ptr == ltac::SP){
+                        return;
+                    }
+
+                    if(!live.test(reg_ptr->reg)){
+                        dead[i] = true;
                     }
                 }
             }
+        }
+    });
 
+    auto it = iterate(block->l_statements);
+
+    for(std::size_t j = 0; j < dead.size(); ++j){
+        if(dead[j]){
+            it.erase();
+            optimized = hit(Rule::DEAD_CODE_ELIMINATION);
+        } else {
             ++it;
         }
     }
@@ -778,176 +442,301 @@ bool move_forward(BIt& bit, BIt& bend, It& it, It& end){
     return false;
 }
 
-bool conditional_move(mtac::function_p function, Platform platform){
-    bool optimized = false;
+/*!
+ * Replace a comparison followed by a branch on two moves of the same register starting at the 
+ * given statement by a conditional move. The statements can span several basic blocks, the 
+ * modified basic blocks are added to touched. 
+ */
+template<typename BIt, typename It>
+bool conditional_move(BIt bit, BIt bend, It it, It end, ltac::Register free_reg, std::vector<mtac::basic_block_p>& touched){
+    auto cmp_bit = bit;
+    auto cmp_it = it;
+    auto cmp_end = end;
 
-    RegisterUsage usage = collect_register_usage(function, platform);
+    if(!move_forward(bit, bend, it, end)){
+        return false;
+    }
 
-    auto free_reg = get_free_reg(usage, platform);
-    if(free_reg == ltac::SP){
-        return optimized;
+    auto* jump_1_ptr = boost::get<std::shared_ptr<ltac::Jump>>(&*it);
+    if(!jump_1_ptr || !move_forward(bit, bend, it, end)){
+        return false;
     }
 
-    auto bit = function->begin();
-    auto bend = function->end();
+    auto* mov_1_ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&*it);
+    if(!mov_1_ptr || (*mov_1_ptr)->op != ltac::Operator::MOV || !move_forward(bit, bend, it, end)){
+        return false;
+    }
 
-    auto& bb = *bit;
+    if(!boost::get<std::shared_ptr<ltac::Jump>>(&*it) || !move_forward(bit, bend, it, end)){
+        return false;
+    }
 
-    auto it = bb->l_statements.begin();
-    auto end = bb->l_statements.end();
+    if(!boost::get<std::string>(&*it) || !move_forward(bit, bend, it, end)){
+        return false;
+    }
 
-    while(true){
-        if(it == end){
-            move_forward(bit, bend, it, end);
+    auto* mov_2_ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&*it);
+    if(!mov_2_ptr || (*mov_2_ptr)->op != ltac::Operator::MOV || !move_forward(bit, bend, it, end)){
+        return false;
+    }
+
+    if(!boost::get<std::string>(&*it)){
+        return false;
+    }
+
+    if(!ltac::is_reg(*(*mov_1_ptr)->arg1) || !ltac::is_reg(*(*mov_2_ptr)->arg1)){
+        return false;
+    }
+
+    auto reg1 = boost::get<ltac::Register>(*(*mov_1_ptr)->arg1); 
+    auto reg2 = boost::get<ltac::Register>(*(*mov_2_ptr)->arg1); 
+
+    if(reg1 != reg2){
+        return false;
+    }
+
+    //The comparison is kept, the six following statements are replaced
+    std::vector<ltac::Statement> replacement = {
+        *mov_1_ptr,
+        make_node<ltac::Instruction>(ltac::Operator::MOV, free_reg, *(*mov_2_ptr)->arg2),
+        make_node<ltac::Instruction>(get_cmov_op((*jump_1_ptr)->type), reg1, free_reg),
+        make_node<ltac::Instruction>(ltac::Operator::NOP),
+        make_node<ltac::Instruction>(ltac::Operator::NOP),
+        make_node<ltac::Instruction>(ltac::Operator::NOP)
+    };
+
+    for(auto& statement : replacement){
+        move_forward(cmp_bit, bend, cmp_it, cmp_end);
+        *cmp_it = statement;
+
+        touched.push_back(*cmp_bit);
+    }
+
+    return hit(Rule::CONDITIONAL_MOVE);
+}
+
+/*!
+ * \struct Peephole
+ * \brief The state of the peephole optimization of a function. 
+ *
+ * The basic blocks whose statements changed are kept in a work list and only them are optimized 
+ * again. The liveness of the hard registers is updated block by block: when the live registers at 
+ * the entry of a block change, its predecessors are optimized again. 
+ */
+struct Peephole {
+    mtac::function_p function;
+    Platform platform;
+
+    LivenessProblem problem;
+    std::shared_ptr<Liveness> liveness;
+
+    bool changed = false;   //Indicates that statements changed since the liveness was solved
+
+    RegisterUsage usage;
+    ltac::Register free_reg;
+
+    std::deque<mtac::basic_block_p> work_list;
+    std::unordered_set<mtac::basic_block_p> pending;
+
+    Peephole(mtac::function_p function, Platform platform) : function(function), platform(platform) {
+        liveness = solve_liveness();
+
+        usage = collect_register_usage(function, platform);
+        free_reg = get_free_reg(usage, platform);
+
+        for(auto& block : function){
+            add(block);
         }
+    }
 
-        auto statement = *it;
+    std::shared_ptr<Liveness> solve_liveness(){
+        auto results = mtac::backward_bit_data_flow(function, problem);
 
-        if(auto* ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&statement)){
-            if((*ptr)->op != ltac::Operator::CMP_INT){
-                if(!move_forward(bit, bend, it, end)){
-                    return optimized;
-                }
+        //The conditional moves can use registers that were not used before
+        std::size_t registers = getPlatformDescriptor(platform)->number_of_registers();
 
-                continue;
-            }
+        for(auto& values : results->IN){
+            values.resize(std::max(values.size(), registers));
+        }
 
-            auto temp_bit = bit;
-            auto temp_it = it;
-            auto temp_end = end;
+        for(auto& values : results->OUT){
+            values.resize(std::max(values.size(), registers));
+        }
 
-            if(!move_forward(temp_bit, bend, temp_it, temp_end)){
-                return optimized;
-            }
+        return results;
+    }
 
-            if(auto* jump_1_ptr = boost::get<std::shared_ptr<ltac::Jump>>(&*temp_it)){
-                if(!move_forward(temp_bit, bend, temp_it, temp_end)){
-                    return optimized;
-                }
+    void add(const mtac::basic_block_p& block){
+        if(pending.insert(block).second){
+            work_list.push_back(block);
+        }
+    }
+
+    bool conditional_moves(const mtac::basic_block_p& block){
+        //All the registers are used
+        if(free_reg == ltac::SP){
+            return false;
+        }
+
+        auto bit = function->at(block);
+        auto bend = function->end();
+
+        auto& statements = block->l_statements;
 
-                if(auto* mov_1_ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&*temp_it)){
-                    if((*mov_1_ptr)->op != ltac::Operator::MOV){
-                        if(!move_forward(bit, bend, it, end)){
-                            return optimized;
+        for(auto it = statements.begin(); it != statements.end(); ++it){
+            if(auto* ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&*it)){
+                if((*ptr)->op == ltac::Operator::CMP_INT || (*ptr)->op == ltac::Operator::TEST){
+                    std::vector<mtac::basic_block_p> touched;
+
+                    if(conditional_move(bit, bend, it, statements.end(), free_reg, touched)){
+                        //The live registers at the exit of the block must be correct before looking for dead code
+                        for(auto bb = touched.rbegin(); bb != touched.rend(); ++bb){
+                            update_liveness(*bb);
+                            add(*bb);
                         }
 
-                        continue;
-                    }
+                        usage.insert(free_reg);
+                        free_reg = get_free_reg(usage, platform);
 
-                    if(!move_forward(temp_bit, bend, temp_it, temp_end)){
-                        return optimized;
+                        return true;
                     }
+                }
+            }
+        }
 
-                    if(boost::get<std::shared_ptr<ltac::Jump>>(&*temp_it)){
-                        if(!move_forward(temp_bit, bend, temp_it, temp_end)){
-                            return optimized;
-                        }
+        return false;
+    }
 
-                        if(boost::get<std::string>(&*temp_it)){
-                            if(!move_forward(temp_bit, bend, temp_it, temp_end)){
-                                return optimized;
-                            }
-
-                            if(auto* mov_2_ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&*temp_it)){
-                                if((*mov_2_ptr)->op != ltac::Operator::MOV){
-                                    if(!move_forward(bit, bend, it, end)){
-                                        return optimized;
-                                    }
-
-                                    continue;
-                                }
-
-                                if(!move_forward(temp_bit, bend, temp_it, temp_end)){
-                                    return optimized;
-                                }
-
-                                if(boost::get<std::string>(&*temp_it)){
-                                    if(ltac::is_reg(*(*mov_1_ptr)->arg1) && ltac::is_reg(*(*mov_2_ptr)->arg1)){
-                                        auto& reg1 = boost::get<ltac::Register>(*(*mov_1_ptr)->arg1); 
-                                        auto& reg2 = boost::get<ltac::Register>(*(*mov_2_ptr)->arg1); 
-
-                                        if(reg1 != reg2){
-                                            if(!move_forward(bit, bend, it, end)){
-                                                return optimized;
-                                            }
-
-                                            continue;
-                                        }
-
-                                        auto cmov_op = get_cmov_op((*jump_1_ptr)->type);
-
-                                        move_forward(bit, bend, it, end);
-                                        *it = *mov_1_ptr;
-                                        move_forward(bit, bend, it, end);
-                                        *it = std::make_shared<ltac::Instruction>(ltac::Operator::MOV, free_reg, *(*mov_2_ptr)->arg2);
-                                        move_forward(bit, bend, it, end);
-                                        *it = std::make_shared<ltac::Instruction>(cmov_op, reg1, free_reg);
-                                        move_forward(bit, bend, it, end);
-                                        
-                                        *it = std::make_shared<ltac::Instruction>(ltac::Operator::NOP);
-                                        move_forward(bit, bend, it, end);
-                                        *it = std::make_shared<ltac::Instruction>(ltac::Operator::NOP);
-                                        move_forward(bit, bend, it, end);
-                                        *it = std::make_shared<ltac::Instruction>(ltac::Operator::NOP);
-                                        move_forward(bit, bend, it, end);
-
-                                        optimized = true;
-                                    }
-                                }
-                            }
-                        }
+    //Compute the live registers at the entry of the block from the ones at its exit
+    void update_liveness(const mtac::basic_block_p& block){
+        if(!liveness->numbers.count(block)){
+            return;
+        }
+
+        auto values = liveness->out(block);
+        auto& statements = block->l_statements;
+
+        for(std::size_t i = statements.size(); i > 0; --i){
+            problem.transfer(statements[i - 1], values);
+        }
+
+        if(values != liveness->in(block)){
+            liveness->in(block).swap(values);
+
+            for(auto& predecessor : block->predecessors){
+                if(!liveness->numbers.count(predecessor)){
+                    continue;
+                }
+
+                auto& out = liveness->out(predecessor);
+                out.reset();
+
+                for(auto& successor : predecessor->successors){
+                    if(liveness->numbers.count(successor)){
+                        out |= liveness->in(successor);
                     }
                 }
+
+                add(predecessor);
             }
         }
+    }
+
+    void optimize(const mtac::basic_block_p& block){
+        bool optimized;
+
+        do {
+            optimized = false;
+
+            optimized |= basic_optimizations(block, platform);
+            optimized |= constant_propagation(block);
+            optimized |= copy_propagation(block, platform);
+            optimized |= dead_code_elimination(block, *liveness);
+            optimized |= conditional_moves(block);
 
-        if(!move_forward(bit, bend, it, end)){
-            return optimized;
+            changed |= optimized;
+        } while(optimized);
+
+        update_liveness(block);
+    }
+
+    void run(){
+        std::size_t visits = 0;
+
+        while(true){
+            while(!work_list.empty()){
+                auto block = work_list.front();
+                work_list.pop_front();
+                pending.erase(block);
+
+                optimize(block);
+
+                ++visits;
+            }
+
+            if(!changed){
+                break;
+            }
+
+            /*
+             * The incremental updates never remove a register that is live around a loop. The liveness 
+             * is solved again and only the blocks whose live registers at exit changed are optimized again.
+             */
+            changed = false;
+
+            auto results = solve_liveness();
+
+            for(auto& block : function){
+                if(results->numbers.count(block) && results->out(block) != liveness->out(block)){
+                    add(block);
+                }
+            }
+
+            liveness = results;
+
+            if(work_list.empty()){
+                break;
+            }
         }
+
+        log::emit<Debug>("Peephole") << "Optimized " << function->getName() << " with " << visits << " visits of " << function->bb_count() << " blocks" << log::endl;
     }
+};
 
-    return optimized;
-}
+} //end of anonymous namespace
 
-bool debug(const std::string& name, bool b, mtac::function_p function){
+void eddic::ltac::optimize(mtac::function_p function, Platform platform){
     if(log::enabled<Debug>()){
-        if(b){
-            log::emit<Debug>("Peephole") << name << " returned true" << log::endl;
+        log::emit<Debug>("Peephole") << "Start optimizations on " << function->getName() << log::endl;
 
-            //Print the function
-            ltac::Printer printer;
-            printer.print(function);
-        } else {
-            log::emit<Debug>("Peephole") << name << " returned false" << log::endl;
-        }
+        //Print the function
+        ltac::Printer printer;
+        printer.print(function);
     }
 
-    return b;
-}
+    Peephole peephole(function, platform);
+    peephole.run();
 
-} //end of anonymous namespace
+    if(log::enabled<Debug>()){
+        ltac::Printer printer;
+        printer.print(function);
+    }
+}
 
 void eddic::ltac::optimize(mtac::program_p program, Platform platform){
     PerfsTimer timer("Peephole optimizations");
 
     for(auto& function : program->functions){
-        if(log::enabled<Debug>()){
-            log::emit<Debug>("Peephole") << "Start optimizations on " << function->getName() << log::endl;
+        ltac::optimize(function, platform);
+    }
+}
 
-            //Print the function
-            ltac::Printer printer;
-            printer.print(function);
-        }
+void eddic::ltac::print_peephole_statistics(){
+    std::cout << "Peephole rules:" << std::endl;
 
-        bool optimized;
-        do {
-            optimized = false;
-            
-            optimized |= debug("Basic optimizations", basic_optimizations(function, platform), function);
-            optimized |= debug("Constant propagation", constant_propagation(function), function);
-            optimized |= debug("Copy propagation", copy_propagation(function, platform), function);
-            optimized |= debug("Dead-Code Elimination", dead_code_elimination(function), function);
-            optimized |= debug("Conditional move", conditional_move(function, platform), function);
-        } while(optimized);
+    ltac::print_peephole_rules_statistics(std::cout);
+
+    for(unsigned int i = 0; i < static_cast<unsigned int>(Rule::COUNT); ++i){
+        std::cout << "  " << std::left << std::setw(24) << rule_names[i] << hits[i].load() << std::endl;
     }
 }
@@ -40,6 +40,8 @@ std::string to_string(ltac::Operator op){
             return "CMP_INT"; 
         case ltac::Operator::CMP_FLOAT:
             return "CMP_FLOAT"; 
+        case ltac::Operator::TEST:
+            return "TEST"; 
         case ltac::Operator::OR:
             return "OR"; 
         case ltac::Operator::XOR:
@@ -85,6 +87,22 @@ std::string to_string(ltac::Operator op){
             return "I2F"; 
         case ltac::Operator::F2I:
             return "F2I"; 
+        case ltac::Operator::PMOV:
+            return "PMOV"; 
+        case ltac::Operator::PADD:
+            return "PADD"; 
+        case ltac::Operator::PSUB:
+            return "PSUB"; 
+        case ltac::Operator::PFADD:
+            return "PFADD"; 
+        case ltac::Operator::PFSUB:
+            return "PFSUB"; 
+        case ltac::Operator::PFMUL:
+            return "PFMUL"; 
+        case ltac::Operator::PSPLAT:
+            return "PSPLAT"; 
+        case ltac::Operator::PSHR:
+            return "PSHR"; 
         case ltac::Operator::CMOVE:
             return "CMOVE"; 
         case ltac::Operator::CMOVNE:
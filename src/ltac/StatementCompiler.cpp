@@ -6,6 +6,7 @@
 //=======================================================================
 
 #include "assert.hpp"
+#include "arena.hpp"
 #include "FunctionContext.hpp"
 #include "Utils.hpp"
 #include "Type.hpp"
@@ -288,28 +289,28 @@ void ltac::StatementCompiler::operator()(std::shared_ptr<mtac::IfFalse> if_false
 
             switch(*if_false->op){
                 case mtac::BinaryOperator::FE:
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_false->block->label, ltac::JumpType::NE));
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_false->block->label, ltac::JumpType::P));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_false->block->label, ltac::JumpType::NE));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_false->block->label, ltac::JumpType::P));
                     break;
                 case mtac::BinaryOperator::FNE:
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_false->block->label, ltac::JumpType::E));
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_false->block->label, ltac::JumpType::P));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_false->block->label, ltac::JumpType::E));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_false->block->label, ltac::JumpType::P));
                     break;
                 case mtac::BinaryOperator::FL:
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_false->block->label, ltac::JumpType::AE));
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_false->block->label, ltac::JumpType::P));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_false->block->label, ltac::JumpType::AE));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_false->block->label, ltac::JumpType::P));
                     break;
                 case mtac::BinaryOperator::FLE:
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_false->block->label, ltac::JumpType::A));
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_false->block->label, ltac::JumpType::P));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_false->block->label, ltac::JumpType::A));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_false->block->label, ltac::JumpType::P));
                     break;
                 case mtac::BinaryOperator::FG:
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_false->block->label, ltac::JumpType::BE));
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_false->block->label, ltac::JumpType::P));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_false->block->label, ltac::JumpType::BE));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_false->block->label, ltac::JumpType::P));
                     break;
                 case mtac::BinaryOperator::FGE:
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_false->block->label, ltac::JumpType::B));
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_false->block->label, ltac::JumpType::P));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_false->block->label, ltac::JumpType::B));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_false->block->label, ltac::JumpType::P));
                     break;
                 default:
                     eddic_unreachable("This operation is not a float operator");
@@ -320,22 +321,22 @@ void ltac::StatementCompiler::operator()(std::shared_ptr<mtac::IfFalse> if_false
 
             switch(*if_false->op){
                 case mtac::BinaryOperator::EQUALS:
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_false->block->label, ltac::JumpType::NE));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_false->block->label, ltac::JumpType::NE));
                     break;
                 case mtac::BinaryOperator::NOT_EQUALS:
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_false->block->label, ltac::JumpType::E));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_false->block->label, ltac::JumpType::E));
                     break;
                 case mtac::BinaryOperator::LESS:
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_false->block->label, ltac::JumpType::GE));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_false->block->label, ltac::JumpType::GE));
                     break;
                 case mtac::BinaryOperator::LESS_EQUALS:
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_false->block->label, ltac::JumpType::G));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_false->block->label, ltac::JumpType::G));
                     break;
                 case mtac::BinaryOperator::GREATER:
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_false->block->label, ltac::JumpType::LE));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_false->block->label, ltac::JumpType::LE));
                     break;
                 case mtac::BinaryOperator::GREATER_EQUALS:
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_false->block->label, ltac::JumpType::L));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_false->block->label, ltac::JumpType::L));
                     break;
                 default:
                     eddic_unreachable("This operation is not a float operator");
@@ -345,7 +346,7 @@ void ltac::StatementCompiler::operator()(std::shared_ptr<mtac::IfFalse> if_false
     } else {
         compare_unary(if_false->arg1);
 
-        bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_false->block->label, ltac::JumpType::Z));
+        bb->l_statements.push_back(make_node<ltac::Jump>(if_false->block->label, ltac::JumpType::Z));
     }
 }
 
@@ -359,28 +360,28 @@ void ltac::StatementCompiler::operator()(std::shared_ptr<mtac::If> if_){
 
             switch(*if_->op){
                 case mtac::BinaryOperator::FE:
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_->block->label, ltac::JumpType::E));
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_->block->label, ltac::JumpType::P));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_->block->label, ltac::JumpType::E));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_->block->label, ltac::JumpType::P));
                     break;
                 case mtac::BinaryOperator::FNE:
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_->block->label, ltac::JumpType::NE));
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_->block->label, ltac::JumpType::P));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_->block->label, ltac::JumpType::NE));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_->block->label, ltac::JumpType::P));
                     break;
                 case mtac::BinaryOperator::FL:
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_->block->label, ltac::JumpType::B));
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_->block->label, ltac::JumpType::P));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_->block->label, ltac::JumpType::B));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_->block->label, ltac::JumpType::P));
                     break;
                 case mtac::BinaryOperator::FLE:
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_->block->label, ltac::JumpType::BE));
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_->block->label, ltac::JumpType::P));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_->block->label, ltac::JumpType::BE));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_->block->label, ltac::JumpType::P));
                     break;
                 case mtac::BinaryOperator::FG:
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_->block->label, ltac::JumpType::A));
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_->block->label, ltac::JumpType::P));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_->block->label, ltac::JumpType::A));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_->block->label, ltac::JumpType::P));
                     break;
                 case mtac::BinaryOperator::FGE:
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_->block->label, ltac::JumpType::AE));
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_->block->label, ltac::JumpType::P));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_->block->label, ltac::JumpType::AE));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_->block->label, ltac::JumpType::P));
                     break;
                 default:
                     eddic_unreachable("This operation is not a float operator");
@@ -391,22 +392,22 @@ void ltac::StatementCompiler::operator()(std::shared_ptr<mtac::If> if_){
 
             switch(*if_->op){
                 case mtac::BinaryOperator::EQUALS:
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_->block->label, ltac::JumpType::E));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_->block->label, ltac::JumpType::E));
                     break;
                 case mtac::BinaryOperator::NOT_EQUALS:
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_->block->label, ltac::JumpType::NE));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_->block->label, ltac::JumpType::NE));
                     break;
                 case mtac::BinaryOperator::LESS:
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_->block->label, ltac::JumpType::L));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_->block->label, ltac::JumpType::L));
                     break;
                 case mtac::BinaryOperator::LESS_EQUALS:
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_->block->label, ltac::JumpType::LE));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_->block->label, ltac::JumpType::LE));
                     break;
                 case mtac::BinaryOperator::GREATER:
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_->block->label, ltac::JumpType::G));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_->block->label, ltac::JumpType::G));
                     break;
                 case mtac::BinaryOperator::GREATER_EQUALS:
-                    bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_->block->label, ltac::JumpType::GE));
+                    bb->l_statements.push_back(make_node<ltac::Jump>(if_->block->label, ltac::JumpType::GE));
                     break;
                 default:
                     eddic_unreachable("This operation is not a float operator");
@@ -417,7 +418,7 @@ void ltac::StatementCompiler::operator()(std::shared_ptr<mtac::If> if_){
     } else {
         compare_unary(if_->arg1);
 
-        bb->l_statements.push_back(std::make_shared<ltac::Jump>(if_->block->label, ltac::JumpType::NZ));
+        bb->l_statements.push_back(make_node<ltac::Jump>(if_->block->label, ltac::JumpType::NZ));
     }
 }
 
@@ -426,7 +427,7 @@ void ltac::StatementCompiler::operator()(std::shared_ptr<mtac::Goto> goto_){
 
     end_bb();
 
-    bb->l_statements.push_back(std::make_shared<ltac::Jump>(goto_->block->label, ltac::JumpType::ALWAYS));
+    bb->l_statements.push_back(make_node<ltac::Jump>(goto_->block->label, ltac::JumpType::ALWAYS));
 }
 
 ltac::PseudoRegister ltac::StatementCompiler::get_address_in_pseudo_reg(std::shared_ptr<Variable> var, int offset){
@@ -596,7 +597,7 @@ void ltac::StatementCompiler::operator()(std::shared_ptr<mtac::Call> call){
 
     first_param = true;
 
-    auto call_instruction = std::make_shared<ltac::Jump>(call->function, ltac::JumpType::CALL);
+    auto call_instruction = make_node<ltac::Jump>(call->function, ltac::JumpType::CALL);
     call_instruction->target_function = call->functionDefinition;
     call_instruction->uses = uses;
     call_instruction->float_uses = float_uses;
@@ -1269,6 +1270,88 @@ void ltac::StatementCompiler::compile_DOT_PASSIGN(std::shared_ptr<mtac::Quadrupl
     }
 }
 
+void ltac::StatementCompiler::compile_VDOT(std::shared_ptr<mtac::Quadruple> quadruple){
+    auto variable = ltac::get_variable(*quadruple->arg1);
+
+    auto reg = manager.get_pseudo_float_reg_no_move(quadruple->result);
+    ltac::add_instruction(bb, ltac::Operator::PMOV, reg, address(variable, *quadruple->arg2));
+
+    manager.set_written(quadruple->result);
+}
+
+void ltac::StatementCompiler::compile_DOT_VASSIGN(std::shared_ptr<mtac::Quadruple> quadruple){
+    auto reg = manager.get_pseudo_float_reg(ltac::get_variable(*quadruple->arg2));
+    ltac::add_instruction(bb, ltac::Operator::PMOV, address(quadruple->result, *quadruple->arg1), reg);
+}
+
+void ltac::StatementCompiler::compile_VSPLAT(std::shared_ptr<mtac::Quadruple> quadruple){
+    auto reg = manager.get_pseudo_float_reg_no_move(quadruple->result);
+
+    //The value is put in the first element and then copied into the others
+    if(mtac::isFloat(*quadruple->arg1) || (ltac::is_variable(*quadruple->arg1) && ltac::is_float_var(ltac::get_variable(*quadruple->arg1)))){
+        manager.copy(*quadruple->arg1, reg);
+    } else {
+        auto int_reg = manager.get_free_pseudo_reg();
+        manager.copy(*quadruple->arg1, int_reg);
+        ltac::add_instruction(bb, ltac::Operator::FMOV, reg, int_reg);
+    }
+
+    ltac::add_instruction(bb, ltac::Operator::PSPLAT, reg);
+
+    manager.set_written(quadruple->result);
+}
+
+void ltac::StatementCompiler::compile_packed(std::shared_ptr<mtac::Quadruple> quadruple, ltac::Operator op){
+    auto reg1 = manager.get_pseudo_float_reg(ltac::get_variable(*quadruple->arg1));
+    auto reg2 = manager.get_pseudo_float_reg(ltac::get_variable(*quadruple->arg2));
+
+    //Form v = v op w
+    if(*quadruple->arg1 == quadruple->result){
+        ltac::add_instruction(bb, op, reg1, reg2);
+    } 
+    //Form w = v op w, the result cannot be computed in place 
+    else if(*quadruple->arg2 == quadruple->result){
+        auto reg = manager.get_free_pseudo_float_reg();
+        ltac::add_instruction(bb, ltac::Operator::PMOV, reg, reg1);
+        ltac::add_instruction(bb, op, reg, reg2);
+        ltac::add_instruction(bb, ltac::Operator::PMOV, reg2, reg);
+    } else {
+        auto reg = manager.get_pseudo_float_reg_no_move(quadruple->result);
+        ltac::add_instruction(bb, ltac::Operator::PMOV, reg, reg1);
+        ltac::add_instruction(bb, op, reg, reg2);
+    }
+
+    manager.set_written(quadruple->result);
+}
+
+void ltac::StatementCompiler::compile_VSUM(std::shared_ptr<mtac::Quadruple> quadruple){
+    auto reg = manager.get_pseudo_float_reg(ltac::get_variable(*quadruple->arg1));
+    bool is_float = quadruple->op == mtac::Operator::VFSUM;
+
+    auto sum_reg = manager.get_free_pseudo_float_reg();
+    auto high_reg = manager.get_free_pseudo_float_reg();
+
+    ltac::add_instruction(bb, ltac::Operator::PMOV, sum_reg, reg);
+
+    //Add the high half of the vector to its low half until only one element is left
+    int size = (is_float ? FLOAT : INT)->size(platform);
+    for(int shift = 8; shift >= size; shift /= 2){
+        ltac::add_instruction(bb, ltac::Operator::PMOV, high_reg, sum_reg);
+        ltac::add_instruction(bb, ltac::Operator::PSHR, high_reg, shift);
+        ltac::add_instruction(bb, is_float ? ltac::Operator::PFADD : ltac::Operator::PADD, sum_reg, high_reg);
+    }
+
+    if(is_float){
+        auto result_reg = manager.get_pseudo_float_reg_no_move(quadruple->result);
+        ltac::add_instruction(bb, ltac::Operator::FMOV, result_reg, sum_reg);
+    } else {
+        auto result_reg = manager.get_pseudo_reg_no_move(quadruple->result);
+        ltac::add_instruction(bb, ltac::Operator::MOV, result_reg, sum_reg);
+    }
+
+    manager.set_written(quadruple->result);
+}
+
 void ltac::StatementCompiler::compile_NOT(std::shared_ptr<mtac::Quadruple> quadruple){
     auto reg = manager.get_pseudo_reg_no_move(quadruple->result);
     manager.copy(*quadruple->arg1, reg);
@@ -1425,6 +1508,34 @@ void ltac::StatementCompiler::operator()(std::shared_ptr<mtac::Quadruple> quadru
         case mtac::Operator::DOT_FASSIGN:
             compile_DOT_FASSIGN(quadruple);
             break;
+        case mtac::Operator::VDOT:
+            compile_VDOT(quadruple);
+            break;
+        case mtac::Operator::DOT_VASSIGN:
+            compile_DOT_VASSIGN(quadruple);
+            break;
+        case mtac::Operator::VSPLAT:
+            compile_VSPLAT(quadruple);
+            break;
+        case mtac::Operator::VADD:
+            compile_packed(quadruple, ltac::Operator::PADD);
+            break;
+        case mtac::Operator::VSUB:
+            compile_packed(quadruple, ltac::Operator::PSUB);
+            break;
+        case mtac::Operator::VFADD:
+            compile_packed(quadruple, ltac::Operator::PFADD);
+            break;
+        case mtac::Operator::VFSUB:
+            compile_packed(quadruple, ltac::Operator::PFSUB);
+            break;
+        case mtac::Operator::VFMUL:
+            compile_packed(quadruple, ltac::Operator::PFMUL);
+            break;
+        case mtac::Operator::VSUM:
+        case mtac::Operator::VFSUM:
+            compile_VSUM(quadruple);
+            break;
         case mtac::Operator::RETURN:
             compile_RETURN(quadruple);
             break;
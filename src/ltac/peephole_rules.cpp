@@ -0,0 +1,748 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <iomanip>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "assert.hpp"
+#include "Utils.hpp"
+#include "PlatformDescriptor.hpp"
+
+#include "ltac/peephole_rules.hpp"
+#include "ltac/Statement.hpp"
+#include "ltac/Utils.hpp"
+
+using namespace eddic;
+using eddic::ltac::Operator;
+
+namespace {
+
+/*!
+ * The shape of an operand in a pattern.
+ */
+enum class Shape : unsigned int {
+    ANY,        //Any operand or no operand at all
+    NONE,       //No operand
+    REG,
+    FLOAT_REG,
+    INT,
+    ADDRESS,
+    LABEL
+};
+
+/*!
+ * A pattern matching one instruction. An empty list of operators matches any instruction.
+ */
+struct Pattern {
+    std::vector<Operator> ops;
+    Shape arg1;
+    Shape arg2;
+    Shape arg3;
+};
+
+/*!
+ * The window of instructions a rule is matched against.
+ */
+struct Window {
+    std::vector<ltac::Statement>& statements;
+    std::size_t position;
+    mtac::basic_block_p block;
+    Platform platform;
+    std::array<std::shared_ptr<ltac::Instruction>, 3> i;
+    std::size_t length;
+};
+
+/*!
+ * A peephole rule: the window of instructions it applies to, an optional guard checking
+ * what the shapes cannot express and the rewrite of the window.
+ */
+struct Rule {
+    const char* name;
+    std::vector<Pattern> patterns;
+    bool (*guard)(Window& window);
+    void (*rewrite)(Window& window);
+};
+
+/* Helpers for the guards and the rewrites */
+
+inline ltac::Register reg(boost::optional<ltac::Argument>& arg){
+    return boost::get<ltac::Register>(*arg);
+}
+
+inline int value(boost::optional<ltac::Argument>& arg){
+    return boost::get<int>(*arg);
+}
+
+inline ltac::Address& address(boost::optional<ltac::Argument>& arg){
+    return boost::get<ltac::Address>(*arg);
+}
+
+inline bool is_reg(const boost::optional<ltac::AddressRegister>& arg, ltac::Register reg){
+    if(arg){
+        if(auto* ptr = boost::get<ltac::Register>(&*arg)){
+            return *ptr == reg;
+        }
+    }
+
+    return false;
+}
+
+//Indicates if the argument reads the given register
+bool uses(boost::optional<ltac::Argument>& arg, ltac::Register reg){
+    if(auto* ptr = boost::get<ltac::Register>(&*arg)){
+        return *ptr == reg;
+    } else if(auto* ptr = boost::get<ltac::Address>(&*arg)){
+        return is_reg(ptr->base_register, reg) || is_reg(ptr->scaled_register, reg);
+    }
+
+    return false;
+}
+
+inline void nop(std::shared_ptr<ltac::Instruction>& instruction){
+    ltac::transform_to_nop(instruction);
+}
+
+bool is_param_register(ltac::Register reg, Platform platform){
+    auto descriptor = getPlatformDescriptor(platform);
+
+    for(unsigned int i = 0; i < descriptor->numberOfIntParamRegisters(); ++i){
+        if(reg == ltac::Register(descriptor->int_param_register(i + 1))){
+            return true;
+        }
+    }
+
+    return reg == ltac::Register(descriptor->int_return_register1())
+        || reg == ltac::Register(descriptor->int_return_register2());
+}
+
+/* Flags analysis */
+
+//Beyond this number of blocks, the flags are considered read
+const std::size_t max_flags_blocks = 8;
+
+bool sets_flags(Operator op){
+    return op == Operator::CMP_INT
+        || op == Operator::CMP_FLOAT
+        || op == Operator::TEST
+        || op == Operator::OR
+        || op == Operator::XOR
+        || op == Operator::AND
+        || op == Operator::ADD
+        || op == Operator::SUB
+        || op == Operator::NEG;
+}
+
+bool reads_carry(Operator op){
+    return op >= Operator::CMOVA && op <= Operator::CMOVBE;
+}
+
+bool reads_carry(ltac::JumpType type){
+    return type == ltac::JumpType::A || type == ltac::JumpType::AE || type == ltac::JumpType::B || type == ltac::JumpType::BE;
+}
+
+/*!
+ * Indicates if the flags at the given position may be read before being set again. If carry is true,
+ * only the carry flag is considered. The successors are followed when the end of the block is reached.
+ */
+bool flags_read(mtac::basic_block_p block, std::size_t position, bool carry, std::unordered_set<mtac::basic_block_p>& visited){
+    auto& statements = block->l_statements;
+
+    for(std::size_t j = position; j < statements.size(); ++j){
+        auto& statement = statements[j];
+
+        if(auto* ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&statement)){
+            auto op = (*ptr)->op;
+
+            if(op >= Operator::CMOVE && op <= Operator::CMOVLE){
+                if(!carry || reads_carry(op)){
+                    return true;
+                }
+            } else if(op == Operator::RET || sets_flags(op)){
+                return false;
+            }
+        } else if(auto* ptr = boost::get<std::shared_ptr<ltac::Jump>>(&statement)){
+            auto type = (*ptr)->type;
+
+            //The flags are not preserved by a call
+            if(type == ltac::JumpType::CALL){
+                return false;
+            } else if(type == ltac::JumpType::ALWAYS){
+                break;
+            } else if(!carry || reads_carry(type)){
+                return true;
+            }
+        }
+    }
+
+    for(auto& successor : block->successors){
+        if(visited.size() >= max_flags_blocks){
+            return true;
+        }
+
+        if(visited.insert(successor).second && flags_read(successor, 0, carry, visited)){
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool flags_dead(Window& window){
+    std::unordered_set<mtac::basic_block_p> visited;
+    return !flags_read(window.block, window.position + window.length, false, visited);
+}
+
+bool carry_dead(Window& window){
+    std::unordered_set<mtac::basic_block_p> visited;
+    return !flags_read(window.block, window.position + window.length, true, visited);
+}
+
+/*
+ * The rules of the peephole optimizer. At a given position, the rules are tried in the order
+ * of the table. The rules of the second phase and the instruction selection come last, they
+ * only apply when nothing else does.
+ */
+
+const Rule rules[] = {
+    /* Rules on one instruction */
+
+    //ADD or SUB 0 has no effect
+    {"add/sub 0",
+        {{{Operator::ADD, Operator::SUB}, Shape::REG, Shape::INT}},
+        [](Window& w){ return value(w.i[0]->arg2) == 0 && flags_dead(w); },
+        [](Window& w){ nop(w.i[0]); }},
+
+    //MOV reg, reg is useless
+    {"useless mov",
+        {{{Operator::MOV}, Shape::REG, Shape::REG}},
+        [](Window& w){ return reg(w.i[0]->arg1) == reg(w.i[0]->arg2); },
+        [](Window& w){ nop(w.i[0]); }},
+
+    {"mul to shift",
+        {{{Operator::MUL2, Operator::MUL3}, Shape::REG, Shape::INT, Shape::NONE}},
+        [](Window& w){ return isPowerOfTwo(value(w.i[0]->arg2)); },
+        [](Window& w){
+            w.i[0]->op = Operator::SHIFT_LEFT;
+            w.i[0]->arg2 = powerOfTwo(value(w.i[0]->arg2));
+        }},
+
+    {"mul to lea",
+        {{{Operator::MUL2, Operator::MUL3}, Shape::REG, Shape::INT, Shape::NONE}},
+        [](Window& w){
+            auto constant = value(w.i[0]->arg2);
+            return constant == 3 || constant == 5 || constant == 9;
+        },
+        [](Window& w){
+            auto r = reg(w.i[0]->arg1);
+
+            w.i[0]->op = Operator::LEA;
+            w.i[0]->arg2 = ltac::Address(r, r, value(w.i[0]->arg2) - 1, 0);
+        }},
+
+    //MUL3 r1, r2, c can be computed with a LEA when c is 2, 3, 5 or 9
+    {"mul3 to lea",
+        {{{Operator::MUL3}, Shape::REG, Shape::REG, Shape::INT}},
+        [](Window& w){
+            auto constant = value(w.i[0]->arg3);
+            return constant == 2 || constant == 3 || constant == 5 || constant == 9;
+        },
+        [](Window& w){
+            auto r = reg(w.i[0]->arg2);
+            auto constant = value(w.i[0]->arg3);
+
+            w.i[0]->op = Operator::LEA;
+            w.i[0]->arg2 = constant == 2 ? ltac::Address(r, r) : ltac::Address(r, r, constant - 1, 0);
+            w.i[0]->arg3.reset();
+        }},
+
+    //TEST reg, reg sets the same flags as CMP reg, 0 with a shorter encoding
+    {"cmp 0 to test",
+        {{{Operator::CMP_INT}, Shape::REG, Shape::INT}},
+        [](Window& w){ return value(w.i[0]->arg2) == 0; },
+        [](Window& w){
+            w.i[0]->op = Operator::TEST;
+            w.i[0]->arg2 = w.i[0]->arg1;
+        }},
+
+    //OR reg, reg does not need to write reg to set the flags
+    {"or to test",
+        {{{Operator::OR}, Shape::REG, Shape::REG}},
+        [](Window& w){ return reg(w.i[0]->arg1) == reg(w.i[0]->arg2); },
+        [](Window& w){ w.i[0]->op = Operator::TEST; }},
+
+    //LEA reg, [base] is a MOV
+    {"lea to mov",
+        {{{Operator::LEA}, Shape::REG, Shape::ADDRESS}},
+        [](Window& w){
+            auto& a = address(w.i[0]->arg2);
+            return a.base_register && boost::get<ltac::Register>(&*a.base_register) && !a.scaled_register && !a.absolute
+                && (!a.displacement || *a.displacement == 0);
+        },
+        [](Window& w){
+            w.i[0]->op = Operator::MOV;
+            w.i[0]->arg2 = boost::get<ltac::Register>(*address(w.i[0]->arg2).base_register);
+        }},
+
+    /* Rules on three instructions */
+
+    //MOV r1, r2; SHIFT_LEFT r1, k; ADD r1, r3 is a scaled LEA
+    {"shift add to lea",
+        {{{Operator::MOV}, Shape::REG, Shape::REG}, {{Operator::SHIFT_LEFT}, Shape::REG, Shape::INT}, {{Operator::ADD}, Shape::REG, Shape::REG}},
+        [](Window& w){
+            auto r1 = reg(w.i[0]->arg1);
+            auto shift = value(w.i[1]->arg2);
+
+            return r1 != reg(w.i[0]->arg2) && reg(w.i[1]->arg1) == r1 && reg(w.i[2]->arg1) == r1 && reg(w.i[2]->arg2) != r1
+                && shift >= 1 && shift <= 3 && flags_dead(w);
+        },
+        [](Window& w){
+            w.i[2]->op = Operator::LEA;
+            w.i[2]->arg2 = ltac::Address(reg(w.i[2]->arg2), reg(w.i[0]->arg2), 1 << value(w.i[1]->arg2), 0);
+
+            nop(w.i[0]);
+            nop(w.i[1]);
+        }},
+
+    /* Rules on two instructions */
+
+    //Statements after RET are dead
+    {"dead after ret",
+        {{{Operator::RET}}, {{}}},
+        nullptr,
+        [](Window& w){ nop(w.i[1]); }},
+
+    //Two following LEAVE are not useful
+    {"double leave",
+        {{{Operator::LEAVE}}, {{Operator::LEAVE}}},
+        nullptr,
+        [](Window& w){ nop(w.i[1]); }},
+
+    {"combine add/sub",
+        {{{Operator::ADD, Operator::SUB}, Shape::REG, Shape::INT}, {{Operator::ADD, Operator::SUB}, Shape::REG, Shape::INT}},
+        [](Window& w){ return reg(w.i[0]->arg1) == reg(w.i[1]->arg1) && flags_dead(w); },
+        [](Window& w){
+            auto second = value(w.i[1]->arg2);
+
+            w.i[0]->arg2 = value(w.i[0]->arg2) + (w.i[0]->op == w.i[1]->op ? second : -second);
+
+            nop(w.i[1]);
+        }},
+
+    //Cross MOV (r1 = r2, r2 = r1), keep only the first
+    {"cross mov",
+        {{{Operator::MOV}, Shape::REG, Shape::REG}, {{Operator::MOV}, Shape::REG, Shape::REG}},
+        [](Window& w){ return reg(w.i[0]->arg1) == reg(w.i[1]->arg2) && reg(w.i[0]->arg2) == reg(w.i[1]->arg1); },
+        [](Window& w){ nop(w.i[1]); }},
+
+    //Storing a value just loaded from the same address
+    {"redundant store",
+        {{{Operator::MOV}, Shape::REG, Shape::ADDRESS}, {{Operator::MOV}, Shape::ADDRESS, Shape::REG}},
+        [](Window& w){
+            auto r = reg(w.i[0]->arg1);
+            return r == reg(w.i[1]->arg2) && !uses(w.i[0]->arg2, r) && address(w.i[0]->arg2) == address(w.i[1]->arg1);
+        },
+        [](Window& w){ nop(w.i[1]); }},
+
+    //Loading a value just stored to the same address
+    {"redundant load",
+        {{{Operator::MOV}, Shape::ADDRESS, Shape::REG}, {{Operator::MOV}, Shape::REG, Shape::ADDRESS}},
+        [](Window& w){ return reg(w.i[0]->arg2) == reg(w.i[1]->arg1) && address(w.i[0]->arg1) == address(w.i[1]->arg2); },
+        [](Window& w){ nop(w.i[1]); }},
+
+    //The first MOV of a chain of MOV to the same register is dead
+    {"dead mov",
+        {{{Operator::MOV}, Shape::REG}, {{Operator::MOV}, Shape::REG}},
+        [](Window& w){
+            auto r = reg(w.i[0]->arg1);
+            return r == reg(w.i[1]->arg1) && !uses(w.i[1]->arg2, r);
+        },
+        [](Window& w){ nop(w.i[0]); }},
+
+    //The first store of two stores to the same address is dead
+    {"dead store",
+        {{{Operator::MOV}, Shape::ADDRESS}, {{Operator::MOV}, Shape::ADDRESS}},
+        [](Window& w){ return !boost::get<ltac::Address>(&*w.i[1]->arg2) && address(w.i[0]->arg1) == address(w.i[1]->arg1); },
+        [](Window& w){ nop(w.i[0]); }},
+
+    {"mov add to lea",
+        {{{Operator::MOV}, Shape::REG}, {{Operator::ADD}, Shape::REG}},
+        [](Window& w){
+            auto r = reg(w.i[0]->arg1);
+
+            if(r != reg(w.i[1]->arg1)){
+                return false;
+            }
+
+            auto& source = *w.i[0]->arg2;
+            auto& added = *w.i[1]->arg2;
+
+            if(auto* ptr = boost::get<ltac::Register>(&source)){
+                if(*ptr == r || !(boost::get<int>(&added) || boost::get<ltac::Register>(&added))){
+                    return false;
+                }
+            } else if(!boost::get<std::string>(&source) || !boost::get<int>(&added)){
+                return false;
+            }
+
+            return flags_dead(w);
+        },
+        [](Window& w){
+            auto r = reg(w.i[0]->arg1);
+
+            auto& source = *w.i[0]->arg2;
+            auto& added = *w.i[1]->arg2;
+
+            w.i[1]->op = Operator::LEA;
+
+            if(auto* ptr = boost::get<std::string>(&source)){
+                w.i[1]->arg2 = ltac::Address(*ptr, boost::get<int>(added));
+            } else if(auto* ptr = boost::get<int>(&added)){
+                w.i[1]->arg2 = ltac::Address(boost::get<ltac::Register>(source), *ptr);
+            } else {
+                //ADD r1, r1 adds the source register twice
+                auto scaled = boost::get<ltac::Register>(added) == r ? boost::get<ltac::Register>(source) : boost::get<ltac::Register>(added);
+                w.i[1]->arg2 = ltac::Address(boost::get<ltac::Register>(source), scaled);
+            }
+
+            nop(w.i[0]);
+        }},
+
+    {"pop push to mov",
+        {{{Operator::POP}, Shape::REG}, {{Operator::PUSH}, Shape::REG}},
+        [](Window& w){ return reg(w.i[0]->arg1) == reg(w.i[1]->arg1); },
+        [](Window& w){
+            w.i[0]->op = Operator::MOV;
+            w.i[0]->arg2 = ltac::Address(ltac::SP, 0);
+
+            nop(w.i[1]);
+        }},
+
+    //PUSH r1; POP r2 is a MOV r2, r1
+    {"push pop",
+        {{{Operator::PUSH}, Shape::REG}, {{Operator::POP}, Shape::REG}},
+        nullptr,
+        [](Window& w){
+            if(reg(w.i[0]->arg1) == reg(w.i[1]->arg1)){
+                nop(w.i[1]);
+            } else {
+                w.i[1]->op = Operator::MOV;
+                w.i[1]->arg2 = w.i[0]->arg1;
+            }
+
+            nop(w.i[0]);
+        }},
+
+    /* Second phase rules on two instructions */
+
+    //Forward the source of a MOV into a parameter or return register
+    {"forward mov",
+        {{{Operator::MOV}, Shape::REG}, {{Operator::MOV}, Shape::REG, Shape::REG}},
+        [](Window& w){
+            auto r = reg(w.i[0]->arg1);
+            return reg(w.i[1]->arg2) == r && !uses(w.i[0]->arg2, r) && is_param_register(reg(w.i[1]->arg1), w.platform);
+        },
+        [](Window& w){ w.i[1]->arg2 = w.i[0]->arg2; }},
+
+    {"forward push",
+        {{{Operator::MOV}, Shape::REG}, {{Operator::PUSH}, Shape::REG}},
+        [](Window& w){
+            auto r = reg(w.i[0]->arg1);
+            return reg(w.i[1]->arg1) == r && !ltac::is_float_reg(*w.i[0]->arg2) && !uses(w.i[0]->arg2, r);
+        },
+        [](Window& w){ w.i[1]->arg1 = w.i[0]->arg2; }},
+
+    /* Instruction selection, once the other rules do not apply */
+
+    //MOV reg, 0 is longer than XOR reg, reg
+    {"mov 0 to xor",
+        {{{Operator::MOV}, Shape::REG, Shape::INT}},
+        [](Window& w){ return value(w.i[0]->arg2) == 0 && flags_dead(w); },
+        [](Window& w){
+            w.i[0]->op = Operator::XOR;
+            w.i[0]->arg2 = w.i[0]->arg1;
+        }},
+
+    //INC and DEC are shorter than ADD and SUB but do not set the carry flag
+    {"add/sub 1 to inc/dec",
+        {{{Operator::ADD, Operator::SUB}, Shape::REG, Shape::INT}},
+        [](Window& w){ return (value(w.i[0]->arg2) == 1 || value(w.i[0]->arg2) == -1) && carry_dead(w); },
+        [](Window& w){
+            bool increment = (w.i[0]->op == Operator::ADD) == (value(w.i[0]->arg2) == 1);
+
+            w.i[0]->op = increment ? Operator::INC : Operator::DEC;
+            w.i[0]->arg2.reset();
+        }},
+};
+
+const std::size_t number_of_rules = sizeof(rules) / sizeof(rules[0]);
+
+//The functions are optimized in parallel
+std::atomic<std::size_t> hits[number_of_rules];
+
+/* Decision tree */
+
+const std::size_t number_of_operators = static_cast<std::size_t>(Operator::NOP) + 1;
+
+//The child of a node followed by any operator
+const std::size_t any_operator = number_of_operators;
+
+/*!
+ * A node of the decision tree. The children are indexed by the operator of the next instruction
+ * of the window. The rules are the ones whose window ends at this node.
+ */
+struct Node {
+    std::vector<std::size_t> rules;
+    std::vector<std::unique_ptr<Node>> children;
+
+    Node() : children(number_of_operators + 1) {}
+};
+
+void insert(Node& node, std::size_t rule, std::size_t depth){
+    auto& patterns = rules[rule].patterns;
+
+    if(depth == patterns.size()){
+        node.rules.push_back(rule);
+        return;
+    }
+
+    std::vector<std::size_t> indices;
+
+    if(patterns[depth].ops.empty()){
+        indices.push_back(any_operator);
+    } else {
+        for(auto op : patterns[depth].ops){
+            indices.push_back(static_cast<std::size_t>(op));
+        }
+    }
+
+    for(auto index : indices){
+        auto& child = node.children[index];
+
+        if(!child){
+            child.reset(new Node());
+        }
+
+        insert(*child, rule, depth + 1);
+    }
+}
+
+std::unique_ptr<Node> build_tree(){
+    std::unique_ptr<Node> root(new Node());
+
+    for(std::size_t rule = 0; rule < number_of_rules; ++rule){
+        insert(*root, rule, 0);
+    }
+
+    return root;
+}
+
+/*!
+ * The decision tree stored in arrays, as it is generated in peephole_tree.inc. The root is the 
+ * node 0, so 0 also means that there is no child. 
+ */
+struct FlatTree {
+    std::vector<std::vector<unsigned short>> children;
+    std::vector<unsigned short> rules_begin;
+    std::vector<unsigned short> rules;
+};
+
+unsigned short flatten(const Node& node, FlatTree& tree){
+    auto index = tree.children.size();
+
+    tree.children.emplace_back(number_of_operators + 1, 0);
+    tree.rules_begin.push_back(tree.rules.size());
+    tree.rules.insert(tree.rules.end(), node.rules.begin(), node.rules.end());
+
+    for(std::size_t op = 0; op <= number_of_operators; ++op){
+        if(auto& child = node.children[op]){
+            auto child_index = flatten(*child, tree);
+            tree.children[index][op] = child_index;
+        }
+    }
+
+    return index;
+}
+
+FlatTree flatten(const Node& root){
+    FlatTree tree;
+    flatten(root, tree);
+    tree.rules_begin.push_back(tree.rules.size());
+    return tree;
+}
+
+} //end of anonymous namespace
+
+#ifndef PEEPHOLE_TREE_GENERATOR
+
+//Generated at build time by peephole_tree_generator
+#include "peephole_tree.inc"
+
+namespace {
+
+//Collect the rules whose operators match the window
+void collect(std::size_t node, Window& window, std::size_t depth, std::vector<std::size_t>& candidates){
+    candidates.insert(candidates.end(), tree_rules + tree_rules_begin[node], tree_rules + tree_rules_begin[node + 1]);
+
+    auto position = window.position + depth;
+
+    if(depth == window.i.size() || position >= window.statements.size()){
+        return;
+    }
+
+    if(auto* ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&window.statements[position])){
+        auto op = (*ptr)->op;
+
+        if(op == Operator::NOP){
+            return;
+        }
+
+        window.i[depth] = *ptr;
+
+        if(auto child = tree_children[node][static_cast<std::size_t>(op)]){
+            collect(child, window, depth + 1, candidates);
+        }
+
+        if(auto child = tree_children[node][any_operator]){
+            collect(child, window, depth + 1, candidates);
+        }
+    }
+}
+
+bool matches(Shape shape, boost::optional<ltac::Argument>& arg){
+    switch(shape){
+        case Shape::ANY:
+            return true;
+        case Shape::NONE:
+            return !arg;
+        case Shape::REG:
+            return arg && boost::get<ltac::Register>(&*arg);
+        case Shape::FLOAT_REG:
+            return arg && boost::get<ltac::FloatRegister>(&*arg);
+        case Shape::INT:
+            return arg && boost::get<int>(&*arg);
+        case Shape::ADDRESS:
+            return arg && boost::get<ltac::Address>(&*arg);
+        case Shape::LABEL:
+            return arg && boost::get<std::string>(&*arg);
+    }
+
+    return false;
+}
+
+//Check the shapes of the operands, the operators are already matched by the tree
+bool matches(const Rule& rule, Window& window){
+    for(std::size_t j = 0; j < rule.patterns.size(); ++j){
+        auto& pattern = rule.patterns[j];
+        auto& instruction = window.i[j];
+
+        if(pattern.ops.empty()){
+            continue;
+        }
+
+        //The sized MOV are loads with extension
+        if(instruction->size != ltac::Size::DEFAULT){
+            return false;
+        }
+
+        if(!matches(pattern.arg1, instruction->arg1) || !matches(pattern.arg2, instruction->arg2) || !matches(pattern.arg3, instruction->arg3)){
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} //end of anonymous namespace
+
+bool ltac::apply_peephole_rules(mtac::basic_block_p block, std::size_t position, Platform platform){
+    Window window{block->l_statements, position, block, platform, {{}}, 0};
+
+    std::vector<std::size_t> candidates;
+    collect(0, window, 0, candidates);
+
+    std::sort(candidates.begin(), candidates.end());
+
+    for(auto index : candidates){
+        auto& rule = rules[index];
+
+        window.length = rule.patterns.size();
+
+        if(matches(rule, window) && (!rule.guard || rule.guard(window))){
+            rule.rewrite(window);
+
+            hits[index].fetch_add(1, std::memory_order_relaxed);
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+#else
+
+//The generator only prints the decision tree, it never optimizes
+bool ltac::apply_peephole_rules(mtac::basic_block_p, std::size_t, Platform){
+    eddic_unreachable("The peephole tree generator does not apply the rules");
+}
+
+#endif
+
+void ltac::print_peephole_rules_statistics(std::ostream& out){
+    for(std::size_t i = 0; i < number_of_rules; ++i){
+        out << "  " << std::left << std::setw(24) << rules[i].name << hits[i].load() << std::endl;
+    }
+}
+
+void ltac::generate_peephole_tree(std::ostream& out){
+    auto tree = flatten(*build_tree());
+
+    out << "//Generated by peephole_tree_generator from the rules of peephole_rules.cpp" << std::endl;
+    out << std::endl;
+    out << "namespace {" << std::endl;
+    out << std::endl;
+    out << "const std::size_t generated_operators = " << number_of_operators << ";" << std::endl;
+    out << std::endl;
+    out << "//The children of each node, indexed by the operator of the next instruction, the last one is any operator" << std::endl;
+    out << "const unsigned short tree_children[][generated_operators + 1] = {" << std::endl;
+
+    for(auto& children : tree.children){
+        out << "    {";
+
+        for(std::size_t op = 0; op < children.size(); ++op){
+            out << (op == 0 ? "" : ",") << children[op];
+        }
+
+        out << "}," << std::endl;
+    }
+
+    out << "};" << std::endl;
+    out << std::endl;
+    out << "//The rules of the node i are tree_rules[tree_rules_begin[i]] to tree_rules[tree_rules_begin[i + 1]]" << std::endl;
+    out << "const unsigned short tree_rules_begin[] = {";
+
+    for(std::size_t i = 0; i < tree.rules_begin.size(); ++i){
+        out << (i == 0 ? "" : ", ") << tree.rules_begin[i];
+    }
+
+    out << "};" << std::endl;
+    out << std::endl;
+    out << "const unsigned short tree_rules[] = {";
+
+    for(std::size_t i = 0; i < tree.rules.size(); ++i){
+        out << (i == 0 ? "" : ", ") << tree.rules[i];
+    }
+
+    out << "};" << std::endl;
+    out << std::endl;
+    out << "} //end of anonymous namespace" << std::endl;
+}
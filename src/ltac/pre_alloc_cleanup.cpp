@@ -23,40 +23,44 @@ bool is_float_pseudo_reg(Variant& var){
     return boost::get<ltac::PseudoFloatRegister>(&*var);
 }
 
-void ltac::pre_alloc_cleanup(mtac::program_p program){
-    for(auto& function : program->functions){
-        for(auto& bb : function){
-            auto it = iterate(bb->l_statements);
+void ltac::pre_alloc_cleanup(mtac::function_p function){
+    for(auto& bb : function){
+        auto it = iterate(bb->l_statements);
 
-            while(it.has_next()){
-                auto statement = *it;
+        while(it.has_next()){
+            auto statement = *it;
 
-                if(auto* ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&statement)){
-                    auto instruction = *ptr;
+            if(auto* ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&statement)){
+                auto instruction = *ptr;
 
-                    if(instruction->op == ltac::Operator::MOV && is_pseudo_reg(instruction->arg1) && is_pseudo_reg(instruction->arg2)){
-                        auto reg1 = boost::get<ltac::PseudoRegister>(*instruction->arg1);
-                        auto reg2 = boost::get<ltac::PseudoRegister>(*instruction->arg2);
+                if(instruction->op == ltac::Operator::MOV && is_pseudo_reg(instruction->arg1) && is_pseudo_reg(instruction->arg2)){
+                    auto reg1 = boost::get<ltac::PseudoRegister>(*instruction->arg1);
+                    auto reg2 = boost::get<ltac::PseudoRegister>(*instruction->arg2);
 
-                        if(reg1 == reg2){
-                            it.erase();
-                            continue;
-                        }
-                    }
-                    
-                    if(instruction->op == ltac::Operator::FMOV && is_float_pseudo_reg(instruction->arg1) && is_float_pseudo_reg(instruction->arg2)){
-                        auto reg1 = boost::get<ltac::PseudoFloatRegister>(*instruction->arg1);
-                        auto reg2 = boost::get<ltac::PseudoFloatRegister>(*instruction->arg2);
-
-                        if(reg1 == reg2){
-                            it.erase();
-                            continue;
-                        }
+                    if(reg1 == reg2){
+                        it.erase();
+                        continue;
                     }
                 }
+                
+                if(instruction->op == ltac::Operator::FMOV && is_float_pseudo_reg(instruction->arg1) && is_float_pseudo_reg(instruction->arg2)){
+                    auto reg1 = boost::get<ltac::PseudoFloatRegister>(*instruction->arg1);
+                    auto reg2 = boost::get<ltac::PseudoFloatRegister>(*instruction->arg2);
 
-                ++it;
+                    if(reg1 == reg2){
+                        it.erase();
+                        continue;
+                    }
+                }
             }
+
+            ++it;
         }
     }
 }
+
+void ltac::pre_alloc_cleanup(mtac::program_p program){
+    for(auto& function : program->functions){
+        ltac::pre_alloc_cleanup(function);
+    }
+}
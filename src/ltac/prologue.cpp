@@ -8,6 +8,7 @@
 #include <boost/range/adaptors.hpp>
 
 #include "GlobalContext.hpp"
+#include "arena.hpp"
 #include "FunctionContext.hpp"
 #include "Type.hpp"
 #include "Variable.hpp"
@@ -20,6 +21,23 @@ using namespace eddic;
 
 namespace {
 
+//The blocks up to this size (in bytes) are cleared with stores instead of a call to _memzero
+const int memset_inline_limit = 64;
+
+void clear_stack(mtac::function_p function, mtac::basic_block_p bb, int position, int words, Platform platform){
+    int int_size = INT->size(platform);
+
+    if(words * int_size <= memset_inline_limit){
+        for(int i = 0; i < words; ++i){
+            ltac::add_instruction(bb, ltac::Operator::MOV, ltac::Address(ltac::BP, position + i * int_size), 0);
+        }
+    } else {
+        function->context->global()->addReference("_memzero");
+
+        ltac::add_instruction(bb, ltac::Operator::MEMSET, ltac::Address(ltac::BP, position), words * int_size);
+    }
+}
+
 std::set<ltac::Register> parameter_registers(std::shared_ptr<eddic::Function> function, Platform platform, std::shared_ptr<Configuration> configuration){
     std::set<ltac::Register> overriden_registers;
 
@@ -146,14 +164,14 @@ void callee_restore_registers(mtac::function_p function, It& it, Platform platfo
     if(!function->is_main()){
         for(auto& reg : function->use_registers()){
             if(callee_save(function->definition, reg, platform, configuration)){
-                it.insert(std::make_shared<ltac::Instruction>(ltac::Operator::POP, reg));
+                it.insert(make_node<ltac::Instruction>(ltac::Operator::POP, reg));
             }
         }
 
         for(auto& float_reg : function->use_float_registers()){
             if(callee_save(function->definition, float_reg, platform, configuration)){
-                it.insert(std::make_shared<ltac::Instruction>(ltac::Operator::ADD, ltac::SP, static_cast<int>(FLOAT->size(platform))));
-                it.insert(std::make_shared<ltac::Instruction>(ltac::Operator::FMOV, float_reg, ltac::Address(ltac::SP, 0)));
+                it.insert(make_node<ltac::Instruction>(ltac::Operator::ADD, ltac::SP, static_cast<int>(FLOAT->size(platform))));
+                it.insert(make_node<ltac::Instruction>(ltac::Operator::FMOV, float_reg, ltac::Address(ltac::SP, 0)));
             }
         }
     }
@@ -213,14 +231,14 @@ void caller_save_registers(mtac::function_p function, std::shared_ptr<eddic::Fun
 
                     for(auto& float_reg : boost::adaptors::reverse(function->use_float_registers())){
                         if(caller_save(function, target_function, float_reg, platform, configuration)){
-                            pre_it = bb->l_statements.insert(pre_it, std::make_shared<ltac::Instruction>(ltac::Operator::FMOV, ltac::Address(ltac::SP, 0), float_reg));
-                            pre_it = bb->l_statements.insert(pre_it, std::make_shared<ltac::Instruction>(ltac::Operator::SUB, ltac::SP, static_cast<int>(FLOAT->size(platform))));
+                            pre_it = bb->l_statements.insert(pre_it, make_node<ltac::Instruction>(ltac::Operator::FMOV, ltac::Address(ltac::SP, 0), float_reg));
+                            pre_it = bb->l_statements.insert(pre_it, make_node<ltac::Instruction>(ltac::Operator::SUB, ltac::SP, static_cast<int>(FLOAT->size(platform))));
                         }
                     }
                     
                     for(auto& reg : boost::adaptors::reverse(function->use_registers())){
                         if(caller_save(function, target_function, reg, platform, configuration)){
-                            pre_it = bb->l_statements.insert(pre_it, std::make_shared<ltac::Instruction>(ltac::Operator::PUSH, reg));
+                            pre_it = bb->l_statements.insert(pre_it, make_node<ltac::Instruction>(ltac::Operator::PUSH, reg));
                         }
                     }
 
@@ -279,127 +297,131 @@ void caller_cleanup(mtac::function_p function, std::shared_ptr<eddic::Function>
 
     for(auto& float_reg : boost::adaptors::reverse(function->use_float_registers())){
         if(caller_save(function, target_function, float_reg, platform, configuration)){
-            it.insert_after(std::make_shared<ltac::Instruction>(ltac::Operator::FMOV, float_reg, ltac::Address(ltac::SP, 0)));
-            it.insert_after(std::make_shared<ltac::Instruction>(ltac::Operator::ADD, ltac::SP, static_cast<int>(FLOAT->size(platform))));
+            it.insert_after(make_node<ltac::Instruction>(ltac::Operator::FMOV, float_reg, ltac::Address(ltac::SP, 0)));
+            it.insert_after(make_node<ltac::Instruction>(ltac::Operator::ADD, ltac::SP, static_cast<int>(FLOAT->size(platform))));
         }
     }
     
     for(auto& reg : boost::adaptors::reverse(function->use_registers())){
         if(caller_save(function, target_function, reg, platform, configuration)){
-            it.insert_after(std::make_shared<ltac::Instruction>(ltac::Operator::POP, reg));
+            it.insert_after(make_node<ltac::Instruction>(ltac::Operator::POP, reg));
         }
     }
 }
 
 } //End of anonymous
 
-void ltac::generate_prologue_epilogue(mtac::program_p ltac_program, std::shared_ptr<Configuration> configuration){
+void ltac::generate_prologue_epilogue(mtac::function_p function, Platform platform, std::shared_ptr<Configuration> configuration){
     bool omit_fp = configuration->option_defined("fomit-frame-pointer");
-    auto platform = ltac_program->context->target_platform();
 
-    for(auto& function : ltac_program->functions){
-        auto size = function->context->size();
+    auto size = function->context->size();
 
-        //1. Generate prologue
-        
-        auto bb = function->entry_bb();
+    //1. Generate prologue
     
-        //Enter stack frame
-        if(!omit_fp){
-            ltac::add_instruction(bb, ltac::Operator::ENTER);
-        }
+    auto bb = function->entry_bb();
 
-        //Allocate stack space for locals
-        ltac::add_instruction(bb, ltac::Operator::SUB, ltac::SP, size);
+    //Enter stack frame
+    if(!omit_fp){
+        ltac::add_instruction(bb, ltac::Operator::ENTER);
+    }
 
-        auto iter = function->context->begin();
-        auto end = function->context->end();
+    //Allocate stack space for locals
+    ltac::add_instruction(bb, ltac::Operator::SUB, ltac::SP, size);
 
-        //Clear stack variables
-        for(; iter != end; iter++){
-            auto var = iter->second;
+    auto iter = function->context->begin();
+    auto end = function->context->end();
 
-            //Only stack variables needs to be cleared
-            if(var->position().isStack()){
-                auto type = var->type();
-                int position = var->position().offset();
+    //Clear stack variables
+    for(; iter != end; iter++){
+        auto var = iter->second;
 
-                auto int_size = INT->size(platform);
+        //Only stack variables needs to be cleared
+        if(var->position().isStack()){
+            auto type = var->type();
+            int position = var->position().offset();
 
-                if(type->is_array() && type->has_elements()){
-                    ltac::add_instruction(bb, ltac::Operator::MOV, ltac::Address(ltac::BP, position), static_cast<int>(type->elements()));
-                    ltac::add_instruction(bb, ltac::Operator::MEMSET, ltac::Address(ltac::BP, position + int_size), 
-                            static_cast<int>((type->data_type()->size(platform) / int_size * type->elements())));
-                } else if(type->is_custom_type()){
-                    ltac::add_instruction(bb, ltac::Operator::MEMSET, ltac::Address(ltac::BP, position), static_cast<int>(type->size(platform) / int_size));
-                }
+            auto int_size = INT->size(platform);
+
+            if(type->is_array() && type->has_elements()){
+                ltac::add_instruction(bb, ltac::Operator::MOV, ltac::Address(ltac::BP, position), static_cast<int>(type->elements()));
+                clear_stack(function, bb, position + int_size, type->data_type()->size(platform) / int_size * type->elements(), platform);
+            } else if(type->is_custom_type()){
+                clear_stack(function, bb, position, type->size(platform) / int_size, platform);
             }
         }
+    }
 
-        callee_save_registers(function, bb, platform, configuration);
+    callee_save_registers(function, bb, platform, configuration);
 
-        //2. Generate epilogue
+    //2. Generate epilogue
 
-        bb = function->exit_bb();
+    bb = function->exit_bb();
 
-        callee_restore_registers(function, bb, platform, configuration);
+    callee_restore_registers(function, bb, platform, configuration);
 
-        ltac::add_instruction(bb, ltac::Operator::ADD, ltac::SP, size);
+    ltac::add_instruction(bb, ltac::Operator::ADD, ltac::SP, size);
 
-        //Leave stack frame
-        if(!omit_fp){
-            ltac::add_instruction(bb, ltac::Operator::LEAVE);
-        }
+    //Leave stack frame
+    if(!omit_fp){
+        ltac::add_instruction(bb, ltac::Operator::LEAVE);
+    }
 
-        ltac::add_instruction(bb, ltac::Operator::RET);
-        
-        //3. Generate epilogue for each unresolved RET
-        
-        for(auto& bb : function){
-            auto it = iterate(bb->l_statements);
+    ltac::add_instruction(bb, ltac::Operator::RET);
+    
+    //3. Generate epilogue for each unresolved RET
+    
+    for(auto& bb : function){
+        auto it = iterate(bb->l_statements);
 
-            while(it.has_next()){
-                auto statement = *it;
+        while(it.has_next()){
+            auto statement = *it;
 
-                if(auto* ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&statement)){
-                    if((*ptr)->op == ltac::Operator::PRE_RET){
-                        (*ptr)->op = ltac::Operator::RET;
+            if(auto* ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&statement)){
+                if((*ptr)->op == ltac::Operator::PRE_RET){
+                    (*ptr)->op = ltac::Operator::RET;
 
-                        //Leave stack frame
-                        if(!omit_fp){
-                            it.insert(std::make_shared<ltac::Instruction>(ltac::Operator::LEAVE));
-                        }
+                    //Leave stack frame
+                    if(!omit_fp){
+                        it.insert(make_node<ltac::Instruction>(ltac::Operator::LEAVE));
+                    }
 
-                        it.insert(std::make_shared<ltac::Instruction>(ltac::Operator::ADD, ltac::SP, size));
+                    it.insert(make_node<ltac::Instruction>(ltac::Operator::ADD, ltac::SP, size));
 
-                        callee_restore_registers(function, it, platform, configuration);
-                    }
+                    callee_restore_registers(function, it, platform, configuration);
                 }
-
-                ++it;
             }
+
+            ++it;
         }
+    }
 
-        //4. Generate caller save/restore code
-       
-        for(auto& bb : function){
-            auto it = iterate(bb->l_statements);
+    //4. Generate caller save/restore code
+   
+    for(auto& bb : function){
+        auto it = iterate(bb->l_statements);
 
-            while(it.has_next()){
-                auto statement = *it;
+        while(it.has_next()){
+            auto statement = *it;
 
-                if(auto* ptr = boost::get<std::shared_ptr<ltac::Jump>>(&statement)){
-                    if((*ptr)->type == ltac::JumpType::CALL){
-                        caller_cleanup(function, (*ptr)->target_function, bb, it, platform, configuration);
+            if(auto* ptr = boost::get<std::shared_ptr<ltac::Jump>>(&statement)){
+                if((*ptr)->type == ltac::JumpType::CALL){
+                    caller_cleanup(function, (*ptr)->target_function, bb, it, platform, configuration);
 
-                        //The iterator is invalidated by the cleanup, necessary to find the call again
-                        it.restart();
-                        find(it, *ptr);
-                    }
+                    //The iterator is invalidated by the cleanup, necessary to find the call again
+                    it.restart();
+                    find(it, *ptr);
                 }
-
-                ++it;
             }
+
+            ++it;
         }
     }
 }
+
+void ltac::generate_prologue_epilogue(mtac::program_p ltac_program, std::shared_ptr<Configuration> configuration){
+    auto platform = ltac_program->context->target_platform();
+
+    for(auto& function : ltac_program->functions){
+        ltac::generate_prologue_epilogue(function, platform, configuration);
+    }
+}
@@ -6,7 +6,12 @@
 //=======================================================================
 
 #include <list>
+#include <set>
+#include <algorithm>
+#include <limits>
 
+#include "assert.hpp"
+#include "arena.hpp"
 #include "PerfsTimer.hpp"
 #include "logging.hpp"
 #include "FunctionContext.hpp"
@@ -14,7 +19,7 @@
 #include "Type.hpp"
 
 #include "mtac/Statement.hpp"
-#include "mtac/GlobalOptimizations.hpp"
+#include "mtac/frequencies.hpp"
 
 #include "ltac/Statement.hpp"
 #include "ltac/LiveRegistersProblem.hpp"
@@ -26,13 +31,25 @@
 /*
  * Register allocation using Chaitin-style graph coloring allocation. 
  *
- * The renumber and coalescing are simplified by renumbering coalescing 
- * only pseudo registers that are local to a basic block. 
+ * The renumber is simplified by renumbering only pseudo registers that 
+ * are local to a basic block. The simplify, coalesce, freeze and spill 
+ * phases are done with the iterated coalescing of George and Appel and 
+ * Briggs optimistic coloring. 
+ *
+ * The faster linear scan allocation (Poletto and Sarkar) is used when 
+ * graph coloring is not enabled. It allocates the live intervals in the 
+ * linear order of the statements and spills the interval with the lowest 
+ * spill cost per position. 
+ *
+ * The spill costs are weighted by the execution frequencies of the basic 
+ * blocks, estimated statically or read from a profile. 
+ *
+ * The spilled registers with a single cheap definition are rematerialized 
+ * at each use. The live ranges of the other spilled registers are split 
+ * around the loops they are only used in. 
  *
  * TODO:
- *  - Use Chaitin-Briggs optimistic coloring
- *  - Implement rematerialization
- *  - Use UD-chains and make renumber and coalescing complete
+ *  - Use UD-chains and make renumber complete
  */
 
 using namespace eddic;
@@ -261,6 +278,36 @@ get_special_uses(Stmt& instruction, std::unordered_set<Pseudo>& local_pseudo_reg
     }
 }
 
+
+template<typename Pseudo>
+typename std::enable_if<std::is_same<Pseudo, ltac::PseudoRegister>::value, std::vector<Pseudo>&>::type 
+get_special_kills(std::shared_ptr<ltac::Jump>& jump){
+    return jump->kills;
+}
+
+template<typename Pseudo>
+typename std::enable_if<std::is_same<Pseudo, ltac::PseudoFloatRegister>::value, std::vector<Pseudo>&>::type 
+get_special_kills(std::shared_ptr<ltac::Jump>& jump){
+    return jump->float_kills;
+}
+
+//Call the functor with the registers written by the statement
+
+template<typename Pseudo, typename Functor>
+void definitions(ltac::Statement& statement, Functor functor){
+    if(auto* ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&statement)){
+        if((*ptr)->op != ltac::Operator::NOP && (*ptr)->arg1 && ltac::erase_result((*ptr)->op)){
+            if(auto* reg_ptr = boost::get<Pseudo>(&*(*ptr)->arg1)){
+                functor(*reg_ptr);
+            }
+        }
+    } else if(auto* ptr = boost::get<std::shared_ptr<ltac::Jump>>(&statement)){
+        for(auto& reg : get_special_kills<Pseudo>(*ptr)){
+            functor(reg);
+        }
+    }
+}
+
 template<typename Pseudo>
 void find_local_registers(mtac::function_p function, local_reg<Pseudo>& local_pseudo_registers){
     local_reg<Pseudo> pseudo_registers;
@@ -379,27 +426,30 @@ template<typename Pseudo>
 void gather_pseudo_regs(mtac::function_p function, ltac::interference_graph<Pseudo>& graph){
     for(auto& bb : function){
         for(auto& statement : bb->l_statements){
+            std::unordered_set<Pseudo> registers;
+
             if(auto* ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&statement)){
                 gather((*ptr)->arg1, graph);
                 gather((*ptr)->arg2, graph);
                 gather((*ptr)->arg3, graph);
+
+                get_special_uses(*ptr, registers);
+            } else if(auto* ptr = boost::get<std::shared_ptr<ltac::Jump>>(&statement)){
+                get_special_uses(*ptr, registers);
+            }
+
+            //The implicit uses and kills must be part of the graph as well
+            for(auto& reg : registers){
+                graph.gather(reg);
             }
+
+            definitions<Pseudo>(statement, [&graph](Pseudo& reg){ graph.gather(reg); });
         }
     }
 
     log::emit<Trace>("registers") << "Found " << graph.size() << " pseudo registers" << log::endl;
 }
 
-template<typename Pseudo, typename Results>
-typename std::enable_if<std::is_same<Pseudo, ltac::PseudoRegister>::value, std::unordered_set<Pseudo>&>::type get_live_results(Results& results){
-    return results.registers;
-}
-
-template<typename Pseudo, typename Results>
-typename std::enable_if<std::is_same<Pseudo, ltac::PseudoFloatRegister>::value, std::unordered_set<Pseudo>&>::type get_live_results(Results& results){
-    return results.float_registers;
-}
-
 template<typename Pseudo>
 void build_interference_graph(ltac::interference_graph<Pseudo>& graph, mtac::function_p function){
     //Init the graph structure with the current size
@@ -411,161 +461,102 @@ void build_interference_graph(ltac::interference_graph<Pseudo>& graph, mtac::fun
         return;
     }
 
-    ltac::LivePseudoRegistersProblem problem;
-    auto live_results = mtac::data_flow(function, problem);
-
-    for(auto& bb : function){
-        for(auto& statement : bb->l_statements){
-            auto& live_registers = get_live_results<Pseudo>(live_results->OUT_LS[statement].values());
-
-            if(live_registers.size() > 1){
-                auto it = live_registers.begin();
-                auto end = live_registers.end();
+    ltac::LiveRegistersProblem<Pseudo> problem;
+    auto live_results = mtac::backward_bit_data_flow(function, problem);
 
-                while(it != end){
-                    auto next = it;
-                    ++next;
+    std::vector<std::size_t> live_registers;
 
-                    while(next != end){
-                        graph.add_edge(graph.convert(*it), graph.convert(*next));
+    for(auto& bb : function){
+        live_results->backward_statements(bb, [&graph, &live_registers](ltac::Statement& statement, mtac::BitSet& live){
+            live_registers.clear();
 
-                        ++next;
-                    }
+            for(auto reg = live.find_first(); reg != mtac::BitSet::npos; reg = live.find_next(reg)){
+                live_registers.push_back(graph.convert(Pseudo(reg)));
+            }
 
-                    ++it;
+            for(std::size_t i = 0; i < live_registers.size(); ++i){
+                for(std::size_t j = i + 1; j < live_registers.size(); ++j){
+                    graph.add_edge(live_registers[i], live_registers[j]);
                 }
             }
-        }
-    }
-
-    graph.build_adjacency_vectors();
-}
-
-//3. Coalesce
-
-template<typename Pseudo>
-typename std::enable_if<std::is_same<Pseudo, ltac::PseudoRegister>::value, bool>::type is_copy(ltac::Statement& statement){
-    if(auto* ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&statement)){
-        return (*ptr)->op == ltac::Operator::MOV 
-            && boost::get<Pseudo>(&*(*ptr)->arg1) 
-            && boost::get<Pseudo>(&*(*ptr)->arg2);
-    }
-
-    return false;
-}
-
-template<typename Pseudo>
-typename std::enable_if<std::is_same<Pseudo, ltac::PseudoFloatRegister>::value, bool>::type is_copy(ltac::Statement& statement){
-    if(auto* ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&statement)){
-        return (*ptr)->op == ltac::Operator::FMOV 
-            && boost::get<Pseudo>(&*(*ptr)->arg1) 
-            && boost::get<Pseudo>(&*(*ptr)->arg2);
-    }
-
-    return false;
-}
-
-template<typename Pseudo>
-bool coalesce(ltac::interference_graph<Pseudo>& graph, mtac::function_p function){
-    local_reg<Pseudo> local_pseudo_registers;
-    find_local_registers(function, local_pseudo_registers);
-    
-    std::unordered_set<Pseudo> prune;
-    std::unordered_map<Pseudo, Pseudo> replaces;
-
-    //TODO Instead of pruning dependent registers pairs, update the graph 
-    //and continue to avoid too many rebuilding of the graph
 
-    for(auto& bb : function){
-        for(auto& statement : bb->l_statements){
-            if(is_copy<Pseudo>(statement)){
-                auto instruction = boost::get<std::shared_ptr<ltac::Instruction>>(statement);
-                auto reg1 = boost::get<Pseudo>(*instruction->arg1);
-                auto reg2 = boost::get<Pseudo>(*instruction->arg2);
-
-                if(
-                           reg1 != reg2
-                        && !reg1.bound && !reg2.bound 
-                        && local_pseudo_registers[bb].count(reg1) && local_pseudo_registers[bb].count(reg2) 
-                        && !graph.connected(graph.convert(reg1), graph.convert(reg2))
-                        && !prune.count(reg1) && !prune.count(reg2))
-                {
-                    log::emit<Debug>("registers") << "Coalesce " << reg1 << " and " << reg2 << log::endl;
-
-                    replaces[reg1] = reg2;
-                    prune.insert(reg1);
-                    prune.insert(reg2);
-
-                    ltac::transform_to_nop(instruction);            
+            //A register written but never read must not share a register with the live ones
+            definitions<Pseudo>(statement, [&graph, &live, &live_registers](Pseudo& reg){
+                if(!live.test(reg.reg)){
+                    for(auto live_reg : live_registers){
+                        graph.add_edge(graph.convert(reg), live_reg);
+                    }
                 }
-            }
-        }
+            });
+        });
     }
 
-    replace_registers(function, replaces);
-
-    return !replaces.empty();
+    graph.build_adjacency_vectors();
 }
 
-//4. Spill costs
-
-static const std::size_t store_cost = 5;
-static const std::size_t load_cost = 3;
+//3. Spill costs
 
-std::size_t depth_cost(unsigned int depth){
-    unsigned int cost = 1;
+struct SpillState {
+    std::unordered_map<std::size_t, unsigned int> levels;   //The level of the loop each split register is used in
+    std::unordered_set<std::size_t> temporaries;            //The short-lived registers of the spill code, never spilled again
+};
 
-    while(depth > 0){
-        cost *= 10;
+static const double store_cost = 5.0;
+static const double load_cost = 3.0;
 
-        --depth;
-    }
-
-    return cost;
-}
-
-template<typename Opt, typename Pseudo>
-void update_cost_reg(Opt& reg, ltac::interference_graph<Pseudo>& graph, unsigned int depth){
+template<typename Pseudo, typename Opt, typename Functor>
+void use_cost_reg(Opt& reg, double frequency, Functor& functor){
     if(reg){
         if(auto* ptr = boost::get<Pseudo>(&*reg)){
-            graph.spill_cost(graph.convert(*ptr)) += load_cost * depth_cost(depth);
+            functor(*ptr, load_cost * frequency);
         }
     }
 }
 
-template<typename Opt, typename Pseudo>
-void update_cost(Opt& arg, ltac::interference_graph<Pseudo>& graph, unsigned int depth){
+template<typename Pseudo, typename Opt, typename Functor>
+void use_cost(Opt& arg, double frequency, Functor& functor){
     if(arg){
         if(auto* ptr = boost::get<Pseudo>(&*arg)){
-            graph.spill_cost(graph.convert(*ptr)) += load_cost * depth_cost(depth);
+            functor(*ptr, load_cost * frequency);
         } else if(auto* ptr = boost::get<ltac::Address>(&*arg)){
-            update_cost_reg(ptr->base_register, graph, depth);
-            update_cost_reg(ptr->scaled_register, graph, depth);
+            use_cost_reg<Pseudo>(ptr->base_register, frequency, functor);
+            use_cost_reg<Pseudo>(ptr->scaled_register, frequency, functor);
         }
     }
 }
 
-template<typename Pseudo>
-void estimate_spill_costs(mtac::function_p function, ltac::interference_graph<Pseudo>& graph){
+/*!
+ * Call the functor with each occurrence of a pseudo register and the cost of the store or load 
+ * it would need if spilled, weighted by the execution frequency of its basic block. 
+ */
+template<typename Pseudo, typename Functor>
+void spill_costs(mtac::function_p function, Functor functor){
     for(auto& bb : function){
         for(auto& statement : bb->l_statements){
             if(auto* ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&statement)){
                 if(ltac::erase_result((*ptr)->op)){
                     if(auto* reg_ptr = boost::get<Pseudo>(&*(*ptr)->arg1)){
-                        graph.spill_cost(graph.convert(*reg_ptr)) += store_cost * depth_cost(bb->depth);
+                        functor(*reg_ptr, store_cost * bb->frequency);
                     }
                 } else {
-                    update_cost((*ptr)->arg1, graph, bb->depth);
+                    use_cost<Pseudo>((*ptr)->arg1, bb->frequency, functor);
                 }
 
-                update_cost((*ptr)->arg2, graph, bb->depth);
-                update_cost((*ptr)->arg3, graph, bb->depth);
+                use_cost<Pseudo>((*ptr)->arg2, bb->frequency, functor);
+                use_cost<Pseudo>((*ptr)->arg3, bb->frequency, functor);
             }
         }
     }
 }
 
-//5. Simplify
+template<typename Pseudo>
+void estimate_spill_costs(mtac::function_p function, ltac::interference_graph<Pseudo>& graph){
+    spill_costs<Pseudo>(function, [&graph](Pseudo& pseudo, double cost){
+        graph.spill_cost(graph.convert(pseudo)) += cost;
+    });
+}
+
+//Hard registers of the platform
 
 template<typename Pseudo>
 typename std::enable_if<std::is_same<Pseudo, ltac::PseudoRegister>::value, unsigned int>::type number_of_registers(Platform platform){
@@ -591,314 +582,1173 @@ typename std::enable_if<std::is_same<Pseudo, ltac::PseudoFloatRegister>::value,
     return descriptor->symbolic_float_registers();
 }
 
-//TODO Find a way to get rid of that and use graph.degree() instead
-//graph.degree() is constant-time...
-
 template<typename Pseudo>
-std::size_t degree(ltac::interference_graph<Pseudo>& graph, std::size_t candidate, const std::list<std::size_t>& order){
-    std::size_t count = 0;
+typename std::enable_if<std::is_same<Pseudo, ltac::PseudoRegister>::value, bool>::type is_copy(ltac::Statement& statement){
+    if(auto* ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&statement)){
+        return (*ptr)->op == ltac::Operator::MOV 
+            && boost::get<Pseudo>(&*(*ptr)->arg1) 
+            && boost::get<Pseudo>(&*(*ptr)->arg2);
+    }
 
-    auto& neighbors = graph.neighbors(candidate);
+    return false;
+}
 
-    std::unordered_set<std::size_t> bound;
+template<typename Pseudo>
+typename std::enable_if<std::is_same<Pseudo, ltac::PseudoFloatRegister>::value, bool>::type is_copy(ltac::Statement& statement){
+    if(auto* ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&statement)){
+        return (*ptr)->op == ltac::Operator::FMOV 
+            && boost::get<Pseudo>(&*(*ptr)->arg1) 
+            && boost::get<Pseudo>(&*(*ptr)->arg2);
+    }
 
-    for(auto neighbor : neighbors){
-        auto n_reg = graph.convert(neighbor);
+    return false;
+}
 
-        if(std::find(order.begin(), order.end(), neighbor) == order.end()){
-            ++count;
+//4. Iterated coalescing (George and Appel)
 
-            if(n_reg.bound){
-                bound.insert(n_reg.binding);
-            }
-        } else {
-            if(n_reg.bound && !bound.count(n_reg.binding)){
-                ++count;
-                bound.insert(n_reg.binding);
-            }
-        }
-    }
+/*
+ * The worklists of the nodes are kept consistent with their state: a node is in exactly one of 
+ * them or in the select stack, the coalesced nodes or the precolored (bound) nodes. The degrees
+ * and the adjacency vectors of the graph are updated in place, the graph is never rebuilt during 
+ * one round of allocation. 
+ */
 
-    return count;
-}
+enum class NodeState : unsigned int {
+    PRECOLORED,
+    INITIAL,
+    SIMPLIFY,
+    FREEZE,
+    SPILL,
+    SPILLED,
+    COALESCED,
+    COLORED,
+    SELECT
+};
+
+enum class MoveState : unsigned int {
+    WORKLIST,
+    ACTIVE,
+    COALESCED,
+    CONSTRAINED,
+    FROZEN
+};
+
+struct Move {
+    std::shared_ptr<ltac::Instruction> instruction;
+    std::size_t dst;
+    std::size_t src;
+    MoveState state;
+};
 
 template<typename Pseudo>
-double spill_heuristic(ltac::interference_graph<Pseudo>& graph, std::size_t reg, std::list<std::size_t>& order){
-    return static_cast<double>(graph.spill_cost(reg)) / static_cast<double>(degree(graph, reg, order));
-}
+struct IteratedCoalescing {
+    ltac::interference_graph<Pseudo>& graph;
+    std::size_t K;
+    SpillState& spill_state;
 
-template<typename Pseudo>
-void simplify(ltac::interference_graph<Pseudo>& graph, Platform platform, std::vector<std::size_t>& spilled, std::list<std::size_t>& order){
-    std::set<std::size_t> n;
-    for(std::size_t r = 0; r < graph.size(); ++r){
-        if(graph.convert(r).bound){
-            order.push_back(r);
-            graph.remove_node(r);
-        } else {
-            n.insert(r);
-        }
+    std::vector<NodeState> state;
+    std::vector<std::size_t> alias;
+    std::vector<unsigned short> color;
+    std::vector<std::vector<std::size_t>> move_list;
+
+    std::set<std::size_t> simplify_worklist;
+    std::set<std::size_t> freeze_worklist;
+    std::set<std::size_t> spill_worklist;
+    std::vector<std::size_t> select_stack;
+    std::vector<std::size_t> spilled;
+
+    std::vector<Move> moves;
+    std::vector<std::size_t> worklist_moves;  //May contain moves that are no longer in the worklist
+
+    IteratedCoalescing(ltac::interference_graph<Pseudo>& graph, std::size_t K, SpillState& spill_state) : graph(graph), K(K), spill_state(spill_state) {}
+
+    bool precolored(std::size_t n){
+        return state[n] == NodeState::PRECOLORED;
     }
 
-    auto K = number_of_registers<Pseudo>(platform);
-    log::emit<Trace>("registers") << "Attempt a " << K << "-coloring of the graph" << log::endl;
+    bool significant(std::size_t n){
+        return precolored(n) || graph.degree(n) >= K;
+    }
 
-    while(!n.empty()){
-        std::size_t node;
-        bool found = false;
+    std::vector<std::size_t> adjacent(std::size_t n){
+        std::vector<std::size_t> nodes;
 
-        for(auto candidate : n){
-            log::emit<Dev>("registers") << "Degree(" << graph.convert(candidate) << ") = " << degree(graph, candidate, order) << log::endl;
-            if(degree(graph, candidate, order) < K){
-                node = candidate;        
-                found = true;
-                break;
+        for(auto neighbor : graph.neighbors(n)){
+            if(state[neighbor] != NodeState::SELECT && state[neighbor] != NodeState::COALESCED){
+                nodes.push_back(neighbor);
             }
         }
-        
-        if(!found){
-            node = *n.begin();
-            auto min_cost = spill_heuristic(graph, node, order);
 
-            for(auto candidate : n){
-                if(!graph.convert(candidate).bound && spill_heuristic(graph, candidate, order) < min_cost){
-                    min_cost = spill_heuristic(graph, candidate, order);
-                    node = candidate;
-                }
+        return nodes;
+    }
+
+    template<typename Functor>
+    void node_moves(std::size_t n, Functor functor){
+        for(auto m : move_list[n]){
+            if(moves[m].state == MoveState::ACTIVE || moves[m].state == MoveState::WORKLIST){
+                functor(m);
             }
+        }
+    }
 
-            log::emit<Trace>("registers") << "Mark pseudo " << node << "(" << graph.convert(node) << ") to be spilled" << log::endl;
+    bool move_related(std::size_t n){
+        for(auto m : move_list[n]){
+            if(moves[m].state == MoveState::ACTIVE || moves[m].state == MoveState::WORKLIST){
+                return true;
+            }
+        }
 
-            spilled.push_back(node);
-        } else {
-            log::emit<Trace>("registers") << "Put pseudo " << graph.convert(node) << " on the stack" << log::endl;
+        return false;
+    }
 
-            order.push_back(node);
+    std::size_t get_alias(std::size_t n){
+        while(state[n] == NodeState::COALESCED){
+            n = alias[n];
         }
 
-        n.erase(node);
-        graph.remove_node(node);
+        return n;
     }
 
-    log::emit<Trace>("registers") << "Graph simplified" << log::endl;
-}
+    void move_node(std::size_t n, std::set<std::size_t>& from, std::set<std::size_t>& to, NodeState to_state){
+        from.erase(n);
+        to.insert(n);
+        state[n] = to_state;
+    }
 
-//6. Select
+    void init(mtac::function_p function){
+        state.resize(graph.size(), NodeState::INITIAL);
+        alias.resize(graph.size());
+        color.resize(graph.size());
+        move_list.resize(graph.size());
 
-template<typename Pseudo, typename Hard>
-void replace_registers(mtac::function_p function, std::unordered_map<std::size_t, std::size_t>& allocation, ltac::interference_graph<Pseudo>& graph){
-    std::unordered_map<Pseudo, Hard> register_allocation;
+        std::unordered_map<unsigned short, std::size_t> bindings;
 
-    for(auto& pair : allocation){
-        register_allocation[graph.convert(pair.first)] = {pair.second};
-    }
+        for(std::size_t n = 0; n < graph.size(); ++n){
+            alias[n] = n;
 
-    replace_registers(function, register_allocation);
-}
+            auto pseudo = graph.convert(n);
+            if(pseudo.bound){
+                state[n] = NodeState::PRECOLORED;
+                color[n] = pseudo.binding;
 
-template<typename Pseudo, typename Hard>
-void select(ltac::interference_graph<Pseudo>& graph, mtac::function_p function, Platform platform, std::list<std::size_t>& order){
-    std::unordered_map<std::size_t, std::size_t> allocation;
-    std::set<std::size_t> variable_allocated;
-    
-    auto colors = hard_registers<Pseudo>(platform);
+                //All the pseudo registers bound to the same hard register are the same node
+                if(bindings.count(pseudo.binding)){
+                    auto u = bindings[pseudo.binding];
 
-    //Handle bound registers
-    auto it = iterate(order);
-    while(it.has_next()){
-        auto reg = *it;
+                    for(auto t : graph.neighbors(n)){
+                        graph.connect(t, u);
+                        --graph.degree(t);
+                    }
 
-        //Handle bound registers
-        if(graph.convert(reg).bound){
-            log::emit<Trace>("registers") << "Alloc " << graph.convert(reg).binding << " to pseudo " << graph.convert(reg) << " (bound)" << log::endl;
-            allocation[reg] = graph.convert(reg).binding;
-            it.erase();
-        } else {
-            ++it;
+                    state[n] = NodeState::COALESCED;
+                    alias[n] = u;
+                } else {
+                    bindings[pseudo.binding] = n;
+                }
+            }
         }
-    }
 
-    while(!order.empty()){
-        std::size_t reg = order.back();
-        order.pop_back();
-        
-        for(auto color : colors){
-            bool found = false;
+        for(auto& bb : function){
+            for(auto& statement : bb->l_statements){
+                if(is_copy<Pseudo>(statement)){
+                    auto instruction = boost::get<std::shared_ptr<ltac::Instruction>>(statement);
 
-            for(auto neighbor : graph.neighbors(reg)){
-                if((allocation.count(neighbor) && allocation[neighbor] == color)){
-                    found = true;
-                    break;
-                }
-            }
+                    auto dst = graph.convert(boost::get<Pseudo>(*instruction->arg1));
+                    auto src = graph.convert(boost::get<Pseudo>(*instruction->arg2));
 
-            if(!found){
-                log::emit<Trace>("registers") << "Alloc " << color << " to pseudo " << graph.convert(reg) << log::endl;
-                allocation[reg] = color;
-                variable_allocated.insert(color);
-                break;
+                    move_list[dst].push_back(moves.size());
+                    move_list[src].push_back(moves.size());
+                    worklist_moves.push_back(moves.size());
+
+                    moves.push_back({instruction, dst, src, MoveState::WORKLIST});
+                }
             }
         }
+    }
 
-        if(!allocation.count(reg)){
-            std::cout << "Error allocating " << graph.convert(reg) << std::endl;
-
-            for(auto neighbor : graph.neighbors(reg)){
-                if(allocation.count(neighbor)){
-                    std::cout << "neighbor " << graph.convert(neighbor) << " of color " << allocation[neighbor] << std::endl;
+    void make_worklist(){
+        for(std::size_t n = 0; n < graph.size(); ++n){
+            if(state[n] == NodeState::INITIAL){
+                if(graph.degree(n) >= K){
+                    spill_worklist.insert(n);
+                    state[n] = NodeState::SPILL;
+                } else if(move_related(n)){
+                    freeze_worklist.insert(n);
+                    state[n] = NodeState::FREEZE;
                 } else {
-                    std::cout << "uncolored neighbor " << graph.convert(neighbor) << " of color " << std::endl;
+                    simplify_worklist.insert(n);
+                    state[n] = NodeState::SIMPLIFY;
                 }
             }
         }
-
-        eddic_assert(allocation.count(reg), "The register must have been allocated a color");
-    }
-
-    for(auto& alloc : allocation){
-        function->use(Hard(alloc.second));
     }
 
-    for(auto& alloc : variable_allocated){
-        function->variable_use(Hard(alloc));
+    void enable_moves(std::size_t n){
+        node_moves(n, [this](std::size_t m){
+            if(moves[m].state == MoveState::ACTIVE){
+                moves[m].state = MoveState::WORKLIST;
+                worklist_moves.push_back(m);
+            }
+        });
     }
 
-    replace_registers<Pseudo, Hard>(function, allocation, graph);
-}
+    void decrement_degree(std::size_t m){
+        if(precolored(m)){
+            return;
+        }
 
-//7. Spill code
+        auto d = graph.degree(m)--;
 
-template<typename It>
-void spill_load(ltac::PseudoRegister& pseudo, unsigned int position, It& it){
-    it.insert(std::make_shared<ltac::Instruction>(ltac::Operator::MOV, pseudo, ltac::Address(ltac::BP, position)));
-}
+        if(d == K && state[m] == NodeState::SPILL){
+            enable_moves(m);
 
-template<typename It>
-void spill_load(ltac::PseudoFloatRegister& pseudo, unsigned int position, It& it){
-    it.insert(std::make_shared<ltac::Instruction>(ltac::Operator::FMOV, pseudo, ltac::Address(ltac::BP, position)));
-}
+            for(auto n : adjacent(m)){
+                enable_moves(n);
+            }
 
-template<typename It>
-void spill_store(ltac::PseudoRegister& pseudo, unsigned int position, It& it){
-    it.insert_after(std::make_shared<ltac::Instruction>(ltac::Operator::MOV, ltac::Address(ltac::BP, position), pseudo));
-}
+            if(move_related(m)){
+                move_node(m, spill_worklist, freeze_worklist, NodeState::FREEZE);
+            } else {
+                move_node(m, spill_worklist, simplify_worklist, NodeState::SIMPLIFY);
+            }
+        }
+    }
 
-template<typename It>
-void spill_store(ltac::PseudoFloatRegister& pseudo, unsigned int position, It& it){
-    it.insert_after(std::make_shared<ltac::Instruction>(ltac::Operator::FMOV, ltac::Address(ltac::BP, position), pseudo));
-}
+    void simplify(){
+        auto n = *simplify_worklist.begin();
+        simplify_worklist.erase(simplify_worklist.begin());
 
-template<typename Pseudo>
-void spill_code(ltac::interference_graph<Pseudo>& graph, mtac::function_p function, std::vector<std::size_t>& spilled){
-    auto current_reg = last_register<Pseudo>(function);
-    
-    for(auto reg : spilled){
-        auto pseudo_reg = graph.convert(reg);
+        log::emit<Trace>("registers") << "Put pseudo " << graph.convert(n) << " on the stack" << log::endl;
 
-        //Allocate stack space for the pseudo reg
-        auto position = function->context->stack_position();
-        position -= INT->size(function->context->global()->target_platform());
-        function->context->set_stack_position(position);
+        select_stack.push_back(n);
+        state[n] = NodeState::SELECT;
 
-        for(auto& bb : function){
-            auto it = iterate(bb->l_statements);
-            
-            //TODO Add support for spilling float registers
+        for(auto m : adjacent(n)){
+            decrement_degree(m);
+        }
+    }
 
-            while(it.has_next()){
-                auto statement = *it;
+    bool has_worklist_moves(){
+        while(!worklist_moves.empty() && moves[worklist_moves.back()].state != MoveState::WORKLIST){
+            worklist_moves.pop_back();
+        }
 
-                if(is_store_complete(statement, pseudo_reg)){
-                    Pseudo new_pseudo_reg(++current_reg);
+        return !worklist_moves.empty();
+    }
 
-                    replace_register(statement, pseudo_reg, new_pseudo_reg);
+    void add_worklist(std::size_t u){
+        if(state[u] == NodeState::FREEZE && !move_related(u) && graph.degree(u) < K){
+            move_node(u, freeze_worklist, simplify_worklist, NodeState::SIMPLIFY);
+        }
+    }
 
-                    spill_store(new_pseudo_reg, position, it);
-                } else if(is_store(statement, pseudo_reg)){
-                    Pseudo new_pseudo_reg(++current_reg);
-                    
-                    spill_load(new_pseudo_reg, position, it);
+    //George test, used when u is precolored
+    bool ok(std::size_t t, std::size_t r){
+        return graph.degree(t) < K || precolored(t) || graph.connected(t, r);
+    }
 
-                    ++it;
-                    
-                    spill_store(new_pseudo_reg, position, it);
-                    
-                    replace_register(statement, pseudo_reg, new_pseudo_reg);
-                } else if(is_load(statement, pseudo_reg)){
-                    Pseudo new_pseudo_reg(++current_reg);
+    //Briggs test
+    bool conservative(std::size_t u, std::size_t v){
+        std::unordered_set<std::size_t> nodes;
 
-                    spill_load(new_pseudo_reg, position, it);
+        for(auto n : adjacent(u)){
+            nodes.insert(n);
+        }
 
-                    ++it;
+        for(auto n : adjacent(v)){
+            nodes.insert(n);
+        }
 
-                    replace_register(statement, pseudo_reg, new_pseudo_reg);
-                } 
-                
-                ++it;
+        std::size_t k = 0;
+        for(auto n : nodes){
+            if(significant(n)){
+                ++k;
             }
         }
+
+        return k < K;
     }
 
-    set_last_reg<Pseudo>(function, current_reg);
-}
+    void combine(std::size_t u, std::size_t v){
+        if(state[v] == NodeState::FREEZE){
+            freeze_worklist.erase(v);
+        } else {
+            spill_worklist.erase(v);
+        }
 
-//Register allocation
+        log::emit<Debug>("registers") << "Coalesce " << graph.convert(v) << " into " << graph.convert(u) << log::endl;
 
-template<typename Pseudo, typename Hard>
-void register_allocation(mtac::function_p function, Platform platform){
-    bool coalesced = false;
+        state[v] = NodeState::COALESCED;
+        alias[v] = u;
 
-    while(true){
-        if(!coalesced){
-            //1. Renumber
-            renumber<Pseudo>(function);
-        }
+        move_list[u].insert(move_list[u].end(), move_list[v].begin(), move_list[v].end());
+        enable_moves(v);
 
-        //2. Build
-        ltac::interference_graph<Pseudo> graph;
-        build_interference_graph(graph, function);
+        graph.spill_cost(u) += graph.spill_cost(v);
 
-        //No pseudo registers, return quickly
-        if(!graph.size()){
-            return;
+        for(auto t : adjacent(v)){
+            graph.connect(t, u);
+            decrement_degree(t);
         }
 
-        //3. Coalesce
-        coalesced = coalesce(graph, function);
-
-        if(coalesced){
-            continue;
+        if(graph.degree(u) >= K && state[u] == NodeState::FREEZE){
+            move_node(u, freeze_worklist, spill_worklist, NodeState::SPILL);
         }
+    }
 
-        //4. Spill costs
-        estimate_spill_costs(function, graph);
+    void coalesce(){
+        auto m = worklist_moves.back();
+        worklist_moves.pop_back();
 
-        //5. Simplify
-        std::vector<std::size_t> spilled;
-        std::list<std::size_t> order;
-        simplify(graph, platform, spilled, order);
+        auto x = get_alias(moves[m].dst);
+        auto y = get_alias(moves[m].src);
 
-        if(!spilled.empty()){
-            //6. Spill code
-            spill_code(graph, function, spilled);
+        auto u = precolored(y) ? y : x;
+        auto v = precolored(y) ? x : y;
+
+        if(u == v){
+            moves[m].state = MoveState::COALESCED;
+            add_worklist(u);
+        } else if(precolored(v) || graph.connected(u, v)){
+            moves[m].state = MoveState::CONSTRAINED;
+            add_worklist(u);
+            add_worklist(v);
         } else {
-            //7. Select
-            select<Pseudo, Hard>(graph, function, platform, order);
+            bool can_combine;
 
-            return;
-        }
+            if(precolored(u)){
+                can_combine = true;
+
+                for(auto t : adjacent(v)){
+                    if(!ok(t, u)){
+                        can_combine = false;
+                        break;
+                    }
+                }
+            } else {
+                can_combine = conservative(u, v);
+            }
+
+            if(can_combine){
+                moves[m].state = MoveState::COALESCED;
+                combine(u, v);
+                add_worklist(u);
+            } else {
+                moves[m].state = MoveState::ACTIVE;
+            }
+        }
+    }
+
+    void freeze_moves(std::size_t u){
+        node_moves(u, [this, u](std::size_t m){
+            auto x = get_alias(moves[m].dst);
+            auto y = get_alias(moves[m].src);
+            auto v = y == get_alias(u) ? x : y;
+
+            moves[m].state = MoveState::FROZEN;
+
+            if(state[v] == NodeState::FREEZE && !move_related(v) && graph.degree(v) < K){
+                move_node(v, freeze_worklist, simplify_worklist, NodeState::SIMPLIFY);
+            }
+        });
+    }
+
+    void freeze(){
+        auto u = *freeze_worklist.begin();
+
+        move_node(u, freeze_worklist, simplify_worklist, NodeState::SIMPLIFY);
+        freeze_moves(u);
+    }
+
+    double spill_heuristic(std::size_t n){
+        if(spill_state.temporaries.count(graph.convert(n).reg)){
+            return std::numeric_limits<double>::infinity();
+        }
+
+        return graph.spill_cost(n) / static_cast<double>(graph.degree(n));
+    }
+
+    void select_spill(){
+        auto m = *spill_worklist.begin();
+        auto min_cost = spill_heuristic(m);
+
+        for(auto candidate : spill_worklist){
+            if(spill_heuristic(candidate) < min_cost){
+                min_cost = spill_heuristic(candidate);
+                m = candidate;
+            }
+        }
+
+        log::emit<Trace>("registers") << "Select pseudo " << graph.convert(m) << " as a potential spill" << log::endl;
+
+        move_node(m, spill_worklist, simplify_worklist, NodeState::SIMPLIFY);
+        freeze_moves(m);
+    }
+
+    //Optimistic coloring: a potential spill is only an actual spill if no color is left for it
+    void assign_colors(const std::vector<unsigned short>& colors){
+        while(!select_stack.empty()){
+            auto n = select_stack.back();
+            select_stack.pop_back();
+
+            std::unordered_set<unsigned short> used;
+
+            for(auto w : graph.neighbors(n)){
+                auto a = get_alias(w);
+
+                if(state[a] == NodeState::COLORED || state[a] == NodeState::PRECOLORED){
+                    used.insert(color[a]);
+                }
+            }
+
+            state[n] = NodeState::SPILLED;
+
+            for(auto c : colors){
+                if(!used.count(c)){
+                    log::emit<Trace>("registers") << "Alloc " << c << " to pseudo " << graph.convert(n) << log::endl;
+
+                    state[n] = NodeState::COLORED;
+                    color[n] = c;
+                    break;
+                }
+            }
+
+            if(state[n] == NodeState::SPILLED){
+                log::emit<Trace>("registers") << "Mark pseudo " << graph.convert(n) << " to be spilled" << log::endl;
+
+                spilled.push_back(n);
+            }
+        }
+
+        for(std::size_t n = 0; n < graph.size(); ++n){
+            if(state[n] == NodeState::COALESCED){
+                color[n] = color[get_alias(n)];
+            }
+        }
+    }
+
+    void run(mtac::function_p function, const std::vector<unsigned short>& colors){
+        init(function);
+        make_worklist();
+
+        while(true){
+            if(!simplify_worklist.empty()){
+                simplify();
+            } else if(has_worklist_moves()){
+                coalesce();
+            } else if(!freeze_worklist.empty()){
+                freeze();
+            } else if(!spill_worklist.empty()){
+                select_spill();
+            } else {
+                break;
+            }
+        }
+
+        assign_colors(colors);
+    }
+};
+
+template<typename Pseudo, typename Hard>
+void select(IteratedCoalescing<Pseudo>& allocator, mtac::function_p function){
+    std::unordered_map<Pseudo, Hard> register_allocation;
+
+    for(std::size_t n = 0; n < allocator.graph.size(); ++n){
+        auto pseudo = allocator.graph.convert(n);
+        auto color = allocator.color[n];
+
+        register_allocation[pseudo] = {color};
+
+        function->use(Hard(color));
+
+        if(!pseudo.bound){
+            function->variable_use(Hard(color));
+        }
+    }
+
+    //The coalesced moves are now from a register to itself
+    for(auto& move : allocator.moves){
+        if(move.state == MoveState::COALESCED){
+            ltac::transform_to_nop(move.instruction);
+        }
+    }
+
+    replace_registers(function, register_allocation);
+}
+
+//5. Spill code
+
+//A float register used by a packed instruction holds a whole vector, not only a scalar
+
+bool is_vector(mtac::function_p, ltac::PseudoRegister&){
+    return false;
+}
+
+bool is_vector(mtac::function_p function, ltac::PseudoFloatRegister& pseudo){
+    for(auto& bb : function){
+        for(auto& statement : bb->l_statements){
+            if(auto* ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&statement)){
+                auto op = (*ptr)->op;
+
+                if(op >= ltac::Operator::PMOV && op <= ltac::Operator::PSHR && (contains_reg((*ptr)->arg1, pseudo) || contains_reg((*ptr)->arg2, pseudo))){
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+std::shared_ptr<ltac::Instruction> load(ltac::PseudoRegister& pseudo, unsigned int position, bool){
+    return make_node<ltac::Instruction>(ltac::Operator::MOV, pseudo, ltac::Address(ltac::BP, position));
+}
+
+std::shared_ptr<ltac::Instruction> load(ltac::PseudoFloatRegister& pseudo, unsigned int position, bool vector){
+    return make_node<ltac::Instruction>(vector ? ltac::Operator::PMOV : ltac::Operator::FMOV, pseudo, ltac::Address(ltac::BP, position));
+}
+
+template<typename It>
+void spill_load(ltac::PseudoRegister& pseudo, unsigned int position, bool vector, It& it){
+    it.insert(load(pseudo, position, vector));
+}
+
+template<typename It>
+void spill_load(ltac::PseudoFloatRegister& pseudo, unsigned int position, bool vector, It& it){
+    it.insert(load(pseudo, position, vector));
+}
+
+template<typename It>
+void spill_store(ltac::PseudoRegister& pseudo, unsigned int position, bool, It& it){
+    it.insert_after(make_node<ltac::Instruction>(ltac::Operator::MOV, ltac::Address(ltac::BP, position), pseudo));
+}
+
+template<typename It>
+void spill_store(ltac::PseudoFloatRegister& pseudo, unsigned int position, bool vector, It& it){
+    it.insert_after(make_node<ltac::Instruction>(vector ? ltac::Operator::PMOV : ltac::Operator::FMOV, ltac::Address(ltac::BP, position), pseudo));
+}
+
+//Rematerialization
+
+bool is_pseudo_address(boost::optional<ltac::AddressRegister>& reg){
+    return reg && (boost::get<ltac::PseudoRegister>(&*reg) || boost::get<ltac::PseudoFloatRegister>(&*reg));
+}
+
+//A constant or the address of a label or of a stack slot can be recomputed at each use for free
+
+bool is_rematerializable(std::shared_ptr<ltac::Instruction>& instruction){
+    if(instruction->op == ltac::Operator::MOV && instruction->arg2 && !instruction->arg3){
+        return boost::get<int>(&*instruction->arg2) || boost::get<std::string>(&*instruction->arg2);
+    } else if(instruction->op == ltac::Operator::LEA && instruction->arg2 && !instruction->arg3){
+        if(auto* ptr = boost::get<ltac::Address>(&*instruction->arg2)){
+            return !is_pseudo_address(ptr->base_register) && !is_pseudo_address(ptr->scaled_register);
+        }
+    }
+
+    return false;
+}
+
+//The peephole optimizer can transform a rematerialized constant into a XOR that would destroy the flags
+
+bool reads_flags(ltac::Statement& statement){
+    if(auto* ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&statement)){
+        return (*ptr)->op >= ltac::Operator::CMOVE && (*ptr)->op <= ltac::Operator::CMOVLE;
+    }
+
+    return false;
+}
+
+template<typename Pseudo>
+bool rematerialize(mtac::function_p function, Pseudo& pseudo_reg, std::size_t& current_reg, SpillState& state){
+    std::shared_ptr<ltac::Instruction> definition;
+
+    for(auto& bb : function){
+        for(auto& statement : bb->l_statements){
+            if(is_store(statement, pseudo_reg)){
+                //Only a single definition can be recomputed at each use
+                if(definition){
+                    return false;
+                }
+
+                definition = boost::get<std::shared_ptr<ltac::Instruction>>(statement);
+            } else if(is_load(statement, pseudo_reg) && reads_flags(statement)){
+                return false;
+            }
+        }
+    }
+
+    if(!definition || !ltac::erase_result_complete(definition->op) || !is_rematerializable(definition)){
+        return false;
+    }
+
+    log::emit<Trace>("registers") << "Rematerialize " << pseudo_reg << log::endl;
+
+    for(auto& bb : function){
+        auto it = iterate(bb->l_statements);
+
+        while(it.has_next()){
+            auto statement = *it;
+
+            if(auto* ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&statement)){
+                if(*ptr == definition){
+                    ++it;
+                    continue;
+                }
+            }
+
+            if(is_load(statement, pseudo_reg)){
+                Pseudo new_pseudo_reg(++current_reg);
+                state.temporaries.insert(new_pseudo_reg.reg);
+
+                it.insert(make_node<ltac::Instruction>(definition->op, new_pseudo_reg, *definition->arg2));
+
+                ++it;
+
+                replace_register(statement, pseudo_reg, new_pseudo_reg);
+            }
+
+            ++it;
+        }
+    }
+
+    ltac::transform_to_nop(definition);
+
+    return true;
+}
+
+//Live range splitting
+
+/*
+ * The loops are found from the depth of the basic blocks: a loop of level d is a maximal 
+ * sequence of consecutive basic blocks whose depth is at least d. A spilled register that is 
+ * used but not defined in a loop is loaded once in a new register before the loop instead 
+ * of before each of its uses. If this register is spilled in its turn, it is only split 
+ * around the loops nested in this loop. 
+ */
+
+template<typename Pseudo>
+void split_loop(mtac::function_p function, std::vector<mtac::basic_block_p>& loop, Pseudo& pseudo_reg, unsigned int position, bool vector, 
+        unsigned int level, std::size_t& current_reg, SpillState& state){
+    std::unordered_set<mtac::basic_block_p> blocks(loop.begin(), loop.end());
+    std::vector<mtac::basic_block_p> entries;
+
+    //The register is loaded on the edges entering the loop
+    for(auto& bb : loop){
+        for(auto& predecessor : bb->predecessors){
+            if(!blocks.count(predecessor)){
+                if(predecessor->successors.size() != 1 || predecessor == function->entry_bb()){
+                    return;
+                }
+
+                entries.push_back(predecessor);
+            }
+        }
+    }
+
+    if(entries.empty()){
+        return;
+    }
+
+    Pseudo new_pseudo_reg(++current_reg);
+    state.levels[new_pseudo_reg.reg] = level;
+
+    log::emit<Trace>("registers") << "Split " << pseudo_reg << " into " << new_pseudo_reg << " around a loop of level " << level << log::endl;
+
+    for(auto& entry : entries){
+        auto& statements = entry->l_statements;
+        auto insertion = statements.end();
+
+        if(!statements.empty()){
+            if(auto* ptr = boost::get<std::shared_ptr<ltac::Jump>>(&statements.back())){
+                if((*ptr)->type != ltac::JumpType::CALL){
+                    --insertion;
+                }
+            }
+        }
+
+        statements.insert(insertion, load(new_pseudo_reg, position, vector));
+    }
+
+    for(auto& bb : loop){
+        for(auto& statement : bb->l_statements){
+            replace_register(statement, pseudo_reg, new_pseudo_reg);
+        }
+    }
+}
+
+template<typename Pseudo>
+void split_live_range(mtac::function_p function, std::vector<mtac::basic_block_p>& blocks, std::size_t first, std::size_t last, 
+        Pseudo& pseudo_reg, unsigned int position, bool vector, unsigned int level, std::size_t& current_reg, SpillState& state){
+    std::size_t i = first;
+
+    while(i < last){
+        if(blocks[i]->depth < level){
+            ++i;
+            continue;
+        }
+
+        auto begin = i;
+
+        while(i < last && blocks[i]->depth >= level){
+            ++i;
+        }
+
+        bool used = false;
+        bool defined = false;
+
+        for(auto j = begin; j < i; ++j){
+            for(auto& statement : blocks[j]->l_statements){
+                if(is_store(statement, pseudo_reg)){
+                    defined = true;
+                } else if(is_load(statement, pseudo_reg)){
+                    used = true;
+                }
+            }
+        }
+
+        if(defined){
+            split_live_range(function, blocks, begin, i, pseudo_reg, position, vector, level + 1, current_reg, state);
+        } else if(used){
+            std::vector<mtac::basic_block_p> loop(blocks.begin() + begin, blocks.begin() + i);
+            split_loop(function, loop, pseudo_reg, position, vector, level, current_reg, state);
+        }
+    }
+}
+
+template<typename Pseudo>
+void spill_code(mtac::function_p function, std::vector<Pseudo>& spilled, SpillState& state){
+    auto current_reg = last_register<Pseudo>(function);
+
+    std::vector<mtac::basic_block_p> blocks;
+    for(auto& bb : function){
+        blocks.push_back(bb);
+    }
+    
+    for(auto pseudo_reg : spilled){
+        if(rematerialize(function, pseudo_reg, current_reg, state)){
+            continue;
+        }
+
+        bool vector = is_vector(function, pseudo_reg);
+
+        //Allocate stack space for the pseudo reg
+        auto position = function->context->stack_position();
+        position -= vector ? 16 : INT->size(function->context->global()->target_platform());
+        function->context->set_stack_position(position);
+
+        auto level = state.levels.count(pseudo_reg.reg) ? state.levels[pseudo_reg.reg] + 1 : 1;
+        split_live_range(function, blocks, 0, blocks.size(), pseudo_reg, position, vector, level, current_reg, state);
+
+        for(auto& bb : function){
+            auto it = iterate(bb->l_statements);
+
+            while(it.has_next()){
+                auto statement = *it;
+
+                if(is_store_complete(statement, pseudo_reg)){
+                    Pseudo new_pseudo_reg(++current_reg);
+                    state.temporaries.insert(new_pseudo_reg.reg);
+
+                    replace_register(statement, pseudo_reg, new_pseudo_reg);
+
+                    spill_store(new_pseudo_reg, position, vector, it);
+                } else if(is_store(statement, pseudo_reg)){
+                    Pseudo new_pseudo_reg(++current_reg);
+                    state.temporaries.insert(new_pseudo_reg.reg);
+                    
+                    spill_load(new_pseudo_reg, position, vector, it);
+
+                    ++it;
+                    
+                    spill_store(new_pseudo_reg, position, vector, it);
+                    
+                    replace_register(statement, pseudo_reg, new_pseudo_reg);
+                } else if(is_load(statement, pseudo_reg)){
+                    Pseudo new_pseudo_reg(++current_reg);
+                    state.temporaries.insert(new_pseudo_reg.reg);
+
+                    spill_load(new_pseudo_reg, position, vector, it);
+
+                    ++it;
+
+                    replace_register(statement, pseudo_reg, new_pseudo_reg);
+                } 
+                
+                ++it;
+            }
+        }
+    }
+
+    set_last_reg<Pseudo>(function, current_reg);
+}
+
+template<typename Pseudo>
+void spill_code(ltac::interference_graph<Pseudo>& graph, mtac::function_p function, std::vector<std::size_t>& spilled, SpillState& state){
+    std::vector<Pseudo> pseudo_regs;
+
+    for(auto reg : spilled){
+        pseudo_regs.push_back(graph.convert(reg));
+    }
+
+    spill_code(function, pseudo_regs, state);
+}
+
+//Register allocation
+
+template<typename Pseudo, typename Hard>
+void register_allocation(mtac::function_p function, Platform platform){
+    SpillState spill_state;
+
+    while(true){
+        //1. Renumber
+        renumber<Pseudo>(function);
+
+        //2. Build
+        ltac::interference_graph<Pseudo> graph;
+        build_interference_graph(graph, function);
+
+        //No pseudo registers, return quickly
+        if(!graph.size()){
+            return;
+        }
+
+        //3. Spill costs
+        estimate_spill_costs(function, graph);
+
+        //4. Simplify, coalesce, freeze and select
+        IteratedCoalescing<Pseudo> allocator(graph, number_of_registers<Pseudo>(platform), spill_state);
+        allocator.run(function, hard_registers<Pseudo>(platform));
+
+        if(!allocator.spilled.empty()){
+            //5. Spill code
+            spill_code(graph, function, allocator.spilled, spill_state);
+        } else {
+            select<Pseudo, Hard>(allocator, function);
+
+            return;
+        }
+    }
+}
+
+//Linear scan allocation
+
+/*
+ * Each statement of the function gets two positions in the linear order of the basic blocks: 
+ * 2i where its operands are read and 2i + 1 where its results are written.
+ */
+
+template<typename Pseudo>
+struct live_interval {
+    Pseudo pseudo;
+    std::size_t start;
+    std::size_t end;
+    unsigned short hard = 0;
+    double weight = 0.0;    //The frequency-weighted cost of spilling the interval
+
+    live_interval(Pseudo pseudo, std::size_t position) : pseudo(pseudo), start(position), end(position) {}
+
+    void extend(std::size_t position){
+        start = std::min(start, position);
+        end = std::max(end, position);
+    }
+
+    bool overlaps(const live_interval<Pseudo>& rhs) const {
+        return start <= rhs.end && rhs.start <= end;
+    }
+
+    //Long intervals with few and cold uses are the best ones to spill
+    double density() const {
+        return weight / static_cast<double>(end - start + 1);
+    }
+};
+
+template<typename Pseudo>
+struct live_intervals {
+    std::vector<live_interval<Pseudo>> intervals;
+    std::unordered_map<std::size_t, std::size_t> index;     //Maps register numbers to intervals
+    std::unordered_map<std::size_t, Pseudo> pseudos;        //Maps register numbers to pseudo regs
+
+    void extend(std::size_t reg, std::size_t position){
+        auto it = index.find(reg);
+
+        if(it == index.end()){
+            auto pseudo = pseudos.find(reg);
+
+            index[reg] = intervals.size();
+            intervals.emplace_back(pseudo == pseudos.end() ? Pseudo(reg) : pseudo->second, position);
+        } else {
+            intervals[it->second].extend(position);
+        }
+    }
+};
+
+//The bound pseudo registers are only known from the statements, not from the liveness
+
+template<typename Pseudo>
+void gather_pseudo_regs(mtac::function_p function, live_intervals<Pseudo>& intervals){
+    std::unordered_set<Pseudo> registers;
+
+    for(auto& bb : function){
+        for(auto& statement : bb->l_statements){
+            if(auto* ptr = boost::get<std::shared_ptr<ltac::Instruction>>(&statement)){
+                find_reg((*ptr)->arg1, registers);
+                find_reg((*ptr)->arg2, registers);
+                find_reg((*ptr)->arg3, registers);
+
+                get_special_uses(*ptr, registers);
+            } else if(auto* ptr = boost::get<std::shared_ptr<ltac::Jump>>(&statement)){
+                get_special_uses(*ptr, registers);
+
+                for(auto& reg : get_special_kills<Pseudo>(*ptr)){
+                    registers.insert(reg);
+                }
+            }
+        }
+    }
+
+    for(auto& reg : registers){
+        intervals.pseudos[reg.reg] = reg;
+    }
+}
+
+//A register written but never read still needs a register at the point it is written
+
+template<typename Pseudo>
+void extend_definitions(ltac::Statement& statement, live_intervals<Pseudo>& intervals, std::size_t position){
+    definitions<Pseudo>(statement, [&intervals, position](Pseudo& reg){ intervals.extend(reg.reg, position); });
+}
+
+template<typename Pseudo>
+void build_live_intervals(mtac::function_p function, live_intervals<Pseudo>& intervals){
+    gather_pseudo_regs(function, intervals);
+
+    if(intervals.pseudos.empty()){
+        return;
+    }
+
+    ltac::LiveRegistersProblem<Pseudo> problem;
+    auto live_results = mtac::backward_bit_data_flow(function, problem);
+
+    std::size_t base = 0;
+
+    for(auto& bb : function){
+        auto size = bb->l_statements.size();
+        auto i = base + size;
+
+        live_results->backward_statements(bb, [&](ltac::Statement& statement, mtac::BitSet& live){
+            --i;
+
+            for(auto reg = live.find_first(); reg != mtac::BitSet::npos; reg = live.find_next(reg)){
+                intervals.extend(reg, 2 * i + 1);
+
+                //Inside the block, the registers live after a statement are read by the next one
+                if(i + 1 < base + size){
+                    intervals.extend(reg, 2 * i + 2);
+                }
+            }
+
+            extend_definitions(statement, intervals, 2 * i + 1);
+        });
+
+        if(size){
+            auto& live = live_results->in(bb);
+
+            for(auto reg = live.find_first(); reg != mtac::BitSet::npos; reg = live.find_next(reg)){
+                intervals.extend(reg, 2 * base);
+            }
+        }
+
+        base += size;
+    }
+
+    std::sort(intervals.intervals.begin(), intervals.intervals.end(), 
+            [](const live_interval<Pseudo>& lhs, const live_interval<Pseudo>& rhs){ return lhs.start < rhs.start; });
+
+    for(std::size_t i = 0; i < intervals.intervals.size(); ++i){
+        intervals.index[intervals.intervals[i].pseudo.reg] = i;
+    }
+
+    log::emit<Trace>("registers") << "Found " << intervals.intervals.size() << " live intervals" << log::endl;
+}
+
+/*
+ * The bound pseudo registers are fixed intervals: they always get their hard register and a 
+ * free interval can only take a hard register that is not reserved by an overlapping fixed interval. 
+ */
+
+template<typename Pseudo>
+bool reserved(std::unordered_map<unsigned short, std::vector<std::size_t>>& fixed, std::vector<live_interval<Pseudo>>& intervals, unsigned short hard, std::size_t current){
+    for(auto i : fixed[hard]){
+        if(intervals[i].overlaps(intervals[current])){
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template<typename Pseudo>
+void linear_scan(live_intervals<Pseudo>& live, Platform platform, std::vector<Pseudo>& spilled, SpillState& spill_state){
+    auto& intervals = live.intervals;
+    auto colors = hard_registers<Pseudo>(platform);
+
+    std::unordered_map<unsigned short, std::vector<std::size_t>> fixed;
+    
+    for(std::size_t i = 0; i < intervals.size(); ++i){
+        if(intervals[i].pseudo.bound){
+            intervals[i].hard = intervals[i].pseudo.binding;
+            fixed[intervals[i].hard].push_back(i);
+        }
+    }
+
+    //The free intervals currently holding a hard register, sorted by increasing end
+    std::list<std::size_t> active;
+    std::unordered_set<unsigned short> used;
+
+    for(std::size_t current = 0; current < intervals.size(); ++current){
+        auto& interval = intervals[current];
+
+        if(interval.pseudo.bound){
+            continue;
+        }
+
+        //Expire the intervals that ended before this one
+        while(!active.empty() && intervals[active.front()].end < interval.start){
+            used.erase(intervals[active.front()].hard);
+            active.pop_front();
+        }
+
+        bool found = false;
+
+        for(auto color : colors){
+            if(!used.count(color) && !reserved(fixed, intervals, color, current)){
+                interval.hard = color;
+                found = true;
+                break;
+            }
+        }
+
+        if(!found){
+            //Spill the interval with the lowest spill density among the ones whose register could be taken
+            auto victim = active.end();
+
+            for(auto it = active.begin(); it != active.end(); ++it){
+                if(!reserved(fixed, intervals, intervals[*it].hard, current) && !spill_state.temporaries.count(intervals[*it].pseudo.reg)){
+                    if(victim == active.end() || intervals[*it].density() < intervals[*victim].density()){
+                        victim = it;
+                    }
+                }
+            }
+
+            bool temporary = spill_state.temporaries.count(interval.pseudo.reg);
+
+            if(victim != active.end() && (temporary || intervals[*victim].density() < interval.density())){
+                log::emit<Trace>("registers") << "Mark pseudo " << intervals[*victim].pseudo << " to be spilled" << log::endl;
+
+                spilled.push_back(intervals[*victim].pseudo);
+                interval.hard = intervals[*victim].hard;
+                active.erase(victim);
+
+                found = true;
+            } else {
+                log::emit<Trace>("registers") << "Mark pseudo " << interval.pseudo << " to be spilled" << log::endl;
+
+                spilled.push_back(interval.pseudo);
+            }
+        }
+
+        if(found){
+            log::emit<Trace>("registers") << "Alloc " << interval.hard << " to pseudo " << interval.pseudo << log::endl;
+
+            used.insert(interval.hard);
+
+            auto it = active.begin();
+            while(it != active.end() && intervals[*it].end <= interval.end){
+                ++it;
+            }
+
+            active.insert(it, current);
+        }
+    }
+}
+
+template<typename Pseudo, typename Hard>
+void linear_scan_allocation(mtac::function_p function, Platform platform){
+    SpillState spill_state;
+
+    while(true){
+        //1. Build the live intervals
+        live_intervals<Pseudo> live;
+        build_live_intervals(function, live);
+
+        //No pseudo registers, return quickly
+        if(live.intervals.empty()){
+            return;
+        }
+
+        spill_costs<Pseudo>(function, [&live](Pseudo& pseudo, double cost){
+            auto it = live.index.find(pseudo.reg);
+
+            if(it != live.index.end()){
+                live.intervals[it->second].weight += cost;
+            }
+        });
+
+        //2. Scan the intervals
+        std::vector<Pseudo> spilled;
+        linear_scan(live, platform, spilled, spill_state);
+
+        if(!spilled.empty()){
+            //3. Spill code
+            spill_code(function, spilled, spill_state);
+        } else {
+            //4. Replace the pseudo registers
+            std::unordered_map<Pseudo, Hard> register_allocation;
+
+            for(auto& interval : live.intervals){
+                register_allocation[interval.pseudo] = {interval.hard};
+
+                function->use(Hard(interval.hard));
+
+                if(!interval.pseudo.bound){
+                    function->variable_use(Hard(interval.hard));
+                }
+            }
+
+            replace_registers(function, register_allocation);
+
+            return;
+        }
     }
 }
 
 } //end of anonymous namespace
 
-void ltac::register_allocation(mtac::program_p program, Platform platform){
-    PerfsTimer timer("Register allocation");
+void ltac::register_allocation(mtac::function_p function, Platform platform, std::shared_ptr<Configuration> configuration){
+    PerfsTimer timer("Register allocation of " + function->getName(), true);
 
-    for(auto& function : program->functions){
+    mtac::compute_frequencies(function, configuration);
+
+    if(configuration->option_defined("fgraph-coloring-allocation") && !configuration->option_defined("fno-graph-coloring-allocation")){
         log::emit<Trace>("registers") << "Allocate integer registers for function " << function->getName() << log::endl;
         ::register_allocation<ltac::PseudoRegister, ltac::Register>(function, platform);
-        
+
         log::emit<Trace>("registers") << "Allocate float registers for function " << function->getName() << log::endl;
         ::register_allocation<ltac::PseudoFloatRegister, ltac::FloatRegister>(function, platform);
+    } else {
+        log::emit<Trace>("registers") << "Linear scan of the integer registers of function " << function->getName() << log::endl;
+        linear_scan_allocation<ltac::PseudoRegister, ltac::Register>(function, platform);
+
+        log::emit<Trace>("registers") << "Linear scan of the float registers of function " << function->getName() << log::endl;
+        linear_scan_allocation<ltac::PseudoFloatRegister, ltac::FloatRegister>(function, platform);
     }
 }
+
+void ltac::register_allocation(mtac::program_p program, Platform platform, std::shared_ptr<Configuration> configuration){
+    PerfsTimer timer("Register allocation");
+
+    for(auto& function : program->functions){
+        ltac::register_allocation(function, platform, configuration);
+    }
+}
+
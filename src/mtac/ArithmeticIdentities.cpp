@@ -19,6 +19,9 @@ void mtac::ArithmeticIdentities::operator()(std::shared_ptr<mtac::Quadruple> qua
             if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&*quadruple->arg1)){
                 if(*ptr == quadruple->result){
                    replaceRight(*this, quadruple, mtac::Operator::NOP); 
+
+                   //The no-op must not be seen as a write of the variable
+                   quadruple->result = nullptr;
                 }
             }
 
@@ -6,6 +6,7 @@
 //=======================================================================
 
 #include <unordered_set>
+#include <vector>
 
 #include "FunctionContext.hpp"
 #include "likely.hpp"
@@ -116,6 +117,19 @@ bool mtac::remove_dead_basic_blocks::operator()(mtac::function_p function){
         return false;
     }
 
+    //The blocks reachable from ENTRY, a loop can be dead as a whole
+    std::unordered_set<mtac::basic_block_p> reachable;
+    std::vector<mtac::basic_block_p> worklist{function->entry_bb()};
+
+    while(!worklist.empty()){
+        auto block = worklist.back();
+        worklist.pop_back();
+
+        if(reachable.insert(block).second){
+            worklist.insert(worklist.end(), block->successors.begin(), block->successors.end());
+        }
+    }
+
     auto it = iterate(function);
 
     //ENTRY is always accessed
@@ -124,7 +138,7 @@ bool mtac::remove_dead_basic_blocks::operator()(mtac::function_p function){
     while(it.has_next()){
         auto& block = *it;
 
-        if(block->predecessors.empty()){
+        if(!reachable.count(block) && block != function->exit_bb()){
             it.erase();
         } else {
             ++it;
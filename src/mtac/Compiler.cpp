@@ -11,14 +11,17 @@
 #include <boost/range/adaptors.hpp>
 
 #include "assert.hpp"
+#include "arena.hpp"
 #include "VisitorUtils.hpp"
 #include "Variable.hpp"
 #include "SemanticalException.hpp"
 #include "FunctionContext.hpp"
 #include "mangling.hpp"
 #include "Labels.hpp"
+#include "Options.hpp"
 #include "Type.hpp"
 #include "PerfsTimer.hpp"
+#include "PassTimer.hpp"
 #include "GlobalContext.hpp"
 
 #include "mtac/Compiler.hpp"
@@ -61,9 +64,9 @@ std::shared_ptr<Variable> performOperation(ast::Expression& value, mtac::functio
         right = moveToArgument(operation.get<1>(), function);
        
         if (i == 0){
-            function->add(std::make_shared<mtac::Quadruple>(t1, left, f(operation.get<0>()), right));
+            function->add(make_node<mtac::Quadruple>(t1, left, f(operation.get<0>()), right));
         } else {
-            function->add(std::make_shared<mtac::Quadruple>(t1, t1, f(operation.get<0>()), right));
+            function->add(make_node<mtac::Quadruple>(t1, t1, f(operation.get<0>()), right));
         }
     }
 
@@ -78,13 +81,64 @@ std::shared_ptr<Variable> performFloatOperation(ast::Expression& value, mtac::fu
     return performOperation(value, function, function->context->new_temporary(FLOAT), &mtac::toFloatOperator);
 }
 
+mtac::Argument computeSizeOfArray(std::shared_ptr<Variable> array, mtac::function_p function){
+    if(array->position().isGlobal()){
+        return array->type()->elements();
+    } else if((array->position().is_variable() || array->position().isStack()) && array->type()->has_elements()){
+        return array->type()->elements();
+    } else if(array->position().isParameter() || array->position().isStack() || array->position().is_variable()){
+        auto t1 = function->context->new_temporary(INT);
+
+        //The size of the array is at the address pointed by the variable
+        function->add(make_node<mtac::Quadruple>(t1, array, mtac::Operator::DOT, 0));
+
+        return t1;
+    }
+
+    eddic_unreachable("The variable is not of a valid type");
+}
+
+/*!
+ * Verify at runtime that the index is in the bounds of the array. The check is always made of the 
+ * two same jumps to a block calling _bounds_error, the range analysis of the optimizer removes the
+ * checks that cannot fail, see mtac::bounds_check_elimination.
+ */
+void checkIndexOfArray(std::shared_ptr<Variable> array, mtac::Argument& index, mtac::function_p function){
+    auto global = function->context->global();
+
+    //The index is compared several times
+    if(!mtac::isVariable(index)){
+        auto temp = function->context->new_temporary(INT);
+        function->add(make_node<mtac::Quadruple>(temp, index, mtac::Operator::ASSIGN));
+        index = temp;
+    }
+
+    auto size = computeSizeOfArray(array, function);
+
+    auto errorLabel = newLabel();
+    auto endLabel = newLabel();
+
+    function->add(make_node<mtac::If>(mtac::BinaryOperator::LESS, index, 0, errorLabel));
+    function->add(make_node<mtac::If>(mtac::BinaryOperator::LESS, index, size, endLabel));
+
+    function->add(errorLabel);
+    global->addReference("_bounds_error");
+    function->add(make_node<mtac::Call>("_bounds_error", global->getFunction("_bounds_error")));
+
+    function->add(endLabel);
+}
+
 mtac::Argument computeIndexOfArray(std::shared_ptr<Variable> array, ast::Value indexValue, mtac::function_p function){
     mtac::Argument index = moveToArgument(indexValue, function);
+
+    if(function->bounds_check){
+        checkIndexOfArray(array, index, function);
+    }
     
     auto temp = function->context->new_temporary(INT);
 
-    function->add(std::make_shared<mtac::Quadruple>(temp, index, mtac::Operator::MUL, array->type()->data_type()->size(function->context->global()->target_platform())));
-    function->add(std::make_shared<mtac::Quadruple>(temp, temp, mtac::Operator::ADD, INT->size(function->context->global()->target_platform())));
+    function->add(make_node<mtac::Quadruple>(temp, index, mtac::Operator::MUL, array->type()->data_type()->size(function->context->global()->target_platform())));
+    function->add(make_node<mtac::Quadruple>(temp, temp, mtac::Operator::ADD, INT->size(function->context->global()->target_platform())));
    
     return temp;
 }
@@ -138,7 +192,7 @@ struct ToArgumentsVisitor : public boost::static_visitor<std::vector<mtac::Argum
     result_type operator()(ast::New& new_) const {
         auto type = visit(ast::TypeTransformer(function->context->global()), new_.Content->type);
     
-        auto param = std::make_shared<mtac::Param>(type->size(function->context->global()->target_platform()));
+        auto param = make_node<mtac::Param>(type->size(function->context->global()->target_platform()));
         param->std_param = "a";
         param->function = function->context->global()->getFunction("_F5allocI");
         function->add(param);
@@ -146,7 +200,7 @@ struct ToArgumentsVisitor : public boost::static_visitor<std::vector<mtac::Argum
         auto t1 = function->context->new_temporary(new_pointer_type(INT));
 
         function->context->global()->addReference("_F5allocI");
-        function->add(std::make_shared<mtac::Call>("_F5allocI", function->context->global()->getFunction("_F5allocI"), t1)); 
+        function->add(make_node<mtac::Call>("_F5allocI", function->context->global()->getFunction("_F5allocI"), t1)); 
             
         if(type->is_custom_type() || type->is_template()){
             auto ctor_name = mangle_ctor(new_.Content->values, type);
@@ -159,12 +213,12 @@ struct ToArgumentsVisitor : public boost::static_visitor<std::vector<mtac::Argum
                 //Pass all normal arguments
                 pass_arguments(function, ctor_function, new_);
 
-                auto ctor_param = std::make_shared<mtac::Param>(t1, ctor_function->context->getVariable(ctor_function->parameters[0].name), ctor_function);
+                auto ctor_param = make_node<mtac::Param>(t1, ctor_function->context->getVariable(ctor_function->parameters[0].name), ctor_function);
                 ctor_param->address = true;
                 function->add(ctor_param);
 
                 function->context->global()->addReference(ctor_name);
-                function->add(std::make_shared<mtac::Call>(ctor_name, ctor_function)); 
+                function->add(make_node<mtac::Call>(ctor_name, ctor_function)); 
             }
         }
 
@@ -179,10 +233,10 @@ struct ToArgumentsVisitor : public boost::static_visitor<std::vector<mtac::Argum
         
         auto platform = function->context->global()->target_platform();
 
-        function->add(std::make_shared<mtac::Quadruple>(size, size_temp, mtac::Operator::MUL, static_cast<int>(type->data_type()->size(platform))));
-        function->add(std::make_shared<mtac::Quadruple>(size, size, mtac::Operator::ADD, static_cast<int>(INT->size(platform))));
+        function->add(make_node<mtac::Quadruple>(size, size_temp, mtac::Operator::MUL, static_cast<int>(type->data_type()->size(platform))));
+        function->add(make_node<mtac::Quadruple>(size, size, mtac::Operator::ADD, static_cast<int>(INT->size(platform))));
     
-        auto param = std::make_shared<mtac::Param>(size);
+        auto param = make_node<mtac::Param>(size);
         param->std_param = "a";
         param->function = function->context->global()->getFunction("_F5allocI");
         function->add(param);
@@ -190,9 +244,9 @@ struct ToArgumentsVisitor : public boost::static_visitor<std::vector<mtac::Argum
         auto t1 = function->context->new_temporary(new_pointer_type(INT));
 
         function->context->global()->addReference("_F5allocI");
-        function->add(std::make_shared<mtac::Call>("_F5allocI", function->context->global()->getFunction("_F5allocI"), t1)); 
+        function->add(make_node<mtac::Call>("_F5allocI", function->context->global()->getFunction("_F5allocI"), t1)); 
         
-        function->add(std::make_shared<mtac::Quadruple>(t1, 0, mtac::Operator::DOT_ASSIGN, size_temp));
+        function->add(make_node<mtac::Quadruple>(t1, 0, mtac::Operator::DOT_ASSIGN, size_temp));
 
         return {t1};
     }
@@ -206,20 +260,7 @@ struct ToArgumentsVisitor : public boost::static_visitor<std::vector<mtac::Argum
                 
                 auto variable = boost::get<ast::VariableValue>(value).Content->var;
 
-                if(variable->position().isGlobal()){
-                    return {variable->type()->elements()};
-                } else if((variable->position().is_variable() || variable->position().isStack()) && variable->type()->has_elements()){
-                    return {variable->type()->elements()};
-                } else if(variable->position().isParameter() || variable->position().isStack() || variable->position().is_variable()){
-                    auto t1 = function->context->new_temporary(INT);
-
-                    //The size of the array is at the address pointed by the variable
-                    function->add(std::make_shared<mtac::Quadruple>(t1, variable, mtac::Operator::DOT, 0));
-
-                    return {t1};
-                }
-
-                eddic_unreachable("The variable is not of a valid type");
+                return {computeSizeOfArray(variable, function)};
             }
             case ast::BuiltinType::LENGTH:
                 return {visit(*this, value)[1]};
@@ -287,17 +328,17 @@ struct ToArgumentsVisitor : public boost::static_visitor<std::vector<mtac::Argum
             auto t1 = function->context->new_temporary(INT);
             auto t2 = function->context->new_temporary(INT);
 
-            function->add(std::make_shared<mtac::Quadruple>(t1, var, mtac::Operator::DOT, offset));
-            function->add(std::make_shared<mtac::Quadruple>(t2, var, mtac::Operator::DOT, offset + INT->size(function->context->global()->target_platform())));
+            function->add(make_node<mtac::Quadruple>(t1, var, mtac::Operator::DOT, offset));
+            function->add(make_node<mtac::Quadruple>(t2, var, mtac::Operator::DOT, offset + INT->size(function->context->global()->target_platform())));
 
             return {t1, t2};
         } else {
             auto temp = function->context->new_temporary(member_type);
 
             if(member_type == FLOAT){
-                function->add(std::make_shared<mtac::Quadruple>(temp, var, mtac::Operator::FDOT, offset));
+                function->add(make_node<mtac::Quadruple>(temp, var, mtac::Operator::FDOT, offset));
             } else if(member_type == INT || member_type == CHAR || member_type == BOOL || member_type->is_pointer()){
-                function->add(std::make_shared<mtac::Quadruple>(temp, var, mtac::Operator::DOT, offset));
+                function->add(make_node<mtac::Quadruple>(temp, var, mtac::Operator::DOT, offset));
             } else {
                 eddic_unreachable("Unhandled type");
             }
@@ -317,7 +358,7 @@ struct ToArgumentsVisitor : public boost::static_visitor<std::vector<mtac::Argum
             if(Address){
                 auto temp = function->context->new_temporary(member_type->is_pointer() ? member_type : new_pointer_type(member_type));
                 
-                function->add(std::make_shared<mtac::Quadruple>(temp, value.Content->var, mtac::Operator::PDOT, offset));
+                function->add(make_node<mtac::Quadruple>(temp, value.Content->var, mtac::Operator::PDOT, offset));
 
                 return {temp};
             } else {
@@ -328,7 +369,7 @@ struct ToArgumentsVisitor : public boost::static_visitor<std::vector<mtac::Argum
 
             auto index = computeIndexOfArray(array.Content->var, array.Content->indexValue, function); 
             auto temp = array.Content->context->new_temporary(new_pointer_type(INT));
-            function->add(std::make_shared<mtac::Quadruple>(temp, array.Content->var, mtac::Operator::PDOT, index));
+            function->add(make_node<mtac::Quadruple>(temp, array.Content->var, mtac::Operator::PDOT, index));
             
             auto member_info = mtac::compute_member(function->context->global(), array.Content->var, member_value.Content->memberNames);
             return get_member(member_info.first, member_info.second, temp);
@@ -344,7 +385,7 @@ struct ToArgumentsVisitor : public boost::static_visitor<std::vector<mtac::Argum
             if(Address){
                 auto temp = function->context->new_temporary(member_type->is_pointer() ? member_type : new_pointer_type(member_type));
                 
-                function->add(std::make_shared<mtac::Quadruple>(temp, variable, mtac::Operator::PDOT, offset));
+                function->add(make_node<mtac::Quadruple>(temp, variable, mtac::Operator::PDOT, offset));
 
                 return {temp};
             } else {
@@ -391,7 +432,7 @@ struct ToArgumentsVisitor : public boost::static_visitor<std::vector<mtac::Argum
                 return {value.Content->var};
             } else if(type == STRING){
                 auto temp = value.Content->context->new_temporary(INT);
-                function->add(std::make_shared<mtac::Quadruple>(temp, value.Content->var, mtac::Operator::DOT, INT->size(function->context->global()->target_platform())));
+                function->add(make_node<mtac::Quadruple>(temp, value.Content->var, mtac::Operator::DOT, INT->size(function->context->global()->target_platform())));
 
                 return {value.Content->var, temp};
             } else if(type->is_custom_type() || type->is_template()) {
@@ -407,21 +448,21 @@ struct ToArgumentsVisitor : public boost::static_visitor<std::vector<mtac::Argum
         if(type == INT || type == CHAR || type == BOOL){
             auto temp = function->context->new_temporary(type);
 
-            function->add(std::make_shared<mtac::Quadruple>(temp, variable, mtac::Operator::DOT, 0));
+            function->add(make_node<mtac::Quadruple>(temp, variable, mtac::Operator::DOT, 0));
 
             return {temp};
         } else if(type == FLOAT){
             auto temp = function->context->new_temporary(type);
 
-            function->add(std::make_shared<mtac::Quadruple>(temp, variable, mtac::Operator::FDOT, 0));
+            function->add(make_node<mtac::Quadruple>(temp, variable, mtac::Operator::FDOT, 0));
 
             return {temp};
         } else if(type == STRING){
             auto t1 = function->context->new_temporary(INT);
             auto t2 = function->context->new_temporary(INT);
 
-            function->add(std::make_shared<mtac::Quadruple>(t1, variable, mtac::Operator::DOT, 0));
-            function->add(std::make_shared<mtac::Quadruple>(t2, variable, mtac::Operator::DOT, INT->size(function->context->global()->target_platform())));
+            function->add(make_node<mtac::Quadruple>(t1, variable, mtac::Operator::DOT, 0));
+            function->add(make_node<mtac::Quadruple>(t2, variable, mtac::Operator::DOT, INT->size(function->context->global()->target_platform())));
 
             return {t1, t2};
         } 
@@ -473,10 +514,10 @@ struct ToArgumentsVisitor : public boost::static_visitor<std::vector<mtac::Argum
             auto t1 = function->context->new_temporary(INT);
 
             //Get the label
-            function->add(std::make_shared<mtac::Quadruple>(pointer_temp, array.Content->var, mtac::Operator::ASSIGN));
+            function->add(make_node<mtac::Quadruple>(pointer_temp, array.Content->var, mtac::Operator::ASSIGN));
 
             //Get the specified char 
-            auto quadruple = std::make_shared<mtac::Quadruple>(t1, pointer_temp, mtac::Operator::DOT, index);
+            auto quadruple = make_node<mtac::Quadruple>(t1, pointer_temp, mtac::Operator::DOT, index);
             quadruple->size = mtac::Size::BYTE;
             function->add(quadruple);
 
@@ -488,18 +529,18 @@ struct ToArgumentsVisitor : public boost::static_visitor<std::vector<mtac::Argum
 
         if(type == BOOL || type == CHAR || type == INT || type == FLOAT || type->is_pointer()){
             auto temp = array.Content->context->new_temporary(type);
-            function->add(std::make_shared<mtac::Quadruple>(temp, array.Content->var, mtac::Operator::DOT, index));
+            function->add(make_node<mtac::Quadruple>(temp, array.Content->var, mtac::Operator::DOT, index));
             return {temp};
         } else if (type == STRING){
             auto t1 = array.Content->context->new_temporary(INT);
-            function->add(std::make_shared<mtac::Quadruple>(t1, array.Content->var, mtac::Operator::DOT, index));
+            function->add(make_node<mtac::Quadruple>(t1, array.Content->var, mtac::Operator::DOT, index));
 
             auto t2 = array.Content->context->new_temporary(INT);
             auto t3 = array.Content->context->new_temporary(INT);
 
             //Assign the second part of the string
-            function->add(std::make_shared<mtac::Quadruple>(t3, index, mtac::Operator::ADD, INT->size(function->context->global()->target_platform())));
-            function->add(std::make_shared<mtac::Quadruple>(t2, array.Content->var, mtac::Operator::DOT, t3));
+            function->add(make_node<mtac::Quadruple>(t3, index, mtac::Operator::ADD, INT->size(function->context->global()->target_platform())));
+            function->add(make_node<mtac::Quadruple>(t2, array.Content->var, mtac::Operator::DOT, t3));
 
             return {t1, t2};
         } else {
@@ -538,9 +579,9 @@ struct ToArgumentsVisitor : public boost::static_visitor<std::vector<mtac::Argum
             auto t1 = function->context->new_temporary(type);
 
             if(type == FLOAT){
-                function->add(std::make_shared<mtac::Quadruple>(t1, arg, mtac::Operator::FMINUS));
+                function->add(make_node<mtac::Quadruple>(t1, arg, mtac::Operator::FMINUS));
             } else {
-                function->add(std::make_shared<mtac::Quadruple>(t1, arg, mtac::Operator::MINUS));
+                function->add(make_node<mtac::Quadruple>(t1, arg, mtac::Operator::MINUS));
             }
 
             return {t1};
@@ -549,7 +590,7 @@ struct ToArgumentsVisitor : public boost::static_visitor<std::vector<mtac::Argum
             
             auto t1 = function->context->new_temporary(BOOL);
 
-            function->add(std::make_shared<mtac::Quadruple>(t1, arg, mtac::Operator::NOT));
+            function->add(make_node<mtac::Quadruple>(t1, arg, mtac::Operator::NOT));
 
             return {t1};
         } else {
@@ -567,15 +608,15 @@ struct ToArgumentsVisitor : public boost::static_visitor<std::vector<mtac::Argum
             auto t1 = function->context->new_temporary(destType);
 
             if(destType == FLOAT){
-                function->add(std::make_shared<mtac::Quadruple>(t1, arg, mtac::Operator::I2F));
+                function->add(make_node<mtac::Quadruple>(t1, arg, mtac::Operator::I2F));
             } else if(destType == INT){
                 if(srcType == FLOAT){
-                    function->add(std::make_shared<mtac::Quadruple>(t1, arg, mtac::Operator::F2I));
+                    function->add(make_node<mtac::Quadruple>(t1, arg, mtac::Operator::F2I));
                 } else if(srcType == CHAR){
-                    function->add(std::make_shared<mtac::Quadruple>(t1, arg, mtac::Operator::ASSIGN));
+                    function->add(make_node<mtac::Quadruple>(t1, arg, mtac::Operator::ASSIGN));
                 }
             } else if(destType == CHAR){
-                function->add(std::make_shared<mtac::Quadruple>(t1, arg, mtac::Operator::ASSIGN));
+                function->add(make_node<mtac::Quadruple>(t1, arg, mtac::Operator::ASSIGN));
             } else {
                 return {arg};
             }
@@ -632,52 +673,52 @@ struct AssignValueToVariable : public AbstractVisitor {
 
     void intAssign(const std::vector<mtac::Argument>& arguments) const {
         if(offset){
-            function->add(std::make_shared<mtac::Quadruple>(variable, *offset, mtac::Operator::DOT_ASSIGN, arguments[0]));
+            function->add(make_node<mtac::Quadruple>(variable, *offset, mtac::Operator::DOT_ASSIGN, arguments[0]));
         } else if(indexValue){
             auto index = computeIndexOfArray(variable, *indexValue, function); 
-            function->add(std::make_shared<mtac::Quadruple>(variable, index, mtac::Operator::DOT_ASSIGN, arguments[0]));
+            function->add(make_node<mtac::Quadruple>(variable, index, mtac::Operator::DOT_ASSIGN, arguments[0]));
         } else {
-            function->add(std::make_shared<mtac::Quadruple>(variable, arguments[0], mtac::Operator::ASSIGN));
+            function->add(make_node<mtac::Quadruple>(variable, arguments[0], mtac::Operator::ASSIGN));
         }
     }
 
     void pointerAssign(const std::vector<mtac::Argument>& arguments) const {
         if(offset){
-            function->add(std::make_shared<mtac::Quadruple>(variable, *offset, mtac::Operator::DOT_PASSIGN, arguments[0]));
+            function->add(make_node<mtac::Quadruple>(variable, *offset, mtac::Operator::DOT_PASSIGN, arguments[0]));
         } else if(indexValue){
             auto index = computeIndexOfArray(variable, *indexValue, function); 
-            function->add(std::make_shared<mtac::Quadruple>(variable, index, mtac::Operator::DOT_PASSIGN, arguments[0]));
+            function->add(make_node<mtac::Quadruple>(variable, index, mtac::Operator::DOT_PASSIGN, arguments[0]));
         } else {
-            function->add(std::make_shared<mtac::Quadruple>(variable, arguments[0], mtac::Operator::PASSIGN));
+            function->add(make_node<mtac::Quadruple>(variable, arguments[0], mtac::Operator::PASSIGN));
         }
     }
 
     void floatAssign(const std::vector<mtac::Argument>& arguments) const {
         if(offset){
-            function->add(std::make_shared<mtac::Quadruple>(variable, *offset, mtac::Operator::DOT_FASSIGN, arguments[0]));
+            function->add(make_node<mtac::Quadruple>(variable, *offset, mtac::Operator::DOT_FASSIGN, arguments[0]));
         } else if(indexValue){
             auto index = computeIndexOfArray(variable, *indexValue, function); 
-            function->add(std::make_shared<mtac::Quadruple>(variable, index, mtac::Operator::DOT_FASSIGN, arguments[0]));
+            function->add(make_node<mtac::Quadruple>(variable, index, mtac::Operator::DOT_FASSIGN, arguments[0]));
         } else {
-            function->add(std::make_shared<mtac::Quadruple>(variable, arguments[0], mtac::Operator::FASSIGN));
+            function->add(make_node<mtac::Quadruple>(variable, arguments[0], mtac::Operator::FASSIGN));
         }
     }
 
     void stringAssign(const std::vector<mtac::Argument>& arguments) const {
         if(offset){
-            function->add(std::make_shared<mtac::Quadruple>(variable, *offset, mtac::Operator::DOT_ASSIGN, arguments[0]));
-            function->add(std::make_shared<mtac::Quadruple>(variable, *offset + INT->size(function->context->global()->target_platform()), mtac::Operator::DOT_ASSIGN, arguments[1]));
+            function->add(make_node<mtac::Quadruple>(variable, *offset, mtac::Operator::DOT_ASSIGN, arguments[0]));
+            function->add(make_node<mtac::Quadruple>(variable, *offset + INT->size(function->context->global()->target_platform()), mtac::Operator::DOT_ASSIGN, arguments[1]));
         } else if(indexValue){
             auto index = computeIndexOfArray(variable, *indexValue, function); 
 
-            function->add(std::make_shared<mtac::Quadruple>(variable, index, mtac::Operator::DOT_ASSIGN, arguments[0]));
+            function->add(make_node<mtac::Quadruple>(variable, index, mtac::Operator::DOT_ASSIGN, arguments[0]));
 
             auto temp1 = function->context->new_temporary(INT);
-            function->add(std::make_shared<mtac::Quadruple>(temp1, index, mtac::Operator::ADD, INT->size(function->context->global()->target_platform())));
-            function->add(std::make_shared<mtac::Quadruple>(variable, temp1, mtac::Operator::DOT_ASSIGN, arguments[1]));
+            function->add(make_node<mtac::Quadruple>(temp1, index, mtac::Operator::ADD, INT->size(function->context->global()->target_platform())));
+            function->add(make_node<mtac::Quadruple>(variable, temp1, mtac::Operator::DOT_ASSIGN, arguments[1]));
         } else {
-            function->add(std::make_shared<mtac::Quadruple>(variable, arguments[0], mtac::Operator::ASSIGN));
-            function->add(std::make_shared<mtac::Quadruple>(variable, INT->size(function->context->global()->target_platform()), mtac::Operator::DOT_ASSIGN, arguments[1]));
+            function->add(make_node<mtac::Quadruple>(variable, arguments[0], mtac::Operator::ASSIGN));
+            function->add(make_node<mtac::Quadruple>(variable, INT->size(function->context->global()->target_platform()), mtac::Operator::DOT_ASSIGN, arguments[1]));
         }
     }
     
@@ -723,48 +764,48 @@ struct DereferenceAssign : public AbstractVisitor {
 
     void intAssign(const std::vector<mtac::Argument>& arguments) const {
         if(offset == 0){
-            function->add(std::make_shared<mtac::Quadruple>(variable, 0, mtac::Operator::DOT_ASSIGN, arguments[0]));
+            function->add(make_node<mtac::Quadruple>(variable, 0, mtac::Operator::DOT_ASSIGN, arguments[0]));
         } else {
             auto temp = function->context->new_temporary(new_pointer_type(INT));
 
-            function->add(std::make_shared<mtac::Quadruple>(temp, variable, mtac::Operator::DOT, offset));
-            function->add(std::make_shared<mtac::Quadruple>(temp, 0, mtac::Operator::DOT_ASSIGN, arguments[0]));
+            function->add(make_node<mtac::Quadruple>(temp, variable, mtac::Operator::DOT, offset));
+            function->add(make_node<mtac::Quadruple>(temp, 0, mtac::Operator::DOT_ASSIGN, arguments[0]));
         }
     }
     
     void pointerAssign(const std::vector<mtac::Argument>& arguments) const {
         if(offset == 0){
-            function->add(std::make_shared<mtac::Quadruple>(variable, 0, mtac::Operator::DOT_PASSIGN, arguments[0]));
+            function->add(make_node<mtac::Quadruple>(variable, 0, mtac::Operator::DOT_PASSIGN, arguments[0]));
         } else {
             auto temp = function->context->new_temporary(new_pointer_type(INT));
 
-            function->add(std::make_shared<mtac::Quadruple>(temp, variable, mtac::Operator::DOT, offset));
-            function->add(std::make_shared<mtac::Quadruple>(temp, 0, mtac::Operator::DOT_PASSIGN, arguments[0]));
+            function->add(make_node<mtac::Quadruple>(temp, variable, mtac::Operator::DOT, offset));
+            function->add(make_node<mtac::Quadruple>(temp, 0, mtac::Operator::DOT_PASSIGN, arguments[0]));
         }
     }
     
     void floatAssign(const std::vector<mtac::Argument>& arguments) const {
         if(offset == 0){
-            function->add(std::make_shared<mtac::Quadruple>(variable, 0, mtac::Operator::DOT_FASSIGN, arguments[0]));
+            function->add(make_node<mtac::Quadruple>(variable, 0, mtac::Operator::DOT_FASSIGN, arguments[0]));
         } else {
             auto temp = function->context->new_temporary(new_pointer_type(INT));
 
-            function->add(std::make_shared<mtac::Quadruple>(temp, variable, mtac::Operator::FDOT, offset));
-            function->add(std::make_shared<mtac::Quadruple>(temp, 0, mtac::Operator::DOT_FASSIGN, arguments[0]));
+            function->add(make_node<mtac::Quadruple>(temp, variable, mtac::Operator::FDOT, offset));
+            function->add(make_node<mtac::Quadruple>(temp, 0, mtac::Operator::DOT_FASSIGN, arguments[0]));
         }
     }
 
     void stringAssign(const std::vector<mtac::Argument>& arguments) const {
         if(offset == 0){
-            function->add(std::make_shared<mtac::Quadruple>(variable, 0, mtac::Operator::DOT_ASSIGN, arguments[0]));
-            function->add(std::make_shared<mtac::Quadruple>(variable, INT->size(function->context->global()->target_platform()), mtac::Operator::DOT_ASSIGN, arguments[1]));
+            function->add(make_node<mtac::Quadruple>(variable, 0, mtac::Operator::DOT_ASSIGN, arguments[0]));
+            function->add(make_node<mtac::Quadruple>(variable, INT->size(function->context->global()->target_platform()), mtac::Operator::DOT_ASSIGN, arguments[1]));
         } else {
             auto temp = function->context->new_temporary(new_pointer_type(INT));
             
-            function->add(std::make_shared<mtac::Quadruple>(temp, variable, mtac::Operator::DOT, offset));
+            function->add(make_node<mtac::Quadruple>(temp, variable, mtac::Operator::DOT, offset));
 
-            function->add(std::make_shared<mtac::Quadruple>(temp, offset, mtac::Operator::DOT_ASSIGN, arguments[0]));
-            function->add(std::make_shared<mtac::Quadruple>(temp, offset + INT->size(function->context->global()->target_platform()), mtac::Operator::DOT_ASSIGN, arguments[1]));
+            function->add(make_node<mtac::Quadruple>(temp, offset, mtac::Operator::DOT_ASSIGN, arguments[0]));
+            function->add(make_node<mtac::Quadruple>(temp, offset + INT->size(function->context->global()->target_platform()), mtac::Operator::DOT_ASSIGN, arguments[1]));
         }
     }
 };
@@ -787,7 +828,7 @@ struct AssignVisitor : public boost::static_visitor<> {
             auto index = computeIndexOfArray(source, left.Content->indexValue, function); 
 
             dest = left.Content->context->new_temporary(new_pointer_type(INT));
-            function->add(std::make_shared<mtac::Quadruple>(dest, source, mtac::Operator::PDOT, index));
+            function->add(make_node<mtac::Quadruple>(dest, source, mtac::Operator::PDOT, index));
         } else if(auto* ptr = boost::get<ast::MemberValue>(&member_value.Content->location)){
             auto visitor = ToArgumentsVisitor<true>(function);
             auto left_value = visit_non_variant(visitor, *ptr);
@@ -873,7 +914,7 @@ struct JumpIfFalseVisitor : public boost::static_visitor<> {
     void operator()(T& value) const {
         auto argument = ToArgumentsVisitor<>(function)(value)[0];
 
-        function->add(std::make_shared<mtac::IfFalse>(argument, label));
+        function->add(make_node<mtac::IfFalse>(argument, label));
     }
 };
 
@@ -934,7 +975,7 @@ struct JumpIfTrueVisitor : public boost::static_visitor<> {
         else { //Perform int operations
             auto var = performIntOperation(value, function);
             
-            function->add(std::make_shared<mtac::If>(var, label));
+            function->add(make_node<mtac::If>(var, label));
         }
     }
    
@@ -942,7 +983,7 @@ struct JumpIfTrueVisitor : public boost::static_visitor<> {
     void operator()(T& value) const {
         auto argument = ToArgumentsVisitor<>(function)(value)[0];
 
-        function->add(std::make_shared<mtac::If>(argument, label));
+        function->add(make_node<mtac::If>(argument, label));
     }
 };
 
@@ -981,7 +1022,7 @@ void JumpIfFalseVisitor::operator()(ast::Expression& value) const {
     else { //Perform int operations
         auto var = performIntOperation(value, function);
 
-        function->add(std::make_shared<mtac::IfFalse>(var, label));
+        function->add(make_node<mtac::IfFalse>(var, label));
     }
 }
 
@@ -996,7 +1037,7 @@ std::vector<mtac::Argument> compile_ternary(mtac::function_p function, ast::Tern
 
         visit(JumpIfFalseVisitor(function, falseLabel), ternary.Content->condition); 
         visit(AssignValueToVariable(function, t1), ternary.Content->true_value);
-        function->add(std::make_shared<mtac::Goto>(endLabel));
+        function->add(make_node<mtac::Goto>(endLabel));
         
         function->add(falseLabel);
         visit(AssignValueToVariable(function, t1), ternary.Content->false_value);
@@ -1010,15 +1051,15 @@ std::vector<mtac::Argument> compile_ternary(mtac::function_p function, ast::Tern
         
         visit(JumpIfFalseVisitor(function, falseLabel), ternary.Content->condition); 
         auto args = visit(ToArgumentsVisitor<>(function), ternary.Content->true_value);
-        function->add(std::make_shared<mtac::Quadruple>(t1, args[0], mtac::Operator::ASSIGN));  
-        function->add(std::make_shared<mtac::Quadruple>(t2, args[1], mtac::Operator::ASSIGN));  
+        function->add(make_node<mtac::Quadruple>(t1, args[0], mtac::Operator::ASSIGN));  
+        function->add(make_node<mtac::Quadruple>(t2, args[1], mtac::Operator::ASSIGN));  
 
-        function->add(std::make_shared<mtac::Goto>(endLabel));
+        function->add(make_node<mtac::Goto>(endLabel));
         
         function->add(falseLabel);
         args = visit(ToArgumentsVisitor<>(function), ternary.Content->false_value);
-        function->add(std::make_shared<mtac::Quadruple>(t1, args[0], mtac::Operator::ASSIGN));  
-        function->add(std::make_shared<mtac::Quadruple>(t2, args[1], mtac::Operator::ASSIGN));  
+        function->add(make_node<mtac::Quadruple>(t1, args[0], mtac::Operator::ASSIGN));  
+        function->add(make_node<mtac::Quadruple>(t2, args[1], mtac::Operator::ASSIGN));  
         
         function->add(endLabel);
         
@@ -1031,37 +1072,40 @@ std::vector<mtac::Argument> compile_ternary(mtac::function_p function, ast::Tern
 void performStringOperation(ast::Expression& value, mtac::function_p function, std::shared_ptr<Variable> v1, std::shared_ptr<Variable> v2){
     eddic_assert(value.Content->operations.size() > 0, "Expression with no operation should have been transformed");
 
+    auto global = function->context->global();
+
     std::vector<mtac::Argument> arguments;
 
+    //Compute all the strings before passing the parameters, they can contain calls
     auto first = visit(ToArgumentsVisitor<>(function), value.Content->first);
     arguments.insert(arguments.end(), first.begin(), first.end());
 
-    //Perfom all the additions
-    for(unsigned int i = 0; i < value.Content->operations.size(); ++i){
-        auto operation = value.Content->operations[i];
-
+    for(auto& operation : value.Content->operations){
         auto second = visit(ToArgumentsVisitor<>(function), operation.get<1>());
         arguments.insert(arguments.end(), second.begin(), second.end());
-        
-        for(auto& arg : arguments){
-            function->add(std::make_shared<mtac::Param>(arg));   
-        }
+    }
 
-        arguments.clear();
-        
-        function->context->global()->addReference("_F6concatSS");
+    for(auto& arg : arguments){
+        function->add(make_node<mtac::Param>(arg));   
+    }
 
-        if(i == value.Content->operations.size() - 1){
-            function->add(std::make_shared<mtac::Call>("_F6concatSS", function->context->global()->getFunction("_F6concatSS"), v1, v2)); 
-        } else {
-            auto t1 = function->context->new_temporary(INT);
-            auto t2 = function->context->new_temporary(INT);
-            
-            function->add(std::make_shared<mtac::Call>("_F6concatSS", function->context->global()->getFunction("_F6concatSS"), t1, t2)); 
-          
-            arguments.push_back(t1);
-            arguments.push_back(t2);
-        }
+    //Two strings are concatenated with the binary concat function
+    if(value.Content->operations.size() == 1){
+        global->addReference("_F6concatSS");
+        function->add(make_node<mtac::Call>("_F6concatSS", global->getFunction("_F6concatSS"), v1, v2)); 
+    } 
+    //A chain of concatenations is made in one call to allocate the result only once
+    else {
+        unsigned int strings = value.Content->operations.size() + 1;
+        auto definition = global->concat_function(strings);
+
+        auto param = make_node<mtac::Param>(static_cast<int>(strings));
+        param->std_param = "count";
+        param->function = definition;
+        function->add(param);
+
+        global->addReference("_concatN");
+        function->add(make_node<mtac::Call>("_concatN", definition, v1, v2)); 
     }
 }
 
@@ -1070,9 +1114,10 @@ class CompilerVisitor : public boost::static_visitor<> {
         std::shared_ptr<StringPool> pool;
         mtac::program_p program;
         mtac::function_p function;
+        bool bounds_check;
     
     public:
-        CompilerVisitor(std::shared_ptr<StringPool> p, mtac::program_p mtacProgram) : pool(p), program(mtacProgram) {}
+        CompilerVisitor(std::shared_ptr<StringPool> p, mtac::program_p mtacProgram, bool bounds_check) : pool(p), program(mtacProgram), bounds_check(bounds_check) {}
 
         AUTO_RECURSE_STRUCT()
 
@@ -1111,12 +1156,12 @@ class CompilerVisitor : public boost::static_visitor<> {
                         if(program->context->exists(dtor_name)){
                             auto dtor_function = program->context->getFunction(dtor_name);
 
-                            auto dtor_param = std::make_shared<mtac::Param>(var, dtor_function->context->getVariable(dtor_function->parameters[0].name), dtor_function);
+                            auto dtor_param = make_node<mtac::Param>(var, dtor_function->context->getVariable(dtor_function->parameters[0].name), dtor_function);
                             dtor_param->address = true;
                             function->add(dtor_param);
 
                             program->context->addReference(dtor_name);
-                            function->add(std::make_shared<mtac::Call>(dtor_name, dtor_function)); 
+                            function->add(make_node<mtac::Call>(dtor_name, dtor_function)); 
                         }
                     }
                 }
@@ -1127,6 +1172,7 @@ class CompilerVisitor : public boost::static_visitor<> {
         inline void issue_function(Function& f){
             function = std::make_shared<mtac::Function>(f.Content->context, f.Content->mangledName);
             function->definition = program->context->getFunction(f.Content->mangledName);
+            function->bounds_check = bounds_check;
 
             visit_each(*this, f.Content->instructions);
 
@@ -1162,7 +1208,7 @@ class CompilerVisitor : public boost::static_visitor<> {
                 if (if_.Content->else_) {
                     std::string elseLabel = newLabel();
 
-                    function->add(std::make_shared<mtac::Goto>(elseLabel));
+                    function->add(make_node<mtac::Goto>(elseLabel));
 
                     function->add(endLabel);
 
@@ -1184,7 +1230,7 @@ class CompilerVisitor : public boost::static_visitor<> {
                 
                 issue_destructors(if_.Content->context);
 
-                function->add(std::make_shared<mtac::Goto>(end));
+                function->add(make_node<mtac::Goto>(end));
 
                 for (std::vector<ast::ElseIf>::size_type i = 0; i < if_.Content->elseIfs.size(); ++i) {
                     ast::ElseIf& elseIf = if_.Content->elseIfs[i];
@@ -1208,7 +1254,7 @@ class CompilerVisitor : public boost::static_visitor<> {
                     
                     issue_destructors(elseIf.context);
 
-                    function->add(std::make_shared<mtac::Goto>(end));
+                    function->add(make_node<mtac::Goto>(end));
                 }
 
                 if (if_.Content->else_) {
@@ -1233,12 +1279,12 @@ class CompilerVisitor : public boost::static_visitor<> {
                 //Pass all normal arguments
                 pass_arguments(function, ctor_function, declaration);
 
-                auto ctor_param = std::make_shared<mtac::Param>(var, ctor_function->context->getVariable(ctor_function->parameters[0].name), ctor_function);
+                auto ctor_param = make_node<mtac::Param>(var, ctor_function->context->getVariable(ctor_function->parameters[0].name), ctor_function);
                 ctor_param->address = true;
                 function->add(ctor_param);
 
                 program->context->addReference(ctor_name);
-                function->add(std::make_shared<mtac::Call>(ctor_name, ctor_function)); 
+                function->add(make_node<mtac::Call>(ctor_name, ctor_function)); 
             }
         }
 
@@ -1251,12 +1297,12 @@ class CompilerVisitor : public boost::static_visitor<> {
                 if(program->context->exists(ctor_name)){
                     auto ctor_function = program->context->getFunction(ctor_name);
 
-                    auto ctor_param = std::make_shared<mtac::Param>(var, ctor_function->context->getVariable(ctor_function->parameters[0].name), ctor_function);
+                    auto ctor_param = make_node<mtac::Param>(var, ctor_function->context->getVariable(ctor_function->parameters[0].name), ctor_function);
                     ctor_param->address = true;
                     function->add(ctor_param);
 
                     program->context->addReference(ctor_name);
-                    function->add(std::make_shared<mtac::Call>(ctor_name, ctor_function)); 
+                    function->add(make_node<mtac::Call>(ctor_name, ctor_function)); 
                 }
             } else {
                 if(declaration.Content->value){
@@ -1274,21 +1320,21 @@ class CompilerVisitor : public boost::static_visitor<> {
             auto t1 = swap.Content->context->new_temporary(INT);
 
             if(lhs_var->type() == INT || lhs_var->type() == CHAR || lhs_var->type() == BOOL || lhs_var->type() == STRING){
-                function->add(std::make_shared<mtac::Quadruple>(t1, rhs_var, mtac::Operator::ASSIGN));  
-                function->add(std::make_shared<mtac::Quadruple>(rhs_var, lhs_var, mtac::Operator::ASSIGN));  
-                function->add(std::make_shared<mtac::Quadruple>(lhs_var, t1, mtac::Operator::ASSIGN));  
+                function->add(make_node<mtac::Quadruple>(t1, rhs_var, mtac::Operator::ASSIGN));  
+                function->add(make_node<mtac::Quadruple>(rhs_var, lhs_var, mtac::Operator::ASSIGN));  
+                function->add(make_node<mtac::Quadruple>(lhs_var, t1, mtac::Operator::ASSIGN));  
                 
                 if(lhs_var->type() == STRING){
                     auto t2 = swap.Content->context->new_temporary(INT);
 
                     //t1 = 4(b)
-                    function->add(std::make_shared<mtac::Quadruple>(t1, rhs_var, mtac::Operator::DOT, INT->size(function->context->global()->target_platform())));  
+                    function->add(make_node<mtac::Quadruple>(t1, rhs_var, mtac::Operator::DOT, INT->size(function->context->global()->target_platform())));  
                     //t2 = 4(a)
-                    function->add(std::make_shared<mtac::Quadruple>(t2, lhs_var, mtac::Operator::DOT, INT->size(function->context->global()->target_platform())));  
+                    function->add(make_node<mtac::Quadruple>(t2, lhs_var, mtac::Operator::DOT, INT->size(function->context->global()->target_platform())));  
                     //4(b) = t2
-                    function->add(std::make_shared<mtac::Quadruple>(rhs_var, INT->size(function->context->global()->target_platform()), mtac::Operator::DOT_ASSIGN, t2));  
+                    function->add(make_node<mtac::Quadruple>(rhs_var, INT->size(function->context->global()->target_platform()), mtac::Operator::DOT_ASSIGN, t2));  
                     //4(a) = t1
-                    function->add(std::make_shared<mtac::Quadruple>(lhs_var, INT->size(function->context->global()->target_platform()), mtac::Operator::DOT_ASSIGN, t1));  
+                    function->add(make_node<mtac::Quadruple>(lhs_var, INT->size(function->context->global()->target_platform()), mtac::Operator::DOT_ASSIGN, t1));  
                 }
             } else {
                 eddic_unreachable("Unhandled variable type");
@@ -1328,9 +1374,9 @@ class CompilerVisitor : public boost::static_visitor<> {
             auto arguments = visit(ToArgumentsVisitor<>(function), return_.Content->value);
 
             if(arguments.size() == 1){
-                function->add(std::make_shared<mtac::Quadruple>(mtac::Operator::RETURN, arguments[0]));
+                function->add(make_node<mtac::Quadruple>(mtac::Operator::RETURN, arguments[0]));
             } else if(arguments.size() == 2){
-                function->add(std::make_shared<mtac::Quadruple>(mtac::Operator::RETURN, arguments[0], arguments[1]));
+                function->add(make_node<mtac::Quadruple>(mtac::Operator::RETURN, arguments[0], arguments[1]));
             } else {
                 eddic_unreachable("Unhandled arguments size");
             }   
@@ -1345,25 +1391,25 @@ class CompilerVisitor : public boost::static_visitor<> {
                 if(program->context->exists(dtor_name)){
                     auto dtor_function = program->context->getFunction(dtor_name);
 
-                    auto dtor_param = std::make_shared<mtac::Param>(delete_.Content->variable, dtor_function->context->getVariable(dtor_function->parameters[0].name), dtor_function);
+                    auto dtor_param = make_node<mtac::Param>(delete_.Content->variable, dtor_function->context->getVariable(dtor_function->parameters[0].name), dtor_function);
                     dtor_param->address = true;
                     function->add(dtor_param);
 
                     program->context->addReference(dtor_name);
-                    function->add(std::make_shared<mtac::Call>(dtor_name, dtor_function)); 
+                    function->add(make_node<mtac::Call>(dtor_name, dtor_function)); 
                 }
             }
 
             auto free_name = "_F4freePI";
             auto free_function = program->context->getFunction(free_name);
 
-            auto param = std::make_shared<mtac::Param>(delete_.Content->variable);
+            auto param = make_node<mtac::Param>(delete_.Content->variable);
             param->std_param = "a";
             param->function = free_function;
             function->add(param);
 
             program->context->addReference(free_name);
-            function->add(std::make_shared<mtac::Call>(free_name, free_function)); 
+            function->add(make_node<mtac::Call>(free_name, free_function)); 
         }
 
         template<typename T>
@@ -1392,9 +1438,9 @@ void push_struct_member(ast::MemberValue& memberValue, std::shared_ptr<const Typ
 
             for(auto& v : boost::adaptors::reverse(member_values)){
                 if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&param)){
-                    function->add(std::make_shared<mtac::Param>(v, *ptr, definition));
+                    function->add(make_node<mtac::Param>(v, *ptr, definition));
                 } else if(auto* ptr = boost::get<std::string>(&param)){
-                    function->add(std::make_shared<mtac::Param>(v, *ptr, definition));
+                    function->add(make_node<mtac::Param>(v, *ptr, definition));
                 }
             }
         }
@@ -1430,40 +1476,81 @@ void push_struct(mtac::function_p function, boost::variant<std::shared_ptr<Varia
 
             for(auto& v : boost::adaptors::reverse(member_values)){
                 if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&param)){
-                    function->add(std::make_shared<mtac::Param>(v, *ptr, definition));
+                    function->add(make_node<mtac::Param>(v, *ptr, definition));
                 } else if(auto* ptr = boost::get<std::string>(&param)){
-                    function->add(std::make_shared<mtac::Param>(v, *ptr, definition));
+                    function->add(make_node<mtac::Param>(v, *ptr, definition));
                 }
             }
         }
     }
 }
 
+std::vector<mtac::Argument> compute_argument(mtac::function_p function, std::shared_ptr<eddic::Function> definition, const std::string& name, ast::Value& value){
+    auto context = definition->context;
+
+    //If it's a standard function, there are no context
+    if(!context){
+        return visit(ToArgumentsVisitor<>(function), value);
+    }
+
+    std::shared_ptr<Variable> param = context->getVariable(name);
+
+    if(auto* ptr = boost::get<ast::VariableValue>(&value)){
+        auto type = (*ptr).Content->var->type();
+        if((type->is_custom_type() || type->is_template()) && !param->type()->is_pointer()){
+            //The structures are pushed member by member with the params
+            return {};
+        }
+    } 
+
+    if(param->type()->is_pointer()){
+        return visit(ToArgumentsVisitor<true>(function), value);
+    } else {
+        return visit(ToArgumentsVisitor<>(function), value);
+    }
+}
+
 template<typename Call>
 void pass_arguments(mtac::function_p function, std::shared_ptr<eddic::Function> definition, Call& functionCall){
     auto context = definition->context;
     
     auto values = functionCall.Content->values;
+    auto parameters = definition->parameters;
+
+    //A bounds check creates new basic blocks. With -fbounds-check, all the arguments are computed before 
+    //the first param so that the params of a call are never split across basic blocks (the inliner needs it)
+    std::vector<std::vector<mtac::Argument>> computed;
+
+    if(function->bounds_check){
+        int i = parameters.size()-1;
+
+        for(auto& first : boost::adaptors::reverse(values)){
+            computed.push_back(compute_argument(function, definition, parameters[i--].name, first));
+        }
+    }
+
+    auto next = computed.begin();
 
     //If it's a standard function, there are no context
     if(!context){
-        auto parameters = definition->parameters;
         int i = parameters.size()-1;
 
         for(auto& first : boost::adaptors::reverse(values)){
             auto param = parameters[i--].name; 
             
-            auto args = visit(ToArgumentsVisitor<>(function), first);
+            auto args = function->bounds_check ? *next++ : compute_argument(function, definition, param, first);
             for(auto& arg : boost::adaptors::reverse(args)){
-                function->add(std::make_shared<mtac::Param>(arg, param, definition));   
+                function->add(make_node<mtac::Param>(arg, param, definition));   
             }
         }
     } else {
-        auto parameters = definition->parameters;
         int i = parameters.size()-1;
 
         for(auto& first : boost::adaptors::reverse(values)){
-            std::shared_ptr<Variable> param = context->getVariable(parameters[i--].name);
+            auto name = parameters[i--].name;
+            std::shared_ptr<Variable> param = context->getVariable(name);
+
+            auto args = function->bounds_check ? *next++ : compute_argument(function, definition, name, first);
 
             if(auto* ptr = boost::get<ast::VariableValue>(&first)){
                 auto type = (*ptr).Content->var->type();
@@ -1472,16 +1559,9 @@ void pass_arguments(mtac::function_p function, std::shared_ptr<eddic::Function>
                     continue;
                 }
             } 
-
-            std::vector<mtac::Argument> args;
-            if(param->type()->is_pointer()){
-                args = visit(ToArgumentsVisitor<true>(function), first);
-            } else {
-                args = visit(ToArgumentsVisitor<>(function), first);
-            }
             
             for(auto& arg : boost::adaptors::reverse(args)){
-                auto mtac_param = std::make_shared<mtac::Param>(arg, param, definition);
+                auto mtac_param = make_node<mtac::Param>(arg, param, definition);
                 mtac_param->address = param->type()->is_pointer();
 
                 function->add(mtac_param);
@@ -1498,7 +1578,7 @@ void execute_call(ast::FunctionCall& functionCall, mtac::function_p function, st
 
     pass_arguments(function, definition, functionCall);
 
-    function->add(std::make_shared<mtac::Call>(definition->mangledName, definition, return_, return2_));
+    function->add(make_node<mtac::Call>(definition->mangledName, definition, return_, return2_));
 }
 
 void execute_member_call(ast::MemberFunctionCall& functionCall, mtac::function_p function, std::shared_ptr<Variable> return_, std::shared_ptr<Variable> return2_){
@@ -1512,12 +1592,12 @@ void execute_member_call(ast::MemberFunctionCall& functionCall, mtac::function_p
     auto location_args = visit(ToArgumentsVisitor<>(function), functionCall.Content->object);
                 
     //Pass the address of the object to the member function
-    auto mtac_param = std::make_shared<mtac::Param>(location_args[0], definition->context->getVariable(definition->parameters[0].name), definition);
+    auto mtac_param = make_node<mtac::Param>(location_args[0], definition->context->getVariable(definition->parameters[0].name), definition);
     mtac_param->address = true;
     function->add(mtac_param);   
 
     //Call the function
-    function->add(std::make_shared<mtac::Call>(definition->mangledName, definition, return_, return2_));
+    function->add(make_node<mtac::Call>(definition->mangledName, definition, return_, return2_));
 }
 
 std::shared_ptr<Variable> performBoolOperation(ast::Expression& value, mtac::function_p function){
@@ -1537,11 +1617,11 @@ std::shared_ptr<Variable> performBoolOperation(ast::Expression& value, mtac::fun
             visit(JumpIfFalseVisitor(function, falseLabel), operation.get<1>());
         }
 
-        function->add(std::make_shared<mtac::Quadruple>(t1, 1, mtac::Operator::ASSIGN));
-        function->add(std::make_shared<mtac::Goto>(endLabel));
+        function->add(make_node<mtac::Quadruple>(t1, 1, mtac::Operator::ASSIGN));
+        function->add(make_node<mtac::Goto>(endLabel));
 
         function->add(falseLabel);
-        function->add(std::make_shared<mtac::Quadruple>(t1, 0, mtac::Operator::ASSIGN));
+        function->add(make_node<mtac::Quadruple>(t1, 0, mtac::Operator::ASSIGN));
 
         function->add(endLabel);
     } 
@@ -1556,11 +1636,11 @@ std::shared_ptr<Variable> performBoolOperation(ast::Expression& value, mtac::fun
             visit(JumpIfTrueVisitor(function, trueLabel), operation.get<1>());
         }
 
-        function->add(std::make_shared<mtac::Quadruple>(t1, 0, mtac::Operator::ASSIGN));
-        function->add(std::make_shared<mtac::Goto>(endLabel));
+        function->add(make_node<mtac::Quadruple>(t1, 0, mtac::Operator::ASSIGN));
+        function->add(make_node<mtac::Goto>(endLabel));
 
         function->add(trueLabel);
-        function->add(std::make_shared<mtac::Quadruple>(t1, 1, mtac::Operator::ASSIGN));
+        function->add(make_node<mtac::Quadruple>(t1, 1, mtac::Operator::ASSIGN));
 
         function->add(endLabel);
     }
@@ -1573,9 +1653,9 @@ std::shared_ptr<Variable> performBoolOperation(ast::Expression& value, mtac::fun
         
         auto typeLeft = visit(ast::GetTypeVisitor(), value.Content->first);
         if(typeLeft == INT || typeLeft == CHAR || typeLeft->is_pointer()){
-            function->add(std::make_shared<mtac::Quadruple>(t1, left, mtac::toRelationalOperator(op), right));
+            function->add(make_node<mtac::Quadruple>(t1, left, mtac::toRelationalOperator(op), right));
         } else if(typeLeft == FLOAT){
-            function->add(std::make_shared<mtac::Quadruple>(t1, left, mtac::toFloatRelationalOperator(op), right));
+            function->add(make_node<mtac::Quadruple>(t1, left, mtac::toFloatRelationalOperator(op), right));
         } else {
             eddic_unreachable("Unsupported type in relational operator");
         }
@@ -1605,17 +1685,17 @@ struct PrefixOperationVisitor : boost::static_visitor<std::shared_ptr<Variable>>
     void perform(std::shared_ptr<Variable> t1){
         if(t1->type() == FLOAT){
             if(operation.Content->op == ast::Operator::INC){
-                function->add(std::make_shared<mtac::Quadruple>(t1, t1, mtac::Operator::FADD, 1.0));
+                function->add(make_node<mtac::Quadruple>(t1, t1, mtac::Operator::FADD, 1.0));
             } else if(operation.Content->op == ast::Operator::DEC){
-                function->add(std::make_shared<mtac::Quadruple>(t1, t1, mtac::Operator::FSUB, 1.0));
+                function->add(make_node<mtac::Quadruple>(t1, t1, mtac::Operator::FSUB, 1.0));
             } else {
                 eddic_unreachable("Unsupported operator");    
             }
         } else if (t1->type() == INT){
             if(operation.Content->op == ast::Operator::INC){
-                function->add(std::make_shared<mtac::Quadruple>(t1, t1, mtac::Operator::ADD, 1));
+                function->add(make_node<mtac::Quadruple>(t1, t1, mtac::Operator::ADD, 1));
             } else if(operation.Content->op == ast::Operator::DEC){
-                function->add(std::make_shared<mtac::Quadruple>(t1, t1, mtac::Operator::SUB, 1));
+                function->add(make_node<mtac::Quadruple>(t1, t1, mtac::Operator::SUB, 1));
             } else {
                 eddic_unreachable("Unsupported operator");    
             }
@@ -1657,7 +1737,7 @@ struct PrefixOperationVisitor : boost::static_visitor<std::shared_ptr<Variable>>
             auto index = computeIndexOfArray(variable, left.Content->indexValue, function); 
 
             auto temp = left.Content->context->new_temporary(INT);
-            function->add(std::make_shared<mtac::Quadruple>(temp, variable, mtac::Operator::PDOT, index));
+            function->add(make_node<mtac::Quadruple>(temp, variable, mtac::Operator::PDOT, index));
 
             unsigned int offset = 0;
             std::shared_ptr<const Type> member_type;
@@ -1751,9 +1831,10 @@ std::shared_ptr<Variable> performSuffixOperation(Operation& operation, mtac::fun
 
 } //end of anonymous namespace
 
-void mtac::Compiler::compile(ast::SourceFile& program, std::shared_ptr<StringPool> pool, mtac::program_p mtacProgram) const {
+void mtac::Compiler::compile(ast::SourceFile& program, std::shared_ptr<StringPool> pool, mtac::program_p mtacProgram, std::shared_ptr<Configuration> configuration) const {
     PerfsTimer timer("MTAC Compilation");
+    PassTimer pass_timer("front end", "mtac generation");
 
-    CompilerVisitor visitor(pool, mtacProgram);
+    CompilerVisitor visitor(pool, mtacProgram, configuration->option_defined("fbounds-check"));
     visitor(program);
 }
@@ -6,6 +6,9 @@
 //=======================================================================
 
 #include "StringPool.hpp"
+#include "GlobalContext.hpp"
+#include "FunctionContext.hpp"
+#include "arena.hpp"
 #include "likely.hpp"
 
 #include "mtac/ConcatReduction.hpp"
@@ -18,6 +21,105 @@ template<typename T>
 bool isParam(T& statement){
     return boost::get<std::shared_ptr<mtac::Param>>(&statement);
 }
+
+namespace {
+
+typedef std::pair<mtac::Argument, mtac::Argument> string_piece;
+
+//Merge the adjacent literals of a call to the N-ary concat function
+bool optimize_concat_n(mtac::function_p function, mtac::basic_block_p block, std::shared_ptr<StringPool> pool){
+    auto call = boost::get<std::shared_ptr<mtac::Call>>(block->statements[0]);
+    auto global = function->context->global();
+
+    //The params are on the previous block
+    auto& paramBlock = block->prev;
+
+    //Two params by string and the number of strings
+    std::size_t strings = call->functionDefinition->parameters.size() - 1;
+    std::size_t params = 2 * strings + 1;
+
+    if(paramBlock->statements.size() < params){
+        return false;
+    }
+
+    auto first = paramBlock->statements.end() - params;
+
+    for(auto it = first; it != paramBlock->statements.end(); ++it){
+        if(!isParam(*it)){
+            return false;
+        }
+    }
+
+    std::vector<string_piece> pieces;
+
+    for(std::size_t i = 0; i < strings; ++i){
+        auto& address = boost::get<std::shared_ptr<mtac::Param>>(*(first + 2 * i))->arg;
+        auto& length = boost::get<std::shared_ptr<mtac::Param>>(*(first + 2 * i + 1))->arg;
+
+        if(boost::get<std::string>(&address) && !pieces.empty() && boost::get<std::string>(&pieces.back().first)){
+            std::string firstValue = pool->value(boost::get<std::string>(pieces.back().first));
+            std::string secondValue = pool->value(boost::get<std::string>(address));
+
+            //Remove the quotes
+            firstValue.resize(firstValue.size() - 1);
+            secondValue.erase(0, 1);
+
+            //Compute the result of the concatenation
+            std::string result = firstValue + secondValue;
+
+            pieces.back() = string_piece(pool->label(result, function->getName()), static_cast<int>(result.length() - 2));
+        } else {
+            pieces.push_back(string_piece(address, length));
+        }
+    }
+
+    //No adjacent literals
+    if(pieces.size() == strings){
+        return false;
+    }
+
+    //Remove the params from the previous basic block
+    paramBlock->statements.erase(first, paramBlock->statements.end());
+
+    global->removeReference("_concatN");
+
+    //The whole chain was made of literals
+    if(pieces.size() == 1){
+        //remove the call to concat
+        block->statements.erase(block->statements.begin());
+
+        //Insert assign with the concatenated value 
+        block->statements.insert(block->statements.begin(), make_node<mtac::Quadruple>(call->return_, pieces[0].first, mtac::Operator::ASSIGN));
+        block->statements.insert(block->statements.begin()+1, make_node<mtac::Quadruple>(call->return2_, pieces[0].second, mtac::Operator::ASSIGN));
+
+        return true;
+    }
+
+    for(auto& piece : pieces){
+        paramBlock->statements.push_back(make_node<mtac::Param>(piece.first));
+        paramBlock->statements.push_back(make_node<mtac::Param>(piece.second));
+    }
+
+    //Two strings are concatenated with the binary concat function
+    if(pieces.size() == 2){
+        global->addReference("_F6concatSS");
+        block->statements[0] = make_node<mtac::Call>("_F6concatSS", global->getFunction("_F6concatSS"), call->return_, call->return2_);
+    } else {
+        auto definition = global->concat_function(pieces.size());
+
+        auto param = make_node<mtac::Param>(static_cast<int>(pieces.size()));
+        param->std_param = "count";
+        param->function = definition;
+        paramBlock->statements.push_back(param);
+
+        global->addReference("_concatN");
+        block->statements[0] = make_node<mtac::Call>("_concatN", definition, call->return_, call->return2_);
+    }
+
+    return true;
+}
+
+} //end of anonymous namespace
     
 void mtac::optimize_concat::set_pool(std::shared_ptr<StringPool> pool){
     this->pool = pool;
@@ -56,7 +158,7 @@ bool mtac::optimize_concat::operator()(mtac::function_p function){
                                 //Compute the result of the concatenation
                                 std::string result = firstValue + secondValue;
 
-                                std::string label = pool->label(result);
+                                std::string label = pool->label(result, function->getName());
                                 int length = result.length() - 2;
 
                                 auto ret1 = (*ptr)->return_;
@@ -66,8 +168,8 @@ bool mtac::optimize_concat::operator()(mtac::function_p function){
                                 block->statements.erase(block->statements.begin());
 
                                 //Insert assign with the concatenated value 
-                                block->statements.insert(block->statements.begin(), std::make_shared<mtac::Quadruple>(ret1, label, mtac::Operator::ASSIGN));
-                                block->statements.insert(block->statements.begin()+1, std::make_shared<mtac::Quadruple>(ret2, length, mtac::Operator::ASSIGN));
+                                block->statements.insert(block->statements.begin(), make_node<mtac::Quadruple>(ret1, label, mtac::Operator::ASSIGN));
+                                block->statements.insert(block->statements.begin()+1, make_node<mtac::Quadruple>(ret2, length, mtac::Operator::ASSIGN));
 
                                 //Remove the four params from the previous basic block
                                 paramBlock->statements.erase(paramBlock->statements.end() - 4, paramBlock->statements.end());
@@ -76,6 +178,8 @@ bool mtac::optimize_concat::operator()(mtac::function_p function){
                             }
                         }
                     }
+                } else if((*ptr)->function == "_concatN"){
+                    optimized |= optimize_concat_n(function, block, pool);
                 }
             }
         }
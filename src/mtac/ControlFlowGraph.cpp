@@ -17,6 +17,10 @@ using namespace eddic;
 void mtac::make_edge(mtac::basic_block_p from, mtac::basic_block_p to){
     from->successors.push_back(to);
     to->predecessors.push_back(from);
+
+    if(from->function){
+        from->function->cfg_changed();
+    }
 }
 
 void mtac::remove_edge(mtac::basic_block_p from, mtac::basic_block_p to){
@@ -41,6 +45,10 @@ void mtac::remove_edge(mtac::basic_block_p from, mtac::basic_block_p to){
 
         ++pit;
     }
+
+    if(from->function){
+        from->function->cfg_changed();
+    }
 }
 
 void mtac::build_control_flow_graph(mtac::function_p function){
@@ -50,6 +58,8 @@ void mtac::build_control_flow_graph(mtac::function_p function){
         block->predecessors.clear();
     }
 
+    function->cfg_changed();
+
     //Add the edges
     for(auto& block : function){
         //Get the following block
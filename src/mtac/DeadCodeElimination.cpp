@@ -13,7 +13,6 @@
 #include "Variable.hpp"
 
 #include "mtac/DeadCodeElimination.hpp"
-#include "mtac/GlobalOptimizations.hpp"
 #include "mtac/LiveVariableAnalysisProblem.hpp"
 #include "mtac/Utils.hpp"
 #include "mtac/Offset.hpp"
@@ -30,27 +29,36 @@ bool mtac::dead_code_elimination::operator()(mtac::function_p function){
     do {
         optimized = false;
 
-        mtac::LiveVariableAnalysisProblem problem;
-        auto results = mtac::data_flow(function, problem);
+        auto results = mtac::live_variable_analysis(function);
+        auto& problem = results->problem;
 
         for(auto& block : function){
-            auto it = iterate(block->statements);
+            std::vector<bool> dead(block->statements.size(), false);
+            std::size_t i = block->statements.size();
 
-            while(it.has_next()){
-                auto statement = *it;
+            results->backward_statements(block, [&problem, &dead, &i](mtac::Statement& statement, mtac::BitSet& live){
+                --i;
 
                 if(auto* ptr = boost::get<std::shared_ptr<mtac::Quadruple>>(&statement)){
                     if(mtac::erase_result((*ptr)->op)){
-                        if(results->OUT_S[statement].values().find((*ptr)->result) == results->OUT_S[statement].values().end()){
-                            it.erase();
-                            optimized_once = true;
-                            optimized=true;
-                            continue;
+                        //The NOP quadruples have no result and are not numbered by the liveness problem
+                        if((*ptr)->op == mtac::Operator::NOP || !live.test(problem.index((*ptr)->result))){
+                            dead[i] = true;
                         }
                     }
                 }
+            });
 
-                ++it;
+            auto it = iterate(block->statements);
+
+            for(std::size_t j = 0; j < dead.size(); ++j){
+                if(dead[j]){
+                    it.erase();
+                    optimized_once = true;
+                    optimized = true;
+                } else {
+                    ++it;
+                }
             }
         }
 
@@ -114,6 +122,11 @@ bool mtac::dead_code_elimination::operator()(mtac::function_p function){
                 ++it;
             }
         }
+
+        //The liveness must be solved again on the new statements
+        if(optimized){
+            function->invalidate_analyses(mtac::ANALYSIS_CONTROL_FLOW);
+        }
     } while(optimized);
 
     return optimized_once;
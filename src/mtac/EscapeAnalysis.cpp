@@ -8,12 +8,18 @@
 #include "Variable.hpp"
 
 #include "mtac/EscapeAnalysis.hpp"
+#include "mtac/Function.hpp"
 #include "mtac/Statement.hpp"
 #include "mtac/Utils.hpp"
 
 using namespace eddic;
 
 mtac::EscapedVariables mtac::escape_analysis(mtac::function_p function){
+    //The escaped variables are kept until a pass changes the function
+    if(function->analyses.escaped){
+        return function->analyses.escaped;
+    }
+
     mtac::EscapedVariables pointer_escaped = std::make_shared<mtac::EscapedVariables::element_type>();
 
     for(auto& block : function){
@@ -53,5 +59,7 @@ mtac::EscapedVariables mtac::escape_analysis(mtac::function_p function){
         }
     }
 
+    function->analyses.escaped = pointer_escaped;
+
     return pointer_escaped;
 }
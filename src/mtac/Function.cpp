@@ -5,6 +5,8 @@
 //  http://www.boost.org/LICENSE_1_0.txt)
 //=======================================================================
 
+#include <algorithm>
+
 #include "assert.hpp"
 #include "logging.hpp"
 
@@ -59,6 +61,7 @@ void mtac::Function::create_entry_bb(){
 
     auto new_block = std::make_shared<mtac::basic_block>(-1);
     new_block->context = context;
+    new_block->function = this;
 
     entry = exit = new_block;
 }
@@ -68,16 +71,20 @@ void mtac::Function::create_exit_bb(){
 
     auto new_block = std::make_shared<mtac::basic_block>(-2);
     new_block->context = context;
+    new_block->function = this;
     
     exit->next = new_block;
     new_block->prev = exit;
 
     exit = new_block;
+
+    cfg_changed();
 }
 
 mtac::basic_block_p mtac::Function::new_bb(){
     auto bb = std::make_shared<mtac::basic_block>(++index);
     bb->context = context;
+    bb->function = this;
     return bb;
 }
 
@@ -90,6 +97,8 @@ mtac::basic_block_p mtac::Function::append_bb(){
 
     exit = new_block;
 
+    cfg_changed();
+
     return new_block;
 }   
         
@@ -100,6 +109,7 @@ mtac::basic_block_iterator mtac::Function::insert_before(mtac::basic_block_itera
     eddic_assert(it != begin(), "Cannot add before entry");
 
     block->context = context;
+    block->function = this;
     
     ++count;
 
@@ -107,6 +117,8 @@ mtac::basic_block_iterator mtac::Function::insert_before(mtac::basic_block_itera
     block->next = bb;
     bb->prev->next = block;
     bb->prev = block;
+
+    cfg_changed();
     
     return at(block);
 }
@@ -148,8 +160,8 @@ mtac::basic_block_iterator mtac::Function::remove(mtac::basic_block_p block){
             }
         }
 
-        //If there is a Fall through edge, redirect it
-        if(pred == block->prev){
+        //If there is a Fall through edge, redirect it (only if the block itself falls through)
+        if(pred == block->prev && std::find(block->successors.begin(), block->successors.end(), block->next) != block->successors.end()){
             mtac::make_edge(pred, block->next);
         }
     }
@@ -163,6 +175,8 @@ mtac::basic_block_iterator mtac::Function::remove(mtac::basic_block_p block){
     block->prev = nullptr;
     block->next = nullptr;
 
+    cfg_changed();
+
     return at(next);
 }
 
@@ -279,6 +293,32 @@ std::vector<std::shared_ptr<mtac::Loop>>& mtac::Function::loops(){
     return m_loops;
 }
 
+void mtac::Function::cfg_changed(){
+    numbering.clear();
+    analyses.cfg_changed();
+}
+
+void mtac::Function::invalidate_analyses(unsigned int preserved){
+    if(!(preserved & mtac::ANALYSIS_CFG)){
+        cfg_changed();
+    }
+
+    analyses.invalidate(preserved);
+}
+
+const std::vector<mtac::basic_block_p>& mtac::Function::numbered_blocks(){
+    if(numbering.empty()){
+        numbering.reserve(count);
+
+        for(auto& block : *this){
+            block->id = numbering.size();
+            numbering.push_back(block);
+        }
+    }
+
+    return numbering;
+}
+
 mtac::basic_block_iterator mtac::begin(mtac::function_p function){
     return function->begin();
 }
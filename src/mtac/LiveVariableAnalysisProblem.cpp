@@ -7,7 +7,6 @@
 
 #include "assert.hpp"
 #include "Variable.hpp"
-#include "Type.hpp"
 #include "VisitorUtils.hpp"
 
 #include "mtac/LiveVariableAnalysisProblem.hpp"
@@ -16,71 +15,54 @@
 
 using namespace eddic;
 
-typedef mtac::LiveVariableAnalysisProblem::ProblemDomain ProblemDomain;
+namespace {
+
+//Give a number to each variable used in the function
+
+struct VariableNumbering {
+    std::unordered_map<std::shared_ptr<Variable>, std::size_t>& indices;
 
-std::ostream& mtac::operator<<(std::ostream& stream, mtac::LiveVariableValues& value){
-    stream << "set{";
+    VariableNumbering(std::unordered_map<std::shared_ptr<Variable>, std::size_t>& indices) : indices(indices) {}
 
-    for(auto& v : value){
-        if(!v){
-            stream << "null, ";
-        } else {
-            stream << v->name() << ", ";
+    void live(const std::shared_ptr<Variable>& variable){
+        if(!indices.count(variable)){
+            auto index = indices.size();
+            indices[variable] = index;
         }
     }
 
-    return stream << "}";
-}
+    void dead(const std::shared_ptr<Variable>& variable){
+        live(variable);
+    }
+};
 
-ProblemDomain mtac::LiveVariableAnalysisProblem::Boundary(mtac::function_p function){
-    pointer_escaped = mtac::escape_analysis(function);
+//Update the live variables from the exit to the entry of a statement
 
-    auto value = default_element();
-    return value;
-}
+struct BitValues {
+    mtac::LiveVariableAnalysisProblem& problem;
+    mtac::BitSet& values;
 
-ProblemDomain mtac::LiveVariableAnalysisProblem::Init(mtac::function_p /*function*/){
-    auto value = default_element();
-    return value;
-}
+    BitValues(mtac::LiveVariableAnalysisProblem& problem, mtac::BitSet& values) : problem(problem), values(values) {}
 
-ProblemDomain mtac::LiveVariableAnalysisProblem::meet(ProblemDomain& out, ProblemDomain& in){
-    if(out.top()){
-        return in;
-    } else if(in.top()){
-        return out;
+    void live(const std::shared_ptr<Variable>& variable){
+        values.set(problem.index(variable));
     }
 
-    typename ProblemDomain::Values values;
-    ProblemDomain result(values);
-
-    for(auto& value : in.values()){
-        result.values().insert(value);
+    void dead(const std::shared_ptr<Variable>& variable){
+        values.reset(problem.index(variable));
     }
-    
-    for(auto& value : out.values()){
-        result.values().insert(value);
-    }
-
-    return result;
-}
-
-namespace {
+};
 
+template<typename Values>
 struct LivenessCollector : public boost::static_visitor<> {
-    ProblemDomain& in;
+    Values values;
 
-    LivenessCollector(ProblemDomain& in) : in(in) {}
+    LivenessCollector(Values values) : values(values) {}
 
     template<typename Arg>
     inline void update(Arg& arg){
         if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&arg)){
-            if(in.top()){
-                ProblemDomain::Values values;
-                in.int_values = values;
-            }
-
-            in.values().insert(*ptr);
+            values.live(*ptr);
         }
     }
 
@@ -94,9 +76,9 @@ struct LivenessCollector : public boost::static_visitor<> {
     void operator()(std::shared_ptr<mtac::Quadruple> quadruple){
         if(quadruple->op != mtac::Operator::NOP){
             if(mtac::erase_result(quadruple->op)){
-                in.values().erase(quadruple->result);
+                values.dead(quadruple->result);
             } else {
-                in.values().insert(quadruple->result);
+                values.live(quadruple->result);
             }
 
             update_optional(quadruple->arg1);
@@ -126,20 +108,56 @@ struct LivenessCollector : public boost::static_visitor<> {
 
 } //End of anonymous namespace
 
-ProblemDomain mtac::LiveVariableAnalysisProblem::transfer(mtac::basic_block_p/* basic_block*/, mtac::Statement& statement, ProblemDomain& out){
-    auto in = out;
-    
-    LivenessCollector collector(in);
+std::size_t mtac::LiveVariableAnalysisProblem::init(mtac::function_p function){
+    pointer_escaped = mtac::escape_analysis(function);
+
+    indices.clear();
+
+    VariableNumbering numbering(indices);
+
+    for(auto& escaped_var : *pointer_escaped){
+        numbering.live(escaped_var);
+    }
+
+    LivenessCollector<VariableNumbering> collector(numbering);
+
+    for(auto& block : function){
+        visit_each(collector, block->statements);
+    }
+
+    return indices.size();
+}
+
+std::vector<mtac::Statement>& mtac::LiveVariableAnalysisProblem::statements(mtac::basic_block_p block){
+    return block->statements;
+}
+
+void mtac::LiveVariableAnalysisProblem::transfer(mtac::Statement& statement, BitSet& values){
+    LivenessCollector<BitValues> collector(BitValues(*this, values));
     visit(collector, statement);
 
+    //The escaped variables are always live
     for(auto& escaped_var : *pointer_escaped){
-        in.values().insert(escaped_var);
+        values.set(index(escaped_var));
     }
+}
 
-    return in;
+std::size_t mtac::LiveVariableAnalysisProblem::index(const std::shared_ptr<Variable>& variable){
+    auto it = indices.find(variable);
+
+    eddic_assert(it != indices.end(), "The variable must have been numbered by init()");
+
+    return it->second;
 }
 
-bool mtac::LiveVariableAnalysisProblem::optimize(mtac::Statement& /*statement*/, std::shared_ptr<mtac::DataFlowResults<ProblemDomain>> /*global_results*/){
-    //This analysis is only made to gather information, not to optimize anything
-    throw "Unimplemented";
+mtac::LiveVariables mtac::live_variable_analysis(mtac::function_p function){
+    auto& analyses = function->analyses;
+
+    //The liveness is kept until a pass changes the function
+    if(!analyses.live_variables){
+        analyses.live_problem = std::make_shared<mtac::LiveVariableAnalysisProblem>();
+        analyses.live_variables = mtac::backward_bit_data_flow(function, *analyses.live_problem);
+    }
+
+    return analyses.live_variables;
 }
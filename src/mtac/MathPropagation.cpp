@@ -7,16 +7,51 @@
 
 #include "Variable.hpp"
 #include "Type.hpp"
+#include "VisitorUtils.hpp"
 
 #include "mtac/MathPropagation.hpp"
 #include "mtac/OptimizerUtils.hpp"
+#include "mtac/Utils.hpp"
+#include "mtac/Function.hpp"
 
 using namespace eddic;
 
-void mtac::MathPropagation::clear(){
+namespace {
+
+bool uses(boost::optional<mtac::Argument>& arg, std::shared_ptr<Variable> variable){
+    if(arg){
+        if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&*arg)){
+            return *ptr == variable;
+        }
+    }
+
+    return false;
+}
+
+bool is_load(mtac::Operator op){
+    return op == mtac::Operator::DOT || op == mtac::Operator::FDOT || op == mtac::Operator::PDOT || op == mtac::Operator::VDOT;
+}
+
+} //end of anonymous namespace
+
+bool mtac::MathPropagation::operator()(mtac::function_p function){
     optimized = false;
-    assigns.clear();
     usage.clear();
+
+    //The usage must be collected on the whole function, a variable used in another block cannot be removed
+    pass = mtac::Pass::DATA_MINING;
+    for(auto& block : function){
+        visit_each(*this, block->statements);
+    }
+
+    pass = mtac::Pass::OPTIMIZE;
+    for(auto& block : function){
+        assigns.clear();
+
+        visit_each(*this, block->statements);
+    }
+
+    return optimized;
 }
 
 void mtac::MathPropagation::collect(mtac::Argument* arg){
@@ -36,10 +71,6 @@ void mtac::MathPropagation::operator()(std::shared_ptr<mtac::Quadruple> quadrupl
         collect(quadruple->arg1);
         collect(quadruple->arg2);
     } else {
-        if(quadruple->result){
-            assigns[quadruple->result] = quadruple;
-        }
-
         if(quadruple->op == mtac::Operator::ASSIGN){
             if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&*quadruple->arg1)){
                 //We only duplicate the math operation if the variable is used once to not add overhead
@@ -53,6 +84,36 @@ void mtac::MathPropagation::operator()(std::shared_ptr<mtac::Quadruple> quadrupl
                 }
             }
         }
+
+        if(quadruple->result && mtac::erase_result(quadruple->op)){
+            invalidate(quadruple->result);
+
+            if(!uses(quadruple->arg1, quadruple->result) && !uses(quadruple->arg2, quadruple->result)){
+                assigns[quadruple->result] = quadruple;
+            }
+        } else {
+            //The loaded values can be modified by the store
+            auto it = assigns.begin();
+            while(it != assigns.end()){
+                if(is_load(it->second->op)){
+                    it = assigns.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+    }
+}
+
+void mtac::MathPropagation::invalidate(std::shared_ptr<Variable> variable){
+    //The expressions using the old value of the variable cannot be propagated anymore
+    auto it = assigns.begin();
+    while(it != assigns.end()){
+        if(it->first == variable || uses(it->second->arg1, variable) || uses(it->second->arg2, variable)){
+            it = assigns.erase(it);
+        } else {
+            ++it;
+        }
     }
 }
 
@@ -69,3 +130,16 @@ void mtac::MathPropagation::operator()(std::shared_ptr<mtac::If> if_){
         collect(if_->arg2);
     }
 }
+
+void mtac::MathPropagation::operator()(std::shared_ptr<mtac::Param> param){
+    if(pass == mtac::Pass::DATA_MINING){
+        collect(&param->arg);
+    }
+}
+
+void mtac::MathPropagation::operator()(std::shared_ptr<mtac::Call>){
+    //The called function can modify the global variables
+    if(pass == mtac::Pass::OPTIMIZE){
+        assigns.clear();
+    }
+}
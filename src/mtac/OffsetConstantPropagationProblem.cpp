@@ -211,6 +211,8 @@ bool mtac::OffsetConstantPropagationProblem::optimize(mtac::Statement& statement
                                     quadruple->op = mtac::Operator::PASSIGN;
                                 }
                             }
+                        } else if(quadruple->result->type() == FLOAT){
+                            quadruple->op = mtac::Operator::FASSIGN;
                         }
 
                         changes = true;
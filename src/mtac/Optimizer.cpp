@@ -6,7 +6,8 @@
 //=======================================================================
 
 #include <memory>
-#include <thread>
+#include <atomic>
+#include <algorithm>
 #include <type_traits>
 
 #include "boost_cfg.hpp"
@@ -16,9 +17,11 @@
 #include "VisitorUtils.hpp"
 #include "Options.hpp"
 #include "PerfsTimer.hpp"
+#include "PassTimer.hpp"
 #include "iterators.hpp"
 #include "likely.hpp"
 #include "logging.hpp"
+#include "parallel.hpp"
 
 #include "ltac/Statement.hpp"
 
@@ -36,11 +39,11 @@
 #include "mtac/FunctionOptimizations.hpp"
 #include "mtac/DeadCodeElimination.hpp"
 #include "mtac/BasicBlockOptimizations.hpp"
-#include "mtac/BranchOptimizations.hpp"
 #include "mtac/ConcatReduction.hpp"
 #include "mtac/inlining.hpp"
-#include "mtac/loop_analysis.hpp"
 #include "mtac/loop_optimizations.hpp"
+#include "mtac/sccp.hpp"
+#include "mtac/gvn.hpp"
 
 //The optimization visitors
 #include "mtac/ArithmeticIdentities.hpp"
@@ -51,9 +54,7 @@
 
 //The data-flow problems
 #include "mtac/GlobalOptimizations.hpp"
-#include "mtac/ConstantPropagationProblem.hpp"
 #include "mtac/OffsetConstantPropagationProblem.hpp"
-#include "mtac/CommonSubexpressionElimination.hpp"
 
 using namespace eddic;
 
@@ -72,6 +73,7 @@ struct pass_traits<all_basic_optimizations> {
     STATIC_STRING(name, "all_basic_optimizations");
     STATIC_CONSTANT(unsigned int, property_flags, 0);
     STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_ALL);
 
     typedef basic_passes sub_passes;
 };
@@ -80,18 +82,16 @@ typedef boost::mpl::vector<
         mtac::ArithmeticIdentities*, 
         mtac::ReduceInStrength*, 
         mtac::ConstantFolding*, 
-        mtac::ConstantPropagationProblem*,
         mtac::OffsetConstantPropagationProblem*,
-        mtac::CommonSubexpressionElimination*,
+        mtac::global_value_numbering*,
         mtac::PointerPropagation*,
         mtac::MathPropagation*,
-        mtac::optimize_branches*,
         mtac::optimize_concat*,
         mtac::remove_dead_basic_blocks*,
         mtac::merge_basic_blocks*,
         mtac::dead_code_elimination*,
         mtac::remove_aliases*,
-        mtac::loop_analysis*,
+        mtac::bounds_check_elimination*,
         mtac::loop_invariant_code_motion*,
         mtac::loop_induction_variables_optimization*,
         mtac::remove_empty_loops*,
@@ -107,10 +107,62 @@ struct pass_traits<all_optimizations> {
     STATIC_STRING(name, "all_optimizations");
     STATIC_CONSTANT(unsigned int, property_flags, 0);
     STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_ALL);
 
     typedef passes sub_passes;
 };
 
+typedef boost::mpl::vector<
+        mtac::sparse_conditional_constant_propagation*
+    > ssa_passes;
+
+struct all_ssa_optimizations {};
+
+template<>
+struct pass_traits<all_ssa_optimizations> {
+    STATIC_CONSTANT(pass_type, type, pass_type::IPA_SUB);
+    STATIC_STRING(name, "all_ssa_optimizations");
+    STATIC_CONSTANT(unsigned int, property_flags, 0);
+    STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_ALL);
+
+    typedef ssa_passes sub_passes;
+};
+
+typedef boost::mpl::vector<
+        mtac::loop_vectorization*
+    > vectorization_passes;
+
+struct all_vectorizations {};
+
+template<>
+struct pass_traits<all_vectorizations> {
+    STATIC_CONSTANT(pass_type, type, pass_type::IPA_SUB);
+    STATIC_STRING(name, "all_vectorizations");
+    STATIC_CONSTANT(unsigned int, property_flags, 0);
+    STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_ALL);
+
+    typedef vectorization_passes sub_passes;
+};
+
+typedef boost::mpl::vector<
+        mtac::loop_unrolling*
+    > unrolling_passes;
+
+struct all_unrollings {};
+
+template<>
+struct pass_traits<all_unrollings> {
+    STATIC_CONSTANT(pass_type, type, pass_type::IPA_SUB);
+    STATIC_STRING(name, "all_unrollings");
+    STATIC_CONSTANT(unsigned int, property_flags, 0);
+    STATIC_CONSTANT(unsigned int, todo_after_flags, 0);
+    STATIC_CONSTANT(unsigned int, preserved_flags, ANALYSIS_ALL);
+
+    typedef unrolling_passes sub_passes;
+};
+
 }
 }
 
@@ -122,6 +174,18 @@ typedef boost::mpl::vector<
         mtac::all_basic_optimizations*
     > ipa_basic_passes;
 
+typedef boost::mpl::vector<
+        mtac::all_ssa_optimizations*
+    > ipa_ssa_passes;
+
+typedef boost::mpl::vector<
+        mtac::all_vectorizations*
+    > ipa_vectorization_passes;
+
+typedef boost::mpl::vector<
+        mtac::all_unrollings*
+    > ipa_unrolling_passes;
+
 typedef boost::mpl::vector<
         mtac::remove_unused_functions*,
         mtac::all_optimizations*,
@@ -198,6 +262,21 @@ struct pass_runner {
         remove_nop<Pass>();
     }
 
+    template<typename Pass>
+    inline typename std::enable_if<boost::type_traits::ice_or<mtac::pass_traits<Pass>::type == mtac::pass_type::IPA, mtac::pass_traits<Pass>::type == mtac::pass_type::IPA_SUB>::value, void>::type 
+    invalidate_analyses(){
+        //The interprocedural passes can change any function
+        for(auto& function : program->functions){
+            function->invalidate_analyses(mtac::pass_traits<Pass>::preserved_flags);
+        }
+    }
+
+    template<typename Pass>
+    inline typename std::enable_if<boost::type_traits::ice_and<mtac::pass_traits<Pass>::type != mtac::pass_type::IPA, mtac::pass_traits<Pass>::type != mtac::pass_type::IPA_SUB>::value, void>::type 
+    invalidate_analyses(){
+        function->invalidate_analyses(mtac::pass_traits<Pass>::preserved_flags);
+    }
+
     template<typename Pass>
     inline typename std::enable_if<need_pool<Pass>::value, void>::type set_pool(Pass& pass){
         pass.set_pool(pool);
@@ -246,21 +325,52 @@ struct pass_runner {
         return pass(program);
     }
     
+    template<typename Pass>
+    void optimize_function(mtac::function_p function){
+        this->function = function;
+
+        if(log::enabled<Debug>()){
+            log::emit<Debug>("Optimizer") << "Start optimizations on " << function->getName() << log::endl;
+
+            print(function);
+        }
+
+        boost::mpl::for_each<typename mtac::pass_traits<Pass>::sub_passes>(boost::ref(*this));
+    }
+    
     template<typename Pass>
     inline typename std::enable_if<mtac::pass_traits<Pass>::type == mtac::pass_type::IPA_SUB, bool>::type apply(){
         auto& functions = program->functions;
-        for(auto& function : functions){
-            this->function = function;
-    
-            if(log::enabled<Debug>()){
-                log::emit<Debug>("Optimizer") << "Start optimizations on " << function->getName() << log::endl;
 
-                print(function);
+        //The debug output of several functions cannot be interleaved
+        if(configuration->option_defined("single-threaded") || log::enabled<Debug>()){
+            for(auto& function : functions){
+                optimize_function<Pass>(function);
             }
 
-            boost::mpl::for_each<typename mtac::pass_traits<Pass>::sub_passes>(boost::ref(*this));
+            return false;
         }
 
+        //Start with the biggest functions to balance the work between the threads
+        std::vector<mtac::function_p> sorted_functions(functions);
+        std::stable_sort(sorted_functions.begin(), sorted_functions.end(), 
+                [](const mtac::function_p& lhs, const mtac::function_p& rhs){ return lhs->size() > rhs->size(); });
+
+        std::atomic<bool> any_optimized(false);
+
+        //The IPA passes are barriers, every function is optimized before the next IPA pass starts
+        parallel_for_each(sorted_functions, worker_threads(), [&](mtac::function_p& function){
+            pass_runner runner(program, pool, configuration, platform);
+
+            runner.optimize_function<Pass>(function);
+
+            if(runner.optimized){
+                any_optimized = true;
+            }
+        });
+
+        optimized |= any_optimized.load();
+
         return false;
     }
     
@@ -357,17 +467,45 @@ struct pass_runner {
         }
     }
 
+    template<typename Pass>
+    inline typename std::enable_if<boost::type_traits::ice_or<mtac::pass_traits<Pass>::type == mtac::pass_type::IPA, mtac::pass_traits<Pass>::type == mtac::pass_type::IPA_SUB>::value, std::size_t>::type 
+    statements(){
+        std::size_t statements = 0;
+
+        for(auto& function : program->functions){
+            statements += function->size();
+        }
+
+        return statements;
+    }
+
+    template<typename Pass>
+    inline typename std::enable_if<boost::type_traits::ice_and<mtac::pass_traits<Pass>::type != mtac::pass_type::IPA, mtac::pass_traits<Pass>::type != mtac::pass_type::IPA_SUB>::value, std::size_t>::type 
+    statements(){
+        return function->size();
+    }
+
     template<typename Pass>
     inline void operator()(Pass*){
         bool local = false;
         {
             PerfsTimer timer(mtac::pass_traits<Pass>::name());
 
+            //The statements are only counted for the report of --time-passes
+            bool timed = time_passes_enabled();
+            PassTimer pass_timer("mtac", mtac::pass_traits<Pass>::name(), timed ? statements<Pass>() : 0);
+
             local = apply<Pass>();
+
+            if(timed){
+                pass_timer.changed(local);
+                pass_timer.statements(statements<Pass>());
+            }
         }
 
         if(local){
             apply_todo<Pass>();
+            invalidate_analyses<Pass>();
         }
 
         debug_local<Pass>(local);
@@ -390,9 +528,26 @@ void mtac::Optimizer::optimize(mtac::program_p program, std::shared_ptr<StringPo
         //Apply Interprocedural Optimizations
         pass_runner runner(program, string_pool, configuration, platform);
         do{
+            do{
+                runner.optimized = false;
+                boost::mpl::for_each<ipa_passes>(boost::ref(runner));
+            } while(runner.optimized);
+
+            //The SSA form is only built once the optimizer engine converged, the engine is run again 
+            //as long as the sparse optimizations find new constants
             runner.optimized = false;
-            boost::mpl::for_each<ipa_passes>(boost::ref(runner));
+            boost::mpl::for_each<ipa_ssa_passes>(boost::ref(runner));
         } while(runner.optimized);
+
+        //The other passes do not know the vector operators, so the loops are vectorized last
+        if(configuration->option_defined("fvectorize-loops")){
+            boost::mpl::for_each<ipa_vectorization_passes>(boost::ref(runner));
+        }
+
+        //The unrolled loops are not recognized anymore by the loop optimizations, so they are unrolled at the very end
+        if(configuration->option_defined("funroll-loops")){
+            boost::mpl::for_each<ipa_unrolling_passes>(boost::ref(runner));
+        }
     } else {
         //Even if global optimizations are disabled, perform basic optimization (only constant folding)
         pass_runner runner(program, string_pool, configuration, platform);
@@ -0,0 +1,14 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#include "mtac/Phi.hpp"
+
+using namespace eddic;
+
+mtac::Phi::Phi(std::shared_ptr<Variable> variable, std::size_t predecessors) : variable(variable), result(variable), args(predecessors, variable) {
+    //Nothing to init
+}
@@ -18,6 +18,7 @@
 #include "mtac/Printer.hpp"
 #include "mtac/Program.hpp"
 #include "mtac/Statement.hpp"
+#include "mtac/Phi.hpp"
 
 using namespace eddic;
 
@@ -125,6 +126,20 @@ struct DebugVisitor : public boost::static_visitor<> {
 
     void operator()(mtac::basic_block_p block){
         pretty_print(block, stream);
+
+        for(auto& phi : block->phis){
+            stream << "\t" << printVar(phi->result) << " = phi(";
+
+            for(std::size_t i = 0; i < phi->args.size(); ++i){
+                if(i > 0){
+                    stream << ", ";
+                }
+
+                stream << printArg(phi->args[i]);
+            }
+
+            stream << ")" << endl;
+        }
         
         visit_each(*this, block->statements);     
     }
@@ -194,6 +209,26 @@ struct DebugVisitor : public boost::static_visitor<> {
             stream << "\t(" << printVar(quadruple->result) << ")" << printArg(*quadruple->arg1) << " = (float) " << printArg(*quadruple->arg2) << " : "<< quadruple->depth << endl;
         } else if(op == mtac::Operator::DOT_PASSIGN){
             stream << "\t(" << printVar(quadruple->result) << ")" << printArg(*quadruple->arg1) << " = (pointer) " << printArg(*quadruple->arg2) << " : "<< quadruple->depth << endl;
+        } else if(op == mtac::Operator::VDOT){
+            stream << "\t" << printVar(quadruple->result) << " = (vector) (" << printArg(*quadruple->arg1) << ")" << printArg(*quadruple->arg2) << " : "<< quadruple->depth << endl;
+        } else if(op == mtac::Operator::DOT_VASSIGN){
+            stream << "\t(" << printVar(quadruple->result) << ")" << printArg(*quadruple->arg1) << " = (vector) " << printArg(*quadruple->arg2) << " : "<< quadruple->depth << endl;
+        } else if(op == mtac::Operator::VSPLAT){
+            stream << "\t" << printVar(quadruple->result) << " = (splat) " << printArg(*quadruple->arg1) << " : "<< quadruple->depth << endl;
+        } else if(op == mtac::Operator::VADD){
+            stream << "\t" << printVar(quadruple->result) << " = " << printArg(*quadruple->arg1) << " + (vector) " << printArg(*quadruple->arg2) << " : "<< quadruple->depth << endl;
+        } else if(op == mtac::Operator::VSUB){
+            stream << "\t" << printVar(quadruple->result) << " = " << printArg(*quadruple->arg1) << " - (vector) " << printArg(*quadruple->arg2) << " : "<< quadruple->depth << endl;
+        } else if(op == mtac::Operator::VFADD){
+            stream << "\t" << printVar(quadruple->result) << " = " << printArg(*quadruple->arg1) << " + (float vector) " << printArg(*quadruple->arg2) << " : "<< quadruple->depth << endl;
+        } else if(op == mtac::Operator::VFSUB){
+            stream << "\t" << printVar(quadruple->result) << " = " << printArg(*quadruple->arg1) << " - (float vector) " << printArg(*quadruple->arg2) << " : "<< quadruple->depth << endl;
+        } else if(op == mtac::Operator::VFMUL){
+            stream << "\t" << printVar(quadruple->result) << " = " << printArg(*quadruple->arg1) << " * (float vector) " << printArg(*quadruple->arg2) << " : "<< quadruple->depth << endl;
+        } else if(op == mtac::Operator::VSUM){
+            stream << "\t" << printVar(quadruple->result) << " = (sum) " << printArg(*quadruple->arg1) << " : "<< quadruple->depth << endl;
+        } else if(op == mtac::Operator::VFSUM){
+            stream << "\t" << printVar(quadruple->result) << " = (float sum) " << printArg(*quadruple->arg1) << " : "<< quadruple->depth << endl;
         } else if(op == mtac::Operator::RETURN){
             stream << "\treturn";
 
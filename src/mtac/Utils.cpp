@@ -6,6 +6,7 @@
 //=======================================================================
 
 #include "Type.hpp"
+#include "arena.hpp"
 #include "VisitorUtils.hpp"
 #include "GlobalContext.hpp"
 #include "mangling.hpp"
@@ -163,6 +164,7 @@ bool eddic::mtac::erase_result(mtac::Operator op){
            op != mtac::Operator::DOT_ASSIGN 
         && op != mtac::Operator::DOT_FASSIGN 
         && op != mtac::Operator::DOT_PASSIGN 
+        && op != mtac::Operator::DOT_VASSIGN 
         && op != mtac::Operator::RETURN; 
 }
 
@@ -223,48 +225,53 @@ struct StatementClone : public boost::static_visitor<mtac::Statement> {
     StatementClone(std::shared_ptr<GlobalContext> global_context) : global_context(global_context) {}
 
     mtac::Statement operator()(std::shared_ptr<mtac::Quadruple> quadruple){
-        auto copy = std::make_shared<mtac::Quadruple>();
+        auto copy = make_node<mtac::Quadruple>();
 
         copy->result = quadruple->result;
         copy->arg1 = quadruple->arg1;
         copy->arg2 = quadruple->arg2;
         copy->op = quadruple->op;
+        copy->size = quadruple->size;
+        copy->depth = quadruple->depth;
         
         return copy;
     }
     
     mtac::Statement operator()(std::shared_ptr<mtac::Param> param){
-        auto copy = std::make_shared<mtac::Param>();
+        auto copy = make_node<mtac::Param>();
 
         copy->arg = param->arg;
         copy->param = param->param;
         copy->std_param = param->std_param;
         copy->function = param->function;
         copy->address = param->address;
+        copy->depth = param->depth;
 
         return copy;
     }
 
     mtac::Statement operator()(std::shared_ptr<mtac::IfFalse> if_){
-        auto copy = std::make_shared<mtac::IfFalse>();
+        auto copy = make_node<mtac::IfFalse>();
 
         copy->op = if_->op;
         copy->arg1 = if_->arg1;
         copy->arg2 = if_->arg2;
         copy->label = if_->label;
         copy->block = if_->block;
+        copy->depth = if_->depth;
 
         return copy;
     }
 
     mtac::Statement operator()(std::shared_ptr<mtac::If> if_){
-        auto copy = std::make_shared<mtac::If>();
+        auto copy = make_node<mtac::If>();
 
         copy->op = if_->op;
         copy->arg1 = if_->arg1;
         copy->arg2 = if_->arg2;
         copy->label = if_->label;
         copy->block = if_->block;
+        copy->depth = if_->depth;
 
         return copy;
     }
@@ -272,17 +279,20 @@ struct StatementClone : public boost::static_visitor<mtac::Statement> {
     mtac::Statement operator()(std::shared_ptr<mtac::Call> call){
         global_context->addReference(call->function);
 
-        return std::make_shared<mtac::Call>(call->function, call->functionDefinition, call->return_, call->return2_);
+        auto copy = make_node<mtac::Call>(call->function, call->functionDefinition, call->return_, call->return2_);
+        copy->depth = call->depth;
+        return copy;
     }
 
     mtac::Statement operator()(std::shared_ptr<mtac::Goto> goto_){
-        auto copy = std::make_shared<mtac::Goto>(goto_->label);
+        auto copy = make_node<mtac::Goto>(goto_->label);
         copy->block = goto_->block;
+        copy->depth = goto_->depth;
         return copy;
     }
 
     mtac::Statement operator()(std::shared_ptr<mtac::NoOp>){
-        return std::make_shared<mtac::NoOp>();
+        return make_node<mtac::NoOp>();
     }
 
     mtac::Statement operator()(const std::string& str){
@@ -70,6 +70,122 @@ bool is_not_direct_alias(std::shared_ptr<Variable> source, std::shared_ptr<Varia
     return true;
 }
 
+struct VariableUse : public boost::static_visitor<bool> {
+    std::shared_ptr<Variable> variable;
+
+    VariableUse(std::shared_ptr<Variable> variable) : variable(variable) {}
+
+    template<typename T>
+    bool use(T& arg){
+        auto* ptr = boost::get<std::shared_ptr<Variable>>(&arg);
+        return ptr && *ptr == variable;
+    }
+
+    template<typename T>
+    bool use_optional(T& opt){
+        return opt && use(*opt);
+    }
+
+    bool operator()(std::shared_ptr<mtac::Quadruple> quadruple){
+        return quadruple->result == variable || use_optional(quadruple->arg1) || use_optional(quadruple->arg2);
+    }
+
+    bool operator()(std::shared_ptr<mtac::Param> param){
+        return use(param->arg);
+    }
+
+    bool operator()(std::shared_ptr<mtac::If> if_){
+        return use(if_->arg1) || use_optional(if_->arg2);
+    }
+
+    bool operator()(std::shared_ptr<mtac::IfFalse> if_false){
+        return use(if_false->arg1) || use_optional(if_false->arg2);
+    }
+
+    bool operator()(std::shared_ptr<mtac::Call> call){
+        return call->return_ == variable || call->return2_ == variable;
+    }
+
+    template<typename T>
+    bool operator()(T& /*t*/){
+        return false;
+    }
+};
+
+bool is_copy(mtac::Statement& statement, std::shared_ptr<Variable> source, std::shared_ptr<Variable> target){
+    if(auto* ptr = boost::get<std::shared_ptr<mtac::Quadruple>>(&statement)){
+        auto quadruple = *ptr;
+
+        if((quadruple->op == mtac::Operator::ASSIGN || quadruple->op == mtac::Operator::PASSIGN) && quadruple->result == target){
+            auto* var_ptr = boost::get<std::shared_ptr<Variable>>(&*quadruple->arg1);
+            return var_ptr && *var_ptr == source;
+        }
+    }
+
+    return false;
+}
+
+bool is_definition(mtac::Statement& statement, std::shared_ptr<Variable> variable){
+    if(auto* ptr = boost::get<std::shared_ptr<mtac::Quadruple>>(&statement)){
+        return mtac::erase_result((*ptr)->op) && (*ptr)->result == variable;
+    } else if(auto* ptr = boost::get<std::shared_ptr<mtac::Call>>(&statement)){
+        return (*ptr)->return_ == variable || (*ptr)->return2_ == variable;
+    }
+
+    return false;
+}
+
+//The target can replace the variable only if the variable is only used in the basic block of its copy, 
+//if the target is not used between the definition and the copy and not modified before the last use
+bool is_local_alias(std::shared_ptr<Variable> variable, std::shared_ptr<Variable> target, mtac::function_p function){
+    VariableUse variable_use(variable);
+    VariableUse target_use(target);
+
+    //A global target can be modified by any call
+    bool global = target->position().isGlobal();
+
+    bool defined = false;
+    bool copied = false;
+    bool redefined = false;
+
+    for(auto& block : function){
+        for(auto& statement : block->statements){
+            if(copied){
+                //After the copy, the variable can still be used until the target is modified
+                if(visit(variable_use, statement) && redefined){
+                    return false;
+                }
+
+                redefined |= is_definition(statement, target) || (global && boost::get<std::shared_ptr<mtac::Call>>(&statement));
+            } else if(defined){
+                if(is_copy(statement, variable, target)){
+                    copied = true;
+                } else if(visit(target_use, statement)){
+                    return false;
+                } else if(global && boost::get<std::shared_ptr<mtac::Call>>(&statement)){
+                    return false;
+                }
+            } else if(visit(variable_use, statement)){
+                //The variable must be defined before being used
+                if(!is_definition(statement, variable)){
+                    return false;
+                }
+
+                defined = true;
+            }
+        }
+
+        if(defined && !copied){
+            return false;
+        }
+
+        //The variable cannot be used in the other blocks
+        redefined = copied;
+    }
+
+    return copied;
+}
+
 std::vector<std::shared_ptr<Variable>> get_targets(std::shared_ptr<Variable> variable, mtac::function_p function){
     std::vector<std::shared_ptr<Variable>> targets;
     
@@ -260,8 +376,8 @@ bool mtac::remove_aliases::operator()(mtac::function_p function){
                 auto targets = get_targets(var, function);
 
                 if(targets.size() == 1){
-                    if(pointer_escaped->find(var) == pointer_escaped->end()){
-                        if(is_not_direct_alias(var, targets[0], function) && targets[0]->type() != STRING){
+                    if(pointer_escaped->find(var) == pointer_escaped->end() && pointer_escaped->find(targets[0]) == pointer_escaped->end()){
+                        if(is_not_direct_alias(var, targets[0], function) && targets[0]->type() != STRING && is_local_alias(var, targets[0], function)){
                             VariableReplace replacer(var, targets[0]);
                             replacer.reverse = true;
 
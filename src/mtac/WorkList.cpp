@@ -0,0 +1,60 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#include "logging.hpp"
+
+#include "mtac/WorkList.hpp"
+#include "mtac/Function.hpp"
+
+using namespace eddic;
+
+mtac::WorkList::WorkList(const std::vector<mtac::basic_block_p>& order) : pending(order.size(), true), pending_blocks(order.size()) {
+    for(std::size_t i = 0; i < order.size(); ++i){
+        positions[order[i]] = i;
+    }
+}
+
+bool mtac::WorkList::next_sweep(){
+    if(pending_blocks == 0){
+        return false;
+    }
+
+    ++sweeps;
+
+    return true;
+}
+
+bool mtac::WorkList::take(std::size_t position){
+    if(pending[position]){
+        pending[position] = false;
+        --pending_blocks;
+
+        return true;
+    }
+
+    return false;
+}
+
+void mtac::WorkList::add(const mtac::basic_block_p& block){
+    auto position = positions[block];
+
+    if(!pending[position]){
+        pending[position] = true;
+        ++pending_blocks;
+    }
+}
+
+void mtac::WorkList::visit(){
+    ++visits;
+}
+
+void mtac::WorkList::report(mtac::function_p function, const std::string& direction){
+    if(log::enabled<Trace>()){
+        log::emit<Trace>("Data-Flow") << direction << " data-flow on " << function->getName() << " converged after " << sweeps << " sweeps and " 
+            << visits << " visits of " << positions.size() << " blocks in " << timer.micro_elapsed() << "us" << log::endl;
+    }
+}
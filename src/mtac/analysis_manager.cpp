@@ -0,0 +1,42 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#include "mtac/analysis_manager.hpp"
+#include "mtac/LiveVariableAnalysisProblem.hpp"
+
+using namespace eddic;
+
+void mtac::analysis_manager::cfg_changed(){
+    post_order.clear();
+    dominators_valid = false;
+    loops_valid = false;
+
+    //The liveness is solved on the CFG
+    live_variables = nullptr;
+    live_problem = nullptr;
+}
+
+void mtac::analysis_manager::invalidate(unsigned int preserved){
+    //The loops are computed from the dominators
+    if(!(preserved & mtac::ANALYSIS_DOMINATORS)){
+        dominators_valid = false;
+        loops_valid = false;
+    }
+
+    if(!(preserved & mtac::ANALYSIS_LOOPS)){
+        loops_valid = false;
+    }
+
+    if(!(preserved & mtac::ANALYSIS_ESCAPED_VARIABLES)){
+        escaped = nullptr;
+    }
+
+    if(!(preserved & mtac::ANALYSIS_LIVE_VARIABLES)){
+        live_variables = nullptr;
+        live_problem = nullptr;
+    }
+}
@@ -0,0 +1,74 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#include <algorithm>
+#include <utility>
+
+#include "mtac/block_order.hpp"
+#include "mtac/Function.hpp"
+
+using namespace eddic;
+
+std::vector<mtac::basic_block_p> mtac::post_order(mtac::function_p function){
+    //The order is kept until the CFG changes
+    if(!function->analyses.post_order.empty()){
+        return function->analyses.post_order;
+    }
+
+    auto& blocks = function->numbered_blocks();
+
+    std::vector<mtac::basic_block_p> order;
+    order.reserve(blocks.size());
+
+    std::vector<bool> visited(blocks.size(), false);
+
+    //Iterative DFS, the functions can have a lot of blocks
+    std::vector<std::pair<mtac::basic_block_p, std::size_t>> stack;
+
+    auto entry = function->entry_bb();
+    visited[entry->id] = true;
+    stack.emplace_back(entry, 0);
+
+    while(!stack.empty()){
+        auto& top = stack.back();
+        auto block = top.first;
+
+        if(top.second < block->successors.size()){
+            auto& successor = block->successors[top.second++];
+
+            if(!visited[successor->id]){
+                visited[successor->id] = true;
+                stack.emplace_back(successor, 0);
+            }
+        } else {
+            order.push_back(block);
+            stack.pop_back();
+        }
+    }
+
+    //The unreachable blocks come first, they are never reached by the DFS
+    std::vector<mtac::basic_block_p> unreachable;
+
+    for(auto& block : blocks){
+        if(!visited[block->id]){
+            unreachable.push_back(block);
+        }
+    }
+
+    std::reverse(unreachable.begin(), unreachable.end());
+    order.insert(order.begin(), unreachable.begin(), unreachable.end());
+
+    function->analyses.post_order = order;
+
+    return order;
+}
+
+std::vector<mtac::basic_block_p> mtac::reverse_post_order(mtac::function_p function){
+    auto order = post_order(function);
+    std::reverse(order.begin(), order.end());
+    return order;
+}
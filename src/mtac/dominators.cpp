@@ -6,7 +6,6 @@
 //=======================================================================
 
 #include <vector>
-#include <unordered_map>
 
 #include "PerfsTimer.hpp"
 
@@ -33,9 +32,6 @@ struct dominators {
     std::vector<std::vector<unsigned int>> pred;
     std::vector<std::vector<unsigned int>> bucket;
 
-    std::unordered_map<mtac::basic_block_p, unsigned int> numbers;
-    std::unordered_map<unsigned int, mtac::basic_block_p> blocks;
-
     dominators(std::size_t cn, mtac::function_p function) : cn(cn), function(function), 
             parent(cn+1), semi(cn+1), vertex(cn+1), dom(cn+1), size(cn+1), child(cn+1), label(cn+1), ancestor(cn+1),
             succ(cn+1), pred(cn+1), bucket(cn+1) {
@@ -118,29 +114,23 @@ struct dominators {
     void compute_dominators(){
         PerfsTimer timer("Dominators");
 
-        /* Step 0. Translate basic blocks to numbers */
+        /* Step 0. Translate basic blocks to numbers, the number of a block is its id plus one */
 
-        unsigned int number = 0;
-        for(auto& block : function){
-            numbers[block] = ++number;
-            blocks[number] = block;
-        }
-        
-        number = 0;
-        for(auto& block : function){
-            ++number;
+        auto& blocks = function->numbered_blocks();
+
+        for(auto& block : blocks){
             for(auto& s : block->successors){
-                succ[number].push_back(numbers[s]);
+                succ[block->id + 1].push_back(s->id + 1);
             }
         }
 
         /* Step 1. */
 
-        for(unsigned int v = 1; v <= n; ++v){
+        for(unsigned int v = 1; v <= cn; ++v){
             semi[v] = 0;
         }
     
-        unsigned int n = 0;
+        n = 0;
 
         dfs(1);
 
@@ -190,23 +180,27 @@ struct dominators {
 
         /* Step 5 */
 
-        number = 0;
-        for(auto& block : function){
-            ++number;
-
-            if(number == 1){
-                block->dominator = nullptr;
-            }
+        for(auto& block : blocks){
+            auto number = dom[block->id + 1];
 
-            //TODO Not sure if not necessary to use another array
-            block->dominator = blocks[dom[number]]; 
+            block->dominator = number == 0 ? nullptr : blocks[number - 1];
         }
     }
 };
 
 void mtac::compute_dominators(std::shared_ptr<Function> function){
+    //The dominators are kept until the CFG changes
+    if(function->analyses.dominators_valid){
+        return;
+    }
+
     auto n = function->bb_count();
 
     dominators dom(n, function);
     dom.compute_dominators();
+
+    function->analyses.dominators_valid = true;
+
+    //The loops depend on the dominators
+    function->analyses.loops_valid = false;
 }
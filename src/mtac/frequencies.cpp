@@ -0,0 +1,217 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "logging.hpp"
+
+#include "mtac/frequencies.hpp"
+#include "mtac/Function.hpp"
+#include "mtac/block_order.hpp"
+
+using namespace eddic;
+
+namespace {
+
+//Ball and Larus loop branch heuristic
+static const double loop_probability = 0.88;
+
+//The estimation is stopped when the frequencies are stable enough
+static const double epsilon = 1e-6;
+static const unsigned int max_sweeps = 256;
+
+//The execution counts of the blocks of each function
+typedef std::unordered_map<std::string, std::unordered_map<int, double>> Profile;
+
+std::mutex profile_lock;
+std::unordered_map<std::string, Profile> profiles;
+
+//The profile is read once and shared by all the passes and all the threads
+const Profile& get_profile(const std::string& file){
+    std::lock_guard<std::mutex> lock(profile_lock);
+
+    auto it = profiles.find(file);
+    if(it != profiles.end()){
+        return it->second;
+    }
+
+    auto& profile = profiles[file];
+
+    std::ifstream stream(file);
+
+    if(!stream){
+        log::emit<Info>("Frequencies") << "The profile " << file << " cannot be read" << log::endl;
+    }
+
+    std::string function;
+    int index;
+    double count;
+
+    while(stream >> function >> index >> count){
+        profile[function][index] += count;
+    }
+
+    return profile;
+}
+
+bool load_profile(mtac::function_p function, std::shared_ptr<Configuration> configuration){
+    if(!configuration || !configuration->option_defined("fprofile-use")){
+        return false;
+    }
+
+    auto& profile = get_profile(configuration->option_value("fprofile-use"));
+
+    auto it = profile.find(function->getName());
+    if(it == profile.end()){
+        return false;
+    }
+
+    auto& counts = it->second;
+
+    auto entry = counts.find(function->entry_bb()->index);
+    if(entry == counts.end() || entry->second <= 0.0){
+        return false;
+    }
+
+    for(auto& block : function){
+        auto count = counts.find(block->index);
+        block->frequency = count == counts.end() ? 0.0 : count->second / entry->second;
+    }
+
+    return true;
+}
+
+typedef std::unordered_map<mtac::basic_block_p, std::size_t> Numbers;
+
+//With a reverse post-order, an edge going backward is a back edge
+bool is_back_edge(Numbers& numbers, const mtac::basic_block_p& from, const mtac::basic_block_p& to){
+    return numbers[to] <= numbers[from];
+}
+
+/*!
+ * Compute the number of natural loops containing each basic block. The depth of the blocks 
+ * computed by the loop analysis is not used because the CFG can have changed since. 
+ */
+Numbers loop_depths(const std::vector<mtac::basic_block_p>& order, Numbers& numbers){
+    Numbers depths;
+
+    for(auto& block : order){
+        for(auto& successor : block->successors){
+            if(!is_back_edge(numbers, block, successor)){
+                continue;
+            }
+
+            //The natural loop contains the header and all the blocks reaching the latch without the header
+            std::unordered_set<mtac::basic_block_p> loop = {successor};
+            std::vector<mtac::basic_block_p> stack;
+
+            if(loop.insert(block).second){
+                stack.push_back(block);
+            }
+
+            while(!stack.empty()){
+                auto current = stack.back();
+                stack.pop_back();
+
+                for(auto& predecessor : current->predecessors){
+                    if(numbers.count(predecessor) && loop.insert(predecessor).second){
+                        stack.push_back(predecessor);
+                    }
+                }
+            }
+
+            for(auto& member : loop){
+                ++depths[member];
+            }
+        }
+    }
+
+    return depths;
+}
+
+double probability(Numbers& numbers, Numbers& depths, const mtac::basic_block_p& from, const mtac::basic_block_p& to){
+    auto& successors = from->successors;
+
+    if(successors.size() != 2){
+        return 1.0 / successors.size();
+    }
+
+    auto& other = successors[0] == to ? successors[1] : successors[0];
+
+    bool back = is_back_edge(numbers, from, to);
+    if(back != is_back_edge(numbers, from, other)){
+        return back ? loop_probability : 1.0 - loop_probability;
+    }
+
+    bool exit = depths[to] < depths[from];
+    if(exit != (depths[other] < depths[from])){
+        return exit ? 1.0 - loop_probability : loop_probability;
+    }
+
+    return 0.5;
+}
+
+void estimate_frequencies(mtac::function_p function){
+    //The unreachable blocks are never executed
+    for(auto& block : function){
+        block->frequency = 0.0;
+    }
+
+    auto order = mtac::reverse_post_order(function);
+
+    Numbers numbers;
+    for(std::size_t i = 0; i < order.size(); ++i){
+        numbers[order[i]] = i;
+    }
+
+    auto depths = loop_depths(order, numbers);
+
+    function->entry_bb()->frequency = 1.0;
+
+    //Gauss-Seidel sweeps in reverse post-order, only the back edges need more than one sweep
+    for(unsigned int sweep = 0; sweep < max_sweeps; ++sweep){
+        double change = 0.0;
+
+        for(auto& block : order){
+            if(block == function->entry_bb()){
+                continue;
+            }
+
+            double frequency = 0.0;
+
+            for(auto& predecessor : block->predecessors){
+                if(numbers.count(predecessor)){
+                    frequency += predecessor->frequency * probability(numbers, depths, predecessor, block);
+                }
+            }
+
+            change = std::max(change, std::fabs(frequency - block->frequency) / std::max(frequency, 1.0));
+            block->frequency = frequency;
+        }
+
+        if(change < epsilon){
+            break;
+        }
+    }
+}
+
+} //end of anonymous namespace
+
+void mtac::compute_frequencies(mtac::function_p function, std::shared_ptr<Configuration> configuration){
+    if(!load_profile(function, configuration)){
+        estimate_frequencies(function);
+    }
+
+    for(auto& block : function){
+        log::emit<Trace>("Frequencies") << "B" << block->index << " of " << function->getName() << " : " << block->frequency << log::endl;
+    }
+}
@@ -0,0 +1,445 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#include <unordered_set>
+#include <utility>
+
+#include <boost/functional/hash.hpp>
+
+#include "Variable.hpp"
+#include "arena.hpp"
+#include "Type.hpp"
+#include "FunctionContext.hpp"
+#include "logging.hpp"
+
+#include "mtac/gvn.hpp"
+#include "mtac/ssa.hpp"
+#include "mtac/Phi.hpp"
+#include "mtac/Function.hpp"
+#include "mtac/Statement.hpp"
+#include "mtac/Utils.hpp"
+#include "mtac/EscapeAnalysis.hpp"
+
+using namespace eddic;
+
+namespace {
+
+typedef unsigned int ValueNumber;   //0 means that the value has no number
+
+struct ExpressionKey {
+    mtac::Operator op;
+    mtac::Size size;        //The size of the operands, the same operation on different sizes gives different values
+    ValueNumber lhs;
+    ValueNumber rhs;
+    unsigned int memory;    //The state of the memory for the loads, 0 for the other expressions
+
+    bool operator==(const ExpressionKey& rhs) const {
+        return op == rhs.op && size == rhs.size && lhs == rhs.lhs && this->rhs == rhs.rhs && memory == rhs.memory;
+    }
+};
+
+struct ExpressionKeyHash {
+    std::size_t operator()(const ExpressionKey& key) const {
+        std::size_t seed = static_cast<std::size_t>(key.op);
+        boost::hash_combine(seed, static_cast<std::size_t>(key.size));
+        boost::hash_combine(seed, key.lhs);
+        boost::hash_combine(seed, key.rhs);
+        boost::hash_combine(seed, key.memory);
+        return seed;
+    }
+};
+
+struct Leader {
+    std::shared_ptr<mtac::Quadruple> quadruple;
+    mtac::basic_block_p block;
+    ValueNumber number;
+};
+
+/*!
+ * The state of the memory at a point of the function. A load can only be replaced by a dominating
+ * load done in the same state. The local aggregates whose address never escapes can only be modified
+ * directly, they have their own state.
+ */
+struct MemoryState {
+    unsigned int global;
+    unsigned int base;
+    std::unordered_map<std::shared_ptr<Variable>, unsigned int> variables;
+
+    unsigned int of(std::shared_ptr<Variable> variable){
+        auto it = variables.find(variable);
+        return it == variables.end() ? base : it->second;
+    }
+};
+
+bool is_commutative(mtac::Operator op){
+    return op == mtac::Operator::ADD || op == mtac::Operator::MUL
+        || op == mtac::Operator::FADD || op == mtac::Operator::FMUL
+        || op == mtac::Operator::EQUALS || op == mtac::Operator::NOT_EQUALS
+        || op == mtac::Operator::FE || op == mtac::Operator::FNE
+        || op == mtac::Operator::AND;
+}
+
+bool is_load(mtac::Operator op){
+    return op == mtac::Operator::DOT || op == mtac::Operator::FDOT;
+}
+
+bool is_store(mtac::Operator op){
+    return op == mtac::Operator::DOT_ASSIGN || op == mtac::Operator::DOT_FASSIGN || op == mtac::Operator::DOT_PASSIGN;
+}
+
+bool is_copy(mtac::Operator op){
+    return op == mtac::Operator::ASSIGN || op == mtac::Operator::FASSIGN;
+}
+
+struct ValueNumbering {
+    mtac::function_p function;
+    const mtac::SSAVersions& versions;
+    mtac::EscapedVariables escaped;
+
+    std::unordered_set<std::shared_ptr<Variable>> defined;     //The variables defined in the function, other than the SSA versions
+
+    ValueNumber next_number = 1;
+    unsigned int next_state = 1;
+
+    std::unordered_map<std::shared_ptr<Variable>, ValueNumber> variables;
+    std::unordered_map<std::shared_ptr<Variable>, ValueNumber> addresses;
+    std::unordered_map<int, ValueNumber> ints;
+    std::unordered_map<double, ValueNumber> floats;
+    std::unordered_map<std::string, ValueNumber> strings;
+
+    std::unordered_map<ExpressionKey, Leader, ExpressionKeyHash> table;
+    std::unordered_map<mtac::basic_block_p, MemoryState> memory_out;
+
+    std::vector<std::pair<std::shared_ptr<mtac::Quadruple>, Leader>> redundant;
+
+    ValueNumbering(mtac::function_p function, const mtac::SSAVersions& versions) : function(function), versions(versions), escaped(mtac::escape_analysis(function)) {}
+
+    template<typename Key>
+    ValueNumber lazy_number(std::unordered_map<Key, ValueNumber>& numbers, const Key& key){
+        auto it = numbers.find(key);
+        if(it != numbers.end()){
+            return it->second;
+        }
+
+        return numbers[key] = next_number++;
+    }
+
+    void collect_definitions(){
+        for(auto& block : function){
+            for(auto& statement : block->statements){
+                if(auto* ptr = boost::get<std::shared_ptr<mtac::Quadruple>>(&statement)){
+                    auto& quadruple = *ptr;
+
+                    if(quadruple->result && mtac::erase_result(quadruple->op) && !versions.count(quadruple->result)){
+                        defined.insert(quadruple->result);
+                    }
+                } else if(auto* ptr = boost::get<std::shared_ptr<mtac::Call>>(&statement)){
+                    if((*ptr)->return_){
+                        defined.insert((*ptr)->return_);
+                    }
+
+                    if((*ptr)->return2_){
+                        defined.insert((*ptr)->return2_);
+                    }
+                }
+            }
+        }
+    }
+
+    //The SSA versions and the variables that are never written hold a single value
+    bool is_stable(std::shared_ptr<Variable> variable){
+        return versions.count(variable)
+            || (!defined.count(variable) && !escaped->count(variable) && !variable->position().isGlobal());
+    }
+
+    //Only the direct stores can modify a local aggregate whose address never escapes
+    bool is_local_memory(std::shared_ptr<Variable> variable){
+        auto position = variable->position();
+
+        return (position.is_temporary() || position.is_variable() || position.isStack()) && !escaped->count(variable);
+    }
+
+    ValueNumber number(const mtac::Argument& arg){
+        if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&arg)){
+            if(versions.count(*ptr)){
+                auto it = variables.find(*ptr);
+                return it == variables.end() ? 0 : it->second;
+            } else if(is_stable(*ptr)){
+                return lazy_number(variables, *ptr);
+            }
+
+            return 0;
+        } else if(auto* ptr = boost::get<int>(&arg)){
+            return lazy_number(ints, *ptr);
+        } else if(auto* ptr = boost::get<double>(&arg)){
+            return lazy_number(floats, *ptr);
+        } else if(auto* ptr = boost::get<std::string>(&arg)){
+            return lazy_number(strings, *ptr);
+        }
+
+        return 0;
+    }
+
+    ValueNumber number(const boost::optional<mtac::Argument>& arg){
+        return arg ? number(*arg) : 0;
+    }
+
+    /*!
+     * Compute the key of the expression computed by the quadruple.
+     * \return false if the expression cannot be numbered.
+     */
+    bool key(std::shared_ptr<mtac::Quadruple> quadruple, MemoryState& state, ExpressionKey& key){
+        auto op = quadruple->op;
+
+        if(op < mtac::Operator::ADD || op > mtac::Operator::PDOT || !quadruple->arg1){
+            return false;
+        }
+
+        //The value must fit in a temporary to be reused
+        auto type = quadruple->result->type();
+        if(!mtac::is_single_int_register(type) && !mtac::is_single_float_register(type)){
+            return false;
+        }
+
+        key.op = op;
+        key.size = quadruple->size;
+        key.memory = 0;
+
+        auto& arg1 = *quadruple->arg1;
+        auto* variable_ptr = boost::get<std::shared_ptr<Variable>>(&arg1);
+
+        if(op == mtac::Operator::PDOT && !variable_ptr){
+            return false;
+        }
+
+        if(op == mtac::Operator::PDOT && !(*variable_ptr)->type()->is_pointer()){
+            //The address of a variable never changes
+            key.lhs = lazy_number(addresses, *variable_ptr);
+        } else if(is_load(op) || op == mtac::Operator::PDOT){
+            //PDOT on a pointer loads the address stored in the pointed memory
+            if(variable_ptr && !(*variable_ptr)->type()->is_pointer()){
+                key.lhs = lazy_number(addresses, *variable_ptr);
+                key.memory = is_local_memory(*variable_ptr) ? state.of(*variable_ptr) : state.global;
+            } else {
+                key.lhs = number(arg1);
+                key.memory = state.global;
+            }
+        } else {
+            key.lhs = number(arg1);
+        }
+
+        key.rhs = number(quadruple->arg2);
+
+        if(!key.lhs || (quadruple->arg2 && !key.rhs)){
+            return false;
+        }
+
+        if(is_commutative(op) && key.rhs < key.lhs){
+            std::swap(key.lhs, key.rhs);
+        }
+
+        return true;
+    }
+
+    void invalidate(std::shared_ptr<Variable> base, MemoryState& state){
+        if(!base->type()->is_pointer() && is_local_memory(base)){
+            state.variables[base] = next_state++;
+        } else {
+            state.global = next_state++;
+        }
+    }
+
+    void visit(std::shared_ptr<mtac::Quadruple> quadruple, mtac::basic_block_p block, MemoryState& state, std::vector<ExpressionKey>& added){
+        auto op = quadruple->op;
+
+        if(!quadruple->result || op == mtac::Operator::NOP){
+            return;
+        }
+
+        if(is_store(op)){
+            invalidate(quadruple->result, state);
+            return;
+        }
+
+        if(!mtac::erase_result(op)){
+            return;
+        }
+
+        //A write to a variable living in memory can be seen by the loads through pointers
+        if(!versions.count(quadruple->result) && (escaped->count(quadruple->result) || quadruple->result->position().isGlobal())){
+            state.global = next_state++;
+        }
+
+        ValueNumber result = 0;
+
+        if(is_copy(op) || (op == mtac::Operator::PASSIGN && !mtac::isVariable(*quadruple->arg1))){
+            result = number(*quadruple->arg1);
+        } else if(op == mtac::Operator::PASSIGN){
+            auto variable = boost::get<std::shared_ptr<Variable>>(*quadruple->arg1);
+
+            if(variable->type()->is_pointer()){
+                result = number(*quadruple->arg1);
+            } else {
+                result = lazy_number(addresses, variable);
+            }
+        } else {
+            ExpressionKey expression;
+            if(key(quadruple, state, expression)){
+                auto it = table.find(expression);
+
+                if(it != table.end()){
+                    redundant.emplace_back(quadruple, it->second);
+                    result = it->second.number;
+                } else {
+                    result = next_number++;
+                    table[expression] = {quadruple, block, result};
+                    added.push_back(expression);
+                }
+            }
+        }
+
+        if(versions.count(quadruple->result)){
+            variables[quadruple->result] = result ? result : next_number++;
+        }
+    }
+
+    void visit(mtac::basic_block_p block, std::vector<ExpressionKey>& added){
+        MemoryState state;
+
+        //The state of the memory is only known when the block can only be reached from its dominator
+        if(block->predecessors.size() == 1 && block->predecessors[0] == block->dominator){
+            state = memory_out[block->dominator];
+        } else {
+            state.global = state.base = next_state++;
+        }
+
+        for(auto& phi : block->phis){
+            variables[phi->result] = next_number++;
+        }
+
+        for(auto& statement : block->statements){
+            if(auto* ptr = boost::get<std::shared_ptr<mtac::Quadruple>>(&statement)){
+                visit(*ptr, block, state, added);
+            } else if(auto* ptr = boost::get<std::shared_ptr<mtac::Param>>(&statement)){
+                if((*ptr)->address){
+                    state.global = next_state++;
+                }
+            } else if(boost::get<std::shared_ptr<mtac::Call>>(&statement)){
+                state.global = next_state++;
+            }
+        }
+
+        memory_out[block] = std::move(state);
+    }
+
+    void number(){
+        collect_definitions();
+
+        std::unordered_map<mtac::basic_block_p, std::vector<mtac::basic_block_p>> children;
+
+        for(auto& block : function){
+            if(block->dominator){
+                children[block->dominator].push_back(block);
+            }
+        }
+
+        //The expressions of a block are only available in the blocks it dominates
+        std::vector<std::pair<mtac::basic_block_p, bool>> stack;
+        std::unordered_map<mtac::basic_block_p, std::vector<ExpressionKey>> added;
+
+        stack.emplace_back(function->entry_bb(), false);
+
+        while(!stack.empty()){
+            auto block = stack.back().first;
+            auto leaving = stack.back().second;
+            stack.pop_back();
+
+            if(leaving){
+                for(auto& expression : added[block]){
+                    table.erase(expression);
+                }
+
+                added.erase(block);
+            } else {
+                visit(block, added[block]);
+
+                stack.emplace_back(block, true);
+
+                for(auto& child : children[block]){
+                    stack.emplace_back(child, false);
+                }
+            }
+        }
+    }
+
+    std::shared_ptr<mtac::Quadruple> make_copy(std::shared_ptr<Variable> result, std::shared_ptr<Variable> value){
+        if(mtac::is_single_float_register(result->type())){
+            return make_node<mtac::Quadruple>(result, value, mtac::Operator::FASSIGN);
+        } else {
+            return make_node<mtac::Quadruple>(result, value, mtac::Operator::ASSIGN);
+        }
+    }
+
+    //The value of a leader is kept in a new temporary, this does not extend the live range of any SSA version
+    bool transform(){
+        std::unordered_map<std::shared_ptr<mtac::Quadruple>, std::shared_ptr<Variable>> temporaries;
+
+        for(auto& pair : redundant){
+            auto& leader = pair.second;
+
+            if(!temporaries.count(leader.quadruple)){
+                auto source = leader.quadruple;
+                auto temporary = function->context->new_temporary(source->result->type());
+
+                auto& statements = leader.block->statements;
+                for(auto it = statements.begin(); it != statements.end(); ++it){
+                    if(auto* ptr = boost::get<std::shared_ptr<mtac::Quadruple>>(&*it)){
+                        if(*ptr == source){
+                            auto copy = make_copy(source->result, temporary);
+                            copy->depth = source->depth;
+
+                            statements.insert(it + 1, copy);
+                            break;
+                        }
+                    }
+                }
+
+                source->result = temporary;
+                temporaries[source] = temporary;
+            }
+
+            auto copy = make_copy(pair.first->result, temporaries[leader.quadruple]);
+
+            pair.first->op = copy->op;
+            pair.first->arg1 = copy->arg1;
+            pair.first->arg2.reset();
+            pair.first->size = mtac::Size::DEFAULT;
+        }
+
+        return !redundant.empty();
+    }
+};
+
+} //end of anonymous namespace
+
+bool mtac::global_value_numbering::operator()(mtac::function_p function){
+    auto versions = mtac::build_ssa(function);
+
+    ValueNumbering numbering(function, versions);
+    numbering.number();
+
+    bool optimized = numbering.transform();
+
+    //The redundant expressions read a new temporary, the versions of a variable still do not interfere
+    mtac::revert_ssa(function, versions);
+
+    if(log::enabled<Debug>()){
+        log::emit<Debug>("GVN") << function->getName() << ": " << numbering.redundant.size() << " redundant expressions" << log::endl;
+    }
+
+    return optimized;
+}
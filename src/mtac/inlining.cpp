@@ -9,6 +9,7 @@
 #include <unordered_map>
 
 #include "logging.hpp"
+#include "arena.hpp"
 #include "Options.hpp"
 #include "Type.hpp"
 #include "FunctionContext.hpp"
@@ -22,6 +23,7 @@
 #include "mtac/VariableReplace.hpp"
 #include "mtac/ControlFlowGraph.hpp"
 #include "mtac/Statement.hpp"
+#include "mtac/frequencies.hpp"
 
 using namespace eddic;
 
@@ -58,6 +60,18 @@ struct BBReplace : public boost::static_visitor<> {
     }
 };
 
+mtac::basic_block_p jump_target(mtac::Statement& statement){
+    if(auto* ptr = boost::get<std::shared_ptr<mtac::Goto>>(&statement)){
+        return (*ptr)->block;
+    } else if(auto* ptr = boost::get<std::shared_ptr<mtac::If>>(&statement)){
+        return (*ptr)->block;
+    } else if(auto* ptr = boost::get<std::shared_ptr<mtac::IfFalse>>(&statement)){
+        return (*ptr)->block;
+    }
+
+    return nullptr;
+}
+
 BBClones clone(mtac::function_p source_function, mtac::function_p dest_function, mtac::basic_block_p bb, std::shared_ptr<GlobalContext> context){
     log::emit<Trace>("Inlining") << "Clone " << source_function->getName() << " into " << dest_function->getName() << log::endl;
 
@@ -76,6 +90,9 @@ BBClones clone(mtac::function_p source_function, mtac::function_p dest_function,
         if(block->index >= 0){
             auto new_bb = dest_function->new_bb();
 
+            //The inlined blocks are executed each time the call is
+            new_bb->frequency = bb->frequency * block->frequency;
+
             //Copy the control flow graph properties, they will be corrected after
             new_bb->successors = block->successors;
             new_bb->predecessors = block->predecessors;
@@ -112,6 +129,23 @@ BBClones clone(mtac::function_p source_function, mtac::function_p dest_function,
             }
         }
     }
+
+    //The blocks jumping to the call site must now jump to the inlined code
+    auto first = bb_clones[old_entry->successors.front()];
+
+    BBClones call_site;
+    call_site[exit] = first;
+    BBReplace jump_replacer(call_site);
+
+    auto predecessors = exit->predecessors;
+    for(auto& pred : predecessors){
+        if(!pred->statements.empty() && jump_target(pred->statements.back()) == exit){
+            visit(jump_replacer, pred->statements.back());
+
+            mtac::remove_edge(pred, exit);
+            mtac::make_edge(pred, first);
+        }
+    }
     
     return bb_clones;
 }
@@ -150,7 +184,7 @@ mtac::VariableClones copy_parameters(mtac::function_p source_function, mtac::fun
 
                     variable_clones[src_var] = dest_var;
 
-                    auto quadruple = std::make_shared<mtac::Quadruple>();
+                    auto quadruple = make_node<mtac::Quadruple>();
                     quadruple->op = mtac::Operator::NOP;
                     *pit = quadruple;
                 } else if(src_var->type() == STRING){
@@ -160,7 +194,7 @@ mtac::VariableClones copy_parameters(mtac::function_p source_function, mtac::fun
                         variable_clones[src_var] = dest_var;
 
                         //Copy the label
-                        auto quadruple = std::make_shared<mtac::Quadruple>();
+                        auto quadruple = make_node<mtac::Quadruple>();
                         quadruple->op = mtac::Operator::ASSIGN;
                         quadruple->result = dest_var;
                         quadruple->arg1 = (*ptr)->arg;
@@ -175,7 +209,7 @@ mtac::VariableClones copy_parameters(mtac::function_p source_function, mtac::fun
                             auto dest_var = variable_clones[src_var];
 
                             //Copy the size
-                            auto quadruple = std::make_shared<mtac::Quadruple>();
+                            auto quadruple = make_node<mtac::Quadruple>();
                             quadruple->op = mtac::Operator::DOT_ASSIGN;
                             quadruple->result = dest_var;
                             quadruple->arg1 = static_cast<int>(INT->size(dest_definition->context->global()->target_platform()));
@@ -189,7 +223,7 @@ mtac::VariableClones copy_parameters(mtac::function_p source_function, mtac::fun
                         }
                     }
                 } else {
-                    auto quadruple = std::make_shared<mtac::Quadruple>();
+                    auto quadruple = make_node<mtac::Quadruple>();
                     std::shared_ptr<Variable> dest_var;
                     
                     auto type = src_var->type();
@@ -282,7 +316,7 @@ void adapt_instructions(mtac::VariableClones& variable_clones, BBClones& bb_clon
                 auto quadruple = *ret_ptr;
 
                 if(quadruple->op == mtac::Operator::RETURN){
-                    auto goto_ = std::make_shared<mtac::Goto>();
+                    auto goto_ = make_node<mtac::Goto>();
                     goto_->block = basic_block;
 
                     mtac::remove_edge(new_bb, new_bb->next);
@@ -305,7 +339,7 @@ void adapt_instructions(mtac::VariableClones& variable_clones, BBClones& bb_clon
                         }
 
                         if(call->return2_){
-                            ssit.insert(std::make_shared<mtac::Quadruple>(call->return2_, *quadruple->arg2, op));
+                            ssit.insert(make_node<mtac::Quadruple>(call->return2_, *quadruple->arg2, op));
 
                             ++ssit;
                         }
@@ -350,6 +384,10 @@ bool can_be_inlined(mtac::function_p function){
     return true;
 }
 
+//Execution frequencies of the call sites, the static estimation gives about 8 for a loop and 70 for a nested loop
+static const double hot_frequency = 50.0;
+static const double warm_frequency = 5.0;
+
 bool will_inline(mtac::function_p source_function, mtac::function_p target_function, std::shared_ptr<mtac::Call> call, mtac::basic_block_p bb){
     //Do not inline recursive calls
     if(source_function == target_function){
@@ -367,13 +405,13 @@ bool will_inline(mtac::function_p source_function, mtac::function_p target_funct
             return target_size < 250;
         }
 
-        //For inner loop, increase the chances of inlining
-        if(call->depth > 1){
+        //For very hot calls (inner loops), increase the chances of inlining
+        if(bb->frequency >= hot_frequency){
             return source_size < 500 && target_size < 100;
         }
         
-        //For single loop, increase a bit the changes of inlining
-        if(call->depth > 0){
+        //For warm calls (single loop), increase a bit the changes of inlining
+        if(bb->frequency >= warm_frequency){
             return source_size < 300 && target_size < 75;
         }
 
@@ -401,9 +439,11 @@ mtac::function_p get_target(std::shared_ptr<mtac::Call> call, mtac::program_p pr
     return nullptr;
 }
 
-bool call_site_inlining(mtac::function_p dest_function, mtac::program_p program){
+bool call_site_inlining(mtac::function_p dest_function, mtac::program_p program, std::shared_ptr<Configuration> configuration){
     bool optimized = false;
 
+    mtac::compute_frequencies(dest_function, configuration);
+
     auto bit = dest_function->begin();
     auto bend = dest_function->end();
         
@@ -439,6 +479,7 @@ bool call_site_inlining(mtac::function_p dest_function, mtac::program_p program)
                     }
 
                     //Clone all the source basic blocks in the dest function
+                    mtac::compute_frequencies(source_function, configuration);
                     auto bb_clones = clone(source_function, dest_function, basic_block, program->context);
 
                     //Fix all the instructions (clones and return)
@@ -485,7 +526,7 @@ bool mtac::inline_functions::operator()(mtac::program_p program){
                 continue; 
             }
 
-            optimized |= call_site_inlining(function, program);
+            optimized |= call_site_inlining(function, program, configuration);
         }
 
         return optimized;
@@ -16,6 +16,7 @@
 #include "mtac/dominators.hpp"
 #include "mtac/Loop.hpp"
 #include "mtac/Program.hpp"
+#include "mtac/Function.hpp"
 #include "mtac/Statement.hpp"
 
 using namespace eddic;
@@ -92,6 +93,14 @@ void mtac::full_loop_analysis(mtac::function_p function){
 }
 
 bool mtac::loop_analysis::operator()(mtac::function_p function){
+    //The loops are kept until the CFG or the dominators change
+    if(function->analyses.loops_valid){
+        return false;
+    }
+
+    //The back edges are found with the dominators
+    mtac::compute_dominators(function);
+
     std::vector<std::pair<mtac::basic_block_p, mtac::basic_block_p>> back_edges;
 
     for(auto& block : function){
@@ -100,7 +109,14 @@ bool mtac::loop_analysis::operator()(mtac::function_p function){
             if(block == succ){
                 back_edges.push_back(std::make_pair(block,succ));
             } else {
-                if(block->dominator == succ){
+                //The edge is a back edge if its target dominates its source
+                auto dominator = block->dominator;
+
+                while(dominator && dominator != succ){
+                    dominator = dominator->dominator;
+                }
+
+                if(dominator == succ){
                     back_edges.push_back(std::make_pair(block,succ));
                 }
             }
@@ -114,7 +130,7 @@ bool mtac::loop_analysis::operator()(mtac::function_p function){
         std::set<mtac::basic_block_p> natural_loop;
 
         auto n = back_edge.first;
-        auto d = back_edge.first;
+        auto d = back_edge.second;
 
         natural_loop.insert(d);
         natural_loop.insert(n);
@@ -147,6 +163,8 @@ bool mtac::loop_analysis::operator()(mtac::function_p function){
 
     log::emit<Trace>("Control-Flow") << "Found " << function->loops().size() << " natural loops" << log::endl;
 
+    function->analyses.loops_valid = true;
+
     //Analysis only
     return false;
 }
@@ -7,8 +7,11 @@
 
 #include <map>
 #include <unordered_map>
+#include <unordered_set>
 
+#include "assert.hpp"
 #include "iterators.hpp"
+#include "arena.hpp"
 #include "VisitorUtils.hpp"
 #include "Type.hpp"
 #include "FunctionContext.hpp"
@@ -23,6 +26,7 @@
 #include "mtac/ControlFlowGraph.hpp"
 #include "mtac/Statement.hpp"
 #include "mtac/Utils.hpp"
+#include "mtac/EscapeAnalysis.hpp"
 
 using namespace eddic;
 
@@ -157,8 +161,29 @@ bool is_invariant(mtac::Statement& statement, Usage& usage){
     return false;
 }
 
+bool dominates(mtac::basic_block_p dominator, mtac::basic_block_p bb){
+    while(bb && bb != dominator){
+        bb = bb->dominator;
+    }
+
+    return bb == dominator;
+}
+
+/*!
+ * Return the header of the loop, the only block of the loop that is entered from outside the loop. 
+ */
+mtac::basic_block_p find_header(std::shared_ptr<mtac::Loop> loop){
+    for(auto& bb : loop){
+        if(!bb->dominator || !loop->blocks().count(bb->dominator)){
+            return bb;
+        }
+    }
+
+    eddic_unreachable("A loop has always a header");
+}
+
 mtac::basic_block_p create_pre_header(std::shared_ptr<mtac::Loop> loop, mtac::function_p function){
-    auto first_bb = *loop->blocks().begin();
+    auto first_bb = find_header(loop);
 
     //Remove the fall through edge
     mtac::remove_edge(first_bb->prev, first_bb);
@@ -251,28 +276,20 @@ bool is_valid_invariant(mtac::basic_block_p source_bb, mtac::Statement statement
     for(auto& bb : loop){
         //A bb always dominates itself => no need to consider the source basic block
         if(bb != source_bb){
-            if(use_variable(bb, var)){
-                auto dominator = bb->dominator;
-
-                //If the bb is not dominated by the source bb, it is not valid
-                if(dominator != source_bb){
-                    return false;
-                }
+            //If the bb is not dominated by the source bb, it is not valid
+            if(use_variable(bb, var) && !dominates(source_bb, bb)){
+                return false;
             }
         }
     }
     
-    auto exit_block = *loop->blocks().rbegin();
-
-    if(exit_block == source_bb){
-        return true;
-    }
-                
-    auto dominator = exit_block->dominator;
-
-    //If the exit bb is not dominated by the source bb, it is not valid
-    if(dominator != source_bb){
-        return false;
+    for(auto& bb : loop){
+        for(auto& succ : bb->successors){
+            //If an exit bb is not dominated by the source bb, it is not valid
+            if(!loop->blocks().count(succ) && !dominates(source_bb, bb)){
+                return false;
+            }
+        }
     }
     
     return true;
@@ -415,6 +432,9 @@ InductionVariables find_basic_induction_variables(std::shared_ptr<mtac::Loop> lo
 InductionVariables find_dependent_induction_variables(std::shared_ptr<mtac::Loop> loop, const InductionVariables& basic_induction_variables, mtac::function_p function){
     auto dependent_induction_variables = find_all_candidates(loop);
 
+    //The variables that cannot be induction variables anymore
+    std::unordered_set<std::shared_ptr<Variable>> invalid;
+
     for(auto& bb : loop){
         for(auto& statement : bb->statements){
             if(auto* ptr = boost::get<std::shared_ptr<mtac::Quadruple>>(&statement)){
@@ -422,7 +442,7 @@ InductionVariables find_dependent_induction_variables(std::shared_ptr<mtac::Loop
                 auto var = quadruple->result;
 
                 //If it is not a candidate, do not test it
-                if(!dependent_induction_variables.count(var)){
+                if(!dependent_induction_variables.count(var) || invalid.count(var)){
                     continue;
                 }
                 
@@ -455,6 +475,12 @@ InductionVariables find_dependent_induction_variables(std::shared_ptr<mtac::Loop
                     }
                 
                     arg1 = *quadruple->arg1;
+                } else if(source_equation.i){
+                    //A variable assigned several times in the loop is not an induction variable
+                    dependent_induction_variables.erase(var);
+                    invalid.insert(var);
+
+                    continue;
                 }
 
                 if(quadruple->op == mtac::Operator::MUL){
@@ -585,15 +611,18 @@ InductionVariables find_dependent_induction_variables(std::shared_ptr<mtac::Loop
                 }
                 
                 dependent_induction_variables.erase(var);
+                invalid.insert(var);
             } else if(auto* ptr = boost::get<std::shared_ptr<mtac::Call>>(&statement)){
                 auto call = *ptr;
 
                 if(call->return_){
                     dependent_induction_variables.erase(call->return_);
+                    invalid.insert(call->return_);
                 }
 
                 if(call->return2_){
                     dependent_induction_variables.erase(call->return2_);
+                    invalid.insert(call->return2_);
                 }
             }
         }
@@ -644,7 +673,7 @@ bool strength_reduce(std::shared_ptr<mtac::Loop> loop, LinearEquation& basic_equ
                         //After an assignment to a basic induction variable, insert addition for tj
                         else if(quadruple == basic_equation.def){
                             ++it;
-                            auto new_quadruple = std::make_shared<mtac::Quadruple>(tj, tj, mtac::Operator::ADD, db);
+                            auto new_quadruple = make_node<mtac::Quadruple>(tj, tj, mtac::Operator::ADD, db);
                             it.insert(new_quadruple);
 
                             new_induction_variables[tj] = {new_quadruple, i, equation.e, equation.d, true};
@@ -669,8 +698,8 @@ bool strength_reduce(std::shared_ptr<mtac::Loop> loop, LinearEquation& basic_equ
                 pre_header = create_pre_header(loop, function);
             }
 
-            pre_header->statements.push_back(std::make_shared<mtac::Quadruple>(tj, equation.e, mtac::Operator::MUL, i));
-            pre_header->statements.push_back(std::make_shared<mtac::Quadruple>(tj, tj, mtac::Operator::ADD, equation.d));
+            pre_header->statements.push_back(make_node<mtac::Quadruple>(tj, equation.e, mtac::Operator::MUL, i));
+            pre_header->statements.push_back(make_node<mtac::Quadruple>(tj, tj, mtac::Operator::ADD, equation.d));
 
             optimized = true;
         }
@@ -831,6 +860,11 @@ void induction_variable_replace(std::shared_ptr<mtac::Loop> loop, InductionVaria
 bool loop_induction_variables_optimization(std::shared_ptr<mtac::Loop> loop, mtac::function_p function){
     bool optimized = false;
 
+    //The induction variables are found in the order of the statements, it is only the order of execution in a single basic block
+    if(loop->blocks().size() > 1){
+        return optimized;
+    }
+
     //1. Identify all the induction variables
     auto basic_induction_variables = find_basic_induction_variables(loop);
     auto dependent_induction_variables = find_dependent_induction_variables(loop, basic_induction_variables, function);
@@ -954,6 +988,8 @@ int number_of_iterations(LinearEquation& linear_equation, int initial_value, mta
 } //end of anonymous namespace
 
 bool mtac::loop_invariant_code_motion::operator()(mtac::function_p function){
+    mtac::loop_analysis()(function);
+
     if(function->loops().empty()){
         return false;
     }
@@ -968,6 +1004,8 @@ bool mtac::loop_invariant_code_motion::operator()(mtac::function_p function){
 }
 
 bool mtac::loop_induction_variables_optimization::operator()(mtac::function_p function){
+    mtac::loop_analysis()(function);
+
     if(function->loops().empty()){
         return false;
     }
@@ -1007,6 +1045,8 @@ std::pair<bool, int> get_initial_value(mtac::basic_block_p bb, std::shared_ptr<V
 }
 
 bool mtac::remove_empty_loops::operator()(mtac::function_p function){
+    mtac::loop_analysis()(function);
+
     if(function->loops().empty()){
         return false;
     }
@@ -1046,7 +1086,7 @@ bool mtac::remove_empty_loops::operator()(mtac::function_p function){
                                     bb->statements.clear();
                                     loop_removed = true;
 
-                                    bb->statements.push_back(std::make_shared<mtac::Quadruple>(first->result, initial_value.second + it * linear_equation.d, mtac::Operator::ASSIGN));
+                                    bb->statements.push_back(make_node<mtac::Quadruple>(first->result, initial_value.second + it * linear_equation.d, mtac::Operator::ASSIGN));
                                 }
                         
                                 if(loop_removed){
@@ -1073,6 +1113,8 @@ bool mtac::remove_empty_loops::operator()(mtac::function_p function){
 }
 
 bool mtac::complete_loop_peeling::operator()(mtac::function_p function){
+    mtac::loop_analysis()(function);
+
     if(function->loops().empty()){
         return false;
     }
@@ -1088,6 +1130,7 @@ bool mtac::complete_loop_peeling::operator()(mtac::function_p function){
             auto bb = *loop->begin();
 
             if(bb->statements.size() < 2 || bb->statements.size() > 100){
+                ++lit;
                 continue;
             }
 
@@ -1131,3 +1174,1336 @@ bool mtac::complete_loop_peeling::operator()(mtac::function_p function){
 
     return optimized;
 }
+
+namespace {
+
+//The vectorizer works on SSE registers
+const unsigned int vector_size = 16;
+
+enum class VectorKind : unsigned int {
+    IV_UPDATE,      //Update of a basic induction variable
+    LOAD,           //v = (array)iv
+    STORE,          //(array)iv = v
+    OPERATION,      //v = v1 op v2
+    REDUCTION,      //s = s op v
+    SKIP            //Statement without effect or already handled by the previous one
+};
+
+struct VectorStatement {
+    VectorKind kind;
+    std::shared_ptr<mtac::Quadruple> quadruple;
+    std::shared_ptr<Variable> sum;              //For the reductions, the sum variable
+    std::shared_ptr<Variable> copy;             //For the reductions of the form t = s op v; s = t, the variable t
+};
+
+struct ArrayAccess {
+    std::shared_ptr<Variable> array;
+    std::shared_ptr<Variable> index;
+    bool updated;       //Indicates if the index has already been incremented when the array is accessed
+    bool store;
+};
+
+bool is_indirect_array(std::shared_ptr<Variable> array){
+    return array->position().isParameter() || array->type()->is_dynamic_array();
+}
+
+bool is_local_array(std::shared_ptr<Variable> array){
+    return !is_indirect_array(array) && array->position().isStack();
+}
+
+//Two arrays passed as parameters or allocated on the heap can be the same memory
+bool may_alias(std::shared_ptr<Variable> lhs, std::shared_ptr<Variable> rhs){
+    return lhs == rhs
+        || (lhs->position().isParameter() && !is_local_array(rhs))
+        || (rhs->position().isParameter() && !is_local_array(lhs))
+        || (lhs->type()->is_dynamic_array() && rhs->type()->is_dynamic_array());
+}
+
+//Return the condition "if i < n goto bb" of a single-block loop entered only by falling through from the previous block
+std::shared_ptr<mtac::If> counted_loop_condition(mtac::basic_block_p bb){
+    auto prev = bb->prev;
+    if(!prev || bb->predecessors.size() != 2 || !bb->next){
+        return nullptr;
+    }
+
+    for(auto& predecessor : bb->predecessors){
+        if(predecessor != bb && predecessor != prev){
+            return nullptr;
+        }
+    }
+
+    if(!prev->statements.empty()){
+        auto& last = prev->statements.back();
+
+        if(boost::get<std::shared_ptr<mtac::Goto>>(&last)){
+            return nullptr;
+        } else if(auto* ptr = boost::get<std::shared_ptr<mtac::If>>(&last)){
+            if((*ptr)->block == bb){
+                return nullptr;
+            }
+        } else if(auto* ptr = boost::get<std::shared_ptr<mtac::IfFalse>>(&last)){
+            if((*ptr)->block == bb){
+                return nullptr;
+            }
+        }
+    }
+
+    if(bb->statements.size() < 2){
+        return nullptr;
+    }
+
+    auto* if_ptr = boost::get<std::shared_ptr<mtac::If>>(&bb->statements.back());
+    if(!if_ptr || !(*if_ptr)->op || !(*if_ptr)->arg2 || (*if_ptr)->block != bb){
+        return nullptr;
+    }
+
+    auto if_ = *if_ptr;
+
+    if(*if_->op != mtac::BinaryOperator::LESS && *if_->op != mtac::BinaryOperator::LESS_EQUALS){
+        return nullptr;
+    }
+
+    if(!mtac::isVariable(if_->arg1)){
+        return nullptr;
+    }
+
+    return if_;
+}
+
+struct LoopVectorizer {
+    std::shared_ptr<mtac::Loop> loop;
+    mtac::function_p function;
+    Platform platform;
+    bool fast_math;             //The float reductions can be reassociated
+
+    mtac::basic_block_p bb;
+    std::shared_ptr<mtac::If> if_;
+    std::shared_ptr<Variable> counter;
+    int lanes = 0;
+
+    InductionVariables basic_induction_variables;
+    Usage write_usage;
+    Usage read_usage;
+
+    std::vector<VectorStatement> statements;
+    std::vector<ArrayAccess> accesses;
+    std::unordered_map<std::shared_ptr<Variable>, bool> vectors;        //The scalars transformed into vectors (true for float vectors)
+    std::unordered_map<std::shared_ptr<Variable>, unsigned int> index_uses;
+
+    LoopVectorizer(std::shared_ptr<mtac::Loop> loop, mtac::function_p function, Platform platform, bool fast_math) : loop(loop), function(function), platform(platform), fast_math(fast_math) {}
+
+    bool is_scalar_invariant(mtac::Argument& arg, bool is_float){
+        if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&arg)){
+            auto var = *ptr;
+            return write_usage.written[var] == 0 && !vectors.count(var) && var->type() == (is_float ? FLOAT : INT);
+        }
+
+        return is_float ? mtac::isFloat(arg) : mtac::isInt(arg);
+    }
+
+    bool is_vector(mtac::Argument& arg, bool is_float){
+        if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&arg)){
+            auto it = vectors.find(*ptr);
+            return it != vectors.end() && it->second == is_float;
+        }
+
+        return false;
+    }
+
+    bool is_operand(mtac::Argument& arg, bool is_float){
+        return is_vector(arg, is_float) || is_scalar_invariant(arg, is_float);
+    }
+
+    //The new values must not be used outside of the loop, they are only computed as vectors
+    bool is_local_value(std::shared_ptr<Variable> var){
+        if(var->position().isGlobal() || write_usage.written[var] != 1 || vectors.count(var) || basic_induction_variables.count(var)){
+            return false;
+        }
+
+        for(auto& block : function){
+            if(block != bb && use_variable(block, var)){
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool add_access(std::shared_ptr<Variable> array, mtac::Argument& index, bool store, std::unordered_set<std::shared_ptr<Variable>>& updated, bool& is_float){
+        auto type = array->type();
+        if(!type->is_array() || type->is_pointer()){
+            return false;
+        }
+
+        auto data_type = type->data_type();
+        if(data_type != INT && data_type != FLOAT){
+            return false;
+        }
+
+        if(!mtac::isVariable(index)){
+            return false;
+        }
+
+        auto index_var = boost::get<std::shared_ptr<Variable>>(index);
+
+        //Only the unit-stride accesses can be vectorized
+        auto it = basic_induction_variables.find(index_var);
+        if(it == basic_induction_variables.end() || it->second.d != static_cast<int>(data_type->size(platform))){
+            return false;
+        }
+
+        if(vector_size / data_type->size(platform) != static_cast<unsigned int>(lanes)){
+            return false;
+        }
+
+        is_float = data_type == FLOAT;
+        ++index_uses[index_var];
+        accesses.push_back({array, index_var, updated.count(index_var) > 0, store});
+
+        return true;
+    }
+
+    bool add_reduction(std::shared_ptr<mtac::Quadruple> quadruple, std::shared_ptr<mtac::Quadruple> next, bool is_float){
+        //The vector accumulators add the values in a different order, this changes the rounding of a float sum
+        if(is_float && !fast_math){
+            return false;
+        }
+
+        auto op = quadruple->op;
+        auto sum = quadruple->result;
+        std::shared_ptr<Variable> copy;
+
+        //t = s op v; s = t, t can be used after the loop
+        if(next && (next->op == mtac::Operator::ASSIGN || next->op == mtac::Operator::FASSIGN) && mtac::equals(*next->arg1, sum)){
+            copy = sum;
+            sum = next->result;
+
+            if(write_usage.written[copy] != 1 || read_usage.read[copy] != 1){
+                return false;
+            }
+        }
+
+        //s = s op v or s = v + s
+        boost::optional<mtac::Argument> value;
+        if(mtac::equals(*quadruple->arg1, sum)){
+            value = quadruple->arg2;
+        } else if((op == mtac::Operator::ADD || op == mtac::Operator::FADD) && mtac::equals(*quadruple->arg2, sum)){
+            value = quadruple->arg1;
+        } else {
+            return false;
+        }
+
+        if(!is_vector(*value, is_float) || sum->type() != (is_float ? FLOAT : INT) || basic_induction_variables.count(sum)){
+            return false;
+        }
+
+        //The sum cannot be used anywhere else in the loop
+        if(write_usage.written[sum] != 1 || read_usage.read[sum] != 1){
+            return false;
+        }
+
+        statements.push_back({VectorKind::REDUCTION, quadruple, sum, copy});
+
+        if(copy){
+            statements.push_back({VectorKind::SKIP, next, nullptr, nullptr});
+        }
+
+        return true;
+    }
+
+    bool analyze_body(){
+        std::unordered_set<std::shared_ptr<Variable>> updated;
+
+        auto& body = bb->statements;
+
+        for(std::size_t i = 0; i + 1 < body.size(); ++i){
+            auto& statement = body[i];
+
+            if(boost::get<std::shared_ptr<mtac::NoOp>>(&statement)){
+                continue;
+            }
+
+            auto* ptr = boost::get<std::shared_ptr<mtac::Quadruple>>(&statement);
+            if(!ptr){
+                return false;
+            }
+
+            auto quadruple = *ptr;
+            auto op = quadruple->op;
+
+            if(op == mtac::Operator::NOP){
+                continue;
+            }
+
+            auto it = basic_induction_variables.find(quadruple->result);
+            if(it != basic_induction_variables.end() && it->second.def == quadruple){
+                updated.insert(quadruple->result);
+                statements.push_back({VectorKind::IV_UPDATE, quadruple, nullptr, nullptr});
+                continue;
+            }
+
+            //If the previous statement was a reduction t = s op v, this is s = t
+            if(!statements.empty() && statements.back().kind == VectorKind::SKIP && statements.back().quadruple == quadruple){
+                continue;
+            }
+
+            if(op == mtac::Operator::DOT && quadruple->size == mtac::Size::DEFAULT && mtac::isVariable(*quadruple->arg1)){
+                bool is_float = false;
+                if(!add_access(boost::get<std::shared_ptr<Variable>>(*quadruple->arg1), *quadruple->arg2, false, updated, is_float)){
+                    return false;
+                }
+
+                if(quadruple->result->type() != (is_float ? FLOAT : INT) || !is_local_value(quadruple->result)){
+                    return false;
+                }
+
+                vectors[quadruple->result] = is_float;
+                statements.push_back({VectorKind::LOAD, quadruple, nullptr, nullptr});
+            } else if(op == mtac::Operator::DOT_ASSIGN || op == mtac::Operator::DOT_FASSIGN){
+                bool is_float = false;
+                if(!add_access(quadruple->result, *quadruple->arg1, true, updated, is_float)){
+                    return false;
+                }
+
+                if(is_float != (op == mtac::Operator::DOT_FASSIGN) || !is_operand(*quadruple->arg2, is_float)){
+                    return false;
+                }
+
+                statements.push_back({VectorKind::STORE, quadruple, nullptr, nullptr});
+            } else if(op == mtac::Operator::ADD || op == mtac::Operator::SUB || op == mtac::Operator::FADD || op == mtac::Operator::FSUB || op == mtac::Operator::FMUL){
+                bool is_float = op == mtac::Operator::FADD || op == mtac::Operator::FSUB || op == mtac::Operator::FMUL;
+
+                std::shared_ptr<mtac::Quadruple> next;
+                if(i + 2 < body.size()){
+                    if(auto* next_ptr = boost::get<std::shared_ptr<mtac::Quadruple>>(&body[i + 1])){
+                        next = *next_ptr;
+                    }
+                }
+
+                //v = v1 op v2 with at least one vector operand
+                if(is_operand(*quadruple->arg1, is_float) && is_operand(*quadruple->arg2, is_float) 
+                        && (is_vector(*quadruple->arg1, is_float) || is_vector(*quadruple->arg2, is_float))
+                        && quadruple->result->type() == (is_float ? FLOAT : INT) && is_local_value(quadruple->result)){
+                    vectors[quadruple->result] = is_float;
+                    statements.push_back({VectorKind::OPERATION, quadruple, nullptr, nullptr});
+                } else if(op == mtac::Operator::FMUL || !add_reduction(quadruple, next, is_float)){
+                    return false;
+                }
+            } else {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool check_induction_variables(){
+        for(auto& biv : basic_induction_variables){
+            auto var = biv.first;
+            
+            //The induction variables can only be used in their update, to index the arrays and in the condition
+            if(read_usage.read[var] != 1 + index_uses[var] + (var == counter ? 1 : 0)){
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool check_dependencies(){
+        for(auto& store : accesses){
+            if(!store.store){
+                continue;
+            }
+
+            for(auto& access : accesses){
+                if(&access != &store && may_alias(store.array, access.array)){
+                    //The same element must be accessed in the same iteration
+                    if(access.index != store.index || access.updated != store.updated || access.array->type()->data_type() != store.array->type()->data_type()){
+                        return false;
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool analyze(){
+        if(loop->blocks().size() != 1){
+            return false;
+        }
+
+        bb = *loop->begin();
+
+        if_ = counted_loop_condition(bb);
+        if(!if_){
+            return false;
+        }
+
+        counter = boost::get<std::shared_ptr<Variable>>(if_->arg1);
+
+        basic_induction_variables = find_basic_induction_variables(loop);
+        write_usage = compute_write_usage(loop);
+        read_usage = compute_read_usage(loop);
+
+        auto it = basic_induction_variables.find(counter);
+        if(it == basic_induction_variables.end() || it->second.d <= 0){
+            return false;
+        }
+
+        if(!is_invariant(if_->arg2, write_usage) || !(mtac::isInt(*if_->arg2) || mtac::isVariable(*if_->arg2))){
+            return false;
+        }
+
+        lanes = vector_size / INT->size(platform);
+
+        if(!analyze_body() || accesses.empty()){
+            return false;
+        }
+
+        return check_induction_variables() && check_dependencies();
+    }
+
+    template<typename... Args>
+    std::shared_ptr<mtac::Quadruple> add(mtac::basic_block_p block, Args... args){
+        auto quadruple = make_node<mtac::Quadruple>(args...);
+        quadruple->depth = if_->depth;
+        block->statements.push_back(quadruple);
+        return quadruple;
+    }
+
+    template<typename Jump>
+    void add_jump(mtac::basic_block_p block, mtac::Argument limit, mtac::basic_block_p target){
+        auto jump = make_node<Jump>(*if_->op, counter, limit, "");
+        jump->block = target;
+        jump->depth = if_->depth;
+        block->statements.push_back(jump);
+    }
+
+    void transform(){
+        auto context = function->context;
+        auto prev = bb->prev;
+        auto exit = bb->next;
+
+        auto pre = function->new_bb();
+        auto vector_loop = function->new_bb();
+        auto post = function->new_bb();
+
+        pre->depth = post->depth = prev->depth;
+        vector_loop->depth = bb->depth;
+
+        //The vector loop is already as wide as possible and the remainder loop runs less than lanes times
+        vector_loop->vectorized = bb->vectorized = true;
+
+        //The vector loop runs while there are still enough iterations for a complete vector
+        int step = basic_induction_variables[counter].d;
+        mtac::Argument limit = *if_->arg2;
+        if(mtac::isInt(limit)){
+            limit = boost::get<int>(limit) - (lanes - 1) * step;
+        } else {
+            auto limit_var = context->new_temporary(INT);
+            add(pre, limit_var, *if_->arg2, mtac::Operator::SUB, (lanes - 1) * step);
+            limit = limit_var;
+        }
+
+        std::unordered_map<std::shared_ptr<Variable>, std::shared_ptr<Variable>> vector_vars;
+        std::unordered_map<std::shared_ptr<Variable>, std::shared_ptr<Variable>> accumulators;
+        std::vector<std::shared_ptr<Variable>> late_updates;
+
+        auto vector_arg = [&](mtac::Argument& arg) -> std::shared_ptr<Variable> {
+            if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&arg)){
+                auto it = vector_vars.find(*ptr);
+                if(it != vector_vars.end()){
+                    return it->second;
+                }
+            }
+
+            //The invariants are copied in all the elements before the loop
+            auto splat = context->new_temporary(FLOAT);
+            add(pre, splat, arg, mtac::Operator::VSPLAT);
+            return splat;
+        };
+
+        auto vector_var = [&](std::shared_ptr<Variable> var){
+            auto vector = context->new_temporary(FLOAT);
+            vector_vars[var] = vector;
+            return vector;
+        };
+
+        for(auto& statement : statements){
+            auto quadruple = statement.quadruple;
+            bool is_float = false;
+
+            switch(statement.kind){
+                case VectorKind::IV_UPDATE:
+                    {
+                        auto var = quadruple->result;
+                        int d = basic_induction_variables[var].d;
+
+                        //If the variable is used after its update, the first element is accessed after one step and 
+                        //the other steps are done at the end of the loop
+                        bool used_after = false;
+                        for(auto& access : accesses){
+                            used_after |= access.index == var && access.updated;
+                        }
+
+                        if(used_after){
+                            add(vector_loop, var, var, mtac::Operator::ADD, d);
+                            late_updates.push_back(var);
+                        } else {
+                            add(vector_loop, var, var, mtac::Operator::ADD, d * lanes);
+                        }
+                    }
+
+                    break;
+                case VectorKind::LOAD:
+                    add(vector_loop, vector_var(quadruple->result), *quadruple->arg1, mtac::Operator::VDOT, *quadruple->arg2);
+                    break;
+                case VectorKind::STORE:
+                    add(vector_loop, quadruple->result, *quadruple->arg1, mtac::Operator::DOT_VASSIGN, vector_arg(*quadruple->arg2));
+                    break;
+                case VectorKind::OPERATION:
+                    {
+                        mtac::Operator op;
+                        switch(quadruple->op){
+                            case mtac::Operator::ADD:   op = mtac::Operator::VADD; break;
+                            case mtac::Operator::SUB:   op = mtac::Operator::VSUB; break;
+                            case mtac::Operator::FADD:  op = mtac::Operator::VFADD; break;
+                            case mtac::Operator::FSUB:  op = mtac::Operator::VFSUB; break;
+                            default:                    op = mtac::Operator::VFMUL; break;
+                        }
+
+                        auto arg1 = vector_arg(*quadruple->arg1);
+                        auto arg2 = vector_arg(*quadruple->arg2);
+                        add(vector_loop, vector_var(quadruple->result), arg1, op, arg2);
+                    }
+
+                    break;
+                case VectorKind::REDUCTION:
+                    {
+                        is_float = statement.sum->type() == FLOAT;
+
+                        //Partial sums are accumulated in each element of a vector
+                        auto accumulator = context->new_temporary(FLOAT);
+                        accumulators[statement.sum] = accumulator;
+
+                        if(is_float){
+                            add(pre, accumulator, 0.0, mtac::Operator::VSPLAT);
+                        } else {
+                            add(pre, accumulator, 0, mtac::Operator::VSPLAT);
+                        }
+
+                        auto& value = mtac::equals(*quadruple->arg1, statement.sum) ? *quadruple->arg2 : *quadruple->arg1;
+                        add(vector_loop, accumulator, accumulator, is_float ? mtac::Operator::VFADD : mtac::Operator::VADD, vector_arg(value));
+
+                        //The sum of the elements is added to the sum after the loop
+                        auto total = context->new_temporary(is_float ? FLOAT : INT);
+                        add(post, total, accumulator, is_float ? mtac::Operator::VFSUM : mtac::Operator::VSUM);
+
+                        auto target = statement.copy ? statement.copy : statement.sum;
+                        add(post, target, statement.sum, quadruple->op, total);
+
+                        if(statement.copy){
+                            add(post, statement.sum, statement.copy, is_float ? mtac::Operator::FASSIGN : mtac::Operator::ASSIGN);
+                        }
+                    }
+
+                    break;
+                case VectorKind::SKIP:
+                    break;
+            }
+        }
+
+        for(auto& var : late_updates){
+            add(vector_loop, var, var, mtac::Operator::ADD, basic_induction_variables[var].d * (lanes - 1));
+        }
+
+        //Enter the vector loop only if there are enough iterations
+        add_jump<mtac::IfFalse>(pre, limit, bb);
+        add_jump<mtac::If>(vector_loop, limit, vector_loop);
+
+        //The remaining iterations are done in the original loop
+        add_jump<mtac::IfFalse>(post, *if_->arg2, exit);
+
+        function->insert_before(function->at(bb), pre);
+        function->insert_before(function->at(bb), vector_loop);
+        function->insert_before(function->at(bb), post);
+
+        mtac::remove_edge(prev, bb);
+        mtac::make_edge(prev, pre);
+        mtac::make_edge(pre, vector_loop);
+        mtac::make_edge(pre, bb);
+        mtac::make_edge(vector_loop, vector_loop);
+        mtac::make_edge(vector_loop, post);
+        mtac::make_edge(post, bb);
+        mtac::make_edge(post, exit);
+    }
+};
+
+} //end of anonymous namespace
+
+void mtac::loop_vectorization::set_platform(Platform platform){
+    this->platform = platform;
+}
+
+void mtac::loop_vectorization::set_configuration(std::shared_ptr<Configuration> configuration){
+    this->configuration = configuration;
+}
+
+bool mtac::loop_vectorization::operator()(mtac::function_p function){
+    mtac::loop_analysis()(function);
+
+    if(function->loops().empty()){
+        return false;
+    }
+
+    bool optimized = false;
+    bool fast_math = configuration->option_defined("ffast-math");
+
+    for(auto& loop : function->loops()){
+        LoopVectorizer vectorizer(loop, function, platform, fast_math);
+
+        if(vectorizer.analyze()){
+            vectorizer.transform();
+
+            optimized = true;
+        }
+    }
+
+    return optimized;
+}
+
+namespace {
+
+//Maximum number of statements in the body of an unrolled loop
+const std::size_t unroll_budget = 64;
+
+//The small bodies are unrolled more and the outermost loops, less executed, are unrolled less
+unsigned int unroll_factor(std::size_t size, unsigned int depth){
+    auto budget = depth > 1 ? unroll_budget : unroll_budget / 2;
+
+    for(unsigned int factor = 8; factor > 1; factor /= 2){
+        if(size * factor <= budget){
+            return factor;
+        }
+    }
+
+    return 1;
+}
+
+bool unroll_loop(mtac::function_p function, std::shared_ptr<mtac::Loop> loop){
+    if(loop->blocks().size() != 1){
+        return false;
+    }
+
+    auto bb = *loop->begin();
+
+    //Unrolling the loops produced by the vectorizer would only add code
+    if(bb->vectorized){
+        return false;
+    }
+
+    auto if_ = counted_loop_condition(bb);
+    if(!if_){
+        return false;
+    }
+
+    auto counter = boost::get<std::shared_ptr<Variable>>(if_->arg1);
+
+    auto basic_induction_variables = find_basic_induction_variables(loop);
+    auto write_usage = compute_write_usage(loop);
+
+    auto it = basic_induction_variables.find(counter);
+    if(it == basic_induction_variables.end() || it->second.d <= 0){
+        return false;
+    }
+
+    if(!is_invariant(if_->arg2, write_usage) || !(mtac::isInt(*if_->arg2) || mtac::isVariable(*if_->arg2))){
+        return false;
+    }
+
+    std::vector<mtac::Statement> body;
+    for(std::size_t i = 0; i + 1 < bb->statements.size(); ++i){
+        auto& statement = bb->statements[i];
+
+        if(boost::get<std::shared_ptr<mtac::NoOp>>(&statement)){
+            continue;
+        }
+
+        if(auto* ptr = boost::get<std::shared_ptr<mtac::Quadruple>>(&statement)){
+            if((*ptr)->op == mtac::Operator::NOP){
+                continue;
+            }
+        }
+
+        //The cost of the jump is negligible compared to the cost of a call
+        if(boost::get<std::shared_ptr<mtac::Call>>(&statement)){
+            return false;
+        }
+
+        body.push_back(statement);
+    }
+
+    unsigned int depth = 0;
+    for(auto& other : function->loops()){
+        depth += other->blocks().count(bb);
+    }
+
+    auto factor = unroll_factor(body.size(), depth);
+    if(factor < 2){
+        return false;
+    }
+
+    auto context = function->context;
+    auto prev = bb->prev;
+    auto exit = bb->next;
+
+    auto pre = function->new_bb();
+    auto unrolled = function->new_bb();
+    auto post = function->new_bb();
+
+    pre->depth = post->depth = prev->depth;
+    unrolled->depth = bb->depth;
+
+    //The unrolled loop runs while the factor iterations would all have been done by the loop
+    int step = it->second.d;
+    mtac::Argument limit = *if_->arg2;
+    if(mtac::isInt(limit)){
+        limit = boost::get<int>(limit) - static_cast<int>(factor - 1) * step;
+    } else {
+        auto limit_var = context->new_temporary(INT);
+
+        auto quadruple = make_node<mtac::Quadruple>(limit_var, *if_->arg2, mtac::Operator::SUB, static_cast<int>(factor - 1) * step);
+        quadruple->depth = if_->depth;
+        pre->statements.push_back(quadruple);
+
+        limit = limit_var;
+    }
+
+    for(unsigned int i = 0; i < factor; ++i){
+        for(auto& statement : body){
+            unrolled->statements.push_back(mtac::copy(statement, context->global()));
+        }
+    }
+
+    //Enter the unrolled loop only if there are enough iterations
+    auto enter = make_node<mtac::IfFalse>(*if_->op, counter, limit, "");
+    enter->block = bb;
+    enter->depth = if_->depth;
+    pre->statements.push_back(enter);
+
+    auto back = make_node<mtac::If>(*if_->op, counter, limit, "");
+    back->block = unrolled;
+    back->depth = if_->depth;
+    unrolled->statements.push_back(back);
+
+    //The remaining iterations are done in the original loop
+    auto leave = make_node<mtac::IfFalse>(*if_->op, counter, *if_->arg2, "");
+    leave->block = exit;
+    leave->depth = if_->depth;
+    post->statements.push_back(leave);
+
+    function->insert_before(function->at(bb), pre);
+    function->insert_before(function->at(bb), unrolled);
+    function->insert_before(function->at(bb), post);
+
+    mtac::remove_edge(prev, bb);
+    mtac::make_edge(prev, pre);
+    mtac::make_edge(pre, unrolled);
+    mtac::make_edge(pre, bb);
+    mtac::make_edge(unrolled, unrolled);
+    mtac::make_edge(unrolled, post);
+    mtac::make_edge(post, bb);
+    mtac::make_edge(post, exit);
+
+    return true;
+}
+
+} //end of anonymous namespace
+
+bool mtac::loop_unrolling::operator()(mtac::function_p function){
+    mtac::loop_analysis()(function);
+
+    if(function->loops().empty()){
+        return false;
+    }
+
+    bool optimized = false;
+
+    for(auto& loop : function->loops()){
+        optimized |= unroll_loop(function, loop);
+    }
+
+    return optimized;
+}
+
+namespace {
+
+//The counted loop "for(i = initial; i < limit; i += step)" whose bounds checks are analyzed
+struct CountedLoop {
+    mtac::basic_block_p header;
+    mtac::basic_block_p latch;
+    mtac::basic_block_p entry;
+
+    std::shared_ptr<Variable> i;
+    int step;
+    mtac::Argument limit;
+    bool inclusive;                 //The condition of the loop is i <= limit
+
+    bool initial_known;
+    int initial;
+    bool guarded;                   //The loop is entered only if the initial value satisfies the condition
+};
+
+//A bounds check generated by the front end: "if index < 0 goto error; if index < size goto ok; error: call _bounds_error; ok:"
+struct BoundsCheck {
+    mtac::basic_block_p lower;
+    mtac::basic_block_p upper;
+    mtac::basic_block_p error;
+
+    std::shared_ptr<Variable> index;
+    int offset;                     //The index is i + offset
+    mtac::Argument size;
+};
+
+bool is_bounds_error(mtac::basic_block_p bb){
+    if(bb && !bb->statements.empty()){
+        if(auto* ptr = boost::get<std::shared_ptr<mtac::Call>>(&bb->statements.front())){
+            return (*ptr)->function == "_bounds_error";
+        }
+    }
+
+    return false;
+}
+
+std::shared_ptr<mtac::If> last_if(mtac::basic_block_p bb){
+    if(bb && !bb->statements.empty()){
+        if(auto* ptr = boost::get<std::shared_ptr<mtac::If>>(&bb->statements.back())){
+            if((*ptr)->op && (*ptr)->arg2){
+                return *ptr;
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+//Return the array whose size is held by the variable, if all its definitions are "var = (array)0"
+std::shared_ptr<Variable> size_of(mtac::function_p function, std::shared_ptr<Variable> var){
+    std::shared_ptr<Variable> array;
+
+    for(auto& bb : function){
+        for(auto& statement : bb->statements){
+            if(auto* ptr = boost::get<std::shared_ptr<mtac::Quadruple>>(&statement)){
+                auto quadruple = *ptr;
+
+                if(quadruple->result == var && mtac::erase_result(quadruple->op)){
+                    if(quadruple->op != mtac::Operator::DOT || !mtac::isVariable(*quadruple->arg1) || !mtac::equals<int>(*quadruple->arg2, 0)){
+                        return nullptr;
+                    }
+
+                    auto source = boost::get<std::shared_ptr<Variable>>(*quadruple->arg1);
+
+                    if(array && array != source){
+                        return nullptr;
+                    }
+
+                    array = source;
+                }
+            } else if(auto* ptr = boost::get<std::shared_ptr<mtac::Call>>(&statement)){
+                if((*ptr)->return_ == var || (*ptr)->return2_ == var){
+                    return nullptr;
+                }
+            }
+        }
+    }
+
+    return array;
+}
+
+//Indicates if the two arguments always hold the same value in the loop
+bool same_value(mtac::function_p function, mtac::Argument& lhs, mtac::Argument& rhs, Usage& usage){
+    if(mtac::isInt(lhs) && mtac::isInt(rhs)){
+        return boost::get<int>(lhs) == boost::get<int>(rhs);
+    }
+
+    if(mtac::isVariable(lhs) && mtac::isVariable(rhs)){
+        auto left = boost::get<std::shared_ptr<Variable>>(lhs);
+        auto right = boost::get<std::shared_ptr<Variable>>(rhs);
+
+        if(left == right){
+            return usage.written[left] == 0 && !left->position().isGlobal() && !mtac::escape_analysis(function)->count(left);
+        }
+
+        //The size of an array never changes
+        auto array = size_of(function, left);
+        return array && array == size_of(function, right) && usage.written[array] == 0;
+    }
+
+    return false;
+}
+
+bool find_counted_loop(std::shared_ptr<mtac::Loop> loop, mtac::function_p function, CountedLoop& counted){
+    counted.header = find_header(loop);
+
+    counted.latch = nullptr;
+    counted.entry = nullptr;
+
+    for(auto& pred : counted.header->predecessors){
+        if(loop->blocks().count(pred)){
+            if(counted.latch){
+                return false;
+            }
+
+            counted.latch = pred;
+        } else {
+            if(counted.entry){
+                return false;
+            }
+
+            counted.entry = pred;
+        }
+    }
+
+    if(!counted.latch || !counted.entry){
+        return false;
+    }
+
+    auto if_ = last_if(counted.latch);
+    if(!if_ || if_->block != counted.header || !mtac::isVariable(if_->arg1)){
+        return false;
+    }
+
+    if(*if_->op != mtac::BinaryOperator::LESS && *if_->op != mtac::BinaryOperator::LESS_EQUALS){
+        return false;
+    }
+
+    counted.i = boost::get<std::shared_ptr<Variable>>(if_->arg1);
+    counted.limit = *if_->arg2;
+    counted.inclusive = *if_->op == mtac::BinaryOperator::LESS_EQUALS;
+
+    //A variable whose address is taken can be modified by a pointer
+    auto escaped = mtac::escape_analysis(function);
+    if(escaped->count(counted.i) || counted.i->position().isGlobal()){
+        return false;
+    }
+
+    auto basic_induction_variables = find_basic_induction_variables(loop);
+
+    auto it = basic_induction_variables.find(counted.i);
+    if(it == basic_induction_variables.end() || it->second.d <= 0){
+        return false;
+    }
+
+    counted.step = it->second.d;
+
+    //The induction variable must be incremented only at the end of the iteration
+    bool in_latch = false;
+    for(auto& statement : counted.latch->statements){
+        if(auto* ptr = boost::get<std::shared_ptr<mtac::Quadruple>>(&statement)){
+            in_latch |= *ptr == it->second.def;
+        }
+    }
+
+    if(!in_latch){
+        return false;
+    }
+
+    auto initial = get_initial_value(counted.entry, counted.i);
+    counted.initial_known = initial.first;
+    counted.initial = initial.second;
+
+    //The loop is guarded by "ifFalse i < limit goto exit"
+    counted.guarded = false;
+    if(!counted.entry->statements.empty()){
+        if(auto* ptr = boost::get<std::shared_ptr<mtac::IfFalse>>(&counted.entry->statements.back())){
+            auto guard = *ptr;
+            auto usage = compute_write_usage(loop);
+
+            if(guard->op && guard->arg2 && *guard->op == *if_->op && !loop->blocks().count(guard->block) && same_value(function, *guard->arg2, counted.limit, usage)){
+                if(mtac::equals(guard->arg1, counted.i)){
+                    counted.guarded = true;
+                } else if(counted.initial_known && mtac::equals<int>(guard->arg1, counted.initial)){
+                    counted.guarded = true;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+bool find_bounds_check(mtac::basic_block_p bb, CountedLoop& counted, BoundsCheck& check){
+    auto lower_if = last_if(bb);
+    if(!lower_if || *lower_if->op != mtac::BinaryOperator::LESS || !mtac::equals<int>(*lower_if->arg2, 0) || !is_bounds_error(lower_if->block)){
+        return false;
+    }
+
+    check.lower = bb;
+    check.upper = bb->next;
+    check.error = lower_if->block;
+
+    auto upper_if = last_if(check.upper);
+    if(!upper_if || *upper_if->op != mtac::BinaryOperator::LESS || check.upper->next != check.error || !mtac::isVariable(lower_if->arg1)){
+        return false;
+    }
+
+    check.index = boost::get<std::shared_ptr<Variable>>(lower_if->arg1);
+    check.size = *upper_if->arg2;
+
+    if(!mtac::equals(upper_if->arg1, check.index)){
+        return false;
+    }
+
+    //The index must not be modified between the two comparisons
+    for(auto& statement : check.upper->statements){
+        if(auto* ptr = boost::get<std::shared_ptr<mtac::Quadruple>>(&statement)){
+            if((*ptr)->result == check.index && mtac::erase_result((*ptr)->op)){
+                return false;
+            }
+        }
+    }
+
+    if(check.index == counted.i){
+        check.offset = 0;
+        return true;
+    }
+
+    //The index can be computed as i + offset just before the check
+    for(auto it = bb->statements.rbegin(); it != bb->statements.rend(); ++it){
+        if(auto* ptr = boost::get<std::shared_ptr<mtac::Quadruple>>(&*it)){
+            auto quadruple = *ptr;
+
+            if(quadruple->result == check.index && mtac::erase_result(quadruple->op)){
+                if(quadruple->op == mtac::Operator::ADD){
+                    if(mtac::equals(*quadruple->arg1, counted.i) && mtac::isInt(*quadruple->arg2)){
+                        check.offset = boost::get<int>(*quadruple->arg2);
+                        return true;
+                    } else if(mtac::equals(*quadruple->arg2, counted.i) && mtac::isInt(*quadruple->arg1)){
+                        check.offset = boost::get<int>(*quadruple->arg1);
+                        return true;
+                    }
+                } else if(quadruple->op == mtac::Operator::SUB){
+                    if(mtac::equals(*quadruple->arg1, counted.i) && mtac::isInt(*quadruple->arg2)){
+                        check.offset = -boost::get<int>(*quadruple->arg2);
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+        }
+    }
+
+    return false;
+}
+
+//The smallest index is initial + offset, the induction variable only grows
+bool lower_proven(CountedLoop& counted, BoundsCheck& check){
+    return counted.initial_known && counted.initial + check.offset >= 0;
+}
+
+//The greatest index is the greatest of initial + offset and limit + offset (minus one if the condition is strict)
+bool upper_proven(mtac::function_p function, CountedLoop& counted, BoundsCheck& check, Usage& usage){
+    int last = check.offset - (counted.inclusive ? 0 : 1);
+
+    if(mtac::isInt(counted.limit) && mtac::isInt(check.size)){
+        if(boost::get<int>(counted.limit) + last >= boost::get<int>(check.size)){
+            return false;
+        }
+    } else if(!same_value(function, counted.limit, check.size, usage) || last >= 0){
+        return false;
+    }
+
+    //If the initial value satisfies the condition, it is smaller than the limit
+    if(counted.guarded){
+        return true;
+    }
+
+    if(counted.initial_known){
+        if(mtac::isInt(counted.limit)){
+            int limit = boost::get<int>(counted.limit);
+
+            if(counted.initial < limit || (counted.inclusive && counted.initial == limit)){
+                return true;
+            }
+        }
+
+        if(mtac::isInt(check.size)){
+            return counted.initial + check.offset < boost::get<int>(check.size);
+        }
+    }
+
+    return false;
+}
+
+//The checks can be hoisted only if they fail exactly when one of the iterations would have failed
+bool can_hoist(std::shared_ptr<mtac::Loop> loop, CountedLoop& counted){
+    //With a step of one, all the values between the initial value and the limit are taken
+    if(counted.step != 1){
+        return false;
+    }
+
+    //The pre header must be entered by falling through
+    if(counted.entry != counted.header->prev){
+        return false;
+    }
+
+    if(!counted.entry->statements.empty()){
+        auto& last = counted.entry->statements.back();
+
+        if(boost::get<std::shared_ptr<mtac::Goto>>(&last)){
+            return false;
+        } else if(auto* ptr = boost::get<std::shared_ptr<mtac::If>>(&last)){
+            if((*ptr)->block == counted.header){
+                return false;
+            }
+        } else if(auto* ptr = boost::get<std::shared_ptr<mtac::IfFalse>>(&last)){
+            if((*ptr)->block == counted.header){
+                return false;
+            }
+        }
+    }
+
+    for(auto& bb : loop){
+        //The loop must do all its iterations
+        if(bb != counted.latch){
+            for(auto& succ : bb->successors){
+                if(!loop->blocks().count(succ)){
+                    return false;
+                }
+            }
+        }
+
+        //Failing earlier is only invisible if the loop has no side effect outside the memory
+        for(auto& statement : bb->statements){
+            if(auto* ptr = boost::get<std::shared_ptr<mtac::Call>>(&statement)){
+                if((*ptr)->function != "_bounds_error"){
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+//Return a value usable before the loop that is equal to the given argument in the loop
+boost::optional<mtac::Argument> value_before_loop(mtac::function_p function, mtac::Argument& arg, mtac::basic_block_p bb, Usage& usage){
+    if(mtac::isInt(arg)){
+        return arg;
+    }
+
+    if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&arg)){
+        auto var = *ptr;
+
+        if(usage.written[var] == 0 && !var->position().isGlobal() && !mtac::escape_analysis(function)->count(var)){
+            return arg;
+        }
+
+        //The size of the array can be loaded again
+        auto array = size_of(function, var);
+        if(array && usage.written[array] == 0){
+            auto size = function->context->new_temporary(INT);
+            bb->statements.push_back(make_node<mtac::Quadruple>(size, array, mtac::Operator::DOT, 0));
+            return mtac::Argument(size);
+        }
+    }
+
+    return boost::none;
+}
+
+bool hoist_bounds_check(std::shared_ptr<mtac::Loop> loop, mtac::function_p function, CountedLoop& counted, BoundsCheck& check, bool lower, bool upper, Usage& usage){
+    auto context = function->context;
+    auto depth = counted.entry->depth;
+
+    auto first = function->new_bb();
+    first->depth = depth;
+
+    boost::optional<mtac::Argument> size;
+    boost::optional<mtac::Argument> limit;
+
+    if(upper){
+        size = value_before_loop(function, check.size, first, usage);
+        limit = value_before_loop(function, counted.limit, first, usage);
+
+        if(!size || !limit){
+            return false;
+        }
+    }
+
+    //Before the loop, i holds its initial value
+    mtac::Argument low = counted.i;
+    if(check.offset != 0){
+        auto temp = context->new_temporary(INT);
+        first->statements.push_back(make_node<mtac::Quadruple>(temp, counted.i, mtac::Operator::ADD, check.offset));
+        low = temp;
+    }
+
+    //Each block jumps to the error block if its condition is not respected
+    std::vector<mtac::basic_block_p> blocks;
+
+    auto add_condition = [&](mtac::basic_block_p bb, mtac::BinaryOperator op, mtac::Argument arg1, mtac::Argument arg2){
+        bb->depth = depth;
+
+        auto if_ = make_node<mtac::If>(op, arg1, arg2, "");
+        if_->depth = depth;
+        bb->statements.push_back(if_);
+
+        blocks.push_back(bb);
+    };
+
+    if(lower){
+        add_condition(first, mtac::BinaryOperator::LESS, low, 0);
+    }
+
+    if(upper){
+        add_condition(blocks.empty() ? first : function->new_bb(), mtac::BinaryOperator::GREATER_EQUALS, low, *size);
+
+        auto bb = function->new_bb();
+
+        int last = check.offset - (counted.inclusive ? 0 : 1);
+
+        mtac::Argument high = *limit;
+        if(last != 0){
+            auto temp = context->new_temporary(INT);
+            bb->statements.push_back(make_node<mtac::Quadruple>(temp, *limit, mtac::Operator::ADD, last));
+            high = temp;
+        }
+
+        add_condition(bb, mtac::BinaryOperator::GREATER_EQUALS, high, *size);
+    }
+
+    auto error = function->new_bb();
+    error->depth = depth;
+    error->statements.push_back(mtac::copy(check.error->statements.front(), context->global()));
+
+    for(auto& bb : blocks){
+        boost::get<std::shared_ptr<mtac::If>>(bb->statements.back())->block = error;
+    }
+
+    //The empty pre header is where the checks succeed
+    auto pre_header = create_pre_header(loop, function);
+
+    auto goto_ = make_node<mtac::Goto>();
+    goto_->block = pre_header;
+    goto_->depth = depth;
+    blocks.back()->statements.push_back(goto_);
+
+    mtac::remove_edge(counted.entry, pre_header);
+    mtac::make_edge(counted.entry, blocks.front());
+
+    for(auto& bb : blocks){
+        function->insert_before(function->at(pre_header), bb);
+
+        mtac::make_edge(bb, error);
+    }
+
+    function->insert_before(function->at(pre_header), error);
+
+    for(std::size_t i = 0; i + 1 < blocks.size(); ++i){
+        mtac::make_edge(blocks[i], blocks[i + 1]);
+    }
+
+    mtac::make_edge(blocks.back(), pre_header);
+    mtac::make_edge(error, pre_header);
+
+    return true;
+}
+
+void remove_lower_check(BoundsCheck& check){
+    check.lower->statements.back() = make_node<mtac::NoOp>();
+    mtac::remove_edge(check.lower, check.error);
+}
+
+void remove_upper_check(BoundsCheck& check){
+    auto if_ = boost::get<std::shared_ptr<mtac::If>>(check.upper->statements.back());
+
+    auto goto_ = make_node<mtac::Goto>();
+    goto_->label = if_->label;
+    goto_->block = if_->block;
+    goto_->depth = if_->depth;
+
+    check.upper->statements.back() = goto_;
+    mtac::remove_edge(check.upper, check.error);
+}
+
+bool bounds_check_elimination(std::shared_ptr<mtac::Loop> loop, mtac::function_p function, bool& hoisted){
+    CountedLoop counted;
+    if(!find_counted_loop(loop, function, counted)){
+        return false;
+    }
+
+    auto usage = compute_write_usage(loop);
+    bool hoistable = !hoisted && can_hoist(loop, counted);
+
+    bool optimized = false;
+
+    for(auto& bb : loop){
+        BoundsCheck check;
+        if(!find_bounds_check(bb, counted, check)){
+            continue;
+        }
+
+        bool lower = lower_proven(counted, check);
+        bool upper = upper_proven(function, counted, check, usage);
+
+        if(!lower || !upper){
+            //The check must be executed at each iteration to be hoisted
+            if(!hoistable || hoisted || !dominates(check.lower, counted.latch)){
+                if(lower){
+                    remove_lower_check(check);
+                    optimized = true;
+                } else if(upper){
+                    remove_upper_check(check);
+                    optimized = true;
+                }
+
+                continue;
+            }
+
+            //The blocks are changed, the other checks will be handled in the next pass
+            if(!hoist_bounds_check(loop, function, counted, check, !lower, !upper, usage)){
+                continue;
+            }
+
+            hoisted = true;
+        }
+
+        remove_lower_check(check);
+        remove_upper_check(check);
+
+        optimized = true;
+    }
+
+    return optimized;
+}
+
+} //end of anonymous namespace
+
+bool mtac::bounds_check_elimination::operator()(mtac::function_p function){
+    if(!function->bounds_check){
+        return false;
+    }
+
+    mtac::loop_analysis()(function);
+
+    if(function->loops().empty()){
+        return false;
+    }
+
+    bool optimized = false;
+    bool hoisted = false;
+
+    for(auto& loop : function->loops()){
+        optimized |= ::bounds_check_elimination(loop, function, hoisted);
+
+        //The loops are not valid anymore after a hoisting
+        if(hoisted){
+            break;
+        }
+    }
+
+    return optimized;
+}
@@ -0,0 +1,662 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#include <unordered_set>
+#include <utility>
+
+#include "assert.hpp"
+#include "arena.hpp"
+#include "Variable.hpp"
+#include "Type.hpp"
+#include "logging.hpp"
+
+#include "mtac/sccp.hpp"
+#include "mtac/ssa.hpp"
+#include "mtac/Phi.hpp"
+#include "mtac/Function.hpp"
+#include "mtac/ControlFlowGraph.hpp"
+#include "mtac/Statement.hpp"
+#include "mtac/Utils.hpp"
+
+using namespace eddic;
+
+namespace {
+
+typedef boost::variant<int, double, std::string> Constant;
+
+enum class LatticeState : char {
+    TOP,        //Not yet known
+    CONSTANT,
+    BOTTOM      //Not a constant
+};
+
+struct Lattice {
+    LatticeState state = LatticeState::TOP;
+    Constant value;
+
+    Lattice(){}
+    Lattice(LatticeState state) : state(state) {}
+    Lattice(Constant value) : state(LatticeState::CONSTANT), value(value) {}
+
+    bool operator!=(const Lattice& rhs) const {
+        return state != rhs.state || (state == LatticeState::CONSTANT && !(value == rhs.value));
+    }
+};
+
+Lattice meet(const Lattice& lhs, const Lattice& rhs){
+    if(lhs.state == LatticeState::TOP){
+        return rhs;
+    } else if(rhs.state == LatticeState::TOP){
+        return lhs;
+    } else if(lhs.state == LatticeState::BOTTOM || rhs.state == LatticeState::BOTTOM){
+        return {LatticeState::BOTTOM};
+    } else if(lhs.value == rhs.value){
+        return lhs;
+    } else {
+        return {LatticeState::BOTTOM};
+    }
+}
+
+Lattice fold_int(mtac::Operator op, int lhs, int rhs){
+    switch(op){
+        case mtac::Operator::ADD:
+            return {lhs + rhs};
+        case mtac::Operator::SUB:
+            return {lhs - rhs};
+        case mtac::Operator::MUL:
+            return {lhs * rhs};
+        case mtac::Operator::DIV:
+            return rhs == 0 ? Lattice(LatticeState::BOTTOM) : Lattice(lhs / rhs);
+        case mtac::Operator::MOD:
+            return rhs == 0 ? Lattice(LatticeState::BOTTOM) : Lattice(lhs % rhs);
+        case mtac::Operator::GREATER:
+            return {static_cast<int>(lhs > rhs)};
+        case mtac::Operator::GREATER_EQUALS:
+            return {static_cast<int>(lhs >= rhs)};
+        case mtac::Operator::LESS:
+            return {static_cast<int>(lhs < rhs)};
+        case mtac::Operator::LESS_EQUALS:
+            return {static_cast<int>(lhs <= rhs)};
+        case mtac::Operator::EQUALS:
+            return {static_cast<int>(lhs == rhs)};
+        case mtac::Operator::NOT_EQUALS:
+            return {static_cast<int>(lhs != rhs)};
+        default:
+            return {LatticeState::BOTTOM};
+    }
+}
+
+Lattice fold_float(mtac::Operator op, double lhs, double rhs){
+    switch(op){
+        case mtac::Operator::FADD:
+            return {lhs + rhs};
+        case mtac::Operator::FSUB:
+            return {lhs - rhs};
+        case mtac::Operator::FMUL:
+            return {lhs * rhs};
+        case mtac::Operator::FDIV:
+            return {lhs / rhs};
+        case mtac::Operator::FG:
+            return {static_cast<int>(lhs > rhs)};
+        case mtac::Operator::FGE:
+            return {static_cast<int>(lhs >= rhs)};
+        case mtac::Operator::FL:
+            return {static_cast<int>(lhs < rhs)};
+        case mtac::Operator::FLE:
+            return {static_cast<int>(lhs <= rhs)};
+        case mtac::Operator::FE:
+            return {static_cast<int>(lhs == rhs)};
+        case mtac::Operator::FNE:
+            return {static_cast<int>(lhs != rhs)};
+        default:
+            return {LatticeState::BOTTOM};
+    }
+}
+
+bool compare_int(mtac::BinaryOperator op, int lhs, int rhs){
+    switch(op){
+        case mtac::BinaryOperator::EQUALS:
+            return lhs == rhs;
+        case mtac::BinaryOperator::NOT_EQUALS:
+            return lhs != rhs;
+        case mtac::BinaryOperator::LESS:
+            return lhs < rhs;
+        case mtac::BinaryOperator::LESS_EQUALS:
+            return lhs <= rhs;
+        case mtac::BinaryOperator::GREATER:
+            return lhs > rhs;
+        case mtac::BinaryOperator::GREATER_EQUALS:
+            return lhs >= rhs;
+        default:
+            eddic_unreachable("Unhandled operator");
+    }
+}
+
+bool compare_float(mtac::BinaryOperator op, double lhs, double rhs){
+    switch(op){
+        case mtac::BinaryOperator::FE:
+            return lhs == rhs;
+        case mtac::BinaryOperator::FNE:
+            return lhs != rhs;
+        case mtac::BinaryOperator::FL:
+            return lhs < rhs;
+        case mtac::BinaryOperator::FLE:
+            return lhs <= rhs;
+        case mtac::BinaryOperator::FG:
+            return lhs > rhs;
+        case mtac::BinaryOperator::FGE:
+            return lhs >= rhs;
+        default:
+            eddic_unreachable("Unhandled operator");
+    }
+}
+
+//A statement or a phi function using a SSA variable
+struct UseSite {
+    mtac::basic_block_p block;
+    std::size_t statement;
+    std::shared_ptr<mtac::Phi> phi;
+};
+
+typedef std::pair<mtac::basic_block_p, mtac::basic_block_p> Edge;
+
+struct EdgeHash {
+    std::size_t operator()(const Edge& edge) const {
+        std::hash<mtac::basic_block_p> hasher;
+        return hasher(edge.first) * 31 + hasher(edge.second);
+    }
+};
+
+struct SCCPSolver {
+    mtac::function_p function;
+    const mtac::SSAVersions& versions;
+
+    std::unordered_map<std::shared_ptr<Variable>, Lattice> values;
+    std::unordered_map<std::shared_ptr<Variable>, std::vector<UseSite>> uses;
+
+    std::unordered_set<mtac::basic_block_p> executable;
+    std::unordered_set<Edge, EdgeHash> executable_edges;
+
+    std::vector<Edge> cfg_work_list;
+    std::vector<std::shared_ptr<Variable>> ssa_work_list;
+
+    SCCPSolver(mtac::function_p function, const mtac::SSAVersions& versions) : function(function), versions(versions) {}
+
+    /* Def-use chains of the SSA variables */
+
+    void add_use(const mtac::Argument& arg, UseSite site){
+        if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&arg)){
+            if(versions.count(*ptr)){
+                uses[*ptr].push_back(site);
+            }
+        }
+    }
+
+    void add_use(const boost::optional<mtac::Argument>& arg, UseSite site){
+        if(arg){
+            add_use(*arg, site);
+        }
+    }
+
+    void collect_uses(){
+        for(auto& block : function){
+            for(auto& phi : block->phis){
+                for(auto& arg : phi->args){
+                    add_use(arg, {block, 0, phi});
+                }
+            }
+
+            for(std::size_t i = 0; i < block->statements.size(); ++i){
+                auto& statement = block->statements[i];
+                UseSite site = {block, i, nullptr};
+
+                if(auto* ptr = boost::get<std::shared_ptr<mtac::Quadruple>>(&statement)){
+                    add_use((*ptr)->arg1, site);
+                    add_use((*ptr)->arg2, site);
+                } else if(auto* ptr = boost::get<std::shared_ptr<mtac::If>>(&statement)){
+                    add_use((*ptr)->arg1, site);
+                    add_use((*ptr)->arg2, site);
+                } else if(auto* ptr = boost::get<std::shared_ptr<mtac::IfFalse>>(&statement)){
+                    add_use((*ptr)->arg1, site);
+                    add_use((*ptr)->arg2, site);
+                }
+            }
+        }
+    }
+
+    /* Lattice values */
+
+    Lattice value(const mtac::Argument& arg){
+        if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&arg)){
+            //Only the SSA variables have a single reaching definition
+            if(versions.count(*ptr)){
+                return values[*ptr];
+            }
+
+            return {LatticeState::BOTTOM};
+        } else if(auto* ptr = boost::get<int>(&arg)){
+            return {*ptr};
+        } else if(auto* ptr = boost::get<double>(&arg)){
+            return {*ptr};
+        } else if(auto* ptr = boost::get<std::string>(&arg)){
+            return {*ptr};
+        }
+
+        return {LatticeState::BOTTOM};
+    }
+
+    void update(std::shared_ptr<Variable> variable, const Lattice& computed){
+        auto& current = values[variable];
+        auto lowered = meet(current, computed);
+
+        if(current != lowered){
+            current = lowered;
+            ssa_work_list.push_back(variable);
+        }
+    }
+
+    Lattice evaluate(std::shared_ptr<mtac::Quadruple> quadruple){
+        auto op = quadruple->op;
+
+        if(op == mtac::Operator::ASSIGN || op == mtac::Operator::FASSIGN){
+            return value(*quadruple->arg1);
+        }
+
+        if(!quadruple->arg1){
+            return {LatticeState::BOTTOM};
+        }
+
+        auto lhs = value(*quadruple->arg1);
+
+        if(op == mtac::Operator::MINUS || op == mtac::Operator::NOT || op == mtac::Operator::I2F
+                || op == mtac::Operator::FMINUS || op == mtac::Operator::F2I){
+            if(lhs.state != LatticeState::CONSTANT){
+                return lhs;
+            }
+
+            if(auto* ptr = boost::get<int>(&lhs.value)){
+                if(op == mtac::Operator::MINUS){
+                    return {-1 * *ptr};
+                } else if(op == mtac::Operator::NOT){
+                    return {*ptr == 0 ? 1 : 0};
+                } else if(op == mtac::Operator::I2F){
+                    return {static_cast<double>(static_cast<float>(*ptr))};
+                }
+            } else if(auto* ptr = boost::get<double>(&lhs.value)){
+                if(op == mtac::Operator::FMINUS){
+                    return {-1 * *ptr};
+                } else if(op == mtac::Operator::F2I){
+                    return {static_cast<int>(*ptr)};
+                }
+            }
+
+            return {LatticeState::BOTTOM};
+        }
+
+        if(!quadruple->arg2){
+            return {LatticeState::BOTTOM};
+        }
+
+        auto rhs = value(*quadruple->arg2);
+
+        if(lhs.state == LatticeState::BOTTOM || rhs.state == LatticeState::BOTTOM){
+            return {LatticeState::BOTTOM};
+        } else if(lhs.state == LatticeState::TOP || rhs.state == LatticeState::TOP){
+            return {LatticeState::TOP};
+        }
+
+        if(boost::get<int>(&lhs.value) && boost::get<int>(&rhs.value)){
+            return fold_int(op, boost::get<int>(lhs.value), boost::get<int>(rhs.value));
+        } else if(boost::get<double>(&lhs.value) && boost::get<double>(&rhs.value)){
+            return fold_float(op, boost::get<double>(lhs.value), boost::get<double>(rhs.value));
+        }
+
+        return {LatticeState::BOTTOM};
+    }
+
+    /*!
+     * Evaluate the condition of a branch.
+     * \return TOP if not known yet, BOTTOM if it is not a constant and the int value otherwise.
+     */
+    template<typename Branch>
+    Lattice condition(std::shared_ptr<Branch> branch){
+        auto lhs = value(branch->arg1);
+
+        if(!branch->op){
+            if(lhs.state == LatticeState::CONSTANT && !boost::get<int>(&lhs.value)){
+                return {LatticeState::BOTTOM};
+            }
+
+            return lhs;
+        }
+
+        auto rhs = value(*branch->arg2);
+
+        if(lhs.state == LatticeState::BOTTOM || rhs.state == LatticeState::BOTTOM){
+            return {LatticeState::BOTTOM};
+        } else if(lhs.state == LatticeState::TOP || rhs.state == LatticeState::TOP){
+            return {LatticeState::TOP};
+        }
+
+        if(boost::get<int>(&lhs.value) && boost::get<int>(&rhs.value)){
+            return {static_cast<int>(compare_int(*branch->op, boost::get<int>(lhs.value), boost::get<int>(rhs.value)))};
+        } else if(boost::get<double>(&lhs.value) && boost::get<double>(&rhs.value)){
+            return {static_cast<int>(compare_float(*branch->op, boost::get<double>(lhs.value), boost::get<double>(rhs.value)))};
+        }
+
+        return {LatticeState::BOTTOM};
+    }
+
+    /* Propagation */
+
+    void add_edge(mtac::basic_block_p from, mtac::basic_block_p to){
+        if(to && !executable_edges.count(std::make_pair(from, to))){
+            cfg_work_list.emplace_back(from, to);
+        }
+    }
+
+    void add_successors(mtac::basic_block_p block){
+        for(auto& successor : block->successors){
+            add_edge(block, successor);
+        }
+    }
+
+    //jump is the block reached when the condition is true
+    void visit_branch(mtac::basic_block_p block, const Lattice& condition, bool jump_if_true, mtac::basic_block_p target){
+        if(condition.state == LatticeState::BOTTOM){
+            add_successors(block);
+        } else if(condition.state == LatticeState::CONSTANT){
+            bool value = boost::get<int>(condition.value);
+
+            if(value == jump_if_true){
+                add_edge(block, target);
+            } else {
+                add_edge(block, block->next);
+            }
+        }
+    }
+
+    void visit_statement(mtac::basic_block_p block, std::size_t index){
+        auto& statement = block->statements[index];
+
+        if(auto* ptr = boost::get<std::shared_ptr<mtac::Quadruple>>(&statement)){
+            auto& quadruple = *ptr;
+
+            if(quadruple->result && mtac::erase_result(quadruple->op) && versions.count(quadruple->result)){
+                update(quadruple->result, evaluate(quadruple));
+            }
+        } else if(auto* ptr = boost::get<std::shared_ptr<mtac::If>>(&statement)){
+            visit_branch(block, condition(*ptr), true, (*ptr)->block);
+        } else if(auto* ptr = boost::get<std::shared_ptr<mtac::IfFalse>>(&statement)){
+            visit_branch(block, condition(*ptr), false, (*ptr)->block);
+        }
+    }
+
+    void visit_phi(mtac::basic_block_p block, std::shared_ptr<mtac::Phi> phi){
+        Lattice result;
+
+        for(std::size_t i = 0; i < block->predecessors.size(); ++i){
+            if(executable_edges.count(std::make_pair(block->predecessors[i], block))){
+                result = meet(result, value(phi->args[i]));
+            }
+        }
+
+        update(phi->result, result);
+    }
+
+    bool ends_with_branch(mtac::basic_block_p block){
+        if(block->statements.empty()){
+            return false;
+        }
+
+        auto& last = block->statements.back();
+
+        return boost::get<std::shared_ptr<mtac::If>>(&last) || boost::get<std::shared_ptr<mtac::IfFalse>>(&last);
+    }
+
+    void solve(){
+        collect_uses();
+
+        auto entry = function->entry_bb();
+        executable.insert(entry);
+        add_successors(entry);
+
+        while(!cfg_work_list.empty() || !ssa_work_list.empty()){
+            while(!cfg_work_list.empty()){
+                auto edge = cfg_work_list.back();
+                cfg_work_list.pop_back();
+
+                if(!executable_edges.insert(edge).second){
+                    continue;
+                }
+
+                auto block = edge.second;
+
+                //A new incoming edge can change the phi functions
+                for(auto& phi : block->phis){
+                    visit_phi(block, phi);
+                }
+
+                //The statements are visited only once, when the block becomes executable
+                if(executable.insert(block).second){
+                    for(std::size_t i = 0; i < block->statements.size(); ++i){
+                        visit_statement(block, i);
+                    }
+
+                    if(!ends_with_branch(block)){
+                        add_successors(block);
+                    }
+                }
+            }
+
+            while(!ssa_work_list.empty()){
+                auto variable = ssa_work_list.back();
+                ssa_work_list.pop_back();
+
+                for(auto& site : uses[variable]){
+                    if(!executable.count(site.block)){
+                        continue;
+                    }
+
+                    if(site.phi){
+                        visit_phi(site.block, site.phi);
+                    } else {
+                        visit_statement(site.block, site.statement);
+                    }
+                }
+            }
+        }
+    }
+
+    /* Transformation */
+
+    bool replace(mtac::Argument& arg, bool only_labels = false){
+        if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&arg)){
+            if(versions.count(*ptr)){
+                auto& lattice = values[*ptr];
+
+                if(lattice.state == LatticeState::CONSTANT){
+                    if(only_labels && !boost::get<std::string>(&lattice.value)){
+                        return false;
+                    }
+
+                    if(auto* int_ptr = boost::get<int>(&lattice.value)){
+                        arg = *int_ptr;
+                    } else if(auto* float_ptr = boost::get<double>(&lattice.value)){
+                        arg = *float_ptr;
+                    } else {
+                        arg = boost::get<std::string>(lattice.value);
+                    }
+
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    bool is_string(mtac::Argument& arg){
+        auto* ptr = boost::get<std::shared_ptr<Variable>>(&arg);
+        return ptr && (*ptr)->type() == STRING;
+    }
+
+    bool replace(boost::optional<mtac::Argument>& arg){
+        if(arg){
+            return replace(*arg);
+        }
+
+        return false;
+    }
+
+    bool replace(std::shared_ptr<mtac::Quadruple> quadruple){
+        bool changes = false;
+        auto op = quadruple->op;
+
+        //The statements whose value is known are replaced by an assignment of the constant
+        if(quadruple->result && mtac::erase_result(op) && op != mtac::Operator::ASSIGN && op != mtac::Operator::FASSIGN && versions.count(quadruple->result)){
+            auto& lattice = values[quadruple->result];
+
+            if(lattice.state == LatticeState::CONSTANT){
+                if(auto* ptr = boost::get<int>(&lattice.value)){
+                    quadruple->op = mtac::Operator::ASSIGN;
+                    quadruple->arg1 = *ptr;
+                    quadruple->arg2.reset();
+
+                    return true;
+                } else if(auto* ptr = boost::get<double>(&lattice.value)){
+                    quadruple->op = mtac::Operator::FASSIGN;
+                    quadruple->arg1 = *ptr;
+                    quadruple->arg2.reset();
+
+                    return true;
+                }
+            }
+        }
+
+        //Same restrictions than the constant propagation: no constant in the offset operators
+        if(op == mtac::Operator::DOT){
+            //The label of a string variable cannot be used to access its length
+            if(quadruple->arg1 && !is_string(*quadruple->arg1)){
+                changes |= replace(*quadruple->arg1, true);
+            }
+        } else if(op != mtac::Operator::PDOT && op != mtac::Operator::PASSIGN){
+            changes |= replace(quadruple->arg1);
+        }
+
+        if(op != mtac::Operator::DOT_PASSIGN){
+            changes |= replace(quadruple->arg2);
+        }
+
+        return changes;
+    }
+
+    template<typename Branch>
+    bool fold_branch(mtac::basic_block_p block, mtac::Statement& statement, std::shared_ptr<Branch> branch, bool jump_if_true){
+        auto known = condition(branch);
+
+        if(known.state != LatticeState::CONSTANT){
+            return false;
+        }
+
+        bool value = boost::get<int>(known.value);
+
+        if(value == jump_if_true){
+            auto goto_ = make_node<mtac::Goto>();
+
+            goto_->label = branch->label;
+            goto_->block = branch->block;
+
+            statement = goto_;
+
+            if(block->next != branch->block){
+                mtac::remove_edge(block, block->next);
+            }
+        } else {
+            statement = make_node<mtac::NoOp>();
+
+            if(block->next != branch->block){
+                mtac::remove_edge(block, branch->block);
+            }
+        }
+
+        return true;
+    }
+
+    bool transform(){
+        bool optimized = false;
+
+        for(auto& block : function){
+            //The values are not meaningful in the blocks that can never be executed
+            if(!executable.count(block)){
+                continue;
+            }
+
+            for(auto& statement : block->statements){
+                if(auto* ptr = boost::get<std::shared_ptr<mtac::Quadruple>>(&statement)){
+                    optimized |= replace(*ptr);
+                } else if(auto* ptr = boost::get<std::shared_ptr<mtac::Param>>(&statement)){
+                    if(!(*ptr)->address){
+                        optimized |= replace((*ptr)->arg);
+                    }
+                } else if(auto* ptr = boost::get<std::shared_ptr<mtac::If>>(&statement)){
+                    optimized |= replace((*ptr)->arg1);
+                    optimized |= replace((*ptr)->arg2);
+                } else if(auto* ptr = boost::get<std::shared_ptr<mtac::IfFalse>>(&statement)){
+                    optimized |= replace((*ptr)->arg1);
+                    optimized |= replace((*ptr)->arg2);
+                }
+            }
+        }
+
+        return optimized;
+    }
+
+    //Must be done out of SSA, the removal of the edges would invalidate the phi functions
+    bool fold_branches(){
+        bool optimized = false;
+
+        for(auto& block : function){
+            if(!executable.count(block) || block->statements.empty()){
+                continue;
+            }
+
+            auto& statement = block->statements.back();
+
+            if(auto* ptr = boost::get<std::shared_ptr<mtac::If>>(&statement)){
+                optimized |= fold_branch(block, statement, *ptr, true);
+            } else if(auto* ptr = boost::get<std::shared_ptr<mtac::IfFalse>>(&statement)){
+                optimized |= fold_branch(block, statement, *ptr, false);
+            }
+        }
+
+        return optimized;
+    }
+};
+
+} //end of anonymous namespace
+
+bool mtac::sparse_conditional_constant_propagation::operator()(mtac::function_p function){
+    auto versions = mtac::build_ssa(function);
+
+    SCCPSolver solver(function, versions);
+    solver.solve();
+
+    bool optimized = solver.transform();
+
+    //Only uses have been replaced, the versions of a variable still do not interfere
+    mtac::revert_ssa(function, versions);
+
+    //The conditions only contain constants at this point
+    optimized |= solver.fold_branches();
+
+    if(log::enabled<Debug>()){
+        log::emit<Debug>("SCCP") << function->getName() << ": " << solver.executable.size() << "/" << function->bb_count() << " executable blocks" << log::endl;
+    }
+
+    return optimized;
+}
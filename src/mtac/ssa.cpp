@@ -0,0 +1,478 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#include <unordered_set>
+#include <utility>
+
+#include "FunctionContext.hpp"
+#include "arena.hpp"
+#include "Variable.hpp"
+#include "Type.hpp"
+#include "PerfsTimer.hpp"
+#include "logging.hpp"
+
+#include "mtac/ssa.hpp"
+#include "mtac/Phi.hpp"
+#include "mtac/Function.hpp"
+#include "mtac/Statement.hpp"
+#include "mtac/Utils.hpp"
+#include "mtac/EscapeAnalysis.hpp"
+#include "mtac/dominators.hpp"
+
+using namespace eddic;
+
+namespace {
+
+bool is_reachable(mtac::function_p function, mtac::basic_block_p block){
+    return block == function->entry_bb() || block->dominator;
+}
+
+typedef std::unordered_map<std::shared_ptr<Variable>, std::vector<std::shared_ptr<Variable>>> VersionStacks;
+
+struct SSABuilder {
+    mtac::function_p function;
+    mtac::EscapedVariables escaped;
+
+    std::vector<std::shared_ptr<Variable>> variables;   //The renamed variables in order of appearance
+    std::unordered_set<std::shared_ptr<Variable>> rejected;
+
+    std::unordered_map<std::shared_ptr<Variable>, std::vector<mtac::basic_block_p>> definitions;
+    std::unordered_set<std::shared_ptr<Variable>> upward_exposed;
+
+    VersionStacks stacks;
+    mtac::SSAVersions versions;
+
+    SSABuilder(mtac::function_p function) : function(function), escaped(mtac::escape_analysis(function)) {}
+
+    bool is_candidate(std::shared_ptr<Variable> variable){
+        if(rejected.count(variable)){
+            return false;
+        }
+
+        if(stacks.count(variable)){
+            return true;
+        }
+
+        auto position = variable->position();
+        auto type = variable->type();
+
+        if((position.is_temporary() || position.is_variable() || position.isStack())
+                && (mtac::is_single_int_register(type) || mtac::is_single_float_register(type) || type == STRING)
+                && !escaped->count(variable)){
+            variables.push_back(variable);
+            stacks[variable].push_back(variable);
+            return true;
+        }
+
+        rejected.insert(variable);
+        return false;
+    }
+
+    void reject(std::shared_ptr<Variable> variable){
+        if(variable){
+            rejected.insert(variable);
+        }
+    }
+
+    /* Collection of the variables, their definitions and the upward exposed uses */
+
+    void use(const mtac::Argument& arg, std::unordered_set<std::shared_ptr<Variable>>& killed){
+        if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&arg)){
+            if(!killed.count(*ptr)){
+                upward_exposed.insert(*ptr);
+            }
+        }
+    }
+
+    void use(const boost::optional<mtac::Argument>& arg, std::unordered_set<std::shared_ptr<Variable>>& killed){
+        if(arg){
+            use(*arg, killed);
+        }
+    }
+
+    void collect(){
+        //The values returned by a call are never renamed
+        for(auto& block : function){
+            for(auto& statement : block->statements){
+                if(auto* ptr = boost::get<std::shared_ptr<mtac::Call>>(&statement)){
+                    reject((*ptr)->return_);
+                    reject((*ptr)->return2_);
+                }
+            }
+        }
+
+        for(auto& block : function){
+            std::unordered_set<std::shared_ptr<Variable>> killed;
+
+            for(auto& statement : block->statements){
+                if(auto* ptr = boost::get<std::shared_ptr<mtac::Quadruple>>(&statement)){
+                    auto& quadruple = *ptr;
+
+                    use(quadruple->arg1, killed);
+                    use(quadruple->arg2, killed);
+
+                    if(quadruple->result){
+                        if(mtac::erase_result(quadruple->op)){
+                            if(is_candidate(quadruple->result)){
+                                auto& blocks = definitions[quadruple->result];
+                                if(blocks.empty() || blocks.back() != block){
+                                    blocks.push_back(block);
+                                }
+
+                                killed.insert(quadruple->result);
+                            }
+                        } else {
+                            use(quadruple->result, killed);
+                        }
+                    }
+                } else if(auto* ptr = boost::get<std::shared_ptr<mtac::Param>>(&statement)){
+                    use((*ptr)->arg, killed);
+                } else if(auto* ptr = boost::get<std::shared_ptr<mtac::If>>(&statement)){
+                    use((*ptr)->arg1, killed);
+                    use((*ptr)->arg2, killed);
+                } else if(auto* ptr = boost::get<std::shared_ptr<mtac::IfFalse>>(&statement)){
+                    use((*ptr)->arg1, killed);
+                    use((*ptr)->arg2, killed);
+                }
+            }
+        }
+    }
+
+    /* Placement of the phi functions */
+
+    void place_phis(mtac::DominanceFrontiers& frontiers){
+        for(auto& variable : variables){
+            //A variable that is never live across blocks does not need any phi function
+            if(!upward_exposed.count(variable)){
+                continue;
+            }
+
+            auto work_list = definitions[variable];
+            std::unordered_set<mtac::basic_block_p> defined(work_list.begin(), work_list.end());
+            std::unordered_set<mtac::basic_block_p> has_phi;
+
+            while(!work_list.empty()){
+                auto block = work_list.back();
+                work_list.pop_back();
+
+                for(auto& frontier : frontiers[block]){
+                    if(frontier == function->exit_bb() || has_phi.count(frontier)){
+                        continue;
+                    }
+
+                    frontier->phis.push_back(std::make_shared<mtac::Phi>(variable, frontier->predecessors.size()));
+                    has_phi.insert(frontier);
+
+                    if(defined.insert(frontier).second){
+                        work_list.push_back(frontier);
+                    }
+                }
+            }
+        }
+    }
+
+    /* Renaming of the variables */
+
+    void rename(mtac::Argument& arg){
+        if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&arg)){
+            auto it = stacks.find(*ptr);
+            if(it != stacks.end()){
+                arg = it->second.back();
+            }
+        }
+    }
+
+    void rename(boost::optional<mtac::Argument>& arg){
+        if(arg){
+            rename(*arg);
+        }
+    }
+
+    void rename(std::shared_ptr<Variable>& variable){
+        auto it = stacks.find(variable);
+        if(it != stacks.end()){
+            variable = it->second.back();
+        }
+    }
+
+    void define(std::shared_ptr<Variable>& variable, std::vector<std::shared_ptr<Variable>>& pushed){
+        auto it = stacks.find(variable);
+        if(it != stacks.end()){
+            auto version = function->context->newVariable(variable);
+            versions[version] = variable;
+            it->second.push_back(version);
+            pushed.push_back(variable);
+            variable = version;
+        }
+    }
+
+    void rename(mtac::basic_block_p block, std::vector<std::shared_ptr<Variable>>& pushed){
+        for(auto& phi : block->phis){
+            define(phi->result, pushed);
+        }
+
+        for(auto& statement : block->statements){
+            if(auto* ptr = boost::get<std::shared_ptr<mtac::Quadruple>>(&statement)){
+                auto& quadruple = *ptr;
+
+                rename(quadruple->arg1);
+                rename(quadruple->arg2);
+
+                if(quadruple->result){
+                    if(mtac::erase_result(quadruple->op)){
+                        define(quadruple->result, pushed);
+                    } else {
+                        rename(quadruple->result);
+                    }
+                }
+            } else if(auto* ptr = boost::get<std::shared_ptr<mtac::Param>>(&statement)){
+                rename((*ptr)->arg);
+            } else if(auto* ptr = boost::get<std::shared_ptr<mtac::If>>(&statement)){
+                rename((*ptr)->arg1);
+                rename((*ptr)->arg2);
+            } else if(auto* ptr = boost::get<std::shared_ptr<mtac::IfFalse>>(&statement)){
+                rename((*ptr)->arg1);
+                rename((*ptr)->arg2);
+            }
+        }
+
+        for(auto& successor : block->successors){
+            for(std::size_t i = 0; i < successor->predecessors.size(); ++i){
+                if(successor->predecessors[i] == block){
+                    for(auto& phi : successor->phis){
+                        phi->args[i] = stacks[phi->variable].back();
+                    }
+                }
+            }
+        }
+    }
+
+    void rename(){
+        std::unordered_map<mtac::basic_block_p, std::vector<mtac::basic_block_p>> children;
+
+        for(auto& block : function){
+            if(block->dominator){
+                children[block->dominator].push_back(block);
+            }
+        }
+
+        //Walk the dominator tree without recursion, the versions pushed by a block are popped once all its children are renamed
+        std::vector<std::pair<mtac::basic_block_p, bool>> stack;
+        std::unordered_map<mtac::basic_block_p, std::vector<std::shared_ptr<Variable>>> pushed;
+
+        stack.emplace_back(function->entry_bb(), false);
+
+        while(!stack.empty()){
+            auto block = stack.back().first;
+            auto leaving = stack.back().second;
+            stack.pop_back();
+
+            if(leaving){
+                for(auto& variable : pushed[block]){
+                    stacks[variable].pop_back();
+                }
+
+                pushed.erase(block);
+            } else {
+                rename(block, pushed[block]);
+
+                stack.emplace_back(block, true);
+
+                for(auto& child : children[block]){
+                    stack.emplace_back(child, false);
+                }
+            }
+        }
+    }
+};
+
+} //end of anonymous namespace
+
+mtac::DominanceFrontiers mtac::dominance_frontiers(mtac::function_p function){
+    mtac::DominanceFrontiers frontiers;
+
+    for(auto& block : function){
+        if(!is_reachable(function, block)){
+            continue;
+        }
+
+        std::vector<mtac::basic_block_p> predecessors;
+        for(auto& predecessor : block->predecessors){
+            if(is_reachable(function, predecessor)){
+                predecessors.push_back(predecessor);
+            }
+        }
+
+        if(predecessors.size() < 2){
+            continue;
+        }
+
+        for(auto& predecessor : predecessors){
+            auto runner = predecessor;
+
+            while(runner && runner != block->dominator){
+                auto& frontier = frontiers[runner];
+
+                if(frontier.empty() || frontier.back() != block){
+                    frontier.push_back(block);
+                }
+
+                runner = runner->dominator;
+            }
+        }
+    }
+
+    return frontiers;
+}
+
+mtac::SSAVersions mtac::build_ssa(mtac::function_p function){
+    PerfsTimer timer("SSA construction");
+
+    mtac::compute_dominators(function);
+
+    auto frontiers = mtac::dominance_frontiers(function);
+
+    SSABuilder builder(function);
+    builder.collect();
+    builder.place_phis(frontiers);
+    builder.rename();
+
+    if(log::enabled<Debug>()){
+        std::size_t phis = 0;
+        for(auto& block : function){
+            phis += block->phis.size();
+        }
+
+        log::emit<Debug>("SSA") << function->getName() << ": " << builder.variables.size() << " variables renamed, " << phis << " phi functions" << log::endl;
+    }
+
+    return std::move(builder.versions);
+}
+
+namespace {
+
+std::shared_ptr<mtac::Quadruple> make_copy(std::shared_ptr<Variable> result, mtac::Argument value, mtac::basic_block_p block){
+    auto op = mtac::is_single_float_register(result->type()) ? mtac::Operator::FASSIGN : mtac::Operator::ASSIGN;
+
+    auto copy = make_node<mtac::Quadruple>(result, value, op);
+    copy->depth = block->depth;
+    return copy;
+}
+
+bool is_jump(mtac::Statement& statement){
+    return boost::get<std::shared_ptr<mtac::Goto>>(&statement)
+        || boost::get<std::shared_ptr<mtac::If>>(&statement)
+        || boost::get<std::shared_ptr<mtac::IfFalse>>(&statement);
+}
+
+} //end of anonymous namespace
+
+void mtac::destroy_ssa(mtac::function_p function){
+    PerfsTimer timer("SSA destruction");
+
+    for(auto& block : function){
+        if(block->phis.empty()){
+            continue;
+        }
+
+        std::vector<mtac::Statement> head_copies;
+
+        //Each phi function is isolated with its own temporary, the copies inserted in the predecessors
+        //can therefore not interfere with each other nor with the phi functions of the other blocks
+        for(auto& phi : block->phis){
+            auto temporary = function->context->new_temporary(phi->variable->type());
+
+            for(std::size_t i = 0; i < block->predecessors.size(); ++i){
+                auto& predecessor = block->predecessors[i];
+                auto& statements = predecessor->statements;
+
+                auto position = statements.end();
+                if(!statements.empty() && is_jump(statements.back())){
+                    --position;
+                }
+
+                statements.insert(position, make_copy(temporary, phi->args[i], predecessor));
+            }
+
+            head_copies.push_back(make_copy(phi->result, temporary, block));
+        }
+
+        //The copies at the entry of the block go after the labels
+        auto head = block->statements.begin();
+        while(head != block->statements.end() && boost::get<std::string>(&*head)){
+            ++head;
+        }
+
+        block->statements.insert(head, head_copies.begin(), head_copies.end());
+        block->phis.clear();
+    }
+}
+
+namespace {
+
+struct VersionReverter {
+    const mtac::SSAVersions& versions;
+
+    VersionReverter(const mtac::SSAVersions& versions) : versions(versions) {}
+
+    void revert(std::shared_ptr<Variable>& variable){
+        auto it = versions.find(variable);
+        if(it != versions.end()){
+            variable = it->second;
+        }
+    }
+
+    void revert(mtac::Argument& arg){
+        if(auto* ptr = boost::get<std::shared_ptr<Variable>>(&arg)){
+            revert(*ptr);
+        }
+    }
+
+    void revert(boost::optional<mtac::Argument>& arg){
+        if(arg){
+            revert(*arg);
+        }
+    }
+};
+
+} //end of anonymous namespace
+
+void mtac::revert_ssa(mtac::function_p function, const mtac::SSAVersions& versions){
+    PerfsTimer timer("SSA destruction");
+
+    VersionReverter reverter(versions);
+
+    for(auto& block : function){
+        block->phis.clear();
+
+        for(auto& statement : block->statements){
+            if(auto* ptr = boost::get<std::shared_ptr<mtac::Quadruple>>(&statement)){
+                auto& quadruple = *ptr;
+
+                reverter.revert(quadruple->arg1);
+                reverter.revert(quadruple->arg2);
+
+                if(quadruple->result){
+                    reverter.revert(quadruple->result);
+                }
+            } else if(auto* ptr = boost::get<std::shared_ptr<mtac::Param>>(&statement)){
+                reverter.revert((*ptr)->arg);
+            } else if(auto* ptr = boost::get<std::shared_ptr<mtac::If>>(&statement)){
+                reverter.revert((*ptr)->arg1);
+                reverter.revert((*ptr)->arg2);
+            } else if(auto* ptr = boost::get<std::shared_ptr<mtac::IfFalse>>(&statement)){
+                reverter.revert((*ptr)->arg1);
+                reverter.revert((*ptr)->arg2);
+            }
+        }
+    }
+
+    //The versions are not used anymore
+    for(auto& version : versions){
+        function->context->removeVariable(version.first);
+    }
+}
@@ -21,6 +21,7 @@
 #include <boost/spirit/include/phoenix_object.hpp>
 
 #include "PerfsTimer.hpp"
+#include "PassTimer.hpp"
 
 #include "lexer/SpiritLexer.hpp"
 
@@ -36,6 +37,7 @@ using namespace eddic;
 
 bool parser::SpiritParser::parse(const std::string& file, ast::SourceFile& program){
     PerfsTimer timer("Parsing");
+    PassTimer pass_timer("front end", "parsing");
 
     std::ifstream in(file.c_str());
     in.unsetf(std::ios::skipws);
@@ -6,6 +6,7 @@
 //=======================================================================
 
 #include <string>
+#include <vector>
 #include <iostream>
 
 #include "Options.hpp"
@@ -48,20 +49,30 @@ inline void remove(const std::string& file){
     remove(file.c_str());
 }
 
-inline std::shared_ptr<eddic::Configuration> parse_options(const std::string& file, const std::string& param1, const std::string& param2, const std::string& param3){
+inline std::shared_ptr<eddic::Configuration> parse_options(const std::string& file, const std::string& param1, const std::string& param2, const std::string& param3, const std::vector<std::string>& options = {}){
     std::string output_file = "--output=" + param3;
 
-    const char* argv[6];
-    argv[0] = "./bin/test";
-    argv[1] = param1.c_str();
-    argv[2] = "--quiet";
-    argv[3] = param2.c_str();
-    argv[4] = output_file.c_str();
-    argv[5] = file.c_str();
+    std::vector<const char*> argv;
+    argv.push_back("./bin/test");
+    argv.push_back(param1.c_str());
+    argv.push_back("--quiet");
+    argv.push_back(param2.c_str());
+
+    for(auto& option : options){
+        argv.push_back(option.c_str());
+    }
+
+    argv.push_back(output_file.c_str());
+    argv.push_back(file.c_str());
     
-    BOOST_TEST_MESSAGE( std::string("Compile with options ") + argv[1] + " " + argv[2] + " " + argv[3] + " " + argv[4] + " " + argv[5]); 
+    std::string message = "Compile with options";
+    for(std::size_t i = 1; i < argv.size(); ++i){
+        message += std::string(" ") + argv[i];
+    }
+
+    BOOST_TEST_MESSAGE( message ); 
 
-    auto configuration = eddic::parseOptions(6, argv);
+    auto configuration = eddic::parseOptions(argv.size(), argv.data());
 
     BOOST_REQUIRE (configuration);
 
@@ -153,6 +164,8 @@ TEST_SAMPLE(sort)
 TEST_SAMPLE(identifiers)
 TEST_SAMPLE(registers)
 TEST_SAMPLE(structures)
+TEST_SAMPLE(large_arrays)
+TEST_SAMPLE(strings)
 
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -313,6 +326,18 @@ BOOST_AUTO_TEST_CASE( foreach_ ){
     assert_output("foreach.eddi", "012345");
 }
 
+BOOST_AUTO_TEST_CASE( memory_routines ){
+    assert_output("memory_routines.eddi", "100|0|100|0|0123456789abcdefghijKLMNOPQRSTUVWXYZ+|0123456789abcdefghij|KLMNOPQRSTUVWXYZ+|1|0|0|1|0|0|1|");
+}
+
+BOOST_AUTO_TEST_CASE( vectorization ){
+    assert_output("vectorization.eddi", "10403|5253|55.5000|-101|1.5000");
+}
+
+BOOST_AUTO_TEST_CASE( unrolling ){
+    assert_output("unrolling.eddi", "0|0|21|28|36|4950|14|1785|0,0,1,3,6,10,15,21,28,36,45,|13");
+}
+
 BOOST_AUTO_TEST_CASE( globals_ ){
     assert_output("globals.eddi", "1000a2000aa");
 }
@@ -419,6 +444,56 @@ BOOST_AUTO_TEST_CASE( args ){
     test_args("--64", "--O2", "args.6.out");
 }
 
+static void test_bounds_check(const std::string& arg1, const std::string& arg2, const std::string& arg3){
+    auto configuration = parse_options("test/cases/bounds_check.eddi", arg1, arg2, arg3, {"--fbounds-check"});
+
+    eddic::Compiler compiler;
+    int code = compiler.compile("test/cases/bounds_check.eddi", configuration);
+
+    BOOST_REQUIRE_EQUAL (code, 0);
+
+    //The output is flushed before the program is stopped by the invalid index
+    int status;
+    std::string out = eddic::execCommand({"./" + arg3}, status); 
+    BOOST_CHECK_EQUAL ("28|1|7|7|", out);
+
+    //The last access is out of bounds, the check must not have been removed
+    BOOST_CHECK_EQUAL (1, status);
+    
+    remove("./" + arg3);
+}
+
+BOOST_AUTO_TEST_CASE( bounds_check ){
+    test_bounds_check("--32", "--O0", "bounds_check.1.out");
+    test_bounds_check("--32", "--O1", "bounds_check.2.out");
+    test_bounds_check("--32", "--O2", "bounds_check.3.out");
+
+    test_bounds_check("--64", "--O0", "bounds_check.4.out");
+    test_bounds_check("--64", "--O1", "bounds_check.5.out");
+    test_bounds_check("--64", "--O2", "bounds_check.6.out");
+}
+
+static void test_debug(const std::string& arg1, const std::string& arg2, const std::string& arg3){
+    //The executables with debugging symbols are produced by nasm and ld and not by the encoder
+    auto configuration = parse_options("test/cases/prints.eddi", arg1, arg2, arg3, {"--debug"});
+
+    eddic::Compiler compiler;
+    int code = compiler.compile("test/cases/prints.eddi", configuration);
+
+    BOOST_REQUIRE_EQUAL (code, 0);
+
+    std::string out = eddic::execCommand("./" + arg3); 
+    BOOST_CHECK_EQUAL ("111|0|-111|0|1|999.9900|1.0089|0.0|-1.0089|-999.9900||-0|asdf|1234asdf|", out);
+    
+    remove("./" + arg3);
+}
+
+BOOST_AUTO_TEST_CASE( debug ){
+    test_debug("--64", "--O0", "debug.4.out");
+    test_debug("--64", "--O1", "debug.5.out");
+    test_debug("--64", "--O2", "debug.6.out");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 /* Template tests */ 
@@ -0,0 +1,27 @@
+//=======================================================================
+// Copyright Baptiste Wicht 2011-2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//=======================================================================
+
+#include <fstream>
+#include <iostream>
+
+#include "ltac/peephole_rules.hpp"
+
+/*
+ * Generate the decision tree of the peephole rules in the given file. This is run during the build
+ * to generate the peephole_tree.inc file included by the compiler. 
+ */
+int main(int argc, const char** argv){
+    if(argc != 2){
+        std::cerr << "Usage: peephole_tree_generator file" << std::endl;
+        return 1;
+    }
+
+    std::ofstream out(argv[1]);
+    eddic::ltac::generate_peephole_tree(out);
+
+    return out ? 0 : 1;
+}
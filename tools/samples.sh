@@ -0,0 +1,29 @@
+#! /bin/bash
+
+#By default, stay in the current directory and used the installed eddic version
+executable=${1:-"eddic"}
+base_dir=${2:-"."}
+runs=${3:-"10"}
+
+binary="tmp_samples.out"
+
+#The samples exercising the runtime routines clearing, copying and comparing memory
+samples="large_arrays strings"
+
+for sample in $samples ; do
+    for mode in "--32" "--64" ; do
+        $executable --quiet $mode --O2 -o $binary "$base_dir/eddi_samples/$sample.eddi"
+
+        start=`date +%s%N`
+
+        for (( i = 0; i < $runs; i++ )) ; do
+            ./$binary > /dev/null
+        done
+
+        end=`date +%s%N`
+
+        echo "$sample $mode: $(( ($end - $start) / 1000 / $runs )) us per run"
+    done
+done
+
+rm -f $binary
@@ -0,0 +1,31 @@
+#! /bin/bash
+
+#By default, stay in the current directory and used the installed eddic version
+executable=${1:-"eddic"}
+lines=${2:-"100000"}
+
+source="tmp_syscalls.eddi"
+binary="tmp_syscalls.out"
+
+#A program that does nothing else than printing lines
+cat > $source << END
+void main(){
+    for(int i = 0; i < $lines; i = i + 1){
+        print("line ");
+        println(i);
+    }
+}
+END
+
+for mode in "--32" "--64" ; do
+    $executable --quiet $mode --O2 -o $binary $source
+
+    #Count the write system calls done by the program
+    writes="`strace -f -c -e trace=write ./$binary 2>&1 >/dev/null | egrep ' write$' | awk '{print $4}'`"
+    writes=${writes:-0}
+
+    echo "$mode: $writes write calls for $lines lines (`echo "scale=4; $writes / $lines" | bc` per line)"
+done
+
+rm -f $source
+rm -f $binary